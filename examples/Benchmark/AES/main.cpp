@@ -0,0 +1,84 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib/core.h>
+#include <slib/crypto.h>
+
+using namespace slib;
+
+/*
+	Measures the throughput of AES-128 (CBC, CTR) and AES-128-GCM by message size
+*/
+
+#define BYTES_PER_CASE (64 << 20)
+
+static sl_uint8 g_input[1 << 20];
+static sl_uint8 g_output[(1 << 20) + 16];
+
+static double Measure(sl_uint32 size, const Function<void(sl_uint32)>& run)
+{
+	sl_uint32 n = BYTES_PER_CASE / size;
+	TimeCounter t;
+	for (sl_uint32 i = 0; i < n; i++) {
+		run(size);
+	}
+	double dt = t.getTime().getSecondsCountf();
+	return (double)n * size / dt / 1048576.0;
+}
+
+int main(int argc, const char * argv[])
+{
+	for (sl_size i = 0; i < sizeof(g_input); i++) {
+		g_input[i] = (sl_uint8)i;
+	}
+	sl_uint8 key[16] = {0};
+	sl_uint8 iv[16] = {0};
+	sl_uint8 tag[16];
+
+	AES aes;
+	aes.setKey(key, 16);
+	AES_GCM gcm;
+	gcm.setKey(key, 16);
+
+	Println("AES-NI: %s, PCLMUL: %s (MB/s)", Cpu::isAESNISupported() ? "yes" : "no", Cpu::isPCLMULSupported() ? "yes" : "no");
+	Println("   size       CBC enc       CBC dec           CTR           GCM");
+	sl_uint32 sizes[] = {16, 64, 256, 1024, 4096, 16384, 65536, 1 << 20};
+	for (sl_uint32 k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+		sl_uint32 size = sizes[k];
+		double cbcEnc = Measure(size, [&](sl_uint32 n) {
+			// the padding block is not counted
+			aes.encrypt_CBC_PKCS7Padding(iv, g_input, n - 1, g_output);
+		});
+		aes.encrypt_CBC_PKCS7Padding(iv, g_input, size - 1, g_output);
+		double cbcDec = Measure(size, [&](sl_uint32 n) {
+			aes.decrypt_CBC_PKCS7Padding(iv, g_output, n, g_input);
+		});
+		double ctr = Measure(size, [&](sl_uint32 n) {
+			aes.encrypt_CTR(iv, 0, g_input, n, g_output);
+		});
+		double gcmEnc = Measure(size, [&](sl_uint32 n) {
+			gcm.encrypt(iv, 12, sl_null, 0, g_input, g_output, n, tag);
+		});
+		Println("%7d  %12.1f  %12.1f  %12.1f  %12.1f", size, cbcEnc, cbcDec, ctr, gcmEnc);
+	}
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	Measures million operations/sec of ConcurrentHashMap (lock striping)
+	against CHashMap (one lock for the whole map), shared by an increasing
+	number of threads.
+
+	Every thread runs a mix of 80% get, 15% put and 5% remove over the
+	same key range, so the threads contend on the same map.
+*/
+
+#define KEYS_COUNT 65536
+#define OPERATIONS_PER_THREAD 2000000
+
+static volatile sl_int32 g_flagStart = 0;
+
+static sl_uint32 NextRandom(sl_uint32& seed)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+template <class MAP>
+static void RunOperations(MAP& map, sl_uint32 seed, sl_uint64& check)
+{
+	while (!g_flagStart) {
+		System::yield();
+	}
+	sl_uint64 sum = 0;
+	for (sl_uint32 i = 0; i < OPERATIONS_PER_THREAD; i++) {
+		sl_uint32 r = NextRandom(seed);
+		sl_uint32 key = r % KEYS_COUNT;
+		sl_uint32 op = (r >> 16) % 100;
+		if (op < 80) {
+			sl_uint32 value;
+			if (map.get(key, &value)) {
+				sum += value;
+			}
+		} else if (op < 95) {
+			map.put(key, i);
+		} else {
+			map.remove(key);
+		}
+	}
+	check = sum;
+}
+
+template <class MAP>
+static double Run(MAP& map, sl_uint32 nThreads)
+{
+	for (sl_uint32 i = 0; i < KEYS_COUNT; i++) {
+		map.put(i, i);
+	}
+	g_flagStart = 0;
+	sl_uint64 checks[64] = {0};
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nThreads; i++) {
+		MAP* pMap = &map;
+		sl_uint64* pCheck = checks + i;
+		threads.add_NoLock(Thread::start([pMap, i, pCheck]() {
+			RunOperations(*pMap, i + 1, *pCheck);
+		}));
+	}
+	TimeCounter t;
+	Base::interlockedIncrement32((sl_int32*)&g_flagStart);
+	for (sl_uint32 i = 0; i < nThreads; i++) {
+		threads[i]->join();
+	}
+	double dt = t.getTime().getSecondsCountf();
+	return (double)nThreads * OPERATIONS_PER_THREAD / dt / 1000000.0;
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint32 nMaxThreads = System::getProcessorsCount() * 2;
+	if (nMaxThreads < 8) {
+		nMaxThreads = 8;
+	}
+	if (nMaxThreads > 64) {
+		nMaxThreads = 64;
+	}
+	Println("%d keys, %d processors (million operations/sec)", KEYS_COUNT, System::getProcessorsCount());
+	Println("threads     CHashMap   ConcurrentHashMap");
+	for (sl_uint32 n = 1; n <= nMaxThreads; n *= 2) {
+		double a, b;
+		{
+			CHashMap<sl_uint32, sl_uint32> map;
+			a = Run(map, n);
+		}
+		{
+			ConcurrentHashMap<sl_uint32, sl_uint32> map;
+			b = Run(map, n);
+		}
+		Println("%7d   %10.2f   %17.2f", n, a, b);
+	}
+	return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	Measures million operations/sec of FlatHashMap (open addressing)
+	against CHashMap (chained nodes) for insert, find (hit and miss)
+	and erase, with sl_uint64 keys and table sizes from 1K to 4M items.
+
+	CHashMap is used through the `_NoLock` functions, so that only the
+	data structures are compared.
+*/
+
+#define TOTAL_OPERATIONS 8000000
+
+static sl_uint64 GetKey(sl_uint64 i)
+{
+	// spreads sequential indices over the key space
+	return (i + 1) * 0x9E3779B97F4A7C15ULL;
+}
+
+struct Result
+{
+	double insert;
+	double findHit;
+	double findMiss;
+	double erase;
+};
+
+static double GetMops(sl_size nOps, TimeCounter& t)
+{
+	double dt = t.getTime().getSecondsCountf();
+	if (dt <= 0) {
+		return 0;
+	}
+	return (double)nOps / dt / 1000000.0;
+}
+
+static Result RunFlat(sl_size n, sl_uint32 nRounds, sl_uint64& check)
+{
+	Result r = {0, 0, 0, 0};
+	for (sl_uint32 round = 0; round < nRounds; round++) {
+		FlatHashMap<sl_uint64, sl_uint64> map;
+		TimeCounter t;
+		for (sl_size i = 0; i < n; i++) {
+			map.put(GetKey(i), i);
+		}
+		r.insert += GetMops(n, t);
+		t.reset();
+		for (sl_size i = 0; i < n; i++) {
+			sl_uint64* p = map.getItemPointer(GetKey(i));
+			if (p) {
+				check += *p;
+			}
+		}
+		r.findHit += GetMops(n, t);
+		t.reset();
+		for (sl_size i = 0; i < n; i++) {
+			if (map.getItemPointer(GetKey(i + n))) {
+				check++;
+			}
+		}
+		r.findMiss += GetMops(n, t);
+		t.reset();
+		for (sl_size i = 0; i < n; i++) {
+			map.remove(GetKey(i));
+		}
+		r.erase += GetMops(n, t);
+	}
+	r.insert /= nRounds;
+	r.findHit /= nRounds;
+	r.findMiss /= nRounds;
+	r.erase /= nRounds;
+	return r;
+}
+
+static Result RunChained(sl_size n, sl_uint32 nRounds, sl_uint64& check)
+{
+	Result r = {0, 0, 0, 0};
+	for (sl_uint32 round = 0; round < nRounds; round++) {
+		CHashMap<sl_uint64, sl_uint64> map;
+		TimeCounter t;
+		for (sl_size i = 0; i < n; i++) {
+			map.put_NoLock(GetKey(i), i);
+		}
+		r.insert += GetMops(n, t);
+		t.reset();
+		for (sl_size i = 0; i < n; i++) {
+			HashMapNode<sl_uint64, sl_uint64>* node = map.find_NoLock(GetKey(i));
+			if (node) {
+				check += node->value;
+			}
+		}
+		r.findHit += GetMops(n, t);
+		t.reset();
+		for (sl_size i = 0; i < n; i++) {
+			if (map.find_NoLock(GetKey(i + n))) {
+				check++;
+			}
+		}
+		r.findMiss += GetMops(n, t);
+		t.reset();
+		for (sl_size i = 0; i < n; i++) {
+			map.remove_NoLock(GetKey(i));
+		}
+		r.erase += GetMops(n, t);
+	}
+	r.insert /= nRounds;
+	r.findHit /= nRounds;
+	r.findMiss /= nRounds;
+	r.erase /= nRounds;
+	return r;
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint64 check = 0;
+	Println("Million operations/sec, sl_uint64 keys");
+	Println("items      map        insert   find:hit  find:miss      erase");
+	for (sl_size n = 1024; n <= 4 * 1024 * 1024; n *= 4) {
+		sl_uint32 nRounds = (sl_uint32)(TOTAL_OPERATIONS / n);
+		if (nRounds < 1) {
+			nRounds = 1;
+		}
+		Result a = RunChained(n, nRounds, check);
+		Result b = RunFlat(n, nRounds, check);
+		Println("%-9d  CHashMap    %7.1f  %9.1f  %9.1f  %9.1f", (sl_uint32)n, a.insert, a.findHit, a.findMiss, a.erase);
+		Println("%-9s  FlatHashMap %7.1f  %9.1f  %9.1f  %9.1f", "", b.insert, b.findHit, b.findMiss, b.erase);
+	}
+	// keeps the lookups from being optimized away
+	Println("(checksum %d)", (sl_uint32)check);
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+/*
+	Measures tasks/sec of the classic ThreadPool against the work-stealing
+	pool, for an increasing number of threads.
+
+	- post: the main thread posts every task
+	- fork: root tasks post their children from the worker threads
+*/
+
+#define TASKS_COUNT 1000000
+#define FORK_ROOTS 1000
+#define TASK_WORK 50
+
+static sl_int32 g_nDone = 0;
+
+static void RunTask()
+{
+	volatile sl_uint32 s = 0;
+	for (sl_uint32 i = 0; i < TASK_WORK; i++) {
+		s += i;
+	}
+	Base::interlockedIncrement32(&g_nDone);
+}
+
+static void RunForkRoot(ThreadPool* pool)
+{
+	Function<void()> task = &RunTask;
+	for (sl_uint32 i = 0; i < TASKS_COUNT / FORK_ROOTS; i++) {
+		pool->addTask(task);
+	}
+}
+
+static Ref<ThreadPool> CreatePool(sl_bool flagWorkStealing, sl_uint32 nThreads)
+{
+	if (flagWorkStealing) {
+		return ThreadPool::createWorkStealing(nThreads);
+	} else {
+		return ThreadPool::create(nThreads, nThreads);
+	}
+}
+
+static void WaitDone(sl_int32 n)
+{
+	while (g_nDone < n) {
+		System::sleep(1);
+	}
+}
+
+static double RunPost(sl_bool flagWorkStealing, sl_uint32 nThreads)
+{
+	Ref<ThreadPool> pool = CreatePool(flagWorkStealing, nThreads);
+	g_nDone = 0;
+	Function<void()> task = &RunTask;
+	TimeCounter t;
+	for (sl_uint32 i = 0; i < TASKS_COUNT; i++) {
+		pool->addTask(task);
+	}
+	WaitDone(TASKS_COUNT);
+	double dt = t.getTime().getSecondsCountf();
+	pool->release();
+	return TASKS_COUNT / dt;
+}
+
+static double RunFork(sl_bool flagWorkStealing, sl_uint32 nThreads)
+{
+	Ref<ThreadPool> pool = CreatePool(flagWorkStealing, nThreads);
+	g_nDone = 0;
+	ThreadPool* p = pool.get();
+	TimeCounter t;
+	for (sl_uint32 i = 0; i < FORK_ROOTS; i++) {
+		pool->addTask([p]() {
+			RunForkRoot(p);
+		});
+	}
+	WaitDone(TASKS_COUNT);
+	double dt = t.getTime().getSecondsCountf();
+	pool->release();
+	return TASKS_COUNT / dt;
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint32 nMaxThreads = System::getProcessorsCount() * 2;
+	if (nMaxThreads < 8) {
+		nMaxThreads = 8;
+	}
+	Println("%d tasks, %d processors (tasks/sec)", TASKS_COUNT, System::getProcessorsCount());
+	Println("threads      post:classic   post:stealing   fork:classic   fork:stealing");
+	for (sl_uint32 n = 1; n <= nMaxThreads; n *= 2) {
+		double a = RunPost(sl_false, n);
+		double b = RunPost(sl_true, n);
+		double c = RunFork(sl_false, n);
+		double d = RunFork(sl_true, n);
+		Println("%7d   %14.0f  %14.0f  %13.0f  %14.0f", n, a, b, c, d);
+	}
+	return 0;
+}
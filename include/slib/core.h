@@ -50,6 +50,7 @@
 
 #include "core/spin_lock.h"
 #include "core/mutex.h"
+#include "core/mpsc_queue.h"
 #include "core/string.h"
 #include "core/string_buffer.h"
 #include "core/memory.h"
@@ -66,6 +67,8 @@
 #include "core/list.h"
 #include "core/map.h"
 #include "core/hash_map.h"
+#include "core/flat_hash_map.h"
+#include "core/concurrent_hash_map.h"
 #include "core/hash_table.h"
 #include "core/linked_list.h"
 #include "core/queue.h"
@@ -73,6 +76,7 @@
 #include "core/linked_object.h"
 #include "core/loop_queue.h"
 #include "core/expire.h"
+#include "core/cache.h"
 #include "core/btree.h"
 
 #include "core/math.h"
@@ -80,6 +84,7 @@
 #include "core/animation.h"
 
 #include "core/system.h"
+#include "core/cpu.h"
 #include "core/console.h"
 #include "core/event.h"
 #include "core/thread.h"
@@ -90,11 +95,13 @@
 
 #include "core/io.h"
 #include "core/file.h"
+#include "core/mapped_file.h"
 #include "core/pipe.h"
 #include "core/async.h"
 #include "core/dispatch.h"
 #include "core/dispatch_loop.h"
 #include "core/timer.h"
+#include "core/timing_wheel.h"
 
 #include "core/app.h"
 #include "core/service.h"
@@ -108,7 +115,11 @@
 
 #include "core/regex.h"
 #include "core/json.h"
+#include "core/json_reader.h"
+#include "core/json_writer.h"
+#include "core/json_view.h"
 #include "core/xml.h"
+#include "core/xml_reader.h"
 
 #endif
 
@@ -85,15 +85,26 @@ namespace slib
 		void requestOrder(AsyncIoInstance* instance);
 
 		sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms) override;
+		
+		// number of attached connection instances, used for balancing the loops of AsyncIoLoopGroup
+		sl_uint32 getConnectionsCount();
 
 	protected:
 		sl_bool m_flagInit;
 		sl_bool m_flagRunning;
 		void* m_handle;
+		sl_int32 m_nConnections;
 
 		Ref<Thread> m_thread;
 
-		LinkedQueue< Function<void()> > m_queueTasks;
+		MpscQueue< Function<void()> > m_queueTasks;
+		// set by the producer which wakes the loop, until the loop takes the tasks
+		sl_int32 m_flagWakingTasks;
+	
+		// delayed tasks
+		TimeCounter m_timeCounter;
+		TimingWheel m_timeTasks;
+		Mutex m_lockTimeTasks;
 	
 		LinkedQueue< Ref<AsyncIoInstance> > m_queueInstancesOrder;
 		LinkedQueue< Ref<AsyncIoInstance> > m_queueInstancesClosing;
@@ -106,11 +117,63 @@ namespace slib
 		sl_bool _native_attachInstance(AsyncIoInstance* instance, AsyncIoMode mode);
 		void _native_detachInstance(AsyncIoInstance* instance);
 		void _native_wake();
+		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	public:
+		// io_uring bound to the loop, created on first use. null if the kernel does not support it
+		void* _native_getIoUring();
+#endif
 
 	protected:
 		void _stepBegin();
 		void _stepEnd();
+		// milliseconds until the next delayed task, or -1 for infinite wait
+		sl_int32 _getTimeout();
+	
+	};
+	
 	
+	enum class AsyncIoLoopBalance
+	{
+		RoundRobin = 0,
+		LeastLoaded = 1
+	};
+	
+	class SLIB_EXPORT AsyncIoLoopGroup : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	private:
+		AsyncIoLoopGroup();
+		
+		~AsyncIoLoopGroup();
+		
+	public:
+		// `nLoops` = 0 means the number of processors
+		static Ref<AsyncIoLoopGroup> create(sl_uint32 nLoops = 0, sl_bool flagPinToProcessors = sl_false, sl_bool flagAutoStart = sl_true);
+		
+	public:
+		void release();
+		
+		void start();
+		
+		sl_bool isRunning();
+		
+		sl_uint32 getLoopsCount();
+		
+		Ref<AsyncIoLoop> getLoop(sl_uint32 index);
+		
+		// selects a loop for a new instance, according to `Balance`
+		Ref<AsyncIoLoop> selectLoop();
+		
+	public:
+		SLIB_PROPERTY(AsyncIoLoopBalance, Balance)
+		
+	protected:
+		Array< Ref<AsyncIoLoop> > m_loops;
+		sl_int32 m_indexNext;
+		sl_bool m_flagRunning;
+		
 	};
 	
 	
@@ -141,6 +204,9 @@ namespace slib
 		sl_bool isClosing();
 
 		void setClosing();
+		
+		// connections are counted by the loop, files and listeners are not
+		sl_bool isConnection();
 
 		void addToQueue(LinkedQueue< Ref<AsyncIoInstance> >& queue);
 
@@ -152,6 +218,8 @@ namespace slib
 		void setMode(AsyncIoMode mode);
 
 		void setHandle(sl_file handle);
+		
+		void setConnection(sl_bool flag);
 	
 	public:
 		virtual void close() = 0;
@@ -178,6 +246,7 @@ namespace slib
 		AsyncIoMode m_mode;
 	
 		sl_bool m_flagClosing;
+		sl_bool m_flagConnection;
 
 		sl_bool m_flagOrdering;
 		Mutex m_lockOrdering;
@@ -242,6 +311,10 @@ namespace slib
 		Ref<Referable> userObject;
 		Function<void(AsyncStreamResult*)> callback;
 		sl_bool flagRead;
+		
+		// source of the write request sent by `sendFile`
+		Ref<File> file;
+		sl_uint64 fileOffset;
 
 	protected:
 		AsyncStreamRequest(const void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback, sl_bool flagRead);
@@ -250,6 +323,8 @@ namespace slib
 		static Ref<AsyncStreamRequest> createRead(void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback);
 
 		static Ref<AsyncStreamRequest> createWrite(const void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback);
+		
+		static Ref<AsyncStreamRequest> createSendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult*)>& callback);
 
 	public:
 		void runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError);
@@ -271,6 +346,10 @@ namespace slib
 
 		virtual sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject);
 
+		virtual sl_bool isSendFileSupported();
+
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -322,6 +401,11 @@ namespace slib
 
 		virtual sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) = 0;
 
+		// zero-copy transfer from the file to the stream (`sendfile` on Linux sockets)
+		virtual sl_bool isSendFileSupported();
+
+		virtual sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -352,6 +436,10 @@ namespace slib
 
 		sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) override;
 
+		sl_bool isSendFileSupported() override;
+
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject = sl_null) override;
+
 		sl_bool isSeekable() override;
 
 		sl_bool seek(sl_uint64 pos) override;
@@ -510,6 +598,13 @@ namespace slib
 
 		static Ref<AsyncStream> openIOCP(const String& path, FileMode mode);
 #endif
+		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// returns null if io_uring is not supported
+		static Ref<AsyncStream> openIoUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop);
+		
+		static Ref<AsyncStream> openIoUring(const String& path, FileMode mode);
+#endif
 	
 	public:
 		void close() override;
@@ -642,6 +737,8 @@ namespace slib
 	
 	};
 	
+	class AsyncStreamFilter;
+	
 	class SLIB_EXPORT AsyncOutputBufferElement : public Referable
 	{
 	public:
@@ -651,6 +748,8 @@ namespace slib
 
 		AsyncOutputBufferElement(AsyncStream* stream, sl_uint64 size);
 
+		AsyncOutputBufferElement(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+
 		~AsyncOutputBufferElement();
 	
 	public:
@@ -661,18 +760,35 @@ namespace slib
 
 		sl_bool addHeader(const Memory& header);
 
+		sl_bool addHeader(const MemoryData& header);
+
 		void setBody(AsyncStream* stream, sl_uint64 size);
 	
+		void setBody(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+	
 		MemoryQueue& getHeader();
 	
 		Ref<AsyncStream> getBody();
 	
+		Ref<File> getBodyFile();
+	
+		sl_uint64 getBodyFileOffset();
+	
 		sl_uint64 getBodySize();
 	
+		void skipBody(sl_uint64 size);
+	
+		Ref<AsyncStreamFilter> getBodyFilter();
+	
+		void setBodyFilter(const Ref<AsyncStreamFilter>& filter);
+	
 	protected:
 		MemoryQueue m_header;
 		sl_uint64 m_sizeBody;
 		AtomicRef<AsyncStream> m_body;
+		AtomicRef<File> m_bodyFile;
+		sl_uint64 m_offsetBodyFile;
+		AtomicRef<AsyncStreamFilter> m_bodyFilter;
 
 	};
 	
@@ -690,14 +806,26 @@ namespace slib
 
 		sl_bool write(const Memory& mem);
 
+		// `data.refer` should keep `data.data` alive until the output is completed
+		sl_bool write(const MemoryData& data);
+
 		sl_bool copyFrom(AsyncStream* stream, sl_uint64 size);
 	
+		// the body is written through `filter` attached on the output stream, and is not counted in the output length
+		sl_bool copyFrom(AsyncStream* stream, sl_uint64 size, const Ref<AsyncStreamFilter>& filter);
+	
 		sl_bool copyFromFile(const String& path);
 
 		sl_bool copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 
+		// the file is sent by `AsyncStream::sendFile` when the output stream supports it
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+
 		sl_uint64 getOutputLength() const;
 	
+		// returns `sl_false` when the output contains streams or files
+		sl_bool getOutputMemory(Memory& _out);
+	
 	protected:
 		sl_uint64 m_lengthOutput;
 		LinkedQueue< Ref<AsyncOutputBufferElement> > m_queueOutput;
@@ -707,6 +835,8 @@ namespace slib
 	
 	class AsyncOutput;
 	
+#define SLIB_ASYNC_OUTPUT_SEND_FILE_CHUNK_SIZE 0x40000000
+	
 	class AsyncOutputParam
 	{
 	public:
@@ -749,6 +879,8 @@ namespace slib
 		
 		void onWriteStream(AsyncStreamResult* result);
 
+		void onSendFile(AsyncStreamResult* result);
+
 	protected:
 		void _onError();
 
@@ -0,0 +1,321 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CACHE
+#define CHECKHEADER_SLIB_CORE_CACHE
+
+#include "definition.h"
+
+#include "hash_table.h"
+#include "spin_lock.h"
+#include "math.h"
+#include "system.h"
+
+/*
+	Bounded cache
+
+	The capacity is the total weight of the entries. Entries weigh 1 by default, so the capacity is a number of entries,
+	but `put()` can pass the size of the value to bound the cache by bytes.
+	
+	Eviction policies
+		LRU: evicts the least recently used entry
+		TinyLFU: W-TinyLFU. New entries pass a small LRU window, and then replace the victim of the main (segmented LRU) area
+			only when a count-min sketch says they are used more often. Resists scans and one-hit wonders.
+		Clock: second-chance approximation of LRU. A hit only sets a flag, so hits never relink the entries.
+	
+	Entries may have a time to live. Expired entries are dropped when they are looked up or evicted, or by `removeExpired()`.
+	Every operation takes the spin lock of the cache; use ShardedCache for the caches shared by many threads.
+*/
+
+namespace slib
+{
+	
+	enum class CacheEviction
+	{
+		LRU = 0,
+		TinyLFU = 1,
+		Clock = 2
+	};
+	
+	class SLIB_EXPORT CacheParam
+	{
+	public:
+		CacheEviction eviction;
+		// maximum total weight of the entries. 0 means unbounded
+		sl_size capacity;
+		// default time to live of the entries in milliseconds. 0 means no expiration
+		sl_uint32 timeToLive;
+		
+	public:
+		CacheParam() noexcept;
+		
+		CacheParam(sl_size capacity, CacheEviction eviction = CacheEviction::LRU, sl_uint32 timeToLive = 0) noexcept;
+		
+	};
+	
+	class SLIB_EXPORT CacheStatistics
+	{
+	public:
+		sl_uint64 hits;
+		sl_uint64 misses;
+		sl_uint64 evictions;
+		sl_uint64 expirations;
+		
+	public:
+		CacheStatistics() noexcept;
+		
+	public:
+		CacheStatistics& operator+=(const CacheStatistics& other) noexcept;
+		
+	};
+	
+	// count-min sketch of 4-bit counters, halved periodically so that the old history fades (used by TinyLFU)
+	class SLIB_EXPORT CacheFrequencySketch
+	{
+	public:
+		CacheFrequencySketch() noexcept;
+		
+		~CacheFrequencySketch() noexcept;
+		
+	public:
+		CacheFrequencySketch(const CacheFrequencySketch& other) = delete;
+		
+		CacheFrequencySketch& operator=(const CacheFrequencySketch& other) = delete;
+		
+	public:
+		// grows the table for `count` distinct items
+		void ensureCapacity(sl_size count) noexcept;
+		
+		void increment(sl_size hash) noexcept;
+		
+		// between 0 and 15
+		sl_uint32 estimate(sl_size hash) const noexcept;
+		
+		void clear() noexcept;
+		
+	private:
+		sl_uint64* m_table;
+		sl_size m_mask;
+		sl_size m_size;
+		sl_size m_sizeSample;
+		
+	};
+	
+	template <class KT, class VT>
+	class CacheEntry
+	{
+	public:
+		typedef HashTableNode< KT, CacheEntry<KT, VT> > NODE;
+		
+		VT value;
+		NODE* before;
+		NODE* after;
+		sl_size weight;
+		sl_uint32 timeExpire;
+		sl_uint8 segment;
+		sl_bool flagExpiring;
+		sl_bool flagReferenced;
+		
+	public:
+		template <class VALUE>
+		CacheEntry(VALUE&& _value) noexcept;
+		
+	};
+	
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT Cache
+	{
+	public:
+		typedef CacheEntry<KT, VT> ENTRY;
+		typedef HashTableNode<KT, ENTRY> NODE;
+		
+	public:
+		Cache(const CacheParam& param = CacheParam(), const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+		
+		~Cache() noexcept;
+		
+	public:
+		Cache(const Cache& other) = delete;
+		
+		Cache& operator=(const Cache& other) = delete;
+		
+	public:
+		CacheEviction getEviction() const noexcept;
+		
+		sl_size getCapacity() const noexcept;
+		
+		// evicts the entries exceeding the new capacity
+		void setCapacity(sl_size capacity) noexcept;
+		
+		sl_uint32 getTimeToLive() const noexcept;
+		
+		// applied to the entries put later
+		void setTimeToLive(sl_uint32 ms) noexcept;
+		
+		sl_size getCount() const noexcept;
+		
+		sl_bool isEmpty() const noexcept;
+		
+		sl_bool isNotEmpty() const noexcept;
+		
+		// total weight of the entries
+		sl_size getWeight() const noexcept;
+		
+		// counts a hit or a miss, and refreshes the recency of the entry
+		sl_bool get(const KT& key, VT* outValue = sl_null) noexcept;
+		
+		VT getValue(const KT& key, const VT& def) noexcept;
+		
+		// does not affect the statistics and the eviction order
+		sl_bool contains(const KT& key) noexcept;
+		
+		// returns `sl_false` when the weight exceeds the capacity
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value) noexcept;
+		
+		// `timeToLive`: 0 means the default of the cache
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, sl_size weight, sl_uint32 timeToLive = 0) noexcept;
+		
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+		
+		void removeAll() noexcept;
+		
+		// returns the number of the removed entries
+		sl_size removeExpired() noexcept;
+		
+		CacheStatistics getStatistics() const noexcept;
+		
+		void resetStatistics() noexcept;
+		
+	protected:
+		sl_bool _isExpired(NODE* node, sl_uint32 now) const noexcept;
+		
+		void _link(NODE* node, sl_uint32 segment) noexcept;
+		
+		void _linkBefore(NODE* node, NODE* next) noexcept;
+		
+		void _unlink(NODE* node) noexcept;
+		
+		void _removeNode(NODE* node) noexcept;
+		
+		void _onAccess(NODE* node) noexcept;
+		
+		void _evict() noexcept;
+		
+		void _evictNode(NODE* node) noexcept;
+		
+		void _updateCapacity() noexcept;
+		
+	protected:
+		struct Segment
+		{
+			NODE* first;
+			NODE* last;
+			sl_size weight;
+		};
+		
+		SpinLock m_lock;
+		HashTable<KT, ENTRY, HASH, KEY_EQUALS> m_table;
+		HASH m_hash;
+		
+		CacheEviction m_eviction;
+		sl_size m_capacity;
+		sl_uint32 m_timeToLive;
+		
+		// LRU, Clock: [0]. TinyLFU: window [0], probation [1] and protected [2]
+		Segment m_segments[3];
+		sl_size m_weight;
+		sl_size m_capacityWindow;
+		sl_size m_capacityProtected;
+		// Clock hand
+		NODE* m_hand;
+		CacheFrequencySketch m_sketch;
+		
+		CacheStatistics m_statistics;
+		
+	};
+	
+	// Cache split into shards with their own locks and capacities, selected by the hash of the key
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT ShardedCache
+	{
+	public:
+		typedef Cache<KT, VT, HASH, KEY_EQUALS> SHARD;
+		
+	public:
+		// `nShards` = 0 means 4 x processors (between 4 and 64). `param.capacity` is divided by the shards
+		ShardedCache(const CacheParam& param = CacheParam(), sl_uint32 nShards = 0, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+		
+		~ShardedCache() noexcept;
+		
+	public:
+		ShardedCache(const ShardedCache& other) = delete;
+		
+		ShardedCache& operator=(const ShardedCache& other) = delete;
+		
+	public:
+		sl_uint32 getShardCount() const noexcept;
+		
+		sl_size getCount() const noexcept;
+		
+		sl_size getWeight() const noexcept;
+		
+		sl_bool get(const KT& key, VT* outValue = sl_null) noexcept;
+		
+		VT getValue(const KT& key, const VT& def) noexcept;
+		
+		sl_bool contains(const KT& key) noexcept;
+		
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value) noexcept;
+		
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, sl_size weight, sl_uint32 timeToLive = 0) noexcept;
+		
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+		
+		void removeAll() noexcept;
+		
+		sl_size removeExpired() noexcept;
+		
+		CacheStatistics getStatistics() const noexcept;
+		
+		void resetStatistics() noexcept;
+		
+	public:
+		SHARD* getShard(const KT& key) const noexcept;
+		
+		SHARD* getShardAt(sl_uint32 index) const noexcept;
+		
+	protected:
+		SHARD* m_shards;
+		sl_uint32 m_nShards;
+		HASH m_hash;
+		
+	};
+	
+}
+
+#include "detail/cache.inc"
+
+#endif
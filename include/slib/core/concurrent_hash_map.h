@@ -0,0 +1,173 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#ifndef CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+#define CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+
+#include "definition.h"
+
+#include "hash_table.h"
+#include "spin_lock.h"
+#include "pair.h"
+#include "list.h"
+#include "math.h"
+#include "system.h"
+
+/*
+	Hash map shared by many threads
+
+	Keys are distributed to shards by the high bits of the hash, and every shard is a HashTable guarded by its own SpinLock.
+	Threads working on different shards never touch the same lock or cache line, so reads scale with the number of cores.
+	The number of shards is rounded up to a power of two (default: 4 x processors, between 16 and 256).
+
+	Iteration is weakly consistent: each shard is copied under its lock when the iterator reaches it,
+	so the items inserted or removed during iteration may or may not be visited, but no item is visited twice.
+*/
+
+namespace slib
+{
+	
+	template <class KT, class VT, class HASH, class KEY_EQUALS>
+	class ConcurrentHashMap;
+	
+	template <class KT, class VT, class HASH, class KEY_EQUALS>
+	class SLIB_EXPORT ConcurrentHashMapPosition
+	{
+	public:
+		typedef ConcurrentHashMap<KT, VT, HASH, KEY_EQUALS> MAP;
+		
+	public:
+		ConcurrentHashMapPosition() noexcept;
+		
+		ConcurrentHashMapPosition(const MAP* map) noexcept;
+		
+	public:
+		Pair<KT, VT>& operator*() const noexcept;
+		
+		sl_bool operator==(const ConcurrentHashMapPosition& other) const noexcept;
+		
+		sl_bool operator!=(const ConcurrentHashMapPosition& other) const noexcept;
+		
+		ConcurrentHashMapPosition& operator++() noexcept;
+		
+	private:
+		void _loadShards(sl_uint32 indexShard) noexcept;
+		
+	private:
+		const MAP* m_map;
+		sl_uint32 m_indexShard;
+		List< Pair<KT, VT> > m_items;
+		sl_size m_indexItem;
+		
+	};
+	
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT ConcurrentHashMap
+	{
+	public:
+		typedef HashTable<KT, VT, HASH, KEY_EQUALS> TABLE;
+		
+		struct Shard
+		{
+			SpinLock lock;
+			TABLE table;
+			// keeps the locks of neighbor shards in different cache lines
+			sl_uint8 padding[64];
+			
+			Shard(const HASH& hash, const KEY_EQUALS& key_equals) noexcept: table(0, 0, hash, key_equals) {}
+		};
+		
+	public:
+		ConcurrentHashMap(sl_uint32 nShards = 0, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+		
+		~ConcurrentHashMap() noexcept;
+		
+	public:
+		ConcurrentHashMap(const ConcurrentHashMap& other) = delete;
+		
+		ConcurrentHashMap& operator=(const ConcurrentHashMap& other) = delete;
+		
+	public:
+		sl_uint32 getShardCount() const noexcept;
+		
+		// sum of the shard counts, not a snapshot
+		sl_size getCount() const noexcept;
+		
+		sl_bool isEmpty() const noexcept;
+		
+		sl_bool isNotEmpty() const noexcept;
+		
+		sl_bool get(const KT& key, VT* outValue = sl_null) const noexcept;
+		
+		VT getValue(const KT& key) const noexcept;
+		
+		VT getValue(const KT& key, const VT& def) const noexcept;
+		
+		sl_bool contains(const KT& key) const noexcept;
+		
+		// replaces the value when the key exists
+		template <class KEY, class VALUE>
+		sl_bool put(KEY&& key, VALUE&& value, sl_bool* isInsertion = sl_null) noexcept;
+		
+		// returns `sl_false` (and the existing value) when the key exists
+		template <class KEY, class VALUE>
+		sl_bool putIfAbsent(KEY&& key, VALUE&& value, VT* outExisting = sl_null) noexcept;
+		
+		// `factory()` is called under the shard lock, only when the key does not exist. Returns the value mapped to the key.
+		template <class KEY, class FACTORY>
+		VT computeIfAbsent(KEY&& key, const FACTORY& factory) noexcept;
+		
+		// `callback(VT& value)` is called under the shard lock when the key exists
+		template <class CALLBACK>
+		sl_bool modify(const KT& key, const CALLBACK& callback) noexcept;
+		
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+		
+		sl_size removeAll() noexcept;
+		
+		// `callback(const KT& key, VT& value)` is called under the lock of each shard
+		template <class CALLBACK>
+		void forEach(const CALLBACK& callback) const noexcept;
+		
+		List< Pair<KT, VT> > toList() const noexcept;
+		
+		// range-based for loop (weakly consistent)
+		ConcurrentHashMapPosition<KT, VT, HASH, KEY_EQUALS> begin() const noexcept;
+		
+		ConcurrentHashMapPosition<KT, VT, HASH, KEY_EQUALS> end() const noexcept;
+		
+	public:
+		Shard* getShard(const KT& key) const noexcept;
+		
+		Shard* getShardAt(sl_uint32 index) const noexcept;
+		
+	protected:
+		Shard* m_shards;
+		sl_uint32 m_nShards;
+		HASH m_hash;
+		
+	};
+	
+}
+
+#include "detail/concurrent_hash_map.inc"
+
+#endif
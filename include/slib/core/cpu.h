@@ -0,0 +1,69 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CPU
+#define CHECKHEADER_SLIB_CORE_CPU
+
+#include "definition.h"
+
+#if defined(SLIB_ARCH_IS_X86) || defined(SLIB_ARCH_IS_X64)
+#	define SLIB_CPU_IS_X86_FAMILY
+#endif
+
+/*
+	Enables instruction sets on a function compiled without the corresponding compiler options.
+	The function should be called only after checking the support at runtime (see `Cpu`).
+*/
+#if defined(SLIB_COMPILER_IS_GCC)
+#	define SLIB_TARGET_FEATURES(FEATURES) __attribute__((target(FEATURES)))
+#else
+#	define SLIB_TARGET_FEATURES(FEATURES)
+#endif
+
+namespace slib
+{
+	
+	// Instruction sets supported by the running processor
+	class SLIB_EXPORT Cpu
+	{
+	public:
+		static sl_bool isSSE2Supported();
+		
+		static sl_bool isSSSE3Supported();
+		
+		static sl_bool isSSE41Supported();
+		
+		static sl_bool isSSE42Supported();
+		
+		static sl_bool isAVX2Supported();
+		
+		static sl_bool isAESNISupported();
+		
+		static sl_bool isPCLMULSupported();
+		
+		static sl_bool isSHASupported();
+		
+	};
+
+}
+
+#endif
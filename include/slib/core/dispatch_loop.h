@@ -28,7 +28,9 @@
 #include "dispatch.h"
 #include "thread.h"
 #include "time.h"
-#include "map.h"
+#include "hash_map.h"
+#include "timing_wheel.h"
+#include "mpsc_queue.h"
 
 namespace slib
 {
@@ -38,7 +40,7 @@ namespace slib
 		SLIB_DECLARE_OBJECT
 
 	private:
-		DispatchLoop();
+		DispatchLoop(sl_uint32 timerResolution);
 
 		~DispatchLoop();
 	
@@ -47,7 +49,8 @@ namespace slib
 	
 		static void releaseDefault();
 	
-		static Ref<DispatchLoop> create(sl_bool flagAutoStart = sl_true);
+		// `timerResolution`: granularity (in milliseconds) of delayed tasks and timers
+		static Ref<DispatchLoop> create(sl_bool flagAutoStart = sl_true, sl_uint32 timerResolution = 1);
 	
 	public:
 		void release();
@@ -71,32 +74,20 @@ namespace slib
 
 		TimeCounter m_timeCounter;
 
-		LinkedQueue< Function<void()> > m_queueTasks;
+		MpscQueue< Function<void()> > m_queueTasks;
+		// set by the producer which wakes the loop, until the loop takes the tasks
+		sl_int32 m_flagWakingTasks;
 
-		struct TimeTask
-		{
-			sl_uint64 time;
-			Function<void()> task;
-		};
-		CMap<sl_uint64, TimeTask> m_timeTasks;
+		// delayed tasks and timers
+		TimingWheel m_timeTasks;
+		CHashMap<Timer*, sl_uint64> m_mapTimers;
 		Mutex m_lockTimeTasks;
 
-		class TimerTask
-		{
-		public:
-			WeakRef<Timer> timer;
-
-		public:
-			sl_bool operator==(const TimerTask& other) const;
-		};
-		LinkedQueue<TimerTask> m_queueTimers;
-		Mutex m_lockTimer;
-
 	protected:
 		void _wake();
 		sl_int32 _getTimeout();
 		sl_int32 _getTimeout_TimeTasks();
-		sl_int32 _getTimeout_Timer();
+		void _runTimer(const WeakRef<Timer>& timer);
 		void _runLoop();
 
 	};
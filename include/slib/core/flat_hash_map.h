@@ -0,0 +1,239 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#ifndef CHECKHEADER_SLIB_CORE_FLAT_HASH_MAP
+#define CHECKHEADER_SLIB_CORE_FLAT_HASH_MAP
+
+#include "definition.h"
+
+#include "map_common.h"
+#include "hash.h"
+#include "compare.h"
+#include "cpu.h"
+
+/*
+	Open-addressing hash tables (SwissTable layout)
+
+	Nodes are stored inline in one array, and a control byte per slot keeps 7 bits of the hash.
+	Lookup compares 16 control bytes at once (SSE2 on x86, NEON on ARM64), so most probes touch only one cache line of nodes.
+	Pointers to nodes are invalidated by insertion (rehash), unlike HashTable.
+	The tables are not thread-safe.
+
+	`find()`, `remove()` and the other lookup functions accept any key type which can be passed to HASH and KEY_EQUALS,
+	for example `const sl_char8*` against String keys (no temporary String is created).
+*/
+
+namespace slib
+{
+	
+	template <class KT, class VT>
+	class FlatHashMapNode
+	{
+	public:
+		KT key;
+		VT value;
+		
+	public:
+		template <class KEY, class... VALUE_ARGS>
+		FlatHashMapNode(KEY&& _key, VALUE_ARGS&&... value_args) noexcept;
+		
+	};
+	
+	template <class KT>
+	class FlatHashSetNode
+	{
+	public:
+		KT key;
+		
+	public:
+		template <class KEY>
+		FlatHashSetNode(KEY&& _key) noexcept;
+		
+	};
+	
+	template <class NODE>
+	class SLIB_EXPORT FlatHashTablePosition
+	{
+	public:
+		FlatHashTablePosition(const sl_int8* ctrl, const sl_int8* ctrlEnd, NODE* node) noexcept;
+		
+	public:
+		NODE& operator*() const noexcept;
+		
+		sl_bool operator==(const FlatHashTablePosition& other) const noexcept;
+		
+		sl_bool operator!=(const FlatHashTablePosition& other) const noexcept;
+		
+		FlatHashTablePosition& operator++() noexcept;
+		
+	public:
+		const sl_int8* ctrl;
+		const sl_int8* ctrlEnd;
+		NODE* node;
+		
+	};
+	
+	template <class NODE, class KT, class HASH, class KEY_EQUALS>
+	class SLIB_EXPORT FlatHashTable
+	{
+	public:
+		FlatHashTable(sl_size capacity = 0, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+		
+		FlatHashTable(const FlatHashTable& other) = delete;
+		
+		FlatHashTable(FlatHashTable&& other) noexcept;
+		
+		~FlatHashTable() noexcept;
+		
+	public:
+		FlatHashTable& operator=(const FlatHashTable& other) = delete;
+		
+		FlatHashTable& operator=(FlatHashTable&& other) noexcept;
+		
+	public:
+		sl_size getCount() const noexcept;
+		
+		sl_bool isEmpty() const noexcept;
+		
+		sl_bool isNotEmpty() const noexcept;
+		
+		// number of slots
+		sl_size getCapacity() const noexcept;
+		
+		// prepares the slots for `count` nodes without rehashing
+		sl_bool setCapacity(sl_size count) noexcept;
+		
+		template <class KEY>
+		NODE* find(const KEY& key) const noexcept;
+		
+		sl_bool removeAt(const NODE* node) noexcept;
+		
+		sl_size removeAll() noexcept;
+		
+		void shrink() noexcept;
+		
+		sl_bool copyFrom(const FlatHashTable& other) noexcept;
+		
+		// range-based for loop
+		FlatHashTablePosition<NODE> begin() const noexcept;
+		
+		FlatHashTablePosition<NODE> end() const noexcept;
+		
+	protected:
+		template <class KEY, class... ARGS>
+		MapEmplaceReturn<NODE> _emplace(KEY&& key, ARGS&&... args) noexcept;
+		
+		template <class KEY>
+		NODE* _find(const KEY& key, sl_size hash) const noexcept;
+		
+		sl_size _findSlotForInsert(sl_size hash) const noexcept;
+		
+		void _setCtrl(sl_size index, sl_int8 h) noexcept;
+		
+		sl_bool _resize(sl_size capacity) noexcept;
+		
+		void _free() noexcept;
+		
+	protected:
+		sl_int8* m_ctrl;
+		NODE* m_nodes;
+		sl_size m_capacity;
+		sl_size m_count;
+		sl_size m_growthLeft;
+		HASH m_hash;
+		KEY_EQUALS m_equals;
+		
+	};
+	
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT FlatHashMap : public FlatHashTable<FlatHashMapNode<KT, VT>, KT, HASH, KEY_EQUALS>
+	{
+	public:
+		typedef FlatHashMapNode<KT, VT> NODE;
+		typedef FlatHashTable<NODE, KT, HASH, KEY_EQUALS> BASE;
+		
+	public:
+		FlatHashMap(sl_size capacity = 0, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+		
+		FlatHashMap(FlatHashMap&& other) noexcept = default;
+		
+	public:
+		FlatHashMap& operator=(FlatHashMap&& other) noexcept = default;
+		
+	public:
+		template <class KEY>
+		VT* getItemPointer(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		sl_bool get(const KEY& key, VT* outValue = sl_null) const noexcept;
+		
+		template <class KEY>
+		VT getValue(const KEY& key) const noexcept;
+		
+		template <class KEY>
+		VT getValue(const KEY& key, const VT& def) const noexcept;
+		
+		// replaces the value when the key exists
+		template <class KEY, class VALUE>
+		NODE* put(KEY&& key, VALUE&& value, sl_bool* isInsertion = sl_null) noexcept;
+		
+		// does nothing when the key exists
+		template <class KEY, class... VALUE_ARGS>
+		MapEmplaceReturn<NODE> emplace(KEY&& key, VALUE_ARGS&&... value_args) noexcept;
+		
+		template <class KEY>
+		sl_bool remove(const KEY& key, VT* outValue = sl_null) noexcept;
+		
+	};
+	
+	template < class KT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT FlatHashSet : public FlatHashTable<FlatHashSetNode<KT>, KT, HASH, KEY_EQUALS>
+	{
+	public:
+		typedef FlatHashSetNode<KT> NODE;
+		typedef FlatHashTable<NODE, KT, HASH, KEY_EQUALS> BASE;
+		
+	public:
+		FlatHashSet(sl_size capacity = 0, const HASH& hash = HASH(), const KEY_EQUALS& key_equals = KEY_EQUALS()) noexcept;
+		
+		FlatHashSet(FlatHashSet&& other) noexcept = default;
+		
+	public:
+		FlatHashSet& operator=(FlatHashSet&& other) noexcept = default;
+		
+	public:
+		template <class KEY>
+		sl_bool contains(const KEY& key) const noexcept;
+		
+		// returns `sl_false` when the key exists
+		template <class KEY>
+		sl_bool add(KEY&& key) noexcept;
+		
+		template <class KEY>
+		sl_bool remove(const KEY& key) noexcept;
+		
+	};
+	
+}
+
+#include "detail/flat_hash_map.inc"
+
+#endif
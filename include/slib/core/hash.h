@@ -41,14 +41,25 @@ namespace slib
 		return x ^ (x >> 4) ^ (x >> 7) ^ (x >> 12);
 	}
 
+	SLIB_INLINE constexpr sl_uint32 _priv_Rehash32_xorShift(sl_uint32 x) noexcept
+	{
+		return x ^ (x >> 16);
+	}
+	
+	// xorshift-multiply-xorshift: every input bit affects the low bits used as bucket index
 	SLIB_INLINE constexpr sl_uint32 Rehash32(sl_uint32 x) noexcept
 	{
-		return x ^ (x >> 4) ^ (x >> 7) ^ (x >> 12) ^ (x >> 16) ^ (x >> 19) ^ (x >> 20) ^ (x >> 24) ^ (x >> 27);
+		return _priv_Rehash32_xorShift(_priv_Rehash32_xorShift(x) * 0x45d9f3bU);
+	}
+	
+	SLIB_INLINE constexpr sl_uint64 _priv_Rehash64_xorShift(sl_uint64 x) noexcept
+	{
+		return x ^ (x >> 32);
 	}
 	
 	SLIB_INLINE constexpr sl_uint64 Rehash64(sl_uint64 x) noexcept
 	{
-		return x ^ (x >> 4) ^ (x >> 7) ^ (x >> 12) ^ (x >> 16) ^ (x >> 19) ^ (x >> 20) ^ (x >> 24) ^ (x >> 27) ^ (x >> 31) ^ (x >> 36) ^ (x >> 40) ^ (x >> 45) ^ (x >> 49) ^ (x >> 52) ^ (x >> 57) ^ (x >> 60);
+		return _priv_Rehash64_xorShift(_priv_Rehash64_xorShift(x) * SLIB_UINT64(0xd6e8feb86659fd93));
 	}
 	
 	SLIB_INLINE constexpr sl_size Rehash(sl_size x) noexcept
@@ -0,0 +1,150 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_JSON_READER
+#define CHECKHEADER_SLIB_CORE_JSON_READER
+
+#include "definition.h"
+
+#include "object.h"
+#include "string.h"
+#include "list.h"
+#include "memory.h"
+#include "function.h"
+
+namespace slib
+{
+	
+	class JsonReader;
+	class IReader;
+	class AsyncStream;
+	
+	class SLIB_EXPORT JsonReaderParam
+	{
+	public:
+		// in
+		sl_bool flagSupportComments;
+		// in
+		sl_bool flagLogError;
+		
+		// The string arguments point into the input buffer (or into an internal buffer when the token is split between chunks or contains escapes), and are valid only during the callback
+		Function<void(JsonReader*)> onStartObject;
+		Function<void(JsonReader*)> onEndObject;
+		Function<void(JsonReader*)> onStartArray;
+		Function<void(JsonReader*)> onEndArray;
+		Function<void(JsonReader*, const sl_char8* key, sl_size length)> onKey;
+		Function<void(JsonReader*, const sl_char8* str, sl_size length)> onString;
+		// raw text of the number
+		Function<void(JsonReader*, const sl_char8* str, sl_size length)> onNumber;
+		Function<void(JsonReader*, sl_bool value)> onBoolean;
+		Function<void(JsonReader*)> onNull;
+		
+	public:
+		JsonReaderParam();
+		
+		~JsonReaderParam();
+		
+	};
+	
+	/*
+		Event-driven (SAX style) JSON parser.
+		Input can be fed incrementally by `put()`, and no value tree is built.
+	*/
+	class SLIB_EXPORT JsonReader : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	protected:
+		JsonReader();
+		
+		~JsonReader();
+		
+	public:
+		static Ref<JsonReader> create(const JsonReaderParam& param);
+		
+	public:
+		// returns `sl_false` on syntax error or when stopped
+		sl_bool put(const void* data, sl_size size);
+		
+		// finishes the input, returns `sl_true` when a complete JSON value was read
+		sl_bool end();
+		
+		// reads all data from `reader` and finishes the input
+		sl_bool read(IReader* reader, sl_size sizeChunk = 16384);
+		
+		// reads all data from `stream` and finishes the input, `onComplete` is called with the result of `end()`
+		sl_bool read(const Ref<AsyncStream>& stream, const Function<void(JsonReader*, sl_bool flagSuccess)>& onComplete, sl_uint32 sizeChunk = 16384);
+		
+		void reset();
+		
+		// can be called in the callbacks
+		void stop();
+		
+		sl_bool isError();
+		
+		String getErrorMessage();
+		
+		// number of bytes consumed so far
+		sl_uint64 getPosition();
+		
+		// depth of the current container
+		sl_size getDepth();
+		
+	public:
+		static sl_bool parse(const void* data, sl_size size, const JsonReaderParam& param);
+		
+		static sl_bool parse(const String& json, const JsonReaderParam& param);
+		
+	protected:
+		sl_size _parse(const sl_char8* buf, sl_size len, sl_bool flagEnd);
+		
+		sl_bool _parseString(const sl_char8* buf, sl_size len, sl_size& pos, sl_bool flagEnd, sl_bool flagKey);
+		
+		sl_bool _parsePrimitive(const sl_char8* buf, sl_size len, sl_size& pos, sl_bool flagEnd);
+		
+		sl_bool _parseKeyIdentifier(const sl_char8* buf, sl_size len, sl_size& pos, sl_bool flagEnd);
+		
+		void _completeValue();
+		
+		void _setError(const char* message);
+		
+		void _readStream(const Ref<AsyncStream>& stream, const Memory& buf, const Function<void(JsonReader*, sl_bool flagSuccess)>& onComplete);
+		
+	protected:
+		JsonReaderParam m_param;
+		
+		sl_uint8 m_state;
+		List<sl_bool> m_stack;
+		
+		Memory m_bufPending;
+		sl_size m_sizePending;
+		sl_uint64 m_position;
+		
+		sl_bool m_flagError;
+		sl_bool m_flagStopped;
+		String m_errorMessage;
+		
+	};
+	
+}
+
+#endif
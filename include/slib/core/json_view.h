@@ -0,0 +1,155 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_JSON_VIEW
+#define CHECKHEADER_SLIB_CORE_JSON_VIEW
+
+#include "definition.h"
+
+#include "json.h"
+#include "memory.h"
+
+namespace slib
+{
+	
+	enum class JsonValueType
+	{
+		Invalid = 0,
+		Null = 1,
+		Boolean = 2,
+		Number = 3,
+		String = 4,
+		Array = 5,
+		Object = 6
+	};
+	
+	/*
+		Read-only view over a JSON text.
+		Nothing is parsed in advance: items and elements are located by scanning the text on each lookup, and strings are returned as slices of the input.
+		The input buffer must be kept alive while the view is used, unless the view is created from `Memory`.
+	*/
+	class SLIB_EXPORT JsonView
+	{
+	public:
+		JsonView();
+		
+		JsonView(const sl_char8* data, sl_size size);
+		
+		JsonView(const sl_char8* data, sl_size size, Referable* ref);
+		
+		JsonView(const Memory& mem);
+		
+		JsonView(const JsonView& other);
+		
+		JsonView(JsonView&& other);
+		
+		~JsonView();
+		
+	public:
+		JsonView& operator=(const JsonView& other);
+		
+		JsonView& operator=(JsonView&& other);
+		
+		JsonView operator[](sl_size index) const;
+		
+		JsonView operator[](const String& key) const;
+		
+		JsonView operator[](const sl_char8* key) const;
+		
+	public:
+		JsonValueType getType() const;
+		
+		sl_bool isValid() const;
+		
+		sl_bool isNull() const;
+		
+		sl_bool isNotNull() const;
+		
+		sl_bool isBoolean() const;
+		
+		sl_bool isNumber() const;
+		
+		sl_bool isString() const;
+		
+		sl_bool isArray() const;
+		
+		sl_bool isObject() const;
+		
+		// number of array elements or object items
+		sl_size getElementsCount() const;
+		
+		JsonView getElement(sl_size index) const;
+		
+		List<JsonView> getElements() const;
+		
+		JsonView getItem(const sl_char8* key, sl_size lenKey) const;
+		
+		JsonView getItem(const sl_char8* key) const;
+		
+		JsonView getItem(const String& key) const;
+		
+		// pairs of key (string view) and value
+		List< Pair<JsonView, JsonView> > getItems() const;
+		
+		// text of the value
+		const sl_char8* getRawData() const;
+		
+		sl_size getRawLength() const;
+		
+		String getRawString() const;
+		
+		// characters between the quotes, `flagEscaped` is set when the slice contains escape sequences
+		sl_bool getStringSlice(const sl_char8** data, sl_size* length, sl_bool* flagEscaped = sl_null) const;
+		
+		sl_bool equalsString(const sl_char8* str, sl_size length) const;
+		
+		String getString(const String& def) const;
+		
+		String getString() const;
+		
+		sl_int32 getInt32(sl_int32 def = 0) const;
+		
+		sl_uint32 getUint32(sl_uint32 def = 0) const;
+		
+		sl_int64 getInt64(sl_int64 def = 0) const;
+		
+		sl_uint64 getUint64(sl_uint64 def = 0) const;
+		
+		float getFloat(float def = 0) const;
+		
+		double getDouble(double def = 0) const;
+		
+		sl_bool getBoolean(sl_bool def = sl_false) const;
+		
+		// parses the value into `Json`
+		Json toJson() const;
+		
+	protected:
+		const sl_char8* m_data;
+		const sl_char8* m_end;
+		Ref<Referable> m_ref;
+		
+	};
+	
+}
+
+#endif
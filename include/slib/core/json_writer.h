@@ -0,0 +1,165 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#ifndef CHECKHEADER_SLIB_CORE_JSON_WRITER
+#define CHECKHEADER_SLIB_CORE_JSON_WRITER
+
+#include "definition.h"
+
+#include "json.h"
+#include "memory.h"
+#include "function.h"
+
+namespace slib
+{
+	
+	class IWriter;
+	
+	/*
+		Serializes JSON values incrementally into a chunk buffer.
+		Every filled chunk is passed to the output (IWriter, MemoryBuffer or callback), so the whole document is never materialized as a single string.
+		The output is compatible with `Variant::toJsonString()`.
+	*/
+	class SLIB_EXPORT JsonWriter
+	{
+	public:
+		JsonWriter(IWriter* writer, sl_size sizeChunk = 16384);
+		
+		JsonWriter(MemoryBuffer* buffer, sl_size sizeChunk = 16384);
+		
+		// `onChunk` receives the ownership of each chunk; returning `sl_false` aborts writing
+		JsonWriter(const Function<sl_bool(const Memory& chunk)>& onChunk, sl_size sizeChunk = 16384);
+		
+		// flushes remaining data
+		~JsonWriter();
+		
+	public:
+		sl_bool beginObject();
+		
+		sl_bool endObject();
+		
+		sl_bool beginArray();
+		
+		sl_bool endArray();
+		
+		sl_bool writeKey(const sl_char8* key, sl_size length);
+		
+		sl_bool writeKey(const String& key);
+		
+		sl_bool writeNull();
+		
+		sl_bool writeBoolean(sl_bool value);
+		
+		sl_bool writeInt32(sl_int32 value);
+		
+		sl_bool writeUint32(sl_uint32 value);
+		
+		sl_bool writeInt64(sl_int64 value);
+		
+		sl_bool writeUint64(sl_uint64 value);
+		
+		sl_bool writeFloat(float value);
+		
+		sl_bool writeDouble(double value);
+		
+		sl_bool writeString(const sl_char8* str, sl_size length);
+		
+		sl_bool writeString(const String& str);
+		
+		sl_bool writeString(const String16& str);
+		
+		sl_bool writeTime(const Time& time);
+		
+		// writes already serialized JSON text as a value
+		sl_bool writeRaw(const void* data, sl_size size);
+		
+		sl_bool write(const Variant& value);
+		
+		sl_bool write(const Json& value);
+		
+		// List, Map, HashMap and the types supporting `toJson()`
+		template <class T>
+		sl_bool write(const T& value)
+		{
+			return write(Json(value));
+		}
+		
+		sl_bool flush();
+		
+		sl_bool isError();
+		
+		// total size of the written JSON text
+		sl_uint64 getWrittenSize();
+		
+	public:
+		static sl_bool write(IWriter* writer, const Json& value);
+		
+		static Memory toMemory(const Json& value);
+		
+	protected:
+		void _init(sl_size sizeChunk);
+		
+		sl_bool _beginValue();
+		
+		sl_bool _append(const void* data, sl_size size);
+		
+		sl_bool _appendChar(sl_char8 c);
+		
+		sl_bool _appendEscapedString(const sl_char8* str, sl_size length);
+		
+		sl_bool _writeVariant(const Variant& value);
+		
+		sl_bool _writeList(const List<Variant>& list);
+		
+		sl_bool _writeMap(const Map<String, Variant>& map);
+		
+		sl_bool _writeHashMap(const HashMap<String, Variant>& map);
+		
+		sl_bool _writeMapList(const List< Map<String, Variant> >& list);
+		
+		sl_bool _writeHashMapList(const List< HashMap<String, Variant> >& list);
+		
+		sl_bool _flushChunk();
+		
+	private:
+		IWriter* m_writer;
+		MemoryBuffer* m_buffer;
+		Function<sl_bool(const Memory&)> m_onChunk;
+		
+		Memory m_chunk;
+		sl_char8* m_data;
+		sl_size m_sizeChunk;
+		sl_size m_pos;
+		sl_uint64 m_sizeWritten;
+		
+		sl_bool m_flagNeedComma;
+		sl_bool m_flagError;
+		
+	private:
+		JsonWriter(const JsonWriter&) = delete;
+		
+		JsonWriter& operator=(const JsonWriter&) = delete;
+		
+	};
+	
+}
+
+#endif
@@ -34,6 +34,7 @@ namespace slib
 {
 
 	class LoggerSet;
+	class FileLoggerParam;
 	
 	class SLIB_EXPORT Logger : public Object
 	{
@@ -55,6 +56,8 @@ namespace slib
 		static Ref<Logger> getConsoleLogger();
 
 		static Ref<Logger> createFileLogger(const String& fileNameFormat);
+		
+		static Ref<Logger> createFileLogger(const FileLoggerParam& param);
 
 		static void logGlobal(const String& tag, const String& content);
 
@@ -62,12 +65,44 @@ namespace slib
 	
 	};
 	
+	class SLIB_EXPORT FileLoggerParam
+	{
+	public:
+		// formatted with the current time before each batch is written, so a date in the format rotates the file by time
+		String fileNameFormat;
+		
+		// 0: unlimited. Full files are renamed to "<name>.1", "<name>.2", ...
+		sl_uint64 maximumFileSize;
+		sl_uint32 maximumBackupsCount;
+		
+		// lines waiting for the writer thread (rounded up to a power of 2)
+		sl_uint32 queueSize;
+		
+		// drops lines while the queue is full, instead of blocking the caller
+		sl_bool flagDropOnOverload;
+		
+	public:
+		FileLoggerParam();
+		
+		FileLoggerParam(const String& fileNameFormat);
+		
+		~FileLoggerParam();
+		
+	};
+	
+	/*
+		Lines are formatted by the caller and pushed into a lock-free ring buffer.
+		One writer thread keeps the file open and writes the queued lines in batches.
+		`getFileName()` is called by the logging threads (at most once per second), never by the writer thread.
+	*/
 	class SLIB_EXPORT FileLogger : public Logger
 	{
 	public:
 		FileLogger();
 
 		FileLogger(const String& fileNameFormat);
+		
+		FileLogger(const FileLoggerParam& param);
 
 		~FileLogger();
 	
@@ -76,9 +111,20 @@ namespace slib
 	
 		virtual String getFileName();
 		
+		// waits until the lines logged before are written
+		void flush();
+		
+		sl_uint64 getDroppedLinesCount();
+		
+	private:
+		void _init(const FileLoggerParam& param);
+		
 	protected:
 		String m_fileNameFormat;
 		
+	private:
+		Ref<Referable> m_writer;
+		
 	};
 	
 	class SLIB_EXPORT LoggerSet : public Logger
@@ -114,8 +160,9 @@ namespace slib
 		void logError(const String& tag, const String& content) override;
 
 	protected:
-		CList< Ref<Logger> > m_listLoggers;
-		CList< Ref<Logger> > m_listErrorLoggers;
+		// replaced on change, so logging never waits for a lock
+		AtomicList< Ref<Logger> > m_listLoggers;
+		AtomicList< Ref<Logger> > m_listErrorLoggers;
 	
 	};
 
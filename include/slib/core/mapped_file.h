@@ -0,0 +1,129 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MAPPED_FILE
+#define CHECKHEADER_SLIB_CORE_MAPPED_FILE
+
+#include "definition.h"
+
+#include "file.h"
+#include "memory.h"
+
+namespace slib
+{
+	
+	enum class MappedFileHint
+	{
+		Normal = 0,
+		Sequential = 1,
+		Random = 2,
+		WillNeed = 3,
+		DontNeed = 4
+	};
+	
+	class SLIB_EXPORT MappedFileParam
+	{
+	public:
+		String path;
+		
+		// `file` is used instead of `path` if not null
+		Ref<File> file;
+		
+		sl_bool flagWritable;
+		
+		// region to be mapped. `size == 0` maps until the end of the file
+		sl_uint64 offset;
+		sl_size size;
+		
+		MappedFileHint hint;
+		
+	public:
+		MappedFileParam();
+		
+		~MappedFileParam();
+		
+	};
+	
+	// Memory mapped region of a file. The region stays mapped until the object is freed.
+	// Reading pages beyond the end of a file truncated while mapped raises SIGBUS (an exception on Windows),
+	// so map only files which are not modified by others while in use
+	class SLIB_EXPORT MappedFile : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	private:
+		MappedFile();
+		
+		~MappedFile();
+		
+	public:
+		static Ref<MappedFile> open(const MappedFileParam& param);
+		
+		static Ref<MappedFile> openForRead(const String& path, MappedFileHint hint = MappedFileHint::Normal);
+		
+		static Ref<MappedFile> openForReadWrite(const String& path);
+		
+		// returns a `Memory` referring the mapped region, without copying. Returns null on failure or empty file
+		static Memory mapAllBytes(const String& path, MappedFileHint hint = MappedFileHint::Sequential);
+		
+	public:
+		void* getData() const;
+		
+		sl_size getSize() const;
+		
+		sl_uint64 getOffset() const;
+		
+		sl_bool isWritable() const;
+		
+		// the returned memory keeps this object alive
+		Memory getMemory();
+		
+		sl_bool advise(MappedFileHint hint);
+		
+		sl_bool advise(sl_size offset, sl_size size, MappedFileHint hint);
+		
+		sl_bool flush(sl_bool flagSync = sl_true);
+		
+	private:
+		sl_bool _map(sl_file file, sl_uint64 offset, sl_size size, sl_bool flagWritable);
+		
+		void _unmap();
+		
+	private:
+		Ref<File> m_file;
+		sl_uint8* m_data;
+		sl_size m_size;
+		sl_uint64 m_offset;
+		sl_bool m_flagWritable;
+		
+		// start of the page-aligned mapping
+		void* m_base;
+		sl_size m_sizeBase;
+#if defined(SLIB_PLATFORM_IS_WIN32)
+		void* m_handleMapping;
+#endif
+		
+	};
+
+}
+
+#endif
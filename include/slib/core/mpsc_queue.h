@@ -0,0 +1,148 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MPSC_QUEUE
+#define CHECKHEADER_SLIB_CORE_MPSC_QUEUE
+
+#include "definition.h"
+
+#include "spin_lock.h"
+#include "cpp.h"
+
+#include <new>
+
+/*
+	Multi-producer single-consumer queue (Vyukov's intrusive MPSC queue): linking is lock-free, the node free list is guarded by a spin lock
+
+	`push()` may be called by any thread, and links the node with one atomic exchange.
+	`pop()`, `isEmpty()` and `removeAll()` must be called by one consumer thread at a time.
+	The queue is unbounded: `push()` fails only when a node can not be allocated.
+	Popped nodes are recycled through a small free list (up to 1024 nodes, guarded by a spin lock held for a few instructions),
+	so the steady state does not allocate, and the nodes of a burst above that are freed after they are drained.
+	A popped element may be missed while its producer is between the two steps of `push()`;
+	the producer's wakeup (after `push()` returns) covers that case.
+*/
+
+namespace slib
+{
+	
+	class SLIB_EXPORT MpscQueueBase
+	{
+	public:
+		MpscQueueBase(sl_size sizeElement) noexcept;
+		
+		~MpscQueueBase() noexcept;
+		
+	public:
+		MpscQueueBase(const MpscQueueBase& other) = delete;
+		
+		MpscQueueBase& operator=(const MpscQueueBase& other) = delete;
+		
+	public:
+		// consumer only
+		sl_bool isEmpty() const noexcept;
+		
+		// consumer only
+		sl_bool isNotEmpty() const noexcept;
+		
+	protected:
+		// returns `sl_null` when out of memory
+		void* _allocNode() noexcept;
+		
+		void _freeNode(void* node) noexcept;
+		
+		static void* _getElement(void* node) noexcept;
+		
+		void _pushNode(void* node) noexcept;
+		
+		// returns `sl_null` when the queue is empty
+		void* _popNode() noexcept;
+		
+	private:
+		sl_size m_sizeNode;
+		
+		// last pushed node (producers)
+		void* m_head;
+		sl_uint8 m_padding[56];
+		// oldest node (consumer)
+		void* m_tail;
+		// `next` field of the stub node
+		void* m_stub;
+		
+		SpinLock m_lockFree;
+		void* m_free;
+		sl_uint32 m_nFree;
+		
+	};
+	
+	template <class T>
+	class SLIB_EXPORT MpscQueue : public MpscQueueBase
+	{
+	public:
+		MpscQueue() noexcept: MpscQueueBase(sizeof(T)) {}
+		
+		~MpscQueue() noexcept
+		{
+			removeAll();
+		}
+		
+	public:
+		template <class... ARGS>
+		sl_bool push(ARGS&&... args) noexcept
+		{
+			void* node = _allocNode();
+			if (!node) {
+				return sl_false;
+			}
+			new (_getElement(node)) T(Forward<ARGS>(args)...);
+			_pushNode(node);
+			return sl_true;
+		}
+		
+		// consumer only
+		sl_bool pop(T* _out = sl_null) noexcept
+		{
+			void* node = _popNode();
+			if (!node) {
+				return sl_false;
+			}
+			T* p = (T*)(_getElement(node));
+			if (_out) {
+				*_out = Move(*p);
+			}
+			p->~T();
+			_freeNode(node);
+			return sl_true;
+		}
+		
+		// consumer only
+		void removeAll() noexcept
+		{
+			while (pop()) {
+			}
+		}
+		
+	};
+	
+}
+
+#endif
@@ -94,6 +94,8 @@ namespace slib
 
 	protected:
 		Ref<Pipe> m_pipe;
+		// on Linux, a single eventfd serves as both ends (m_pipe is null)
+		sl_pipe m_hEvent;
 		sl_bool m_flagSet;
 		SpinLock m_lock;
 
@@ -27,6 +27,16 @@
 
 #include "object.h"
 #include "string.h"
+#include "list.h"
+
+/*
+	ECMAScript patterns are compiled into a native program over UTF-8 code points:
+	a DFA built by subset construction runs in linear time, and an NFA simulation takes over
+	when the DFA would be too large or the pattern uses word boundaries.
+	`Icase` folds ASCII letters only.
+	Back-references, look-around, the other grammars and `Collate` fall back to std::regex.
+	Compiled programs are cached by pattern and flags, and are immutable, so they are shared across threads.
+*/
 
 namespace slib
 {
@@ -89,16 +99,53 @@ namespace slib
 		static Ref<CRegEx> create(const String& pattern, const RegExFlags& flags) noexcept;
 
 	public:
+		// whole string
 		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
 		
+		// any substring (`Continuous`: a prefix)
+		sl_bool search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
 	private:
 		static Ref<CRegEx> _create(const String& pattern, int flags) noexcept;
 		
 	private:
+		Ref<Referable> m_program;
 		void* m_obj;
 		
 	};
 	
+	// Matches a string against many patterns in one pass
+	class SLIB_EXPORT RegExSet : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	protected:
+		RegExSet() noexcept;
+		
+		~RegExSet() noexcept;
+		
+	public:
+		// returns null when a pattern is invalid or is not supported by the native engine
+		static Ref<RegExSet> create(const List<String>& patterns, const RegExFlags& flags = RegExFlags::Default) noexcept;
+		
+	public:
+		sl_uint32 getPatternsCount() noexcept;
+		
+		// indices of the patterns matching the whole string, in ascending order
+		List<sl_uint32> match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		// indices of the patterns matching any substring, in ascending order
+		List<sl_uint32> search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool matchAny(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool searchAny(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+	private:
+		Ref<Referable> m_program;
+		
+	};
+	
 	class RegEx;
 	
 	template <>
@@ -113,6 +160,8 @@ namespace slib
 		
 	public:
 		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
+		sl_bool search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
 
 	private:
 		AtomicRef<CRegEx> ref;
@@ -134,6 +183,8 @@ namespace slib
 	public:
 		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
 		
+		sl_bool search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+		
 	public:
 		static sl_bool matchEmail(const String& str) noexcept;
 
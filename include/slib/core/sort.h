@@ -27,6 +27,7 @@
 
 #include "cpp.h"
 #include "compare.h"
+#include "base.h"
 
 namespace slib
 {
@@ -69,6 +70,75 @@ namespace slib
 		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
 
 	};
+	
+	/*
+		Pattern-defeating quicksort (Orson Peters, https://github.com/orlp/pdqsort)
+	 
+		O(n log n) in the worst case (falls back to heap sort), linear on sorted, reversed and all-equal input.
+		Not stable.
+	*/
+	class SLIB_EXPORT PdqSort
+	{
+	public:
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortAsc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+		
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+		
+	};
+	
+	/*
+		LSD radix sort (8 bits per pass, passes are skipped when all keys share the digit)
+	 
+		TYPE (or the key returned by `getKey(const TYPE&)`) must be an integral or floating-point type.
+		Stable. Items sorted by key are permuted by move assignment, so TYPE can be any movable type.
+	*/
+	class SLIB_EXPORT RadixSort
+	{
+	public:
+		template <class TYPE>
+		static void sortAsc(TYPE* list, sl_size size) noexcept;
+		
+		template <class TYPE>
+		static void sortDesc(TYPE* list, sl_size size) noexcept;
+		
+		template <class TYPE, class GET_KEY>
+		static void sortAscByKey(TYPE* list, sl_size size, const GET_KEY& getKey) noexcept;
+		
+		template <class TYPE, class GET_KEY>
+		static void sortDescByKey(TYPE* list, sl_size size, const GET_KEY& getKey) noexcept;
+		
+	};
+	
+	class ThreadPool;
+	
+	/*
+		Sorts the chunks with PdqSort on the thread pool, and merges them in parallel (merge path partitioning).
+		The calling thread also runs the tasks. When `pool` is null, a shared work-stealing pool is used.
+		Needs a temporary buffer of `size` items. Not stable.
+	*/
+	class SLIB_EXPORT ParallelSort
+	{
+	public:
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortAsc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE(), ThreadPool* pool = sl_null) noexcept;
+		
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE(), ThreadPool* pool = sl_null) noexcept;
+		
+	};
+	
+	class SLIB_EXPORT _priv_ParallelSort
+	{
+	public:
+		// number of chunks: power of two, not greater than the number of processors
+		static sl_uint32 getChunksCount(sl_size size) noexcept;
+		
+		// runs `task(context, 0 ~ nTasks-1)` and returns when all are finished
+		static void run(ThreadPool* pool, sl_uint32 nTasks, void (*task)(void* context, sl_uint32 index), void* context) noexcept;
+		
+	};
 
 }
 
@@ -2033,6 +2033,8 @@ namespace slib
 	{
 	public:
 		sl_bool operator()(const String& a, const String& b) const noexcept;
+		
+		sl_bool operator()(const String& a, const sl_char8* b) const noexcept;
 	};
 	
 	template <>
@@ -2047,6 +2049,9 @@ namespace slib
 	{
 	public:
 		sl_size operator()(const String& a) const noexcept;
+		
+		// same as `String::getHashCode()`, without creating a String
+		sl_size operator()(const sl_char8* a) const noexcept;
 	};
 	
 	template <>
@@ -86,6 +86,11 @@ namespace slib
 		 */
 		Memory mergeToMemory() const noexcept;
 		
+		/**
+		 * Returns the first item, to walk through the items without merging them.
+		 */
+		Link<StringData>* getFirstItem() const noexcept;
+		
 	private:
 		LinkedQueue<StringData> m_queue;
 		sl_size m_len;
@@ -154,6 +159,11 @@ namespace slib
 		 */
 		Memory mergeToMemory() const noexcept;
 		
+		/**
+		 * Returns the first item, to walk through the items without merging them.
+		 */
+		Link<StringData>* getFirstItem() const noexcept;
+		
 	private:
 		LinkedQueue<StringData> m_queue;
 		sl_size m_len;
@@ -112,6 +112,9 @@ namespace slib
 		static sl_bool isNotStoppingCurrent();
 
 		static sl_uint64 getCurrentThreadUniqueId();
+		
+		// binds the calling thread to the processor
+		static sl_bool setCurrentThreadAffinity(sl_uint32 processorIndex);
 	
 
 		// attached objects are removed when the thread is exited
@@ -28,10 +28,13 @@
 #include "queue.h"
 #include "thread.h"
 #include "dispatch.h"
+#include "array.h"
 
 namespace slib
 {
 	
+	class _priv_ThreadPoolWorker;
+	
 	class SLIB_EXPORT ThreadPool : public Dispatcher
 	{
 		SLIB_DECLARE_OBJECT
@@ -43,11 +46,16 @@ namespace slib
 
 	public:
 		static Ref<ThreadPool> create(sl_uint32 minThreads = 0, sl_uint32 maxThreads = 30);
+		
+		// fixed workers with per-worker task deques; idle workers steal from the others. 0 means the number of processors
+		static Ref<ThreadPool> createWorkStealing(sl_uint32 nWorkers = 0);
 	
 	public:
 		void release();
 
 		sl_bool isRunning();
+		
+		sl_bool isWorkStealing();
 
 		sl_uint32 getThreadsCount();
 	
@@ -62,6 +70,15 @@ namespace slib
 	
 	protected:
 		void onRunWorker();
+		
+		void onRunStealingWorker(sl_uint32 index);
+		
+	private:
+		sl_bool _addStealingTask(const Function<void()>& task);
+		
+		sl_bool _popStealingTask(sl_uint32 index, Function<void()>& task);
+		
+		void _wakeStealingWorker(sl_uint32 index);
 	
 	protected:
 		CList< Ref<Thread> > m_threadWorkers;
@@ -69,6 +86,12 @@ namespace slib
 		LinkedQueue< Function<void()> > m_tasks;
 
 		sl_bool m_flagRunning;
+		
+		sl_bool m_flagWorkStealing;
+		Array< Ref<_priv_ThreadPoolWorker> > m_stealingWorkers;
+		sl_uint32 m_nStealingWorkers;
+		sl_int32 m_nSleepingStealingWorkers;
+		sl_int32 m_indexNextStealingWorker;
 
 	};
 
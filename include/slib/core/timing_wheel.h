@@ -0,0 +1,120 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_TIMING_WHEEL
+#define CHECKHEADER_SLIB_CORE_TIMING_WHEEL
+
+#include "definition.h"
+
+#include "function.h"
+#include "list.h"
+
+/*
+	Hierarchical timing wheel (Varghese & Lauck)
+
+	Five levels of slots (256 + 4 x 64) cover 2^32 ticks, and later tasks are cascaded again.
+	Adding and cancelling are O(1). Advancing costs O(1) per elapsed tick, and runs of empty ticks are skipped.
+	Tasks never become due before their time, and at most one tick after it.
+	The wheel is not thread-safe.
+*/
+
+namespace slib
+{
+	
+	class _priv_TimingWheelNode;
+	
+	class SLIB_EXPORT TimingWheel
+	{
+	public:
+		// `tickMilliseconds`: resolution of the wheel (1 for fine timers, larger values for coarse timeouts)
+		TimingWheel(sl_uint32 tickMilliseconds = 1) noexcept;
+		
+		TimingWheel(const TimingWheel& other) = delete;
+		
+		~TimingWheel() noexcept;
+		
+	public:
+		TimingWheel& operator=(const TimingWheel& other) = delete;
+		
+	public:
+		sl_uint32 getTickMilliseconds() const noexcept;
+		
+		sl_size getCount() const noexcept;
+		
+		sl_bool isEmpty() const noexcept;
+		
+		sl_bool isNotEmpty() const noexcept;
+		
+		// `time`: milliseconds on the caller's clock. Returns the id of the task (never 0), or 0 on failure
+		sl_uint64 add(sl_uint64 time, const Function<void()>& task) noexcept;
+		
+		// O(1). Returns false if the task was already run or cancelled
+		sl_bool cancel(sl_uint64 id) noexcept;
+		
+		// returns true while the task is waiting in the wheel
+		sl_bool contains(sl_uint64 id) const noexcept;
+		
+		void removeAll() noexcept;
+		
+		// moves the tasks which are due at `now` into `output`, in order of ticks
+		void advance(sl_uint64 now, List< Function<void()> >& output) noexcept;
+		
+		// milliseconds to wait before the next `advance()` (0 if a task is due), or -1 if the wheel is empty
+		sl_int64 getTimeout(sl_uint64 now) const noexcept;
+		
+	private:
+		_priv_TimingWheelNode* _getNode(sl_uint32 index) const noexcept;
+		
+		sl_uint32 _allocNode() noexcept;
+		
+		void _freeNode(sl_uint32 index, _priv_TimingWheelNode* node) noexcept;
+		
+		void _link(sl_uint32 index, _priv_TimingWheelNode* node, sl_uint32 slot) noexcept;
+		
+		void _unlink(sl_uint32 index, _priv_TimingWheelNode* node) noexcept;
+		
+		void _cascade() noexcept;
+		
+		sl_uint32 _detachSlot(sl_uint32 slot) noexcept;
+		
+		void _moveSlot(sl_uint32 slot, List< Function<void()> >& output) noexcept;
+		
+		sl_uint64 _getNextTick() const noexcept;
+		
+	private:
+		sl_uint32 m_tick;
+		// next tick to be processed
+		sl_uint64 m_current;
+		sl_size m_count;
+		
+		_priv_TimingWheelNode** m_pages;
+		sl_uint32 m_nPages;
+		sl_uint32 m_indexFree;
+		
+		sl_uint32 m_heads[513];
+		sl_uint64 m_bitmap[8];
+		
+	};
+	
+}
+
+#endif
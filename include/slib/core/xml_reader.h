@@ -0,0 +1,213 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#ifndef CHECKHEADER_SLIB_CORE_XML_READER
+#define CHECKHEADER_SLIB_CORE_XML_READER
+
+#include "definition.h"
+
+#include "object.h"
+#include "string.h"
+#include "list.h"
+#include "memory.h"
+#include "function.h"
+#include "ptr.h"
+
+namespace slib
+{
+	
+	class IReader;
+	class AsyncStream;
+	
+	enum class XmlReaderEvent
+	{
+		// more input is required (only when the input is fed by `put()`)
+		None = 0,
+		StartElement = 1,
+		EndElement = 2,
+		Text = 3,
+		CDATA = 4,
+		ProcessingInstruction = 5,
+		Comment = 6,
+		EndDocument = 7,
+		Error = 8
+	};
+	
+	// slices into the reader's buffer, valid until the next call of `next()` or `put()`
+	class SLIB_EXPORT XmlReaderAttribute
+	{
+	public:
+		const sl_char8* name;
+		sl_size nameLength;
+		// raw value, entities are not decoded
+		const sl_char8* value;
+		sl_size valueLength;
+		
+	public:
+		String getName() const;
+		
+		// decodes the entities
+		String getValue() const;
+		
+		sl_bool equalsName(const sl_char8* name, sl_size length) const;
+		
+		sl_bool equalsName(const String& name) const;
+		
+	};
+	
+	/*
+		Pull-style XML parser.
+		The input is read in chunks from an IReader, or fed by `put()`, and only the unconsumed part of the current token is kept in the buffer.
+		No XmlNode is created. The names, attributes and texts are slices into the buffer.
+		Namespaces are not processed (qualified names are reported as they are), and DTD is not supported.
+		Long text contents are reported in several Text events to keep the buffer bounded.
+		Well-formedness is checked as `Xml::parseXml`: single root element, no text outside of the root, and valid entities.
+	*/
+	class SLIB_EXPORT XmlReader : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	protected:
+		XmlReader();
+		
+		~XmlReader();
+		
+	public:
+		// the input should be fed by `put()` and `end()`
+		static Ref<XmlReader> create(sl_size sizeChunk = 16384);
+		
+		// the input is read from `reader` on demand
+		static Ref<XmlReader> create(const Ptr<IReader>& reader, sl_size sizeChunk = 16384);
+		
+	public:
+		sl_bool put(const void* data, sl_size size);
+		
+		// finishes the input
+		void end();
+		
+		// returns `XmlReaderEvent::None` when the fed data is consumed
+		XmlReaderEvent next();
+		
+		// reads all data from `stream`, `onEvent` is called for every event and `onComplete` is called after EndDocument or an error
+		sl_bool read(const Ref<AsyncStream>& stream, const Function<void(XmlReader*, XmlReaderEvent)>& onEvent, const Function<void(XmlReader*, sl_bool flagSuccess)>& onComplete, sl_uint32 sizeChunk = 16384);
+		
+		XmlReaderEvent getEvent();
+		
+		// element name (StartElement, EndElement) or target (ProcessingInstruction)
+		const sl_char8* getName(sl_size* outLength);
+		
+		String getName();
+		
+		sl_bool equalsName(const sl_char8* name, sl_size length);
+		
+		sl_bool equalsName(const String& name);
+		
+		// StartElement
+		sl_size getAttributesCount();
+		
+		// StartElement
+		const XmlReaderAttribute* getAttributes();
+		
+		// StartElement, returns decoded value
+		String getAttribute(const String& name);
+		
+		// StartElement: `<tag/>`, EndElement event follows
+		sl_bool isEmptyElement();
+		
+		// Text (entities are not decoded), CDATA, Comment, ProcessingInstruction (content)
+		const sl_char8* getText(sl_size* outLength);
+		
+		// decodes the entities for Text
+		String getText();
+		
+		// depth of the current element
+		sl_size getDepth();
+		
+		// number of bytes consumed so far
+		sl_uint64 getPosition();
+		
+		sl_bool isError();
+		
+		String getErrorMessage();
+		
+		// whitespace-only texts are skipped by default
+		sl_bool isIgnoringWhiteSpaces();
+		
+		void setIgnoringWhiteSpaces(sl_bool flag);
+		
+	protected:
+		sl_size _parse(const sl_char8* buf, sl_size len, sl_bool flagEnd);
+		
+		sl_size _parseText(const sl_char8* buf, sl_size len, sl_bool flagEnd);
+		
+		sl_size _parseStartTag(const sl_char8* buf, sl_size len, sl_bool flagEnd);
+		
+		sl_size _parseEndTag(const sl_char8* buf, sl_size len, sl_bool flagEnd);
+		
+		sl_bool _prepareBuffer(sl_size sizeRequired);
+		
+		sl_bool _fill();
+		
+		sl_bool _pushName(const sl_char8* name, sl_size len);
+		
+		void _popName();
+		
+		void _setError(const char* message);
+		
+		void _readStream(const Ref<AsyncStream>& stream, const Memory& buf, const Function<void(XmlReader*, XmlReaderEvent)>& onEvent, const Function<void(XmlReader*, sl_bool flagSuccess)>& onComplete);
+		
+		sl_bool _dispatchEvents(const Function<void(XmlReader*, XmlReaderEvent)>& onEvent, const Function<void(XmlReader*, sl_bool flagSuccess)>& onComplete);
+		
+	protected:
+		Ptr<IReader> m_reader;
+		sl_size m_sizeChunk;
+		
+		Memory m_buf;
+		sl_char8* m_data;
+		sl_size m_start;
+		sl_size m_end;
+		sl_uint64 m_position;
+		sl_bool m_flagEnded;
+		
+		XmlReaderEvent m_event;
+		const sl_char8* m_name;
+		sl_size m_lenName;
+		const sl_char8* m_text;
+		sl_size m_lenText;
+		List<XmlReaderAttribute> m_attributes;
+		sl_size m_nAttributes;
+		sl_bool m_flagEmptyElement;
+		sl_bool m_flagPendingEnd;
+		
+		// names of the open elements
+		Memory m_bufStack;
+		sl_size m_sizeStack;
+		List<sl_size> m_stack;
+		sl_bool m_flagFoundRoot;
+		
+		sl_bool m_flagIgnoreWhiteSpaces;
+		String m_errorMessage;
+		
+	};
+	
+}
+
+#endif
@@ -99,6 +99,11 @@ namespace slib
 		sl_uint32 m_roundKeyEnc[64];
 		sl_uint32 m_roundKeyDec[64];
 		sl_uint32 m_nCountRounds;
+		
+		// round keys in byte order, used by AES-NI
+		sl_bool m_flagAESNI;
+		sl_uint8 m_roundKeyEncNI[240];
+		sl_uint8 m_roundKeyDecNI[240];
 
 	};
 	
@@ -46,7 +46,12 @@ namespace slib
 	{
 	public:
 		Uint128 M[16]; // Shoup's, 4-bit table
+		sl_uint8 H_CLMUL[16]; // byte-reversed H, used by carry-less multiplication (PCLMULQDQ)
+		sl_bool flagCLMUL;
 	
+	public:
+		GCM_Table();
+
 	public:
 		void generateTable(const void* H /* 16 bytes */);
 
@@ -71,8 +71,12 @@ namespace slib
 
 		sl_uint32 getSize() const final;
 
+	public:
+		// hashes independent messages in parallel SIMD lanes when possible; `outputs` receives `n * HashSize` bytes
+		static void hashMany(const void* const* inputs, const sl_size* sizes, sl_size n, void* outputs);
+
 	private:
-		void _updateSection(const sl_uint8* input);
+		void _updateSections(const sl_uint8* input, sl_size nSections);
 	
 	private:
 		sl_size sizeTotalInput;
@@ -55,7 +55,7 @@ namespace slib
 
 		void _finish();
 
-		void _updateSection(const sl_uint8* input);
+		void _updateSections(const sl_uint8* input, sl_size nSections);
 	
 	protected:
 		sl_size sizeTotalInput;
@@ -97,6 +97,10 @@ namespace slib
 
 		sl_uint32 getSize() const final;
 
+	public:
+		// hashes independent messages in parallel SIMD lanes when possible; `outputs` receives `n * HashSize` bytes
+		static void hashMany(const void* const* inputs, const sl_size* sizes, sl_size n, void* outputs);
+
 	};
 	
 	class SLIB_EXPORT SHA256 : public _priv_SHA256Base
@@ -135,6 +139,10 @@ namespace slib
 
 		sl_uint32 getSize() const final;
 
+	public:
+		// hashes independent messages in parallel SIMD lanes when possible; `outputs` receives `n * HashSize` bytes
+		static void hashMany(const void* const* inputs, const sl_size* sizes, sl_size n, void* outputs);
+
 	};
 	
 	class SLIB_EXPORT _priv_SHA512Base : public CryptoHash
@@ -28,6 +28,7 @@
 #include "../core/object.h"
 #include "../core/memory.h"
 #include "../core/string.h"
+#include "../core/thread_pool.h"
 
 namespace slib
 {
@@ -89,6 +90,9 @@ namespace slib
 	
 		Memory compress(const void* data, sl_size size, sl_bool flagFinish);
 	
+		// compresses and flushes all pending output on a byte boundary (sync flush)
+		Memory compressAndFlush(const void* data, sl_size size);
+	
 		void abort();
 	
 	private:
@@ -171,6 +175,18 @@ namespace slib
 
 		static Memory compressGzip(const void* data, sl_size size, sl_int32 level = 6);
 	
+		/*
+			Parallel compression (pigz style)
+		 
+			The input is split into blocks which are deflated on the thread pool (primed with the preceding 32KB as dictionary),
+			and joined into a single standard zlib/gzip stream. A shared work-stealing pool is used when `pool` is null.
+		*/
+		static Memory compressParallel(const void* data, sl_size size, sl_int32 level = 6, const Ref<ThreadPool>& pool = sl_null);
+	
+		static Memory compressGzipParallel(const GzipParam& param, const void* data, sl_size size, sl_int32 level = 6, const Ref<ThreadPool>& pool = sl_null);
+	
+		static Memory compressGzipParallel(const void* data, sl_size size, sl_int32 level = 6, const Ref<ThreadPool>& pool = sl_null);
+	
 		/*
 			Decompress
 		*/
@@ -117,6 +117,7 @@ namespace slib
 		sl_bool flagIPv6; // default: false
 		sl_bool flagAutoStart; // default: true
 		sl_bool flagLogError; // default: true
+		sl_bool flagReusePort; // default: false, allows multiple listeners on the same port (one per loop)
 		Ref<AsyncIoLoop> ioLoop;
 		
 		Function<void(AsyncTcpServer*, Socket*, const SocketAddress&)> onAccept;
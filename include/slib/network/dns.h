@@ -30,6 +30,7 @@
 
 #include "../core/string.h"
 #include "../core/hash_map.h"
+#include "../core/cache.h"
 #include "../core/json.h"
 #include "../crypto/aes.h"
 
@@ -620,7 +621,8 @@ namespace slib
 			String requestedHostName;
 			sl_bool flagEncrypted;
 		};
-		CHashMap<sl_uint16, ForwardElement> m_mapForward;
+		// the requests which are never answered expire
+		Cache<sl_uint16, ForwardElement> m_mapForward;
 		
 		Function<void(DnsServer*, DnsResolveHostParam&)> m_onResolve;
 		Function<void(DnsServer*, const String& hostName, const IPAddress& hostAddress)> m_onCache;
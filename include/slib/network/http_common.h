@@ -140,6 +140,13 @@ namespace slib
 		TRACE
 	};
 	
+	enum class HttpContentEncoding
+	{
+		Identity = 0,
+		Gzip = 1,
+		Deflate = 2
+	};
+	
 	class SLIB_EXPORT HttpMethods
 	{
 	public:
@@ -160,6 +167,7 @@ namespace slib
 		static const String& TransferEncoding;
 		static const String& ContentEncoding;
 		static const String& Connection;
+		static const String& Vary;
 
 		static const String& Range;
 		static const String& ContentRange;
@@ -276,6 +284,13 @@ namespace slib
 		
 		void setRequestOrigin(const String& origin);
 		
+		String getRequestAcceptEncoding() const;
+		
+		void setRequestAcceptEncoding(const String& encoding);
+		
+		// prefers gzip over deflate, returns `Identity` when none of them is accepted
+		HttpContentEncoding getRequestAcceptedContentEncoding() const;
+		
 		
 		const HashMap<String, String>& getParameters() const;
 		
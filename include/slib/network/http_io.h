@@ -28,11 +28,14 @@
 #include "../core/string.h"
 #include "../crypto/zlib.h"
 
+#include "http_common.h"
 #include "async.h"
 
 namespace slib
 {
 	
+	class Json;
+	
 	class SLIB_EXPORT HttpOutputBuffer
 	{
 	public:
@@ -49,14 +52,29 @@ namespace slib
 		
 		void write(const Memory& mem);
 		
+		/*
+			serializes `json` into chunks without building the whole string.
+			The chunks are queued in the output buffer and sent after the response is completed,
+			and they are merged again when the response is compressed.
+		*/
+		void writeJson(const Json& json);
+		
 		void copyFrom(AsyncStream* stream, sl_uint64 size);
 		
+		// the content is written through `filter`, and is not counted in the output length
+		void copyFrom(AsyncStream* stream, sl_uint64 size, const Ref<AsyncStreamFilter>& filter);
+		
 		void copyFromFile(const String& path);
 		
 		void copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 		
+		void sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+		
 		sl_uint64 getOutputLength() const;
 		
+		// returns `sl_false` when the output contains streams or files
+		sl_bool getOutputMemory(Memory& _out);
+		
 	protected:
 		AsyncOutputBuffer m_bufferOutput;
 		
@@ -134,6 +152,31 @@ namespace slib
 
 	};
 
+	// compresses the written content, and frames the output in the chunked transfer coding
+	class SLIB_EXPORT HttpContentEncoder : public AsyncStreamFilter
+	{
+	protected:
+		HttpContentEncoder();
+		
+		~HttpContentEncoder();
+		
+	public:
+		// `contentLength`: total size of the content written to the encoder, the last chunk is sent after it
+		static Ref<HttpContentEncoder> create(HttpContentEncoding encoding, sl_uint64 contentLength, sl_int32 level = 6);
+		
+	public:
+		HttpContentEncoding getEncoding();
+		
+	protected:
+		Memory filterWrite(const void* data, sl_uint32 size, Referable* userObject) override;
+		
+	protected:
+		HttpContentEncoding m_encoding;
+		sl_uint64 m_sizeRemain;
+		ZlibCompress m_zlib;
+		
+	};
+	
 }
 
 #endif
@@ -30,6 +30,9 @@
 #include "socket_address.h"
 
 #include "../core/thread_pool.h"
+#include "../core/cache.h"
+
+#define SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS 16
 
 namespace slib
 {
@@ -78,6 +81,18 @@ namespace slib
 		
 		void completeResponse();
 		
+		// parameters captured from the path by the router
+		String getPathParameter(const String& name) const;
+		
+		sl_uint32 getPathParametersCount() const;
+		
+		String getPathParameterName(sl_uint32 index) const;
+		
+		String getPathParameterValue(sl_uint32 index) const;
+		
+		// `ranges`: offset and length in the path for each name
+		void setPathParameters(const List<String>& names, const sl_uint32* ranges);
+		
 	public:
 		SLIB_BOOLEAN_PROPERTY(ClosingConnection);
 		SLIB_BOOLEAN_PROPERTY(ProcessingByThread);
@@ -90,6 +105,9 @@ namespace slib
 		AtomicMemory m_requestBody;
 		sl_bool m_flagAsynchronousResponse;
 		
+		List<String> m_pathParameterNames;
+		sl_uint32 m_pathParameterRanges[SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS * 2];
+		
 	private:
 		WeakRef<HttpServiceConnection> m_connection;
 		
@@ -161,6 +179,10 @@ namespace slib
 		
 		void _completeResponse(HttpServiceContext* context);
 		
+		void _encodeResponse(const Ref<HttpServiceContext>& context);
+		
+		void _writeResponse(HttpServiceContext* context);
+		
 	protected:
 		void onReadStream(AsyncStreamResult* result);
 
@@ -199,6 +221,12 @@ namespace slib
 		
 		sl_uint32 maxThreadsCount;
 		sl_bool flagProcessByThreads;
+		sl_bool flagUseWorkStealingThreadPool;
+		
+		sl_uint32 ioLoopsCount; // 0 means the number of processors
+		AsyncIoLoopBalance ioLoopBalance;
+		sl_bool flagReusePort; // one listener per io loop
+		sl_bool flagPinIoLoops;
 		
 		sl_bool flagUseWebRoot;
 		String webRootPath;
@@ -212,6 +240,14 @@ namespace slib
 		sl_bool flagAllowCrossOrigin;
 		sl_bool flagAlwaysRespondAcceptRangesHeader;
 		
+		sl_bool flagCompressResponse; // gzip or deflate, negotiated by `Accept-Encoding`
+		sl_int32 compressionLevel;
+		sl_uint64 minCompressionSize;
+		List<String> compressibleContentTypes; // prefixes of the content types
+		sl_bool flagUsePrecompressedFile; // serves `.gz` sibling of the static file
+		sl_uint64 maxCompressionCacheSize; // compressed static files, keyed by path and modified time. least recently used files are evicted
+		sl_uint64 maxCompressionCacheFileSize; // bigger files are compressed while sending
+		
 		sl_bool flagLogDebug;
 		
 		Function<sl_bool(HttpService*, HttpServiceContext*)> onRequest;
@@ -226,6 +262,8 @@ namespace slib
 		
 	};
 	
+	class _priv_HttpServiceCompressedFile;
+	
 	class SLIB_EXPORT HttpService : public Object
 	{
 		SLIB_DECLARE_OBJECT
@@ -245,6 +283,8 @@ namespace slib
 		
 		Ref<AsyncIoLoop> getAsyncIoLoop();
 		
+		Ref<AsyncIoLoopGroup> getAsyncIoLoopGroup();
+		
 		Ref<ThreadPool> getThreadPool();
 		
 		const HttpServiceParam& getParam();
@@ -262,6 +302,13 @@ namespace slib
 		
 		sl_bool processRangeRequest(const Ref<HttpServiceContext>& context, sl_uint64 totalLength, const String& range, sl_uint64& outStart, sl_uint64& outLength);
 		
+		// compresses the buffered response content when the client accepts it
+		virtual void processContentEncoding(const Ref<HttpServiceContext>& context);
+		
+		sl_bool isCompressibleContentType(const String& contentType);
+		
+		sl_bool isCompressibleResponse(HttpServiceContext* context);
+		
 		virtual Ref<HttpServiceConnection> addConnection(const Ref<AsyncStream>& stream, const SocketAddress& remoteAddress, const SocketAddress& localAddress);
 		
 		virtual void closeConnection(HttpServiceConnection* connection);
@@ -291,8 +338,22 @@ namespace slib
 	protected:
 		sl_bool _init(const HttpServiceParam& param);
 		
+		sl_bool _sendFile(const Ref<HttpServiceContext>& context, const String& path, sl_uint64 offset, sl_uint64 size);
+		
+		Ref<AsyncStream> _openFileStream(const Ref<HttpServiceContext>& context, const String& path);
+		
+		sl_bool _processCompressedFile(const Ref<HttpServiceContext>& context, const String& path, sl_uint64 size);
+		
+		// returns null on cache miss when `flagCompress` is false, or while another thread is compressing the file
+		Memory _getCompressedFile(const String& path, sl_uint64 size, HttpContentEncoding encoding, sl_bool flagCompress);
+		
+		Memory _compressFile(const String& key, const String& path, sl_uint64 size, HttpContentEncoding encoding, const Time& modifiedTime);
+		
+		void _compressFileInBackground(const String& path, sl_uint64 size, HttpContentEncoding encoding);
+		
 	protected:
 		AtomicRef<AsyncIoLoop> m_ioLoop;
+		AtomicRef<AsyncIoLoopGroup> m_ioLoopGroup;
 		AtomicRef<ThreadPool> m_threadPool;
 		sl_bool m_flagRunning;
 		
@@ -302,6 +363,9 @@ namespace slib
 		
 		HttpServiceParam m_param;
 		
+		Cache< String, Ref<_priv_HttpServiceCompressedFile> > m_compressedFiles;
+		CHashMap<String, sl_bool> m_compressingFiles;
+		
 	};
 
 }
@@ -32,6 +32,7 @@
 
 #include "../core/object.h"
 #include "../core/hash_map.h"
+#include "../core/concurrent_hash_map.h"
 
 /*
 	If you are usiing kernel-mode NAT on linux (for example on port range 40000~60000), following configuration will avoid to conflict with kernel-networking.
@@ -137,7 +138,7 @@ namespace slib
 			sl_uint16 sequenceNumberTarget;
 		};
 		
-		CHashMap<IcmpEchoAddress, IcmpEchoElement> m_mapIcmpEchoOutgoing;
+		ConcurrentHashMap<IcmpEchoAddress, IcmpEchoElement> m_mapIcmpEchoOutgoing;
 		CHashMap<sl_uint32, IcmpEchoElement> m_mapIcmpEchoIncoming;
 		
 	};
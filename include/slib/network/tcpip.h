@@ -28,7 +28,8 @@
 #include "constants.h"
 #include "ip_address.h"
 
-#include "../core/expire.h"
+#include "../core/cache.h"
+#include "../core/dispatch_loop.h"
 
 /********************************************************************
 					IPv4 Header from RFC 791
@@ -592,6 +593,7 @@ public:
 		~IPv4Fragmentation();
 
 	public:
+		// the fragments of a packet are dropped when the packet is not completed in `ms` milliseconds. `loop` is not used any more
 		void setupExpiringDuration(sl_uint32 ms, const Ref<DispatchLoop>& loop);
 		
 		void setupExpiringDuration(sl_uint32 ms);
@@ -605,7 +607,8 @@ public:
 		static List<Memory> makeFragments(const IPv4Packet* packet, sl_uint16 mtu = 1500);
 		
 	protected:
-		ExpiringMap< IPv4PacketIdentifier, Ref<IPv4FragmentedPacket> > m_packets;
+		// bounded, so that the fragments of lost packets never pile up
+		Cache< IPv4PacketIdentifier, Ref<IPv4FragmentedPacket> > m_packets;
 		
 	};
 	
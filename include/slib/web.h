@@ -27,6 +27,7 @@
 
 #include "web/service.h"
 #include "web/controller.h"
+#include "web/router.h"
 
 #include "web/ginger.h"
 
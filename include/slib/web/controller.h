@@ -25,17 +25,11 @@
 
 #include "definition.h"
 
-#include "../core/function.h"
-#include "../core/variant.h"
-#include "../network/http_service.h"
-
-#define SWEB_HANDLER_PARAMS_LIST const slib::Ref<slib::HttpServiceContext>& context, HttpMethod method, const slib::String& path
+#include "router.h"
 
 namespace slib
 {
 
-	typedef Function<Variant(SWEB_HANDLER_PARAMS_LIST)> WebHandler;
-
 	class WebController : public Object
 	{
 		SLIB_DECLARE_OBJECT
@@ -47,15 +41,17 @@ namespace slib
 		static Ref<WebController> create();
 		
 	public:
-		void registerHandler(HttpMethod method, const String& path, const WebHandler& handler);
+		/*
+			Segments starting with `:` or `*` are parsed as parameters and wildcards (see WebRouter),
+			so they can not be used as static text.
+			Returns sl_false (and logs the error) when the path is invalid or conflicts with a registered route.
+		*/
+		sl_bool registerHandler(HttpMethod method, const String& path, const WebHandler& handler);
 		
 		sl_bool processHttpRequest(HttpServiceContext* context);
 		
 	protected:
-		static String _getHandlerSignature(HttpMethod method, const String& path);
-		
-	protected:
-		CMap<String, WebHandler> m_handlers;
+		WebRouter m_router;
 		
 		friend class WebModule;
 		
@@ -100,6 +96,7 @@ namespace SWEB_MODULE_##NAME { \
 	class _priv_slib_WebHandlerRegisterer_##NAME { public: _priv_slib_WebHandlerRegisterer_##NAME() { getModule()->addHandler(slib::HttpMethod::METHOD, PATH, &NAME); } } _priv_slib_WebHandlerRegisterer_instance_##NAME; \
 	slib::Variant NAME(SWEB_HANDLER_PARAMS_LIST)
 
+#define SWEB_PATH_PARAM(NAME) slib::String NAME = context->getPathParameter(#NAME);
 #define SWEB_STRING_PARAM(NAME) slib::String NAME = context->getParameter(#NAME);
 #define SWEB_INT_PARAM(NAME, ...) sl_int32 NAME = context->getParameter(#NAME).parseInt32(10, ##__VA_ARGS__);
 #define SWEB_INT64_PARAM(NAME, ...) sl_int64 NAME = context->getParameter(#NAME).parseInt64(10, ##__VA_ARGS__);
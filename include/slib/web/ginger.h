@@ -26,16 +26,68 @@
 #include "definition.h"
 
 #include "../core/json.h"
+#include "../core/string_buffer.h"
 
 namespace slib
 {
 	
+	class AsyncOutputBuffer;
+	class _priv_GingerBlock;
+	
+	/*
+		Ginger template syntax
+	 
+		${var.path}					variable
+		$$ ${{ $}}					escaped '$', '{{', '}}'
+		$# comment					comment until the end of line
+		$for x in xs {{ ... }}
+		$if x {{ ... }} $elseif y == value {{ ... }} $else {{ ... }}
+		$include {{ file }}			renders the template file with same data
+		$inline {{ file }}			inserts the file contents as is
+	*/
+	class SLIB_EXPORT GingerTemplate : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	protected:
+		GingerTemplate();
+		
+		~GingerTemplate();
+		
+	public:
+		// returns `null` on syntax error
+		static Ref<GingerTemplate> create(const String& source);
+		
+		static Ref<GingerTemplate> createFromFile(const String& filePath);
+		
+	public:
+		String render(const Json& data);
+		
+		void render(StringBuffer& output, const Json& data);
+		
+		Memory renderToMemory(const Json& data);
+		
+		sl_bool render(AsyncOutputBuffer* output, const Json& data);
+		
+	public:
+		void _render(StringBuffer& output, const Json& data, sl_uint32 depth);
+		
+	protected:
+		Ref<_priv_GingerBlock> m_root;
+		
+	};
+	
 	class SLIB_EXPORT Ginger
 	{
 	public:
 		static String render(const String& _template, const Json& data);
 		
+		// compiled templates are cached, and reloaded when the file is modified
 		static String renderFile(const String& filePath, const Json& data);
+		
+		static Ref<GingerTemplate> getTemplateFromFile(const String& filePath);
+		
+		static void clearTemplateCache();
 
 	};
 	
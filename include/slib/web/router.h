@@ -0,0 +1,80 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_WEB_ROUTER
+#define CHECKHEADER_SLIB_WEB_ROUTER
+
+#include "definition.h"
+
+#include "../core/function.h"
+#include "../core/variant.h"
+#include "../core/rw_lock.h"
+#include "../network/http_service.h"
+
+#define SWEB_HANDLER_PARAMS_LIST const slib::Ref<slib::HttpServiceContext>& context, HttpMethod method, const slib::String& path
+
+namespace slib
+{
+
+	typedef Function<Variant(SWEB_HANDLER_PARAMS_LIST)> WebHandler;
+	
+	class _priv_WebRouterNode;
+	
+	/*
+		Radix tree of the routes, one tree per method
+	 
+		Segments of the route path
+			static text
+			:name - parameter, matches one non-empty segment
+			*name (or *) - wildcard, matches the rest of the path, should be the last segment
+	 
+		Static segments take priority over parameters, and parameters over wildcards.
+	*/
+	class SLIB_EXPORT WebRouter
+	{
+	public:
+		WebRouter();
+		
+		~WebRouter();
+		
+	public:
+		sl_bool add(HttpMethod method, const String& path, const WebHandler& handler);
+		
+		/*
+			`outParameterRanges`: offset and length in `path` of the captured parameters,
+			should have (SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS * 2) elements.
+			Does not allocate memory.
+		*/
+		WebHandler find(HttpMethod method, const String& path, List<String>* outParameterNames = sl_null, sl_uint32* outParameterRanges = sl_null) const;
+		
+		// finds the route of the request, and applies the captured parameters to `context`
+		WebHandler route(HttpServiceContext* context) const;
+		
+	protected:
+		Ref<_priv_WebRouterNode> m_trees[(int)(HttpMethod::TRACE) + 1];
+		ReadWriteLock m_lock;
+		
+	};
+
+}
+
+#endif
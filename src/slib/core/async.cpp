@@ -23,6 +23,9 @@
 #include "slib/core/async.h"
 
 #include "slib/core/safe_static.h"
+#include "slib/core/system.h"
+
+#define PRIV_ASYNC_MAX_TASKS_PER_STEP 4096
 
 namespace slib
 {
@@ -38,6 +41,8 @@ namespace slib
 		m_flagInit = sl_false;
 		m_flagRunning = sl_false;
 		m_handle = sl_null;
+		m_nConnections = 0;
+		m_flagWakingTasks = 0;
 	}
 
 	AsyncIoLoop::~AsyncIoLoop()
@@ -105,6 +110,9 @@ namespace slib
 		m_queueInstancesClosing.removeAll();
 		m_queueInstancesClosed.removeAll();
 		
+		MutexLocker lockTime(&m_lockTimeTasks);
+		m_timeTasks.removeAll();
+		
 	}
 
 	void AsyncIoLoop::start()
@@ -133,7 +141,10 @@ namespace slib
 			return sl_false;
 		}
 		if (m_queueTasks.push(task)) {
-			wake();
+			// one wakeup covers a burst of tasks
+			if (Base::interlockedCompareExchange32(&m_flagWakingTasks, 1, 0)) {
+				wake();
+			}
 			return sl_true;
 		}
 		return sl_false;
@@ -141,7 +152,19 @@ namespace slib
 
 	sl_bool AsyncIoLoop::dispatch(const Function<void()>& callback, sl_uint64 delay_ms)
 	{
-		return addTask(callback);
+		if (delay_ms == 0) {
+			return addTask(callback);
+		}
+		if (callback.isNull()) {
+			return sl_false;
+		}
+		MutexLocker lock(&m_lockTimeTasks);
+		if (m_timeTasks.add(m_timeCounter.getElapsedMilliseconds() + delay_ms, callback)) {
+			lock.unlock();
+			wake();
+			return sl_true;
+		}
+		return sl_false;
 	}
 
 	void AsyncIoLoop::wake()
@@ -158,7 +181,12 @@ namespace slib
 		if (m_handle) {
 			if (instance && instance->isOpened()) {
 				ObjectLocker lock(this);
-				return _native_attachInstance(instance, mode);
+				if (_native_attachInstance(instance, mode)) {
+					if (instance->isConnection()) {
+						Base::interlockedIncrement32(&m_nConnections);
+					}
+					return sl_true;
+				}
 			}
 		}
 		return sl_false;
@@ -177,6 +205,15 @@ namespace slib
 		}
 	}
 
+	sl_uint32 AsyncIoLoop::getConnectionsCount()
+	{
+		sl_int32 n = m_nConnections;
+		if (n > 0) {
+			return (sl_uint32)n;
+		}
+		return 0;
+	}
+
 	void AsyncIoLoop::requestOrder(AsyncIoInstance* instance)
 	{
 		if (m_handle) {
@@ -189,14 +226,32 @@ namespace slib
 
 	void AsyncIoLoop::_stepBegin()
 	{
+		// Delayed Tasks
+		{
+			List< Function<void()> > tasks;
+			{
+				MutexLocker lock(&m_lockTimeTasks);
+				m_timeCounter.update();
+				if (m_timeTasks.isNotEmpty()) {
+					m_timeTasks.advance(m_timeCounter.getElapsedMilliseconds(), tasks);
+				}
+			}
+			ListElements< Function<void()> > list(tasks);
+			for (sl_size i = 0; i < list.count; i++) {
+				list.data[i]();
+			}
+		}
+		
 		// Async Tasks
 		{
-			LinkedQueue< Function<void()> > tasks;
-			tasks.merge(&m_queueTasks);
+			// the tasks pushed from now on wake the loop again
+			Base::interlockedCompareExchange32(&m_flagWakingTasks, 0, 1);
+			// bounded, so that the tasks posting themselves again do not starve the IO
 			Function<void()> task;
-			while (m_queueTasks.pop(&task)) {
+			for (sl_uint32 i = 0; i < PRIV_ASYNC_MAX_TASKS_PER_STEP && m_queueTasks.pop(&task); i++) {
 				task();
 			}
+			task.setNull();
 		}
 		
 		// Request Orders
@@ -212,18 +267,156 @@ namespace slib
 		}
 	}
 
+	sl_int32 AsyncIoLoop::_getTimeout()
+	{
+		if (m_queueTasks.isNotEmpty()) {
+			return 0;
+		}
+		MutexLocker lock(&m_lockTimeTasks);
+		sl_int64 timeout = m_timeTasks.getTimeout(m_timeCounter.getElapsedMilliseconds());
+		if (timeout > 0x7fffffff) {
+			timeout = 0x7fffffff;
+		}
+		return (sl_int32)timeout;
+	}
+
 	void AsyncIoLoop::_stepEnd()
 	{
 		Ref<AsyncIoInstance> instance;
 		while (m_queueInstancesClosing.pop(&instance)) {
 			if (instance.isNotNull() && instance->isOpened()) {
 				_native_detachInstance(instance.get());
+				if (instance->isConnection()) {
+					Base::interlockedDecrement32(&m_nConnections);
+				}
 				instance->close();
 				m_queueInstancesClosed.push(instance);
 			}
 		}
 	}
 
+/*************************************
+		AsyncIoLoopGroup
+**************************************/
+
+	SLIB_DEFINE_OBJECT(AsyncIoLoopGroup, Object)
+
+	AsyncIoLoopGroup::AsyncIoLoopGroup()
+	{
+		setBalance(AsyncIoLoopBalance::RoundRobin);
+		m_indexNext = 0;
+		m_flagRunning = sl_false;
+	}
+
+	AsyncIoLoopGroup::~AsyncIoLoopGroup()
+	{
+		release();
+	}
+
+	Ref<AsyncIoLoopGroup> AsyncIoLoopGroup::create(sl_uint32 nLoops, sl_bool flagPinToProcessors, sl_bool flagAutoStart)
+	{
+		if (!nLoops) {
+			nLoops = System::getProcessorsCount();
+		}
+		sl_uint32 nProcessors = System::getProcessorsCount();
+		Array< Ref<AsyncIoLoop> > loops = Array< Ref<AsyncIoLoop> >::create(nLoops);
+		if (loops.isNull()) {
+			return sl_null;
+		}
+		for (sl_uint32 i = 0; i < nLoops; i++) {
+			Ref<AsyncIoLoop> loop = AsyncIoLoop::create(sl_false);
+			if (loop.isNull()) {
+				for (sl_uint32 k = 0; k < i; k++) {
+					loops[k]->release();
+				}
+				return sl_null;
+			}
+			if (flagPinToProcessors) {
+				// runs as the first task on the loop thread
+				sl_uint32 processor = i % nProcessors;
+				loop->addTask([processor]() {
+					Thread::setCurrentThreadAffinity(processor);
+				});
+			}
+			loops[i] = loop;
+		}
+		Ref<AsyncIoLoopGroup> ret = new AsyncIoLoopGroup;
+		if (ret.isNotNull()) {
+			ret->m_loops = loops;
+			if (flagAutoStart) {
+				ret->start();
+			}
+			return ret;
+		}
+		for (sl_uint32 i = 0; i < nLoops; i++) {
+			loops[i]->release();
+		}
+		return sl_null;
+	}
+
+	void AsyncIoLoopGroup::release()
+	{
+		ObjectLocker lock(this);
+		Ref<AsyncIoLoop>* loops = m_loops.getData();
+		sl_size n = m_loops.getCount();
+		for (sl_size i = 0; i < n; i++) {
+			loops[i]->release();
+		}
+		m_flagRunning = sl_false;
+	}
+
+	void AsyncIoLoopGroup::start()
+	{
+		ObjectLocker lock(this);
+		Ref<AsyncIoLoop>* loops = m_loops.getData();
+		sl_size n = m_loops.getCount();
+		for (sl_size i = 0; i < n; i++) {
+			loops[i]->start();
+		}
+		m_flagRunning = sl_true;
+	}
+
+	sl_bool AsyncIoLoopGroup::isRunning()
+	{
+		return m_flagRunning;
+	}
+
+	sl_uint32 AsyncIoLoopGroup::getLoopsCount()
+	{
+		return (sl_uint32)(m_loops.getCount());
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::getLoop(sl_uint32 index)
+	{
+		return m_loops.getValueAt(index);
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::selectLoop()
+	{
+		Ref<AsyncIoLoop>* loops = m_loops.getData();
+		sl_uint32 n = (sl_uint32)(m_loops.getCount());
+		if (!n) {
+			return sl_null;
+		}
+		if (n == 1) {
+			return loops[0];
+		}
+		if (getBalance() == AsyncIoLoopBalance::LeastLoaded) {
+			sl_uint32 indexMin = 0;
+			sl_uint32 nMin = loops[0]->getConnectionsCount();
+			for (sl_uint32 i = 1; i < n && nMin; i++) {
+				sl_uint32 m = loops[i]->getConnectionsCount();
+				if (m < nMin) {
+					nMin = m;
+					indexMin = i;
+				}
+			}
+			return loops[indexMin];
+		}
+		sl_uint32 index = ((sl_uint32)(Base::interlockedIncrement32(&m_indexNext))) % n;
+		return loops[index];
+	}
+
 /*************************************
 		AsyncIoInstance
 **************************************/
@@ -234,6 +427,7 @@ namespace slib
 	{
 		m_handle = 0;
 		m_flagClosing = sl_false;
+		m_flagConnection = sl_false;
 		m_flagOrdering = sl_false;
 		m_mode = AsyncIoMode::InOut;
 	}
@@ -296,6 +490,16 @@ namespace slib
 		m_flagClosing = sl_true;
 	}
 
+	sl_bool AsyncIoInstance::isConnection()
+	{
+		return m_flagConnection;
+	}
+
+	void AsyncIoInstance::setConnection(sl_bool flag)
+	{
+		m_flagConnection = flag;
+	}
+
 	void AsyncIoInstance::addToQueue(LinkedQueue< Ref<AsyncIoInstance> >& queue)
 	{
 		MutexLocker lock(&m_lockOrdering);
@@ -396,7 +600,7 @@ namespace slib
 		Referable* _userObject,
 		const Function<void(AsyncStreamResult*)>& _callback,
 		sl_bool _flagRead)
-	 : data((void*)_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead)
+	 : data((void*)_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead), fileOffset(0)
 	{
 	}
 
@@ -418,6 +622,24 @@ namespace slib
 		return new AsyncStreamRequest(data, size, userObject, callback, sl_false);
 	}
 
+	Ref<AsyncStreamRequest> AsyncStreamRequest::createSendFile(
+		const Ref<File>& file,
+		sl_uint64 offset,
+		sl_uint32 size,
+		Referable* userObject,
+		const Function<void(AsyncStreamResult*)>& callback)
+	{
+		if (file.isNull()) {
+			return sl_null;
+		}
+		Ref<AsyncStreamRequest> ret = new AsyncStreamRequest(sl_null, size, userObject, callback, sl_false);
+		if (ret.isNotNull()) {
+			ret->file = file;
+			ret->fileOffset = offset;
+		}
+		return ret;
+	}
+
 	void AsyncStreamRequest::runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError)
 	{
 		if (callback.isNotNull()) {
@@ -463,6 +685,24 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamInstance::isSendFileSupported()
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamInstance::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		if (!(isSendFileSupported())) {
+			return sl_false;
+		}
+		Ref<AsyncStreamRequest> req = AsyncStreamRequest::createSendFile(file, offset, size, userObject, callback);
+		if (req.isNotNull()) {
+			m_requestsWrite.push(req);
+			return sl_true;
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamInstance::isSeekable()
 	{
 		return sl_false;
@@ -557,6 +797,16 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool AsyncStream::isSendFileSupported()
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStream::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		return sl_false;
+	}
+
 	sl_bool AsyncStream::isSeekable()
 	{
 		return sl_false;
@@ -670,6 +920,31 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamBase::isSendFileSupported()
+	{
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			return instance->isSendFileSupported();
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamBase::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult*)>& callback, Referable* userObject)
+	{
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			if (instance->sendFile(file, offset, size, callback, userObject)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamBase::isSeekable()
 	{
 		Ref<AsyncStreamInstance> instance = getIoInstance();
@@ -1446,18 +1721,28 @@ namespace slib
 	AsyncOutputBufferElement::AsyncOutputBufferElement()
 	{
 		m_sizeBody = 0;
+		m_offsetBodyFile = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(const Memory& header)
 	{
 		m_header.add(header);
 		m_sizeBody = 0;
+		m_offsetBodyFile = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(AsyncStream* stream, sl_uint64 size)
 	{
 		m_body = stream;
 		m_sizeBody = size;
+		m_offsetBodyFile = 0;
+	}
+
+	AsyncOutputBufferElement::AsyncOutputBufferElement(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bodyFile = file;
+		m_offsetBodyFile = offset;
+		m_sizeBody = size;
 	}
 
 	AsyncOutputBufferElement::~AsyncOutputBufferElement()
@@ -1466,7 +1751,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmpty() const
 	{
-		if (m_header.getSize() == 0 && (m_sizeBody == 0 || m_body.isNull())) {
+		if (m_header.getSize() == 0 && isEmptyBody()) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1474,7 +1759,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmptyBody() const
 	{
-		if (m_sizeBody == 0 || m_body.isNull()) {
+		if (m_sizeBody == 0 || (m_body.isNull() && m_bodyFile.isNull())) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1485,12 +1770,24 @@ namespace slib
 		return m_header.add(header);
 	}
 
+	sl_bool AsyncOutputBufferElement::addHeader(const MemoryData& header)
+	{
+		return m_header.add(header);
+	}
+
 	void AsyncOutputBufferElement::setBody(AsyncStream* stream, sl_uint64 size)
 	{
 		m_body = stream;
 		m_sizeBody = size;
 	}
 
+	void AsyncOutputBufferElement::setBody(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bodyFile = file;
+		m_offsetBodyFile = offset;
+		m_sizeBody = size;
+	}
+
 	MemoryQueue& AsyncOutputBufferElement::getHeader()
 	{
 		return m_header;
@@ -1501,11 +1798,40 @@ namespace slib
 		return m_body;
 	}
 
+	Ref<File> AsyncOutputBufferElement::getBodyFile()
+	{
+		return m_bodyFile;
+	}
+
+	sl_uint64 AsyncOutputBufferElement::getBodyFileOffset()
+	{
+		return m_offsetBodyFile;
+	}
+
 	sl_uint64 AsyncOutputBufferElement::getBodySize()
 	{
 		return m_sizeBody;
 	}
 
+	void AsyncOutputBufferElement::skipBody(sl_uint64 size)
+	{
+		if (size > m_sizeBody) {
+			size = m_sizeBody;
+		}
+		m_offsetBodyFile += size;
+		m_sizeBody -= size;
+	}
+
+	Ref<AsyncStreamFilter> AsyncOutputBufferElement::getBodyFilter()
+	{
+		return m_bodyFilter;
+	}
+
+	void AsyncOutputBufferElement::setBodyFilter(const Ref<AsyncStreamFilter>& filter)
+	{
+		m_bodyFilter = filter;
+	}
+
 
 /**********************************************
 		AsyncOutputBuffer
@@ -1556,6 +1882,31 @@ namespace slib
 		return sl_true;
 	}
 
+	sl_bool AsyncOutputBuffer::write(const MemoryData& data)
+	{
+		if (!(data.data) || !(data.size)) {
+			return sl_false;
+		}
+		ObjectLocker lock(this);
+		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getBack();
+		if (link && link->value->isEmptyBody()) {
+			if (link->value->addHeader(data)) {
+				m_lengthOutput += data.size;
+			} else {
+				return sl_false;
+			}
+		} else {
+			Ref<AsyncOutputBufferElement> element = new AsyncOutputBufferElement;
+			if (element.isNotNull() && element->addHeader(data)) {
+				m_queueOutput.push(element);
+				m_lengthOutput += data.size;
+			} else {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
 	sl_bool AsyncOutputBuffer::copyFrom(AsyncStream* stream, sl_uint64 size)
 	{
 		if (size == 0) {
@@ -1584,6 +1935,26 @@ namespace slib
 		return sl_true;
 	}
 
+	sl_bool AsyncOutputBuffer::copyFrom(AsyncStream* stream, sl_uint64 size, const Ref<AsyncStreamFilter>& filter)
+	{
+		if (filter.isNull()) {
+			return copyFrom(stream, size);
+		}
+		if (size == 0) {
+			return sl_true;
+		}
+		if (!stream) {
+			return sl_false;
+		}
+		Ref<AsyncOutputBufferElement> data = new AsyncOutputBufferElement(stream, size);
+		if (data.isNotNull()) {
+			data->setBodyFilter(filter);
+			ObjectLocker lock(this);
+			return m_queueOutput.push(data);
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncOutputBuffer::copyFromFile(const String& path)
 	{
 #if defined(SLIB_PLATFORM_IS_WIN32)
@@ -1598,6 +1969,17 @@ namespace slib
 		}
 		return sl_false;
 #else
+#	if defined(SLIB_PLATFORM_IS_LINUX)
+		if (File::exists(path)) {
+			sl_uint64 size = File::getSize(path);
+			if (size > 0) {
+				Ref<AsyncStream> file = AsyncFile::openIoUring(path, FileMode::Read);
+				if (file.isNotNull()) {
+					return copyFrom(file.get(), size);
+				}
+			}
+		}
+#	endif
 		return copyFromFile(path, Ref<Dispatcher>::null());
 #endif
 	}
@@ -1619,11 +2001,56 @@ namespace slib
 		return sl_true;
 	}
 
+	sl_bool AsyncOutputBuffer::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		if (size == 0) {
+			return sl_true;
+		}
+		if (file.isNull()) {
+			return sl_false;
+		}
+		ObjectLocker lock(this);
+		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getBack();
+		if (link && link->value->isEmptyBody()) {
+			link->value->setBody(file, offset, size);
+			m_lengthOutput += size;
+		} else {
+			Ref<AsyncOutputBufferElement> data = new AsyncOutputBufferElement(file, offset, size);
+			if (data.isNotNull()) {
+				if (m_queueOutput.push(data)) {
+					m_lengthOutput += size;
+				} else {
+					return sl_false;
+				}
+			} else {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
 	sl_uint64 AsyncOutputBuffer::getOutputLength() const
 	{
 		return m_lengthOutput;
 	}
 
+	sl_bool AsyncOutputBuffer::getOutputMemory(Memory& _out)
+	{
+		ObjectLocker lock(this);
+		MemoryBuffer buffer;
+		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getFront();
+		while (link) {
+			AsyncOutputBufferElement* element = link->value.get();
+			if (!(element->isEmptyBody())) {
+				return sl_false;
+			}
+			buffer.add(element->getHeader().merge());
+			link = link->next;
+		}
+		_out = buffer.merge();
+		return sl_true;
+	}
+
 /**********************************************
 				AsyncOutput
 **********************************************/
@@ -1739,12 +2166,44 @@ namespace slib
 		} else {
 			sl_uint64 sizeBody = m_elementWriting->getBodySize();
 			Ref<AsyncStream> body = m_elementWriting->getBody();
+			Ref<File> file = m_elementWriting->getBodyFile();
+			Ref<AsyncStreamFilter> filter = m_elementWriting->getBodyFilter();
+			if (sizeBody != 0 && file.isNotNull()) {
+				sl_uint64 offset = m_elementWriting->getBodyFileOffset();
+				if (filter.isNull() && m_streamOutput->isSendFileSupported()) {
+					sl_uint32 size = SLIB_ASYNC_OUTPUT_SEND_FILE_CHUNK_SIZE;
+					if (sizeBody < size) {
+						size = (sl_uint32)sizeBody;
+					}
+					m_flagWriting = sl_true;
+					if (!(m_streamOutput->sendFile(file, offset, size, SLIB_FUNCTION_WEAKREF(AsyncOutput, onSendFile, this)))) {
+						m_flagWriting = sl_false;
+						_onError();
+					}
+					return;
+				}
+				// falls back to copying through the buffers
+				if (file->seek(offset, SeekPosition::Begin)) {
+					body = AsyncFile::create(file);
+				} else {
+					body.setNull();
+				}
+				if (body.isNull()) {
+					_onError();
+					return;
+				}
+			}
 			if (sizeBody != 0 && body.isNotNull()) {
 				m_flagWriting = sl_true;
 				m_elementWriting.setNull();
 				AsyncCopyParam param;
 				param.source = body;
-				param.target = m_streamOutput;
+				if (filter.isNotNull()) {
+					filter->setSourceStream(m_streamOutput);
+					param.target = filter;
+				} else {
+					param.target = m_streamOutput;
+				}
 				param.size = sizeBody;
 				param.bufferSize = m_bufferSize;
 				param.bufferCount = m_bufferCount;
@@ -1780,6 +2239,22 @@ namespace slib
 		_write(sl_true);
 	}
 
+	void AsyncOutput::onSendFile(AsyncStreamResult* result)
+	{
+		m_flagWriting = sl_false;
+		if (result->flagError || result->size != result->requestSize) {
+			_onError();
+			return;
+		}
+		{
+			ObjectLocker lock(this);
+			if (m_elementWriting.isNotNull()) {
+				m_elementWriting->skipBody(result->size);
+			}
+		}
+		_write(sl_true);
+	}
+
 	void AsyncOutput::_onError()
 	{
 		m_onEnd(this, sl_true);
@@ -35,6 +35,12 @@
 #define ASYNC_USE_KEVENT
 #endif
 
+#if defined(ASYNC_USE_EPOLL) && !defined(SLIB_PLATFORM_IS_ANDROID) && defined(__has_include)
+#	if __has_include(<linux/io_uring.h>)
+#		define ASYNC_USE_IO_URING
+#	endif
+#endif
+
 #define ASYNC_MAX_WAIT_EVENT 256
 
 #endif
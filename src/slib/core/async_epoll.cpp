@@ -21,6 +21,7 @@
  */
 
 #include "async_config.h"
+#include "async_uring.h"
 
 #if defined(ASYNC_USE_EPOLL)
 
@@ -42,6 +43,10 @@ namespace slib
 	{
 		int fdEpoll;
 		Ref<PipeEvent> eventWake;
+#if defined(ASYNC_USE_IO_URING)
+		_priv_IoUring* uring;
+		sl_bool flagUringChecked;
+#endif
 	};
 
 	void* AsyncIoLoop::_native_createHandle()
@@ -61,6 +66,10 @@ namespace slib
 			if (handle) {
 				handle->fdEpoll = fdEpoll;
 				handle->eventWake = pipe;
+#if defined(ASYNC_USE_IO_URING)
+				handle->uring = sl_null;
+				handle->flagUringChecked = sl_false;
+#endif
 				// register wake event
 				epoll_event ev;
 				ev.data.ptr = sl_null;
@@ -79,6 +88,13 @@ namespace slib
 	{
 		_priv_AsyncIoLoopHandle* handle = (_priv_AsyncIoLoopHandle*)_handle;
 		::close(handle->fdEpoll);
+#if defined(ASYNC_USE_IO_URING)
+		if (handle->uring) {
+			// the kernel must not complete into the buffers of the pending operations after the ring is gone
+			handle->uring->cancelAll();
+			delete handle->uring;
+		}
+#endif
 		delete handle;
 	}
 
@@ -91,8 +107,15 @@ namespace slib
 		while (m_flagRunning) {
 
 			_stepBegin();
+			
+#if defined(ASYNC_USE_IO_URING)
+			// operations prepared by the orders are submitted in one batch
+			if (handle->uring) {
+				handle->uring->submit();
+			}
+#endif
 
-			int nEvents = ::epoll_wait(handle->fdEpoll, waitEvents, ASYNC_MAX_WAIT_EVENT, -1);
+			int nEvents = ::epoll_wait(handle->fdEpoll, waitEvents, ASYNC_MAX_WAIT_EVENT, (int)(_getTimeout()));
 			if (nEvents == 0) {
 				m_queueInstancesClosed.removeAll();
 			}
@@ -105,6 +128,12 @@ namespace slib
 
 			for (int i = 0; m_flagRunning && i < nEvents; i++) {
 				epoll_event& ev = waitEvents[i];
+#if defined(ASYNC_USE_IO_URING)
+				if (ev.data.ptr == (void*)handle) {
+					handle->uring->processCompletions();
+					continue;
+				}
+#endif
 				AsyncIoInstance* instance = (AsyncIoInstance*)(ev.data.ptr);
 				if (instance) {
 					if (!(instance->isClosing())) {
@@ -146,6 +175,40 @@ namespace slib
 		handle->eventWake->set();
 	}
 
+	void* AsyncIoLoop::_native_getIoUring()
+	{
+#if defined(ASYNC_USE_IO_URING)
+		_priv_AsyncIoLoopHandle* handle = (_priv_AsyncIoLoopHandle*)m_handle;
+		if (!handle) {
+			return sl_null;
+		}
+		if (__atomic_load_n(&(handle->flagUringChecked), __ATOMIC_ACQUIRE)) {
+			return handle->uring;
+		}
+		ObjectLocker lock(this);
+		if (__atomic_load_n(&(handle->flagUringChecked), __ATOMIC_RELAXED)) {
+			return handle->uring;
+		}
+		_priv_IoUring* uring = _priv_IoUring::create(ASYNC_MAX_WAIT_EVENT);
+		if (uring) {
+			// completions are signaled through the eventfd, marked by the loop handle
+			epoll_event ev;
+			ev.data.ptr = (void*)handle;
+			ev.events = EPOLLIN | EPOLLET;
+			if (0 == epoll_ctl(handle->fdEpoll, EPOLL_CTL_ADD, uring->getEventHandle(), &ev)) {
+				handle->uring = uring;
+			} else {
+				delete uring;
+			}
+		}
+		// publishes `uring` to the threads checking the flag without the lock
+		__atomic_store_n(&(handle->flagUringChecked), sl_true, __ATOMIC_RELEASE);
+		return handle->uring;
+#else
+		return sl_null;
+#endif
+	}
+
 	sl_bool AsyncIoLoop::_native_attachInstance(AsyncIoInstance* instance, AsyncIoMode mode)
 	{
 		_priv_AsyncIoLoopHandle* handle = (_priv_AsyncIoLoopHandle*)m_handle;
@@ -84,7 +84,13 @@ namespace slib
 
 			_stepBegin();
 
-			int nEvents = ::kevent(handle->kq, sl_null, 0, waitEvents, ASYNC_MAX_WAIT_EVENT, NULL);
+			sl_int32 timeout = _getTimeout();
+			struct timespec ts;
+			if (timeout >= 0) {
+				ts.tv_sec = timeout / 1000;
+				ts.tv_nsec = (timeout % 1000) * 1000000;
+			}
+			int nEvents = ::kevent(handle->kq, sl_null, 0, waitEvents, ASYNC_MAX_WAIT_EVENT, timeout >= 0 ? &ts : NULL);
 			if (nEvents == 0) {
 				m_queueInstancesClosed.removeAll();
 			}
@@ -0,0 +1,572 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "async_uring.h"
+
+#if defined(ASYNC_USE_IO_URING)
+
+#include "slib/core/async.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/io_uring.h>
+
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#define PRIV_IO_URING_SUPPORTED
+#endif
+
+namespace slib
+{
+	
+#if defined(PRIV_IO_URING_SUPPORTED)
+	static int _priv_IoUring_setup(sl_uint32 entries, io_uring_params* params)
+	{
+		return (int)(::syscall(__NR_io_uring_setup, entries, params));
+	}
+	
+	static int _priv_IoUring_enter(int fd, sl_uint32 nSubmit, sl_uint32 nMinComplete, sl_uint32 flags)
+	{
+		return (int)(::syscall(__NR_io_uring_enter, fd, nSubmit, nMinComplete, flags, sl_null, 0));
+	}
+	
+	static int _priv_IoUring_register(int fd, sl_uint32 opcode, const void* arg, sl_uint32 nArgs)
+	{
+		return (int)(::syscall(__NR_io_uring_register, fd, opcode, arg, nArgs));
+	}
+	
+	// IORING_OP_READ and IORING_OP_WRITE need Linux 5.6, IORING_OP_ASYNC_CANCEL needs 5.5
+	static sl_bool _priv_IoUring_checkOperations(int fd)
+	{
+#if defined(IO_URING_OP_SUPPORTED)
+		sl_size size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+		io_uring_probe* probe = (io_uring_probe*)(Base::createZeroMemory(size));
+		if (!probe) {
+			return sl_false;
+		}
+		sl_bool flagSupported = sl_false;
+		// EINVAL before Linux 5.6
+		if (_priv_IoUring_register(fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+			flagSupported = sl_true;
+			sl_uint32 ops[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_ASYNC_CANCEL};
+			for (sl_size i = 0; i < CountOfArray(ops); i++) {
+				sl_uint32 op = ops[i];
+				if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+					flagSupported = sl_false;
+					break;
+				}
+			}
+		}
+		Base::freeMemory(probe);
+		return flagSupported;
+#else
+		return sl_false;
+#endif
+	}
+#endif
+	
+	_priv_IoUringOperation::_priv_IoUringOperation()
+	{
+		m_prevPending = sl_null;
+		m_nextPending = sl_null;
+	}
+
+	_priv_IoUring::_priv_IoUring()
+	{
+		m_fd = -1;
+		m_fdEvent = -1;
+		m_ptrSq = MAP_FAILED;
+		m_sizeSq = 0;
+		m_ptrCq = MAP_FAILED;
+		m_sizeCq = 0;
+		m_sqes = (io_uring_sqe*)MAP_FAILED;
+		m_sizeSqes = 0;
+		m_sqTailLocal = 0;
+		m_nPrepared = 0;
+		m_pendingFirst = sl_null;
+	}
+	
+	_priv_IoUring::~_priv_IoUring()
+	{
+		if ((void*)m_sqes != MAP_FAILED) {
+			::munmap(m_sqes, m_sizeSqes);
+		}
+		if (m_ptrCq != MAP_FAILED) {
+			::munmap(m_ptrCq, m_sizeCq);
+		}
+		if (m_ptrSq != MAP_FAILED) {
+			::munmap(m_ptrSq, m_sizeSq);
+		}
+		if (m_fd >= 0) {
+			::close(m_fd);
+		}
+		if (m_fdEvent >= 0) {
+			::close(m_fdEvent);
+		}
+	}
+	
+	_priv_IoUring* _priv_IoUring::create(sl_uint32 nEntries)
+	{
+#if defined(PRIV_IO_URING_SUPPORTED)
+		io_uring_params params;
+		Base::zeroMemory(&params, sizeof(params));
+		int fd = _priv_IoUring_setup(nEntries, &params);
+		if (fd < 0) {
+			// ENOSYS on old kernels, EPERM when disabled by seccomp or sysctl
+			return sl_null;
+		}
+		if (!(_priv_IoUring_checkOperations(fd))) {
+			::close(fd);
+			return sl_null;
+		}
+		_priv_IoUring* ret = new _priv_IoUring;
+		if (!ret) {
+			::close(fd);
+			return sl_null;
+		}
+		ret->m_fd = fd;
+		
+		ret->m_sizeSq = params.sq_off.array + params.sq_entries * sizeof(sl_uint32);
+		ret->m_ptrSq = ::mmap(sl_null, ret->m_sizeSq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		if (ret->m_ptrSq == MAP_FAILED) {
+			delete ret;
+			return sl_null;
+		}
+		ret->m_sizeCq = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		ret->m_ptrCq = ::mmap(sl_null, ret->m_sizeCq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (ret->m_ptrCq == MAP_FAILED) {
+			delete ret;
+			return sl_null;
+		}
+		ret->m_sizeSqes = params.sq_entries * sizeof(io_uring_sqe);
+		ret->m_sqes = (io_uring_sqe*)(::mmap(sl_null, ret->m_sizeSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+		if ((void*)(ret->m_sqes) == MAP_FAILED) {
+			delete ret;
+			return sl_null;
+		}
+		
+		sl_uint8* sq = (sl_uint8*)(ret->m_ptrSq);
+		ret->m_sqHead = (sl_uint32*)(sq + params.sq_off.head);
+		ret->m_sqTail = (sl_uint32*)(sq + params.sq_off.tail);
+		ret->m_sqMask = *((sl_uint32*)(sq + params.sq_off.ring_mask));
+		ret->m_sqEntries = *((sl_uint32*)(sq + params.sq_off.ring_entries));
+		ret->m_sqArray = (sl_uint32*)(sq + params.sq_off.array);
+		ret->m_sqTailLocal = *(ret->m_sqTail);
+		
+		sl_uint8* cq = (sl_uint8*)(ret->m_ptrCq);
+		ret->m_cqHead = (sl_uint32*)(cq + params.cq_off.head);
+		ret->m_cqTail = (sl_uint32*)(cq + params.cq_off.tail);
+		ret->m_cqMask = *((sl_uint32*)(cq + params.cq_off.ring_mask));
+		ret->m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+		
+		ret->m_fdEvent = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (ret->m_fdEvent < 0) {
+			delete ret;
+			return sl_null;
+		}
+		if (_priv_IoUring_register(fd, IORING_REGISTER_EVENTFD, &(ret->m_fdEvent), 1) != 0) {
+			delete ret;
+			return sl_null;
+		}
+		return ret;
+#else
+		return sl_null;
+#endif
+	}
+	
+	int _priv_IoUring::getEventHandle()
+	{
+		return m_fdEvent;
+	}
+	
+	io_uring_sqe* _priv_IoUring::_getSubmissionEntry()
+	{
+		sl_uint32 head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+		if (m_sqTailLocal - head >= m_sqEntries) {
+			submit();
+			head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+			if (m_sqTailLocal - head >= m_sqEntries) {
+				return sl_null;
+			}
+		}
+		sl_uint32 index = m_sqTailLocal & m_sqMask;
+		io_uring_sqe* sqe = m_sqes + index;
+		Base::zeroMemory(sqe, sizeof(io_uring_sqe));
+		m_sqArray[index] = index;
+		m_sqTailLocal++;
+		m_nPrepared++;
+		return sqe;
+	}
+	
+	sl_bool _priv_IoUring::prepareRead(int fd, void* data, sl_uint32 size, sl_uint64 offset, _priv_IoUringOperation* operation)
+	{
+		io_uring_sqe* sqe = _getSubmissionEntry();
+		if (sqe) {
+			sqe->opcode = IORING_OP_READ;
+			sqe->fd = fd;
+			sqe->addr = (sl_uint64)(sl_size)data;
+			sqe->len = size;
+			sqe->off = offset;
+			sqe->user_data = (sl_uint64)(sl_size)operation;
+			_addPending(operation);
+			return sl_true;
+		}
+		return sl_false;
+	}
+	
+	sl_bool _priv_IoUring::prepareWrite(int fd, const void* data, sl_uint32 size, sl_uint64 offset, _priv_IoUringOperation* operation)
+	{
+		io_uring_sqe* sqe = _getSubmissionEntry();
+		if (sqe) {
+			sqe->opcode = IORING_OP_WRITE;
+			sqe->fd = fd;
+			sqe->addr = (sl_uint64)(sl_size)data;
+			sqe->len = size;
+			sqe->off = offset;
+			sqe->user_data = (sl_uint64)(sl_size)operation;
+			_addPending(operation);
+			return sl_true;
+		}
+		return sl_false;
+	}
+	
+	sl_bool _priv_IoUring::prepareCancel(_priv_IoUringOperation* operation)
+	{
+		io_uring_sqe* sqe = _getSubmissionEntry();
+		if (sqe) {
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->fd = -1;
+			sqe->addr = (sl_uint64)(sl_size)operation;
+			// the completion of the cancel request itself is ignored
+			sqe->user_data = 0;
+			return sl_true;
+		}
+		return sl_false;
+	}
+	
+	void _priv_IoUring::submit()
+	{
+#if defined(PRIV_IO_URING_SUPPORTED)
+		if (!m_nPrepared) {
+			return;
+		}
+		__atomic_store_n(m_sqTail, m_sqTailLocal, __ATOMIC_RELEASE);
+		for (;;) {
+			int n = _priv_IoUring_enter(m_fd, m_nPrepared, 0, 0);
+			if (n >= 0) {
+				m_nPrepared -= SLIB_MIN((sl_uint32)n, m_nPrepared);
+				if (!n || !m_nPrepared) {
+					break;
+				}
+			} else if (errno != EINTR) {
+				break;
+			}
+		}
+#endif
+	}
+	
+	void _priv_IoUring::processCompletions()
+	{
+		sl_uint64 counter;
+		ssize_t nRead = ::read(m_fdEvent, &counter, sizeof(counter));
+		SLIB_UNUSED(nRead);
+		sl_uint32 head = *m_cqHead;
+		for (;;) {
+			sl_uint32 tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+			if (head == tail) {
+				break;
+			}
+			io_uring_cqe* cqe = m_cqes + (head & m_cqMask);
+			_priv_IoUringOperation* operation = (_priv_IoUringOperation*)(sl_size)(cqe->user_data);
+			sl_int32 result = cqe->res;
+			head++;
+			// release the entry before the callback, which may prepare new operations
+			__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+			if (operation) {
+				_removePending(operation);
+				operation->onIoUringComplete(result);
+			}
+		}
+	}
+	
+	void _priv_IoUring::cancelAll()
+	{
+#if defined(PRIV_IO_URING_SUPPORTED)
+		_priv_IoUringOperation* operation = m_pendingFirst;
+		while (operation) {
+			prepareCancel(operation);
+			operation = operation->m_nextPending;
+		}
+		submit();
+		// the kernel may still write into the buffers of the pending operations, and the operations hold their instances
+		while (m_pendingFirst) {
+			int n = _priv_IoUring_enter(m_fd, 0, 1, IORING_ENTER_GETEVENTS);
+			if (n < 0 && errno != EINTR) {
+				break;
+			}
+			processCompletions();
+		}
+#endif
+	}
+	
+	void _priv_IoUring::_addPending(_priv_IoUringOperation* operation)
+	{
+		operation->m_prevPending = sl_null;
+		operation->m_nextPending = m_pendingFirst;
+		if (m_pendingFirst) {
+			m_pendingFirst->m_prevPending = operation;
+		}
+		m_pendingFirst = operation;
+	}
+	
+	void _priv_IoUring::_removePending(_priv_IoUringOperation* operation)
+	{
+		if (operation->m_prevPending) {
+			operation->m_prevPending->m_nextPending = operation->m_nextPending;
+		} else if (m_pendingFirst == operation) {
+			m_pendingFirst = operation->m_nextPending;
+		}
+		if (operation->m_nextPending) {
+			operation->m_nextPending->m_prevPending = operation->m_prevPending;
+		}
+		operation->m_prevPending = sl_null;
+		operation->m_nextPending = sl_null;
+	}
+	
+	
+	class _priv_LinuxAsyncFileStreamInstance : public AsyncStreamInstance, public _priv_IoUringOperation
+	{
+	public:
+		Ref<File> m_file;
+		Ref<AsyncStreamRequest> m_requestOperating;
+		sl_uint64 m_offset;
+		
+	public:
+		_priv_LinuxAsyncFileStreamInstance()
+		{
+			m_offset = 0;
+		}
+		
+		~_priv_LinuxAsyncFileStreamInstance()
+		{
+			close();
+		}
+		
+	public:
+		static Ref<_priv_LinuxAsyncFileStreamInstance> open(const String& path, FileMode mode)
+		{
+			Ref<File> file = File::open(path, mode);
+			if (file.isNotNull()) {
+				Ref<_priv_LinuxAsyncFileStreamInstance> ret = new _priv_LinuxAsyncFileStreamInstance();
+				if (ret.isNotNull()) {
+					ret->m_file = file;
+					ret->setHandle(file->getHandle());
+					if (mode & FileMode::SeekToEnd) {
+						ret->m_offset = file->getSize();
+					}
+					return ret;
+				}
+			}
+			return sl_null;
+		}
+		
+		void close() override
+		{
+			setHandle(SLIB_FILE_INVALID_HANDLE);
+			if (m_requestOperating.isNotNull()) {
+				// the pending operation still uses the descriptor (it may not even be submitted yet),
+				// so the file is closed when the operation completes
+				_priv_IoUring* ring = _getRing();
+				if (ring) {
+					ring->prepareCancel(this);
+				}
+				return;
+			}
+			_closeFile();
+		}
+		
+		void onOrder() override
+		{
+			sl_file handle = getHandle();
+			if (handle == SLIB_FILE_INVALID_HANDLE) {
+				return;
+			}
+			if (m_requestOperating.isNotNull()) {
+				return;
+			}
+			_priv_IoUring* ring = _getRing();
+			Ref<AsyncStreamRequest> req;
+			if (popReadRequest(req)) {
+				if (req.isNotNull()) {
+					if (req->data && req->size) {
+						if (ring && ring->prepareRead((int)handle, req->data, req->size, m_offset, this)) {
+							_beginOperation(req);
+						} else {
+							_runCallback(req.get(), 0, sl_true);
+						}
+					} else {
+						_runCallback(req.get(), req->size, sl_false);
+					}
+				}
+				return;
+			}
+			if (popWriteRequest(req)) {
+				if (req.isNotNull()) {
+					if (req->data && req->size) {
+						if (ring && ring->prepareWrite((int)handle, req->data, req->size, m_offset, this)) {
+							_beginOperation(req);
+						} else {
+							_runCallback(req.get(), 0, sl_true);
+						}
+					} else {
+						_runCallback(req.get(), req->size, sl_false);
+					}
+				}
+			}
+		}
+		
+		void onEvent(EventDesc*) override
+		{
+		}
+		
+		void onIoUringComplete(sl_int32 result) override
+		{
+			// balances `increaseReference()` in `_beginOperation()`
+			Ref<_priv_LinuxAsyncFileStreamInstance> thiz = this;
+			decreaseReference();
+			Ref<AsyncStreamRequest> req = m_requestOperating;
+			m_requestOperating.setNull();
+			sl_uint32 size = 0;
+			sl_bool flagError = sl_false;
+			if (result >= 0) {
+				// 0: end of file, reported as a successful empty read like the other streams
+				size = (sl_uint32)result;
+				m_offset += size;
+			} else {
+				flagError = sl_true;
+			}
+			if (req.isNotNull()) {
+				_runCallback(req.get(), size, flagError);
+			}
+			if (isOpened()) {
+				requestOrder();
+			} else {
+				_closeFile();
+			}
+		}
+		
+		sl_bool isSeekable() override
+		{
+			return sl_true;
+		}
+		
+		sl_bool seek(sl_uint64 pos) override
+		{
+			m_offset = pos;
+			return sl_true;
+		}
+		
+		sl_uint64 getSize() override
+		{
+			Ref<File> file = m_file;
+			if (file.isNotNull()) {
+				return file->getSize();
+			}
+			return 0;
+		}
+		
+	protected:
+		_priv_IoUring* _getRing()
+		{
+			Ref<AsyncIoLoop> loop = getLoop();
+			if (loop.isNotNull()) {
+				return (_priv_IoUring*)(loop->_native_getIoUring());
+			}
+			return sl_null;
+		}
+		
+		void _closeFile()
+		{
+			Ref<File> file = m_file;
+			if (file.isNotNull()) {
+				file->close();
+			}
+		}
+		
+		void _beginOperation(const Ref<AsyncStreamRequest>& req)
+		{
+			m_requestOperating = req;
+			// keeps the instance alive until the completion is reaped
+			increaseReference();
+		}
+		
+		void _runCallback(AsyncStreamRequest* req, sl_uint32 size, sl_bool flagError)
+		{
+			Ref<AsyncIoObject> object = getObject();
+			if (object.isNotNull()) {
+				req->runCallback(static_cast<AsyncStream*>(object.get()), size, flagError);
+			}
+		}
+		
+	};
+	
+	Ref<AsyncStream> AsyncFile::openIoUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		if (loop.isNull() || !(loop->_native_getIoUring())) {
+			return sl_null;
+		}
+		Ref<_priv_LinuxAsyncFileStreamInstance> ret = _priv_LinuxAsyncFileStreamInstance::open(path, mode);
+		if (ret.isNotNull()) {
+			return AsyncStream::create(ret.get(), AsyncIoMode::None, loop);
+		}
+		return sl_null;
+	}
+	
+	Ref<AsyncStream> AsyncFile::openIoUring(const String& path, FileMode mode)
+	{
+		return AsyncFile::openIoUring(path, mode, AsyncIoLoop::getDefault());
+	}
+	
+}
+
+#elif defined(SLIB_PLATFORM_IS_LINUX)
+
+#include "slib/core/async.h"
+
+namespace slib
+{
+	
+	Ref<AsyncStream> AsyncFile::openIoUring(const String& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		return sl_null;
+	}
+	
+	Ref<AsyncStream> AsyncFile::openIoUring(const String& path, FileMode mode)
+	{
+		return sl_null;
+	}
+	
+}
+
+#endif
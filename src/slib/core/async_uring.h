@@ -0,0 +1,125 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_ASYNC_URING
+#define CHECKHEADER_SLIB_CORE_ASYNC_URING
+
+#include "async_config.h"
+
+#if defined(ASYNC_USE_IO_URING)
+
+#include "slib/core/definition.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace slib
+{
+	
+	class _priv_IoUringOperation
+	{
+	public:
+		_priv_IoUringOperation();
+		
+	public:
+		// `result` is the return value of the operation, or negative errno
+		virtual void onIoUringComplete(sl_int32 result) = 0;
+		
+	private:
+		// list of the pending operations of the ring
+		_priv_IoUringOperation* m_prevPending;
+		_priv_IoUringOperation* m_nextPending;
+		
+		friend class _priv_IoUring;
+	};
+	
+	// Submission and completion rings of io_uring, accessed only by the thread of an AsyncIoLoop
+	class _priv_IoUring
+	{
+	public:
+		_priv_IoUring();
+		
+		~_priv_IoUring();
+		
+	public:
+		// returns null when the kernel does not support io_uring, or the operations used here (read, write and cancel: Linux 5.6+)
+		static _priv_IoUring* create(sl_uint32 nEntries);
+		
+	public:
+		// completions are signaled to this eventfd
+		int getEventHandle();
+		
+		sl_bool prepareRead(int fd, void* data, sl_uint32 size, sl_uint64 offset, _priv_IoUringOperation* operation);
+		
+		sl_bool prepareWrite(int fd, const void* data, sl_uint32 size, sl_uint64 offset, _priv_IoUringOperation* operation);
+		
+		// requests the cancellation of the pending operation. `operation` still receives its completion
+		sl_bool prepareCancel(_priv_IoUringOperation* operation);
+		
+		// submits all the prepared operations by one system call
+		void submit();
+		
+		void processCompletions();
+		
+		// cancels the pending operations and waits until all of them are completed
+		void cancelAll();
+		
+	protected:
+		io_uring_sqe* _getSubmissionEntry();
+		
+		void _addPending(_priv_IoUringOperation* operation);
+		
+		void _removePending(_priv_IoUringOperation* operation);
+		
+	protected:
+		int m_fd;
+		int m_fdEvent;
+		
+		void* m_ptrSq;
+		sl_size m_sizeSq;
+		void* m_ptrCq;
+		sl_size m_sizeCq;
+		io_uring_sqe* m_sqes;
+		sl_size m_sizeSqes;
+		
+		sl_uint32* m_sqHead;
+		sl_uint32* m_sqTail;
+		sl_uint32 m_sqMask;
+		sl_uint32 m_sqEntries;
+		sl_uint32* m_sqArray;
+		sl_uint32 m_sqTailLocal;
+		sl_uint32 m_nPrepared;
+		
+		sl_uint32* m_cqHead;
+		sl_uint32* m_cqTail;
+		sl_uint32 m_cqMask;
+		io_uring_cqe* m_cqes;
+		
+		_priv_IoUringOperation* m_pendingFirst;
+		
+	};
+	
+}
+
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/cache.h"
+
+#include "slib/core/base.h"
+#include "slib/core/hash.h"
+
+#define PRIV_CACHE_SKETCH_MIN_WORDS 16
+#define PRIV_CACHE_SKETCH_MAX_WORDS (1 << 24)
+
+namespace slib
+{
+	
+	CacheParam::CacheParam() noexcept
+	{
+		eviction = CacheEviction::LRU;
+		capacity = 0;
+		timeToLive = 0;
+	}
+	
+	CacheParam::CacheParam(sl_size _capacity, CacheEviction _eviction, sl_uint32 _timeToLive) noexcept
+	{
+		eviction = _eviction;
+		capacity = _capacity;
+		timeToLive = _timeToLive;
+	}
+	
+	
+	CacheStatistics::CacheStatistics() noexcept
+	{
+		hits = 0;
+		misses = 0;
+		evictions = 0;
+		expirations = 0;
+	}
+	
+	CacheStatistics& CacheStatistics::operator+=(const CacheStatistics& other) noexcept
+	{
+		hits += other.hits;
+		misses += other.misses;
+		evictions += other.evictions;
+		expirations += other.expirations;
+		return *this;
+	}
+	
+	
+	CacheFrequencySketch::CacheFrequencySketch() noexcept
+	{
+		m_table = sl_null;
+		m_mask = 0;
+		m_size = 0;
+		m_sizeSample = 0;
+	}
+	
+	CacheFrequencySketch::~CacheFrequencySketch() noexcept
+	{
+		if (m_table) {
+			Base::freeMemory(m_table);
+		}
+	}
+	
+	void CacheFrequencySketch::ensureCapacity(sl_size count) noexcept
+	{
+		if (count < PRIV_CACHE_SKETCH_MIN_WORDS) {
+			count = PRIV_CACHE_SKETCH_MIN_WORDS;
+		} else if (count > PRIV_CACHE_SKETCH_MAX_WORDS) {
+			count = PRIV_CACHE_SKETCH_MAX_WORDS;
+		}
+		if (m_table && count <= m_mask + 1) {
+			return;
+		}
+		// one word (16 counters) per item
+		sl_size n = Math::roundUpToPowerOfTwo(count);
+		sl_uint64* table = (sl_uint64*)(Base::createMemory(n << 3));
+		if (!table) {
+			return;
+		}
+		Base::zeroMemory(table, n << 3);
+		if (m_table) {
+			Base::freeMemory(m_table);
+		}
+		m_table = table;
+		m_mask = n - 1;
+		m_size = 0;
+		m_sizeSample = n * 10;
+	}
+	
+	void CacheFrequencySketch::increment(sl_size hash) noexcept
+	{
+		if (!m_table) {
+			ensureCapacity(0);
+			if (!m_table) {
+				return;
+			}
+		}
+		sl_uint64 h = Rehash64(hash);
+		sl_bool flagAdded = sl_false;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			// 4 rows: the word is chosen by the upper bits and the counter by the lower bits
+			sl_uint64 x = Rehash64(h + i * SLIB_UINT64(0x9E3779B97F4A7C15));
+			sl_uint64& word = m_table[(sl_size)(x >> 4) & m_mask];
+			sl_uint32 shift = ((sl_uint32)x & 15) << 2;
+			if (((word >> shift) & 15) != 15) {
+				word += ((sl_uint64)1) << shift;
+				flagAdded = sl_true;
+			}
+		}
+		if (flagAdded) {
+			m_size++;
+			if (m_size >= m_sizeSample) {
+				// aging: halves all the counters
+				for (sl_size i = 0; i <= m_mask; i++) {
+					m_table[i] = (m_table[i] >> 1) & SLIB_UINT64(0x7777777777777777);
+				}
+				m_size >>= 1;
+			}
+		}
+	}
+	
+	sl_uint32 CacheFrequencySketch::estimate(sl_size hash) const noexcept
+	{
+		if (!m_table) {
+			return 0;
+		}
+		sl_uint64 h = Rehash64(hash);
+		sl_uint32 ret = 15;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint64 x = Rehash64(h + i * SLIB_UINT64(0x9E3779B97F4A7C15));
+			sl_uint64 word = m_table[(sl_size)(x >> 4) & m_mask];
+			sl_uint32 count = (sl_uint32)((word >> (((sl_uint32)x & 15) << 2)) & 15);
+			if (count < ret) {
+				ret = count;
+			}
+		}
+		return ret;
+	}
+	
+	void CacheFrequencySketch::clear() noexcept
+	{
+		if (m_table) {
+			Base::zeroMemory(m_table, (m_mask + 1) << 3);
+		}
+		m_size = 0;
+	}
+	
+}
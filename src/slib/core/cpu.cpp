@@ -0,0 +1,178 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <cpuid.h>
+#	endif
+#endif
+
+namespace slib
+{
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+
+#define PRIV_CPU_SSE2 0x0001
+#define PRIV_CPU_SSSE3 0x0002
+#define PRIV_CPU_SSE41 0x0004
+#define PRIV_CPU_SSE42 0x0008
+#define PRIV_CPU_AVX2 0x0010
+#define PRIV_CPU_AESNI 0x0020
+#define PRIV_CPU_PCLMUL 0x0040
+#define PRIV_CPU_SHA 0x0080
+
+	static void _priv_Cpu_cpuid(sl_uint32 leaf, sl_uint32 subleaf, sl_uint32 regs[4])
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+		int r[4];
+		__cpuidex(r, (int)leaf, (int)subleaf);
+		regs[0] = (sl_uint32)(r[0]);
+		regs[1] = (sl_uint32)(r[1]);
+		regs[2] = (sl_uint32)(r[2]);
+		regs[3] = (sl_uint32)(r[3]);
+#else
+		unsigned int a, b, c, d;
+		__cpuid_count(leaf, subleaf, a, b, c, d);
+		regs[0] = a;
+		regs[1] = b;
+		regs[2] = c;
+		regs[3] = d;
+#endif
+	}
+
+	static sl_uint64 _priv_Cpu_xgetbv()
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+		return (sl_uint64)(_xgetbv(0));
+#else
+		sl_uint32 a, d;
+		__asm__ volatile ("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+		return ((sl_uint64)d << 32) | a;
+#endif
+	}
+
+	static sl_uint32 _priv_Cpu_detectFeatures()
+	{
+		sl_uint32 features = 0;
+		sl_uint32 regs[4];
+		_priv_Cpu_cpuid(0, 0, regs);
+		sl_uint32 nMaxLeaf = regs[0];
+		if (nMaxLeaf < 1) {
+			return 0;
+		}
+		_priv_Cpu_cpuid(1, 0, regs);
+		sl_uint32 ecx = regs[2];
+		sl_uint32 edx = regs[3];
+		if (edx & (1 << 26)) {
+			features |= PRIV_CPU_SSE2;
+		}
+		if (ecx & (1 << 9)) {
+			features |= PRIV_CPU_SSSE3;
+		}
+		if (ecx & (1 << 19)) {
+			features |= PRIV_CPU_SSE41;
+		}
+		if (ecx & (1 << 20)) {
+			features |= PRIV_CPU_SSE42;
+		}
+		if (ecx & (1 << 25)) {
+			features |= PRIV_CPU_AESNI;
+		}
+		if (ecx & (1 << 1)) {
+			features |= PRIV_CPU_PCLMUL;
+		}
+		// AVX registers should be enabled by the OS
+		sl_bool flagAVX = sl_false;
+		if ((ecx & (1 << 27)) && (ecx & (1 << 28))) {
+			flagAVX = (_priv_Cpu_xgetbv() & 6) == 6;
+		}
+		if (nMaxLeaf >= 7) {
+			_priv_Cpu_cpuid(7, 0, regs);
+			if (flagAVX && (regs[1] & (1 << 5))) {
+				features |= PRIV_CPU_AVX2;
+			}
+			if (regs[1] & (1 << 29)) {
+				features |= PRIV_CPU_SHA;
+			}
+		}
+		return features;
+	}
+
+	static sl_uint32 _priv_Cpu_getFeatures()
+	{
+		static sl_uint32 features = _priv_Cpu_detectFeatures();
+		return features;
+	}
+
+#define PRIV_CPU_CHECK(FEATURE) return (_priv_Cpu_getFeatures() & FEATURE) != 0;
+
+#else
+
+#define PRIV_CPU_CHECK(FEATURE) return sl_false;
+
+#endif
+
+	sl_bool Cpu::isSSE2Supported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_SSE2)
+	}
+
+	sl_bool Cpu::isSSSE3Supported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_SSSE3)
+	}
+
+	sl_bool Cpu::isSSE41Supported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_SSE41)
+	}
+
+	sl_bool Cpu::isSSE42Supported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_SSE42)
+	}
+
+	sl_bool Cpu::isAVX2Supported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_AVX2)
+	}
+
+	sl_bool Cpu::isAESNISupported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_AESNI)
+	}
+
+	sl_bool Cpu::isPCLMULSupported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_PCLMUL)
+	}
+
+	sl_bool Cpu::isSHASupported()
+	{
+		PRIV_CPU_CHECK(PRIV_CPU_SHA)
+	}
+
+}
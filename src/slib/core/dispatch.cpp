@@ -26,6 +26,8 @@
 #include "slib/core/safe_static.h"
 #include "slib/core/system.h"
 
+#define PRIV_DISPATCH_MAX_TASKS_PER_STEP 4096
+
 namespace slib
 {
 
@@ -92,10 +94,11 @@ namespace slib
 
 	SLIB_DEFINE_OBJECT(DispatchLoop, Dispatcher)
 
-	DispatchLoop::DispatchLoop()
+	DispatchLoop::DispatchLoop(sl_uint32 timerResolution): m_timeTasks(timerResolution)
 	{
 		m_flagInit = sl_false;
 		m_flagRunning = sl_false;
+		m_flagWakingTasks = 0;
 	}
 
 	DispatchLoop::~DispatchLoop()
@@ -120,9 +123,9 @@ namespace slib
 		}
 	}
 
-	Ref<DispatchLoop> DispatchLoop::create(sl_bool flagAutoStart)
+	Ref<DispatchLoop> DispatchLoop::create(sl_bool flagAutoStart, sl_uint32 timerResolution)
 	{
-		Ref<DispatchLoop> ret = new DispatchLoop;
+		Ref<DispatchLoop> ret = new DispatchLoop(timerResolution);
 		if (ret.isNotNull()) {
 			ret->m_thread = Thread::create(SLIB_FUNCTION_CLASS(DispatchLoop, _runLoop, ret.get()));
 			if (ret->m_thread.isNotNull()) {
@@ -154,6 +157,7 @@ namespace slib
 		
 		MutexLocker lockTime(&m_lockTimeTasks);
 		m_timeTasks.removeAll();
+		m_mapTimers.removeAll_NoLock();
 	}
 
 	void DispatchLoop::start()
@@ -188,20 +192,11 @@ namespace slib
 	sl_int32 DispatchLoop::_getTimeout()
 	{
 		m_timeCounter.update();
-		sl_int32 t1 = _getTimeout_TimeTasks();
-		sl_int32 t2 = _getTimeout_Timer();
+		sl_int32 t = _getTimeout_TimeTasks();
 		if (m_queueTasks.isNotEmpty()) {
 			return 0;
 		}
-		if (t1 < 0) {
-			return t2;
-		} else {
-			if (t2 < 0) {
-				return t1;
-			} else {
-				return SLIB_MIN(t1, t2);
-			}
-		}
+		return t;
 	}
 
 	sl_bool DispatchLoop::dispatch(const Function<void()>& task, sl_uint64 delay_ms)
@@ -211,15 +206,16 @@ namespace slib
 		}
 		if (delay_ms == 0) {
 			if (m_queueTasks.push(task)) {
-				_wake();
+				// one wakeup covers a burst of tasks
+				if (Base::interlockedCompareExchange32(&m_flagWakingTasks, 1, 0)) {
+					_wake();
+				}
 				return sl_true;
 			}
 		} else {
 			MutexLocker lock(&m_lockTimeTasks);
-			TimeTask tt;
-			tt.time = getElapsedMilliseconds() + delay_ms;
-			tt.task = task;
-			if (m_timeTasks.add(tt.time, tt)) {
+			if (m_timeTasks.add(getElapsedMilliseconds() + delay_ms, task)) {
+				lock.unlock();
 				_wake();
 				return sl_true;
 			}
@@ -229,78 +225,58 @@ namespace slib
 
 	sl_int32 DispatchLoop::_getTimeout_TimeTasks()
 	{
-		MutexLocker lock(&m_lockTimeTasks);
-		sl_uint64 rel = getElapsedMilliseconds();
-		if (m_timeTasks.getCount() == 0) {
-			return -1;
-		}
-		sl_int32 timeout = -1;
-		LinkedQueue< Function<void()> > tasks;
-		while (MapNode<sl_uint64, TimeTask>* node = m_timeTasks.getFirstNode()) {
-			if (rel >= node->key) {
-				tasks.push(node->value.task);
-				m_timeTasks.removeAt(node);
-			} else {
-				timeout = (sl_int32)(node->key - rel);
-				break;
+		List< Function<void()> > tasks;
+		{
+			MutexLocker lock(&m_lockTimeTasks);
+			if (m_timeTasks.isEmpty()) {
+				return -1;
 			}
+			m_timeTasks.advance(getElapsedMilliseconds(), tasks);
 		}
-		lock.unlock();
-
-		Function<void()> task;
-		while (tasks.pop(&task)) {
-			task();
+		
+		ListElements< Function<void()> > list(tasks);
+		for (sl_size i = 0; i < list.count; i++) {
+			list.data[i]();
+		}
+		
+		MutexLocker lock(&m_lockTimeTasks);
+		sl_int64 timeout = m_timeTasks.getTimeout(getElapsedMilliseconds());
+		if (timeout > 0x7fffffff) {
+			timeout = 0x7fffffff;
 		}
-		return timeout;
+		return (sl_int32)timeout;
 	}
 
-	sl_int32 DispatchLoop::_getTimeout_Timer()
+	void DispatchLoop::_runTimer(const WeakRef<Timer>& _timer)
 	{
-		MutexLocker lock(&m_lockTimer);
-
-		sl_int32 timeout = -1;
-		LinkedQueue< Ref<Timer> > tasks;
-
-		sl_uint64 rel = getElapsedMilliseconds();
-		Link<TimerTask>* link = m_queueTimers.getFront();
-		while (link) {
-			Ref<Timer> timer(link->value.timer);
-			if (timer.isNotNull()) {
-				if (timer->isStarted()) {
-					sl_uint64 t = rel - timer->getLastRunTime();
-					if (t >= timer->getInterval()) {
-						tasks.push(timer);
-						timer->setLastRunTime(rel);
-						t = timer->getInterval();
-					} else {
-						t = timer->getInterval() - t;
-					}
-					if (timeout < 0 || t < (sl_uint64)timeout) {
-						timeout = (sl_uint32)t;
-					}
-				}
-				link = link->next;
+		Ref<Timer> timer(_timer);
+		if (timer.isNull()) {
+			return;
+		}
+		sl_uint64 now;
+		{
+			MutexLocker lock(&m_lockTimeTasks);
+			sl_uint64 id;
+			if (!(m_mapTimers.get_NoLock(timer.get(), &id))) {
+				// removed
+				return;
+			}
+			if (m_timeTasks.contains(id)) {
+				// restarted after this run was scheduled
+				return;
+			}
+			now = getElapsedMilliseconds();
+			id = m_timeTasks.add(now + timer->getInterval(), SLIB_BIND_WEAKREF(void(), DispatchLoop, _runTimer, this, _timer));
+			if (id) {
+				m_mapTimers.put_NoLock(timer.get(), id);
 			} else {
-				Link<TimerTask>* linkRemove = link;
-				link = link->next;
-				m_queueTimers.removeAt(linkRemove);
+				m_mapTimers.remove_NoLock(timer.get());
 			}
 		}
-
-		lock.unlock();
-
-		Ref<Timer> task;
-		while (tasks.pop(&task)) {
-			if (task.isNotNull()) {
-				task->run();
-			}
+		if (timer->isStarted()) {
+			timer->setLastRunTime(now);
+			timer->run();
 		}
-		return timeout;
-	}
-
-	sl_bool DispatchLoop::TimerTask::operator==(const DispatchLoop::TimerTask& other) const
-	{
-		return timer == other.timer;
 	}
 
 	sl_bool DispatchLoop::addTimer(const Ref<Timer>& timer)
@@ -308,23 +284,30 @@ namespace slib
 		if (timer.isNull()) {
 			return sl_false;
 		}
-		TimerTask t;
-		t.timer = timer;
-		MutexLocker lock(&m_lockTimer);
-		if (m_queueTimers.push(t)) {
-			_wake();
-			return sl_true;
-		} else {
-			return sl_false;
+		MutexLocker lock(&m_lockTimeTasks);
+		sl_uint64 id;
+		if (m_mapTimers.get_NoLock(timer.get(), &id)) {
+			m_timeTasks.cancel(id);
 		}
+		id = m_timeTasks.add(getElapsedMilliseconds() + timer->getInterval(), SLIB_BIND_WEAKREF(void(), DispatchLoop, _runTimer, this, WeakRef<Timer>(timer)));
+		if (id) {
+			if (m_mapTimers.put_NoLock(timer.get(), id)) {
+				lock.unlock();
+				_wake();
+				return sl_true;
+			}
+			m_timeTasks.cancel(id);
+		}
+		return sl_false;
 	}
 
 	void DispatchLoop::removeTimer(const Ref<Timer>& timer)
 	{
-		MutexLocker lock(&m_lockTimer);
-		TimerTask t;
-		t.timer = timer;
-		m_queueTimers.remove(t);
+		MutexLocker lock(&m_lockTimeTasks);
+		sl_uint64 id;
+		if (m_mapTimers.remove_NoLock(timer.get(), &id)) {
+			m_timeTasks.cancel(id);
+		}
 	}
 
 	sl_uint64 DispatchLoop::getElapsedMilliseconds()
@@ -338,12 +321,14 @@ namespace slib
 
 			// Async Tasks
 			{
-				LinkedQueue< Function<void()> > tasks;
-				tasks.merge(&m_queueTasks);
+				// the tasks pushed from now on wake the loop again
+				Base::interlockedCompareExchange32(&m_flagWakingTasks, 0, 1);
+				// bounded, so that the tasks posting themselves again do not starve the timers
 				Function<void()> task;
-				while (tasks.pop_NoLock(&task)) {
+				for (sl_uint32 i = 0; i < PRIV_DISPATCH_MAX_TASKS_PER_STEP && m_queueTasks.pop(&task); i++) {
 					task();
 				}
+				task.setNull();
 			}
 			
 			sl_int32 t = _getTimeout();
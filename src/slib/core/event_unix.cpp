@@ -28,6 +28,13 @@
 #include <time.h>
 #include <sys/time.h>
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#define PRIV_EVENT_USE_FUTEX
+#endif
+
 #include "slib/core/event.h"
 
 #include "slib/core/thread.h"
@@ -35,6 +42,114 @@
 namespace slib
 {
 
+#if defined(PRIV_EVENT_USE_FUTEX)
+
+	class _priv_FutexEvent : public Event
+	{
+	public:
+		// 1: signaled, 0: not signaled
+		sl_int32 m_state;
+		sl_int32 m_nWaiters;
+		sl_bool m_flagAutoReset;
+
+		_priv_FutexEvent()
+		{
+		}
+
+		~_priv_FutexEvent()
+		{
+		}
+
+		static Ref<_priv_FutexEvent> create(sl_bool flagAutoReset)
+		{
+			Ref<_priv_FutexEvent> ret = new _priv_FutexEvent;
+			if (ret.isNotNull()) {
+				ret->m_state = 0;
+				ret->m_nWaiters = 0;
+				ret->m_flagAutoReset = flagAutoReset;
+			}
+			return ret;
+		}
+
+		static sl_int64 _getMonotonicTime()
+		{
+			struct timespec t;
+			clock_gettime(CLOCK_MONOTONIC, &t);
+			return (sl_int64)(t.tv_sec) * 1000000000 + t.tv_nsec;
+		}
+
+		sl_bool _tryConsume()
+		{
+			if (m_flagAutoReset) {
+				sl_int32 expected = 1;
+				return __atomic_compare_exchange_n(&m_state, &expected, 0, sl_false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+			} else {
+				return __atomic_load_n(&m_state, __ATOMIC_ACQUIRE) != 0;
+			}
+		}
+
+		void _native_set() override
+		{
+			__atomic_store_n(&m_state, 1, __ATOMIC_SEQ_CST);
+			// no system call when nobody is waiting
+			if (__atomic_load_n(&m_nWaiters, __ATOMIC_SEQ_CST) > 0) {
+				syscall(SYS_futex, &m_state, FUTEX_WAKE_PRIVATE, m_flagAutoReset ? 1 : 0x7fffffff, sl_null, sl_null, 0);
+			}
+		}
+
+		void _native_reset() override
+		{
+			__atomic_store_n(&m_state, 0, __ATOMIC_RELEASE);
+		}
+
+		sl_bool _native_wait(sl_int32 timeout) override
+		{
+			if (_tryConsume()) {
+				return sl_true;
+			}
+			sl_int64 tEnd = 0;
+			if (timeout >= 0) {
+				tEnd = _getMonotonicTime() + (sl_int64)timeout * 1000000;
+			}
+			for (;;) {
+				if (Thread::isStoppingCurrent()) {
+					break;
+				}
+				struct timespec to;
+				struct timespec* pTimeout = sl_null;
+				if (timeout >= 0) {
+					sl_int64 t = tEnd - _getMonotonicTime();
+					if (t <= 0) {
+						return _tryConsume();
+					}
+					to.tv_sec = (time_t)(t / 1000000000);
+					to.tv_nsec = (long)(t % 1000000000);
+					pTimeout = &to;
+				}
+				__atomic_add_fetch(&m_nWaiters, 1, __ATOMIC_SEQ_CST);
+				if (!(__atomic_load_n(&m_state, __ATOMIC_SEQ_CST))) {
+					// returns immediately if the state has been changed after the check
+					syscall(SYS_futex, &m_state, FUTEX_WAIT_PRIVATE, 0, pTimeout, sl_null, 0);
+				}
+				__atomic_sub_fetch(&m_nWaiters, 1, __ATOMIC_SEQ_CST);
+				if (_tryConsume()) {
+					return sl_true;
+				}
+			}
+			if (m_flagAutoReset) {
+				__atomic_store_n(&m_state, 0, __ATOMIC_RELEASE);
+			}
+			return sl_true;
+		}
+	};
+
+	Ref<Event> Event::create(sl_bool flagAutoReset)
+	{
+		return _priv_FutexEvent::create(flagAutoReset);
+	}
+
+#else
+
 	class _priv_UnixEvent : public Event
 	{
 	public:
@@ -144,6 +259,8 @@ namespace slib
 		return _priv_UnixEvent::create(flagAutoReset);
 	}
 
+#endif
+
 }
 
 #endif
@@ -24,40 +24,87 @@
 #include "slib/core/hash_table.h"
 
 #include "slib/core/math.h"
+#include "slib/core/mio.h"
 
 namespace slib
 {
 
 	/****************************************************
 	 
-		Fowler–Noll–Vo hash function / FNV-1a hash
+		wyhash (final version 4)
 	 
-	 https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
-	 http://www.isthe.com/chongo/tech/comp/fnv/index.html
+	 https://github.com/wangyi-fudan/wyhash
+	 
+	 Reads 8 bytes at a time and mixes with 64x64->128 bit multiplication,
+	 keys up to 16 bytes are hashed without loop.
 	 
 	****************************************************/
-	sl_uint32 HashBytes32(const void* _buf, sl_size n) noexcept
-	{
-		sl_uint8* buf = (sl_uint8*)_buf;
-		sl_uint32 hash = 0x811c9dc5;
-		sl_uint32 prime = 16777619;
-		for (sl_size i = 0; i < n; i++) {
-			hash ^= buf[i];
-			hash *= prime;
-		}
-		return hash;
+	
+	#define PRIV_SLIB_HASH_SECRET0 SLIB_UINT64(0xa0761d6478bd642f)
+	#define PRIV_SLIB_HASH_SECRET1 SLIB_UINT64(0xe7037ed1a0b428db)
+	#define PRIV_SLIB_HASH_SECRET2 SLIB_UINT64(0x8ebc6af09c88c6e3)
+	#define PRIV_SLIB_HASH_SECRET3 SLIB_UINT64(0x589965cc75374cc3)
+	
+	SLIB_INLINE static sl_uint64 _priv_HashBytes_mix(sl_uint64 a, sl_uint64 b) noexcept
+	{
+		sl_uint64 high, low;
+		Math::mul64(a, b, high, low);
+		return high ^ low;
+	}
+	
+	SLIB_INLINE static sl_uint64 _priv_HashBytes_read3(const sl_uint8* p, sl_size n) noexcept
+	{
+		return (((sl_uint64)(p[0])) << 16) | (((sl_uint64)(p[n >> 1])) << 8) | p[n - 1];
 	}
 	
 	sl_uint64 HashBytes64(const void* _buf, sl_size n) noexcept
 	{
-		sl_uint8* buf = (sl_uint8*)_buf;
-		sl_uint64 hash = SLIB_UINT64(0xcbf29ce484222325);
-		sl_uint64 prime = SLIB_UINT64(1099511628211);
-		for (sl_size i = 0; i < n; i++) {
-			hash ^= buf[i];
-			hash *= prime;
+		const sl_uint8* p = (const sl_uint8*)_buf;
+		sl_uint64 seed = _priv_HashBytes_mix(PRIV_SLIB_HASH_SECRET0, PRIV_SLIB_HASH_SECRET1);
+		sl_uint64 a, b;
+		if (n <= 16) {
+			if (n >= 4) {
+				sl_size k = (n >> 3) << 2;
+				a = (((sl_uint64)(MIO::readUint32LE(p))) << 32) | MIO::readUint32LE(p + k);
+				b = (((sl_uint64)(MIO::readUint32LE(p + n - 4))) << 32) | MIO::readUint32LE(p + n - 4 - k);
+			} else if (n) {
+				a = _priv_HashBytes_read3(p, n);
+				b = 0;
+			} else {
+				a = b = 0;
+			}
+		} else {
+			sl_size i = n;
+			if (i > 48) {
+				sl_uint64 see1 = seed;
+				sl_uint64 see2 = seed;
+				do {
+					seed = _priv_HashBytes_mix(MIO::readUint64LE(p) ^ PRIV_SLIB_HASH_SECRET1, MIO::readUint64LE(p + 8) ^ seed);
+					see1 = _priv_HashBytes_mix(MIO::readUint64LE(p + 16) ^ PRIV_SLIB_HASH_SECRET2, MIO::readUint64LE(p + 24) ^ see1);
+					see2 = _priv_HashBytes_mix(MIO::readUint64LE(p + 32) ^ PRIV_SLIB_HASH_SECRET3, MIO::readUint64LE(p + 40) ^ see2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= see1 ^ see2;
+			}
+			while (i > 16) {
+				seed = _priv_HashBytes_mix(MIO::readUint64LE(p) ^ PRIV_SLIB_HASH_SECRET1, MIO::readUint64LE(p + 8) ^ seed);
+				p += 16;
+				i -= 16;
+			}
+			a = MIO::readUint64LE(p + i - 16);
+			b = MIO::readUint64LE(p + i - 8);
 		}
-		return hash;
+		a ^= PRIV_SLIB_HASH_SECRET1;
+		b ^= seed;
+		Math::mul64(a, b, b, a);
+		return _priv_HashBytes_mix(a ^ PRIV_SLIB_HASH_SECRET0 ^ (sl_uint64)n, b ^ PRIV_SLIB_HASH_SECRET1);
+	}
+	
+	sl_uint32 HashBytes32(const void* buf, sl_size n) noexcept
+	{
+		sl_uint64 h = HashBytes64(buf, n);
+		return (sl_uint32)(h ^ (h >> 32));
 	}
 	
 	sl_size HashBytes(const void* buf, sl_size n) noexcept
@@ -28,8 +28,11 @@
 #include "slib/core/map.h"
 
 #include "slib/core/file.h"
+#include "slib/core/mapped_file.h"
 #include "slib/core/log.h"
 
+#include "text_scan.h"
+
 namespace slib
 {
 	
@@ -362,6 +365,12 @@ namespace slib
 		sl_bool flagLineComment = sl_false;
 		sl_bool flagBlockComment = sl_false;
 		while (pos < len) {
+			if (!flagLineComment && !flagBlockComment) {
+				pos = (sl_size)(_priv_TextScan_skipWhiteSpaces(buf + pos, buf + len) - buf);
+				if (pos >= len) {
+					break;
+				}
+			}
 			sl_bool flagEscape = sl_false;
 			CT ch = buf[pos];
 			if (flagSupportComments) {
@@ -410,6 +419,13 @@ namespace slib
 		
 		// string
 		if (first == '"' || first == '\'') {
+			// strings without escape sequences are copied directly
+			const CT* end = _priv_TextScan_findStringSpecial(buf + pos + 1, buf + len, first);
+			if (end < buf + len && *end == first) {
+				sl_size start = pos + 1;
+				pos = (sl_size)(end - buf) + 1;
+				return ST(buf + start, pos - start - 1);
+			}
 			sl_size m = 0;
 			sl_bool f = sl_false;
 			ST str = ParseUtil::parseBackslashEscapes(buf + pos, len - pos, &m, &f);
@@ -519,14 +535,20 @@ namespace slib
 					pos++;
 					return map;
 				} else if (ch == '"' || ch == '\'') {
-					sl_size m = 0;
-					sl_bool f = sl_false;
-					key = ParseUtil::parseBackslashEscapes(buf + pos, len - pos, &m, &f);
-					pos += m;
-					if (f) {
-						flagError = sl_true;
-						errorMessage = "Object Item Name: Missing terminating character \" or ' ";
-						return sl_null;
+					const CT* end = _priv_TextScan_findStringSpecial(buf + pos + 1, buf + len, ch);
+					if (end < buf + len && *end == ch) {
+						key = ST(buf + pos + 1, end - buf - pos - 1);
+						pos = (sl_size)(end - buf) + 1;
+					} else {
+						sl_size m = 0;
+						sl_bool f = sl_false;
+						key = ParseUtil::parseBackslashEscapes(buf + pos, len - pos, &m, &f);
+						pos += m;
+						if (f) {
+							flagError = sl_true;
+							errorMessage = "Object Item Name: Missing terminating character \" or ' ";
+							return sl_null;
+						}
 					}
 				} else {
 					sl_size s = pos;
@@ -709,6 +731,21 @@ namespace slib
 
 	Json Json::parseJsonFromTextFile(const String& filePath, JsonParseParam& param)
 	{
+		// UTF-8 text is parsed directly on the mapped file
+		Memory mem = MappedFile::mapAllBytes(filePath);
+		if (mem.isNotNull()) {
+			sl_char8* data = (sl_char8*)(mem.getData());
+			sl_size size = mem.getSize();
+			if (size >= 2 && (((sl_uint8)(data[0]) == 0xFF && (sl_uint8)(data[1]) == 0xFE) || ((sl_uint8)(data[0]) == 0xFE && (sl_uint8)(data[1]) == 0xFF))) {
+				String16 json = String16::fromUtf(data, size);
+				return parseJson16(json, param);
+			}
+			if (size >= 3 && (sl_uint8)(data[0]) == 0xEF && (sl_uint8)(data[1]) == 0xBB && (sl_uint8)(data[2]) == 0xBF) {
+				data += 3;
+				size -= 3;
+			}
+			return parseJson(data, size, param);
+		}
 		String16 json = File::readAllText16(filePath);
 		return parseJson16(json, param);
 	}
@@ -0,0 +1,524 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/json_reader.h"
+
+#include "slib/core/io.h"
+#include "slib/core/async.h"
+#include "slib/core/parse.h"
+#include "slib/core/log.h"
+
+#include "text_scan.h"
+
+#define PRIV_JSON_READER_STATE_VALUE 0
+#define PRIV_JSON_READER_STATE_ARRAY_FIRST 1
+#define PRIV_JSON_READER_STATE_OBJECT_FIRST 2
+#define PRIV_JSON_READER_STATE_OBJECT_KEY 3
+#define PRIV_JSON_READER_STATE_COLON 4
+#define PRIV_JSON_READER_STATE_COMMA 5
+#define PRIV_JSON_READER_STATE_DONE 6
+
+namespace slib
+{
+	
+	JsonReaderParam::JsonReaderParam()
+	{
+		flagSupportComments = sl_true;
+		flagLogError = sl_true;
+	}
+	
+	JsonReaderParam::~JsonReaderParam()
+	{
+	}
+	
+	
+	SLIB_DEFINE_OBJECT(JsonReader, Object)
+	
+	JsonReader::JsonReader()
+	{
+		m_state = PRIV_JSON_READER_STATE_VALUE;
+		m_sizePending = 0;
+		m_position = 0;
+		m_flagError = sl_false;
+		m_flagStopped = sl_false;
+	}
+	
+	JsonReader::~JsonReader()
+	{
+	}
+	
+	Ref<JsonReader> JsonReader::create(const JsonReaderParam& param)
+	{
+		Ref<JsonReader> ret = new JsonReader;
+		if (ret.isNotNull()) {
+			ret->m_param = param;
+			return ret;
+		}
+		return sl_null;
+	}
+	
+	sl_bool JsonReader::put(const void* _data, sl_size size)
+	{
+		if (m_flagError || m_flagStopped) {
+			return sl_false;
+		}
+		if (!size) {
+			return sl_true;
+		}
+		const sl_char8* data = (const sl_char8*)_data;
+		if (m_sizePending) {
+			// the last token was split between the chunks
+			sl_size total = m_sizePending + size;
+			if (total > m_bufPending.getSize()) {
+				sl_size capacity = m_bufPending.getSize() << 1;
+				if (capacity < total) {
+					capacity = total;
+				}
+				Memory mem = Memory::create(capacity);
+				if (mem.isNull()) {
+					_setError("Out of memory");
+					return sl_false;
+				}
+				Base::copyMemory(mem.getData(), m_bufPending.getData(), m_sizePending);
+				m_bufPending = mem;
+			}
+			sl_char8* buf = (sl_char8*)(m_bufPending.getData());
+			Base::copyMemory(buf + m_sizePending, data, size);
+			sl_size n = _parse(buf, total, sl_false);
+			m_position += n;
+			m_sizePending = total - n;
+			if (n && m_sizePending) {
+				Base::moveMemory(buf, buf + n, m_sizePending);
+			}
+		} else {
+			sl_size n = _parse(data, size, sl_false);
+			m_position += n;
+			if (n < size && !m_flagError && !m_flagStopped) {
+				sl_size sizeRemain = size - n;
+				if (sizeRemain > m_bufPending.getSize()) {
+					m_bufPending = Memory::create(sizeRemain < 1024 ? 1024 : sizeRemain);
+					if (m_bufPending.isNull()) {
+						_setError("Out of memory");
+						return sl_false;
+					}
+				}
+				Base::copyMemory(m_bufPending.getData(), data + n, sizeRemain);
+				m_sizePending = sizeRemain;
+			}
+		}
+		return !(m_flagError || m_flagStopped);
+	}
+	
+	sl_bool JsonReader::end()
+	{
+		if (m_flagError || m_flagStopped) {
+			return sl_false;
+		}
+		if (m_sizePending) {
+			sl_size n = _parse((sl_char8*)(m_bufPending.getData()), m_sizePending, sl_true);
+			m_position += n;
+			m_sizePending = 0;
+			if (m_flagError || m_flagStopped) {
+				return sl_false;
+			}
+		}
+		if (m_state != PRIV_JSON_READER_STATE_DONE) {
+			_setError("Unexpected end of input");
+			return sl_false;
+		}
+		return sl_true;
+	}
+	
+	sl_bool JsonReader::read(IReader* reader, sl_size sizeChunk)
+	{
+		if (!sizeChunk) {
+			sizeChunk = 16384;
+		}
+		Memory mem = Memory::create(sizeChunk);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		void* buf = mem.getData();
+		for (;;) {
+			sl_reg n = reader->read(buf, sizeChunk);
+			if (n <= 0) {
+				break;
+			}
+			if (!(put(buf, n))) {
+				return sl_false;
+			}
+		}
+		return end();
+	}
+	
+	sl_bool JsonReader::read(const Ref<AsyncStream>& stream, const Function<void(JsonReader*, sl_bool flagSuccess)>& onComplete, sl_uint32 sizeChunk)
+	{
+		if (stream.isNull()) {
+			return sl_false;
+		}
+		if (!sizeChunk) {
+			sizeChunk = 16384;
+		}
+		Memory mem = Memory::create(sizeChunk);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		_readStream(stream, mem, onComplete);
+		return sl_true;
+	}
+	
+	void JsonReader::_readStream(const Ref<AsyncStream>& stream, const Memory& buf, const Function<void(JsonReader*, sl_bool flagSuccess)>& onComplete)
+	{
+		Ref<JsonReader> thiz = this;
+		sl_bool flagRequested = stream->readToMemory(buf, [thiz, buf, onComplete](AsyncStreamResult* result) {
+			if (!(result->flagError) && result->size) {
+				if (thiz->put(result->data, result->size)) {
+					thiz->_readStream(result->stream, buf, onComplete);
+				} else {
+					onComplete(thiz.get(), sl_false);
+				}
+			} else {
+				onComplete(thiz.get(), result->flagError ? sl_false : thiz->end());
+			}
+		});
+		if (!flagRequested) {
+			onComplete(this, sl_false);
+		}
+	}
+	
+	void JsonReader::reset()
+	{
+		m_state = PRIV_JSON_READER_STATE_VALUE;
+		m_stack.setNull();
+		m_sizePending = 0;
+		m_position = 0;
+		m_flagError = sl_false;
+		m_flagStopped = sl_false;
+		m_errorMessage.setNull();
+	}
+	
+	void JsonReader::stop()
+	{
+		m_flagStopped = sl_true;
+	}
+	
+	sl_bool JsonReader::isError()
+	{
+		return m_flagError;
+	}
+	
+	String JsonReader::getErrorMessage()
+	{
+		return m_errorMessage;
+	}
+	
+	sl_uint64 JsonReader::getPosition()
+	{
+		return m_position;
+	}
+	
+	sl_size JsonReader::getDepth()
+	{
+		return m_stack.getCount();
+	}
+	
+	sl_bool JsonReader::parse(const void* data, sl_size size, const JsonReaderParam& param)
+	{
+		Ref<JsonReader> reader = create(param);
+		if (reader.isNotNull()) {
+			if (reader->put(data, size)) {
+				return reader->end();
+			}
+		}
+		return sl_false;
+	}
+	
+	sl_bool JsonReader::parse(const String& json, const JsonReaderParam& param)
+	{
+		return parse(json.getData(), json.getLength(), param);
+	}
+	
+	// returns the number of processed bytes, leaving the incomplete token at the end
+	sl_size JsonReader::_parse(const sl_char8* buf, sl_size len, sl_bool flagEnd)
+	{
+		sl_size pos = 0;
+		while (pos < len) {
+			if (m_flagError || m_flagStopped) {
+				return pos;
+			}
+			sl_char8 ch = buf[pos];
+			if (SLIB_CHAR_IS_WHITE_SPACE(ch)) {
+				pos = (sl_size)(_priv_TextScan_skipWhiteSpaces(buf + pos + 1, buf + len) - buf);
+				continue;
+			}
+			if (ch == '/' && m_param.flagSupportComments) {
+				if (pos + 1 >= len) {
+					if (flagEnd) {
+						_setError("Invalid token");
+					}
+					return pos;
+				}
+				sl_char8 next = buf[pos + 1];
+				if (next == '/') {
+					sl_size i = pos + 2;
+					while (i < len && buf[i] != '\r' && buf[i] != '\n') {
+						i++;
+					}
+					if (i >= len && !flagEnd) {
+						return pos;
+					}
+					pos = i;
+					continue;
+				} else if (next == '*') {
+					sl_size i = pos + 3;
+					while (i < len && !(buf[i] == '/' && buf[i - 1] == '*')) {
+						i++;
+					}
+					if (i >= len) {
+						if (flagEnd) {
+							_setError("Comment: Missing */");
+						}
+						return pos;
+					}
+					pos = i + 1;
+					continue;
+				}
+			}
+			switch (m_state) {
+				case PRIV_JSON_READER_STATE_DONE:
+					_setError("Invalid token after the end of JSON value");
+					return pos;
+				case PRIV_JSON_READER_STATE_COLON:
+					if (ch != ':') {
+						_setError("Object: Missing character : ");
+						return pos;
+					}
+					pos++;
+					m_state = PRIV_JSON_READER_STATE_VALUE;
+					break;
+				case PRIV_JSON_READER_STATE_COMMA:
+				{
+					sl_bool flagObject = sl_false;
+					m_stack.getAt_NoLock(m_stack.getCount() - 1, &flagObject);
+					if (ch == ',') {
+						pos++;
+						m_state = flagObject ? PRIV_JSON_READER_STATE_OBJECT_KEY : PRIV_JSON_READER_STATE_VALUE;
+					} else if (ch == (flagObject ? '}' : ']')) {
+						pos++;
+						m_stack.popBack_NoLock();
+						if (flagObject) {
+							m_param.onEndObject(this);
+						} else {
+							m_param.onEndArray(this);
+						}
+						_completeValue();
+					} else {
+						_setError(flagObject ? "Object: Missing character , " : "Array: Missing character ] ");
+						return pos;
+					}
+					break;
+				}
+				case PRIV_JSON_READER_STATE_OBJECT_FIRST:
+				case PRIV_JSON_READER_STATE_OBJECT_KEY:
+					if (ch == '}') {
+						pos++;
+						m_stack.popBack_NoLock();
+						m_param.onEndObject(this);
+						_completeValue();
+					} else if (ch == '"' || ch == '\'') {
+						if (!(_parseString(buf, len, pos, flagEnd, sl_true))) {
+							return pos;
+						}
+						m_state = PRIV_JSON_READER_STATE_COLON;
+					} else {
+						if (!(_parseKeyIdentifier(buf, len, pos, flagEnd))) {
+							return pos;
+						}
+						m_state = PRIV_JSON_READER_STATE_COLON;
+					}
+					break;
+				default:
+					// value
+					if (ch == '{') {
+						pos++;
+						m_stack.add_NoLock(sl_true);
+						m_state = PRIV_JSON_READER_STATE_OBJECT_FIRST;
+						m_param.onStartObject(this);
+					} else if (ch == '[') {
+						pos++;
+						m_stack.add_NoLock(sl_false);
+						m_state = PRIV_JSON_READER_STATE_ARRAY_FIRST;
+						m_param.onStartArray(this);
+					} else if (ch == ']' && m_stack.getCount()) {
+						// empty array, or trailing comma
+						sl_bool flagObject = sl_false;
+						m_stack.getAt_NoLock(m_stack.getCount() - 1, &flagObject);
+						if (flagObject) {
+							_setError("Object: Missing Item value");
+							return pos;
+						}
+						pos++;
+						m_stack.popBack_NoLock();
+						m_param.onEndArray(this);
+						_completeValue();
+					} else if (ch == '"' || ch == '\'') {
+						if (!(_parseString(buf, len, pos, flagEnd, sl_false))) {
+							return pos;
+						}
+						_completeValue();
+					} else {
+						if (!(_parsePrimitive(buf, len, pos, flagEnd))) {
+							return pos;
+						}
+						_completeValue();
+					}
+					break;
+			}
+		}
+		return pos;
+	}
+	
+	sl_bool JsonReader::_parseString(const sl_char8* buf, sl_size len, sl_size& pos, sl_bool flagEnd, sl_bool flagKey)
+	{
+		sl_char8 quote = buf[pos];
+		sl_size start = pos + 1;
+		sl_size i = start;
+		sl_bool flagEscaped = sl_false;
+		for (;;) {
+			if (i < len) {
+				i = (sl_size)(_priv_TextScan_findAny(buf + i, buf + len, quote, '\\') - buf);
+			}
+			if (i >= len) {
+				if (flagEnd) {
+					_setError(flagKey ? "Object Item Name: Missing terminating character \" or ' " : "String: Missing character  \" or ' ");
+				}
+				return sl_false;
+			}
+			sl_char8 ch = buf[i];
+			if (ch == quote) {
+				break;
+			}
+			if (ch == '\\') {
+				flagEscaped = sl_true;
+				i += 2;
+			} else {
+				i++;
+			}
+		}
+		const Function<void(JsonReader*, const sl_char8*, sl_size)>& callback = flagKey ? m_param.onKey : m_param.onString;
+		if (flagEscaped) {
+			if (callback.isNotNull()) {
+				sl_bool flagError = sl_false;
+				String str = ParseUtil::parseBackslashEscapes(buf + pos, i + 1 - pos, sl_null, &flagError);
+				if (flagError) {
+					_setError("String: Invalid escape sequence");
+					return sl_false;
+				}
+				callback(this, str.getData(), str.getLength());
+			}
+		} else {
+			callback(this, buf + start, i - start);
+		}
+		pos = i + 1;
+		return sl_true;
+	}
+	
+	sl_bool JsonReader::_parseKeyIdentifier(const sl_char8* buf, sl_size len, sl_size& pos, sl_bool flagEnd)
+	{
+		sl_size start = pos;
+		sl_size i = pos;
+		while (i < len) {
+			sl_char8 ch = buf[i];
+			if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '_' || (i != start && ch >= '0' && ch <= '9')) {
+				i++;
+			} else {
+				break;
+			}
+		}
+		if (i >= len) {
+			if (flagEnd) {
+				_setError("Object: Missing character : ");
+			}
+			return sl_false;
+		}
+		if (i == start) {
+			_setError("Object: Invalid Item Name");
+			return sl_false;
+		}
+		m_param.onKey(this, buf + start, i - start);
+		pos = i;
+		return sl_true;
+	}
+	
+	sl_bool JsonReader::_parsePrimitive(const sl_char8* buf, sl_size len, sl_size& pos, sl_bool flagEnd)
+	{
+		sl_size start = pos;
+		sl_size i = pos;
+		while (i < len) {
+			sl_char8 ch = buf[i];
+			if (SLIB_CHAR_IS_WHITE_SPACE(ch) || ch == ',' || ch == ']' || ch == '}' || ch == '/' || ch == ':') {
+				break;
+			}
+			i++;
+		}
+		if (i >= len && !flagEnd) {
+			return sl_false;
+		}
+		sl_size n = i - start;
+		const sl_char8* s = buf + start;
+		if (n == 4 && Base::equalsMemory(s, "null", 4)) {
+			m_param.onNull(this);
+		} else if (n == 4 && Base::equalsMemory(s, "true", 4)) {
+			m_param.onBoolean(this, sl_true);
+		} else if (n == 5 && Base::equalsMemory(s, "false", 5)) {
+			m_param.onBoolean(this, sl_false);
+		} else {
+			double f;
+			if (!n || String::parseDouble(&f, s, 0, n) != (sl_reg)n) {
+				_setError("Invalid token");
+				return sl_false;
+			}
+			m_param.onNumber(this, s, n);
+		}
+		pos = i;
+		return sl_true;
+	}
+	
+	void JsonReader::_completeValue()
+	{
+		if (m_stack.getCount()) {
+			m_state = PRIV_JSON_READER_STATE_COMMA;
+		} else {
+			m_state = PRIV_JSON_READER_STATE_DONE;
+		}
+	}
+	
+	void JsonReader::_setError(const char* message)
+	{
+		m_flagError = sl_true;
+		m_errorMessage = message;
+		if (m_param.flagLogError) {
+			LogError("JsonReader", "%s (position: %d)", m_errorMessage, m_position);
+		}
+	}
+	
+}
@@ -0,0 +1,648 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/json_view.h"
+
+#include "slib/core/parse.h"
+
+#include "text_scan.h"
+
+namespace slib
+{
+	
+	static const sl_char8* _priv_JsonView_skipSpace(const sl_char8* p, const sl_char8* end)
+	{
+		while (p < end) {
+			sl_char8 ch = *p;
+			if (SLIB_CHAR_IS_WHITE_SPACE(ch)) {
+				p = _priv_TextScan_skipWhiteSpaces(p + 1, end);
+			} else if (ch == '/' && p + 1 < end) {
+				if (p[1] == '/') {
+					p += 2;
+					while (p < end && *p != '\r' && *p != '\n') {
+						p++;
+					}
+				} else if (p[1] == '*') {
+					p += 3;
+					while (p < end && !(*p == '/' && p[-1] == '*')) {
+						p++;
+					}
+					if (p < end) {
+						p++;
+					}
+				} else {
+					break;
+				}
+			} else {
+				break;
+			}
+		}
+		return p;
+	}
+	
+	// returns the position after the closing quote
+	static const sl_char8* _priv_JsonView_skipString(const sl_char8* p, const sl_char8* end, sl_bool* flagEscaped = sl_null)
+	{
+		sl_char8 quote = *p;
+		p++;
+		while (p < end) {
+			p = _priv_TextScan_findAny(p, end, quote, '\\');
+			if (p >= end) {
+				break;
+			}
+			sl_char8 ch = *p;
+			if (ch == quote) {
+				return p + 1;
+			}
+			if (ch == '\\') {
+				if (flagEscaped) {
+					*flagEscaped = sl_true;
+				}
+				p += 2;
+			} else {
+				p++;
+			}
+		}
+		return sl_null;
+	}
+	
+	static const sl_char8* _priv_JsonView_skipPrimitive(const sl_char8* p, const sl_char8* end)
+	{
+		while (p < end) {
+			sl_char8 ch = *p;
+			if (SLIB_CHAR_IS_WHITE_SPACE(ch) || ch == ',' || ch == ']' || ch == '}' || ch == '/' || ch == ':') {
+				break;
+			}
+			p++;
+		}
+		return p;
+	}
+	
+	static const sl_char8* _priv_JsonView_skipIdentifier(const sl_char8* p, const sl_char8* end)
+	{
+		const sl_char8* start = p;
+		while (p < end) {
+			sl_char8 ch = *p;
+			if ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z') || ch == '_' || (p != start && ch >= '0' && ch <= '9')) {
+				p++;
+			} else {
+				break;
+			}
+		}
+		return p;
+	}
+	
+	// returns the position after the value
+	static const sl_char8* _priv_JsonView_skipValue(const sl_char8* p, const sl_char8* end)
+	{
+		if (p >= end) {
+			return sl_null;
+		}
+		sl_char8 ch = *p;
+		if (ch == '"' || ch == '\'') {
+			return _priv_JsonView_skipString(p, end);
+		}
+		if (ch != '{' && ch != '[') {
+			const sl_char8* e = _priv_JsonView_skipPrimitive(p, end);
+			return e == p ? sl_null : e;
+		}
+		sl_size depth = 0;
+		while (p < end) {
+			p = _priv_TextScan_findJsonStructural(p, end);
+			if (p >= end) {
+				break;
+			}
+			ch = *p;
+			if (ch == '"' || ch == '\'') {
+				p = _priv_JsonView_skipString(p, end);
+				if (!p) {
+					return sl_null;
+				}
+				continue;
+			}
+			if (ch == '/') {
+				const sl_char8* e = _priv_JsonView_skipSpace(p, end);
+				if (e != p) {
+					p = e;
+					continue;
+				}
+			} else if (ch == '{' || ch == '[') {
+				depth++;
+			} else if (ch == '}' || ch == ']') {
+				depth--;
+				if (!depth) {
+					return p + 1;
+				}
+			}
+			p++;
+		}
+		return sl_null;
+	}
+	
+	// `callback(key, keyEnd, value)` returns `sl_false` to stop
+	template <class CALLBACK>
+	static void _priv_JsonView_iterate(const sl_char8* p, const sl_char8* end, const CALLBACK& callback)
+	{
+		if (p >= end) {
+			return;
+		}
+		sl_bool flagObject = *p == '{';
+		if (!flagObject && *p != '[') {
+			return;
+		}
+		p++;
+		for (;;) {
+			p = _priv_JsonView_skipSpace(p, end);
+			if (p >= end) {
+				return;
+			}
+			const sl_char8* key = sl_null;
+			const sl_char8* keyEnd = sl_null;
+			if (flagObject) {
+				if (*p == '}') {
+					return;
+				}
+				key = p;
+				if (*p == '"' || *p == '\'') {
+					keyEnd = _priv_JsonView_skipString(p, end);
+					if (!keyEnd) {
+						return;
+					}
+				} else {
+					keyEnd = _priv_JsonView_skipIdentifier(p, end);
+					if (keyEnd == p) {
+						return;
+					}
+				}
+				p = _priv_JsonView_skipSpace(keyEnd, end);
+				if (p >= end || *p != ':') {
+					return;
+				}
+				p = _priv_JsonView_skipSpace(p + 1, end);
+			} else {
+				if (*p == ']') {
+					return;
+				}
+			}
+			if (!(callback(key, keyEnd, p))) {
+				return;
+			}
+			p = _priv_JsonView_skipValue(p, end);
+			if (!p) {
+				return;
+			}
+			p = _priv_JsonView_skipSpace(p, end);
+			if (p >= end || *p != ',') {
+				return;
+			}
+			p++;
+		}
+	}
+	
+	static sl_bool _priv_JsonView_equalsKey(const sl_char8* key, const sl_char8* keyEnd, const sl_char8* str, sl_size len)
+	{
+		sl_char8 ch = *key;
+		if (ch == '"' || ch == '\'') {
+			key++;
+			keyEnd--;
+			sl_size n = keyEnd - key;
+			if (n == len && Base::equalsMemory(key, str, len)) {
+				return sl_true;
+			}
+			// decode only when escape sequences are present
+			if (Base::findMemory(key, '\\', n)) {
+				String s = ParseUtil::parseBackslashEscapes(key - 1, n + 2);
+				return s.getLength() == len && Base::equalsMemory(s.getData(), str, len);
+			}
+			return sl_false;
+		}
+		return (sl_size)(keyEnd - key) == len && Base::equalsMemory(key, str, len);
+	}
+	
+	static sl_bool _priv_JsonView_parseNumber(const sl_char8* str, sl_size len, sl_int32* _out)
+	{
+		return String::parseInt32(10, _out, str, 0, len) == (sl_reg)len;
+	}
+	
+	static sl_bool _priv_JsonView_parseNumber(const sl_char8* str, sl_size len, sl_uint32* _out)
+	{
+		return String::parseUint32(10, _out, str, 0, len) == (sl_reg)len;
+	}
+	
+	static sl_bool _priv_JsonView_parseNumber(const sl_char8* str, sl_size len, sl_int64* _out)
+	{
+		return String::parseInt64(10, _out, str, 0, len) == (sl_reg)len;
+	}
+	
+	static sl_bool _priv_JsonView_parseNumber(const sl_char8* str, sl_size len, sl_uint64* _out)
+	{
+		return String::parseUint64(10, _out, str, 0, len) == (sl_reg)len;
+	}
+	
+	static sl_bool _priv_JsonView_parseNumber(const sl_char8* str, sl_size len, float* _out)
+	{
+		return String::parseFloat(_out, str, 0, len) == (sl_reg)len;
+	}
+	
+	static sl_bool _priv_JsonView_parseNumber(const sl_char8* str, sl_size len, double* _out)
+	{
+		return String::parseDouble(_out, str, 0, len) == (sl_reg)len;
+	}
+	
+	JsonView::JsonView(): m_data(sl_null), m_end(sl_null)
+	{
+	}
+	
+	JsonView::JsonView(const sl_char8* data, sl_size size): m_data(data), m_end(data + size)
+	{
+		m_data = _priv_JsonView_skipSpace(m_data, m_end);
+	}
+	
+	JsonView::JsonView(const sl_char8* data, sl_size size, Referable* ref): m_data(data), m_end(data + size), m_ref(ref)
+	{
+		m_data = _priv_JsonView_skipSpace(m_data, m_end);
+	}
+	
+	JsonView::JsonView(const Memory& mem): m_data((const sl_char8*)(mem.getData())), m_end(m_data + mem.getSize()), m_ref(mem.ref)
+	{
+		m_data = _priv_JsonView_skipSpace(m_data, m_end);
+	}
+	
+	JsonView::JsonView(const JsonView& other) = default;
+	
+	JsonView::JsonView(JsonView&& other) = default;
+	
+	JsonView::~JsonView()
+	{
+	}
+	
+	JsonView& JsonView::operator=(const JsonView& other) = default;
+	
+	JsonView& JsonView::operator=(JsonView&& other) = default;
+	
+	JsonView JsonView::operator[](sl_size index) const
+	{
+		return getElement(index);
+	}
+	
+	JsonView JsonView::operator[](const String& key) const
+	{
+		return getItem(key.getData(), key.getLength());
+	}
+	
+	JsonView JsonView::operator[](const sl_char8* key) const
+	{
+		return getItem(key);
+	}
+	
+	JsonValueType JsonView::getType() const
+	{
+		if (m_data >= m_end) {
+			return JsonValueType::Invalid;
+		}
+		sl_char8 ch = *m_data;
+		sl_size n = m_end - m_data;
+		switch (ch) {
+			case '{':
+				return JsonValueType::Object;
+			case '[':
+				return JsonValueType::Array;
+			case '"':
+			case '\'':
+				return JsonValueType::String;
+			case 'n':
+				if (n >= 4 && Base::equalsMemory(m_data, "null", 4)) {
+					return JsonValueType::Null;
+				}
+				break;
+			case 't':
+				if (n >= 4 && Base::equalsMemory(m_data, "true", 4)) {
+					return JsonValueType::Boolean;
+				}
+				break;
+			case 'f':
+				if (n >= 5 && Base::equalsMemory(m_data, "false", 5)) {
+					return JsonValueType::Boolean;
+				}
+				break;
+			default:
+				if ((ch >= '0' && ch <= '9') || ch == '-' || ch == '+' || ch == '.') {
+					return JsonValueType::Number;
+				}
+				break;
+		}
+		return JsonValueType::Invalid;
+	}
+	
+	sl_bool JsonView::isValid() const
+	{
+		return getType() != JsonValueType::Invalid;
+	}
+	
+	sl_bool JsonView::isNull() const
+	{
+		JsonValueType type = getType();
+		return type == JsonValueType::Null || type == JsonValueType::Invalid;
+	}
+	
+	sl_bool JsonView::isNotNull() const
+	{
+		return !(isNull());
+	}
+	
+	sl_bool JsonView::isBoolean() const
+	{
+		return getType() == JsonValueType::Boolean;
+	}
+	
+	sl_bool JsonView::isNumber() const
+	{
+		return getType() == JsonValueType::Number;
+	}
+	
+	sl_bool JsonView::isString() const
+	{
+		return getType() == JsonValueType::String;
+	}
+	
+	sl_bool JsonView::isArray() const
+	{
+		return getType() == JsonValueType::Array;
+	}
+	
+	sl_bool JsonView::isObject() const
+	{
+		return getType() == JsonValueType::Object;
+	}
+	
+	sl_size JsonView::getElementsCount() const
+	{
+		sl_size n = 0;
+		_priv_JsonView_iterate(m_data, m_end, [&n](const sl_char8*, const sl_char8*, const sl_char8*) {
+			n++;
+			return sl_true;
+		});
+		return n;
+	}
+	
+	JsonView JsonView::getElement(sl_size index) const
+	{
+		const sl_char8* value = sl_null;
+		sl_size n = 0;
+		_priv_JsonView_iterate(m_data, m_end, [&](const sl_char8*, const sl_char8*, const sl_char8* p) {
+			if (n == index) {
+				value = p;
+				return sl_false;
+			}
+			n++;
+			return sl_true;
+		});
+		if (value) {
+			return JsonView(value, m_end - value, m_ref.get());
+		}
+		return JsonView();
+	}
+	
+	List<JsonView> JsonView::getElements() const
+	{
+		List<JsonView> ret;
+		_priv_JsonView_iterate(m_data, m_end, [&](const sl_char8*, const sl_char8*, const sl_char8* p) {
+			ret.add_NoLock(JsonView(p, m_end - p, m_ref.get()));
+			return sl_true;
+		});
+		return ret;
+	}
+	
+	JsonView JsonView::getItem(const sl_char8* key, sl_size lenKey) const
+	{
+		if (m_data >= m_end || *m_data != '{') {
+			return JsonView();
+		}
+		const sl_char8* value = sl_null;
+		_priv_JsonView_iterate(m_data, m_end, [&](const sl_char8* k, const sl_char8* kEnd, const sl_char8* p) {
+			if (_priv_JsonView_equalsKey(k, kEnd, key, lenKey)) {
+				value = p;
+				return sl_false;
+			}
+			return sl_true;
+		});
+		if (value) {
+			return JsonView(value, m_end - value, m_ref.get());
+		}
+		return JsonView();
+	}
+	
+	JsonView JsonView::getItem(const sl_char8* key) const
+	{
+		return getItem(key, Base::getStringLength(key));
+	}
+	
+	JsonView JsonView::getItem(const String& key) const
+	{
+		return getItem(key.getData(), key.getLength());
+	}
+	
+	List< Pair<JsonView, JsonView> > JsonView::getItems() const
+	{
+		List< Pair<JsonView, JsonView> > ret;
+		if (m_data >= m_end || *m_data != '{') {
+			return ret;
+		}
+		_priv_JsonView_iterate(m_data, m_end, [&](const sl_char8* k, const sl_char8* kEnd, const sl_char8* p) {
+			ret.add_NoLock(JsonView(k, kEnd - k, m_ref.get()), JsonView(p, m_end - p, m_ref.get()));
+			return sl_true;
+		});
+		return ret;
+	}
+	
+	const sl_char8* JsonView::getRawData() const
+	{
+		return m_data;
+	}
+	
+	sl_size JsonView::getRawLength() const
+	{
+		const sl_char8* e = _priv_JsonView_skipValue(m_data, m_end);
+		if (e) {
+			return e - m_data;
+		}
+		return 0;
+	}
+	
+	String JsonView::getRawString() const
+	{
+		return String(m_data, getRawLength());
+	}
+	
+	sl_bool JsonView::getStringSlice(const sl_char8** data, sl_size* length, sl_bool* flagEscaped) const
+	{
+		if (m_data >= m_end) {
+			return sl_false;
+		}
+		if (*m_data == '"' || *m_data == '\'') {
+			sl_bool f = sl_false;
+			const sl_char8* e = _priv_JsonView_skipString(m_data, m_end, &f);
+			if (e) {
+				if (data) {
+					*data = m_data + 1;
+				}
+				if (length) {
+					*length = e - m_data - 2;
+				}
+				if (flagEscaped) {
+					*flagEscaped = f;
+				}
+				return sl_true;
+			}
+			return sl_false;
+		}
+		// identifier keys
+		const sl_char8* e = _priv_JsonView_skipIdentifier(m_data, m_end);
+		if (e != m_data && getType() == JsonValueType::Invalid) {
+			if (data) {
+				*data = m_data;
+			}
+			if (length) {
+				*length = e - m_data;
+			}
+			if (flagEscaped) {
+				*flagEscaped = sl_false;
+			}
+			return sl_true;
+		}
+		return sl_false;
+	}
+	
+	sl_bool JsonView::equalsString(const sl_char8* str, sl_size length) const
+	{
+		if (m_data >= m_end) {
+			return sl_false;
+		}
+		const sl_char8* e;
+		if (*m_data == '"' || *m_data == '\'') {
+			e = _priv_JsonView_skipString(m_data, m_end);
+		} else {
+			e = _priv_JsonView_skipIdentifier(m_data, m_end);
+		}
+		if (!e || e == m_data) {
+			return sl_false;
+		}
+		return _priv_JsonView_equalsKey(m_data, e, str, length);
+	}
+	
+	String JsonView::getString(const String& def) const
+	{
+		const sl_char8* data;
+		sl_size len;
+		sl_bool flagEscaped;
+		if (getStringSlice(&data, &len, &flagEscaped)) {
+			if (flagEscaped) {
+				return ParseUtil::parseBackslashEscapes(data - 1, len + 2);
+			}
+			return String(data, len);
+		}
+		switch (getType()) {
+			case JsonValueType::Boolean:
+			case JsonValueType::Number:
+				return getRawString();
+			default:
+				break;
+		}
+		return def;
+	}
+	
+	String JsonView::getString() const
+	{
+		return getString(String::null());
+	}
+	
+#define PRIV_JSON_VIEW_DEFINE_GET_NUMBER(TYPE, NAME) \
+	TYPE JsonView::get##NAME(TYPE def) const \
+	{ \
+		const sl_char8* data = m_data; \
+		sl_size len = 0; \
+		switch (getType()) { \
+			case JsonValueType::Number: \
+				len = _priv_JsonView_skipPrimitive(m_data, m_end) - m_data; \
+				break; \
+			case JsonValueType::String: \
+				getStringSlice(&data, &len); \
+				break; \
+			case JsonValueType::Boolean: \
+				return (TYPE)(*m_data == 't' ? 1 : 0); \
+			default: \
+				return def; \
+		} \
+		TYPE value; \
+		if (len && _priv_JsonView_parseNumber(data, len, &value)) { \
+			return value; \
+		} \
+		double f; \
+		if (len && String::parseDouble(&f, data, 0, len) == (sl_reg)len) { \
+			return (TYPE)f; \
+		} \
+		return def; \
+	}
+	
+	PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_int32, Int32)
+	PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_uint32, Uint32)
+	PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_int64, Int64)
+	PRIV_JSON_VIEW_DEFINE_GET_NUMBER(sl_uint64, Uint64)
+	PRIV_JSON_VIEW_DEFINE_GET_NUMBER(float, Float)
+	PRIV_JSON_VIEW_DEFINE_GET_NUMBER(double, Double)
+	
+	sl_bool JsonView::getBoolean(sl_bool def) const
+	{
+		switch (getType()) {
+			case JsonValueType::Boolean:
+				return *m_data == 't';
+			case JsonValueType::Number:
+				return getDouble() != 0;
+			case JsonValueType::String:
+				{
+					const sl_char8* data;
+					sl_size len;
+					getStringSlice(&data, &len);
+					sl_bool value;
+					if (String::parseBoolean(&value, data, 0, len) == (sl_reg)len) {
+						return value;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+		return def;
+	}
+	
+	Json JsonView::toJson() const
+	{
+		sl_size len = getRawLength();
+		if (len) {
+			JsonParseParam param;
+			param.flagLogError = sl_false;
+			return Json::parseJson(m_data, len, param);
+		}
+		return sl_null;
+	}
+	
+}
@@ -0,0 +1,609 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#include "slib/core/json_writer.h"
+
+#include "slib/core/io.h"
+#include "slib/core/memory.h"
+#include "slib/core/base.h"
+
+#include "text_scan.h"
+
+namespace slib
+{
+	
+	static const char _priv_JsonWriter_digitPairs[201] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+	
+	// writes the digits backward from `end`, returns the first position
+	static sl_char8* _priv_JsonWriter_formatUint64(sl_char8* end, sl_uint64 value)
+	{
+		sl_char8* p = end;
+		while (value >= 100) {
+			sl_uint32 k = (sl_uint32)(value % 100);
+			value /= 100;
+			p -= 2;
+			p[0] = _priv_JsonWriter_digitPairs[k << 1];
+			p[1] = _priv_JsonWriter_digitPairs[(k << 1) + 1];
+		}
+		if (value >= 10) {
+			sl_uint32 k = (sl_uint32)value;
+			p -= 2;
+			p[0] = _priv_JsonWriter_digitPairs[k << 1];
+			p[1] = _priv_JsonWriter_digitPairs[(k << 1) + 1];
+		} else {
+			*(--p) = (sl_char8)('0' + value);
+		}
+		return p;
+	}
+	
+	static sl_char8* _priv_JsonWriter_formatInt64(sl_char8* end, sl_int64 value)
+	{
+		if (value < 0) {
+			sl_char8* p = _priv_JsonWriter_formatUint64(end, (sl_uint64)(-(value + 1)) + 1);
+			*(--p) = '-';
+			return p;
+		} else {
+			return _priv_JsonWriter_formatUint64(end, (sl_uint64)value);
+		}
+	}
+	
+	
+	JsonWriter::JsonWriter(IWriter* writer, sl_size sizeChunk): m_writer(writer), m_buffer(sl_null)
+	{
+		_init(sizeChunk);
+	}
+	
+	JsonWriter::JsonWriter(MemoryBuffer* buffer, sl_size sizeChunk): m_writer(sl_null), m_buffer(buffer)
+	{
+		_init(sizeChunk);
+	}
+	
+	JsonWriter::JsonWriter(const Function<sl_bool(const Memory&)>& onChunk, sl_size sizeChunk): m_writer(sl_null), m_buffer(sl_null), m_onChunk(onChunk)
+	{
+		_init(sizeChunk);
+	}
+	
+	JsonWriter::~JsonWriter()
+	{
+		flush();
+	}
+	
+	void JsonWriter::_init(sl_size sizeChunk)
+	{
+		if (sizeChunk < 64) {
+			sizeChunk = 64;
+		}
+		m_sizeChunk = sizeChunk;
+		m_data = sl_null;
+		m_pos = 0;
+		m_sizeWritten = 0;
+		m_flagNeedComma = sl_false;
+		m_flagError = sl_false;
+	}
+	
+	sl_bool JsonWriter::beginObject()
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		m_flagNeedComma = sl_false;
+		return _appendChar('{');
+	}
+	
+	sl_bool JsonWriter::endObject()
+	{
+		m_flagNeedComma = sl_true;
+		return _appendChar('}');
+	}
+	
+	sl_bool JsonWriter::beginArray()
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		m_flagNeedComma = sl_false;
+		return _appendChar('[');
+	}
+	
+	sl_bool JsonWriter::endArray()
+	{
+		m_flagNeedComma = sl_true;
+		return _appendChar(']');
+	}
+	
+	sl_bool JsonWriter::writeKey(const sl_char8* key, sl_size length)
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		if (!(_appendEscapedString(key, length))) {
+			return sl_false;
+		}
+		m_flagNeedComma = sl_false;
+		return _append(": ", 2);
+	}
+	
+	sl_bool JsonWriter::writeKey(const String& key)
+	{
+		return writeKey(key.getData(), key.getLength());
+	}
+	
+	sl_bool JsonWriter::writeNull()
+	{
+		return writeRaw("null", 4);
+	}
+	
+	sl_bool JsonWriter::writeBoolean(sl_bool value)
+	{
+		if (value) {
+			return writeRaw("true", 4);
+		} else {
+			return writeRaw("false", 5);
+		}
+	}
+	
+	sl_bool JsonWriter::writeInt32(sl_int32 value)
+	{
+		return writeInt64(value);
+	}
+	
+	sl_bool JsonWriter::writeUint32(sl_uint32 value)
+	{
+		return writeUint64(value);
+	}
+	
+	sl_bool JsonWriter::writeInt64(sl_int64 value)
+	{
+		sl_char8 buf[24];
+		sl_char8* end = buf + sizeof(buf);
+		sl_char8* p = _priv_JsonWriter_formatInt64(end, value);
+		return writeRaw(p, end - p);
+	}
+	
+	sl_bool JsonWriter::writeUint64(sl_uint64 value)
+	{
+		sl_char8 buf[24];
+		sl_char8* end = buf + sizeof(buf);
+		sl_char8* p = _priv_JsonWriter_formatUint64(end, value);
+		return writeRaw(p, end - p);
+	}
+	
+	sl_bool JsonWriter::writeFloat(float value)
+	{
+		// integral values are formatted without the generic floating-point conversion (same output as `String::fromFloat`)
+		if (value > -65536.0f && value < 65536.0f) {
+			sl_int32 n = (sl_int32)value;
+			if ((float)n == value) {
+				sl_char8 buf[24];
+				sl_char8* end = buf + 22;
+				sl_char8* p = _priv_JsonWriter_formatInt64(end, n);
+				end[0] = '.';
+				end[1] = '0';
+				return writeRaw(p, end + 2 - p);
+			}
+		}
+		String s = String::fromFloat(value);
+		return writeRaw(s.getData(), s.getLength());
+	}
+	
+	sl_bool JsonWriter::writeDouble(double value)
+	{
+		// integral values are formatted without the generic floating-point conversion (same output as `String::fromDouble`)
+		if (value > -1e14 && value < 1e14) {
+			sl_int64 n = (sl_int64)value;
+			if ((double)n == value) {
+				sl_char8 buf[32];
+				sl_char8* end = buf + 30;
+				sl_char8* p = _priv_JsonWriter_formatInt64(end, n);
+				end[0] = '.';
+				end[1] = '0';
+				return writeRaw(p, end + 2 - p);
+			}
+		}
+		String s = String::fromDouble(value);
+		return writeRaw(s.getData(), s.getLength());
+	}
+	
+	sl_bool JsonWriter::writeString(const sl_char8* str, sl_size length)
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		m_flagNeedComma = sl_true;
+		return _appendEscapedString(str, length);
+	}
+	
+	sl_bool JsonWriter::writeString(const String& str)
+	{
+		return writeString(str.getData(), str.getLength());
+	}
+	
+	sl_bool JsonWriter::writeString(const String16& str)
+	{
+		String s(str);
+		return writeString(s.getData(), s.getLength());
+	}
+	
+	sl_bool JsonWriter::writeTime(const Time& time)
+	{
+		return writeString(time.toString());
+	}
+	
+	sl_bool JsonWriter::writeRaw(const void* data, sl_size size)
+	{
+		if (!(_beginValue())) {
+			return sl_false;
+		}
+		m_flagNeedComma = sl_true;
+		return _append(data, size);
+	}
+	
+	sl_bool JsonWriter::write(const Variant& value)
+	{
+		return _writeVariant(value);
+	}
+	
+	sl_bool JsonWriter::write(const Json& value)
+	{
+		return _writeVariant(value);
+	}
+	
+	sl_bool JsonWriter::flush()
+	{
+		if (m_flagError) {
+			return sl_false;
+		}
+		if (m_pos) {
+			return _flushChunk();
+		}
+		return sl_true;
+	}
+	
+	sl_bool JsonWriter::isError()
+	{
+		return m_flagError;
+	}
+	
+	sl_uint64 JsonWriter::getWrittenSize()
+	{
+		return m_sizeWritten + m_pos;
+	}
+	
+	sl_bool JsonWriter::write(IWriter* writer, const Json& value)
+	{
+		JsonWriter w(writer);
+		if (w.write(value)) {
+			return w.flush();
+		}
+		return sl_false;
+	}
+	
+	Memory JsonWriter::toMemory(const Json& value)
+	{
+		MemoryBuffer buf;
+		{
+			JsonWriter w(&buf);
+			if (!(w.write(value))) {
+				return sl_null;
+			}
+			if (!(w.flush())) {
+				return sl_null;
+			}
+		}
+		return buf.merge();
+	}
+	
+	sl_bool JsonWriter::_beginValue()
+	{
+		if (m_flagError) {
+			return sl_false;
+		}
+		if (m_flagNeedComma) {
+			return _append(", ", 2);
+		}
+		return sl_true;
+	}
+	
+	sl_bool JsonWriter::_append(const void* _data, sl_size size)
+	{
+		const sl_char8* data = (const sl_char8*)_data;
+		for (;;) {
+			if (!m_data) {
+				if (m_flagError) {
+					return sl_false;
+				}
+				Memory chunk = Memory::create(m_sizeChunk);
+				if (chunk.isNull()) {
+					m_flagError = sl_true;
+					return sl_false;
+				}
+				m_chunk = chunk;
+				m_data = (sl_char8*)(chunk.getData());
+			}
+			sl_size n = m_sizeChunk - m_pos;
+			if (size <= n) {
+				Base::copyMemory(m_data + m_pos, data, size);
+				m_pos += size;
+				return sl_true;
+			}
+			Base::copyMemory(m_data + m_pos, data, n);
+			m_pos = m_sizeChunk;
+			data += n;
+			size -= n;
+			if (!(_flushChunk())) {
+				return sl_false;
+			}
+		}
+	}
+	
+	sl_bool JsonWriter::_appendChar(sl_char8 c)
+	{
+		if (m_data && m_pos < m_sizeChunk) {
+			m_data[m_pos++] = c;
+			return sl_true;
+		}
+		return _append(&c, 1);
+	}
+	
+	sl_bool JsonWriter::_appendEscapedString(const sl_char8* str, sl_size length)
+	{
+		// same escapes as `ParseUtil::applyBackslashEscapes()`
+		if (!(_appendChar('"'))) {
+			return sl_false;
+		}
+		const sl_char8* p = str;
+		const sl_char8* end = str + length;
+		while (p < end) {
+			const sl_char8* q = _priv_TextScan_findStringSpecial(p, end, '"');
+			if (q == end) {
+				return _append(p, end - p) && _appendChar('"');
+			}
+			sl_char8 r;
+			switch (*q) {
+				case '\\':
+					r = '\\';
+					break;
+				case '"':
+					r = '"';
+					break;
+				case 0:
+					r = '0';
+					break;
+				case '\n':
+					r = 'n';
+					break;
+				case '\r':
+					r = 'r';
+					break;
+				case '\b':
+					r = 'b';
+					break;
+				case '\f':
+					r = 'f';
+					break;
+				case '\a':
+					r = 'a';
+					break;
+				case '\v':
+					r = 'v';
+					break;
+				default:
+					r = 0;
+					break;
+			}
+			if (r) {
+				if (q > p) {
+					if (!(_append(p, q - p))) {
+						return sl_false;
+					}
+				}
+				sl_char8 s[2] = {'\\', r};
+				if (!(_append(s, 2))) {
+					return sl_false;
+				}
+			} else {
+				if (!(_append(p, q + 1 - p))) {
+					return sl_false;
+				}
+			}
+			p = q + 1;
+		}
+		return _appendChar('"');
+	}
+	
+	sl_bool JsonWriter::_writeVariant(const Variant& v)
+	{
+		switch (v.getType()) {
+			case VariantType::Int32:
+			case VariantType::Int64:
+				return writeInt64(v.getInt64());
+			case VariantType::Uint32:
+			case VariantType::Uint64:
+				return writeUint64(v.getUint64());
+			case VariantType::Float:
+				return writeFloat(v.getFloat());
+			case VariantType::Double:
+				return writeDouble(v.getDouble());
+			case VariantType::Boolean:
+				return writeBoolean(v.getBoolean());
+			case VariantType::Time:
+				return writeTime(v.getTime());
+			case VariantType::String8:
+			case VariantType::Sz8:
+				return writeString(v.getString());
+			case VariantType::String16:
+			case VariantType::Sz16:
+				return writeString(v.getString16());
+			case VariantType::Object:
+			case VariantType::Weak:
+				{
+					Ref<Referable> obj(v.getObject());
+					if (obj.isNotNull()) {
+						if (CList<Variant>* p1 = CastInstance< CList<Variant> >(obj._ptr)) {
+							return _writeList(p1);
+						} else if (CMap<String, Variant>* p2 = CastInstance< CMap<String, Variant> >(obj._ptr)) {
+							return _writeMap(p2);
+						} else if (CHashMap<String, Variant>* p3 = CastInstance< CHashMap<String, Variant> >(obj._ptr)) {
+							return _writeHashMap(p3);
+						} else if (CList< Map<String, Variant> >* p4 = CastInstance< CList< Map<String, Variant> > >(obj._ptr)) {
+							return _writeMapList(p4);
+						} else if (CList< HashMap<String, Variant> >* p5 = CastInstance< CList< HashMap<String, Variant> > >(obj._ptr)) {
+							return _writeHashMapList(p5);
+						}
+					}
+				}
+				break;
+			default:
+				break;
+		}
+		return writeNull();
+	}
+	
+	sl_bool JsonWriter::_writeList(const List<Variant>& list)
+	{
+		ListLocker<Variant> l(list);
+		if (!(beginArray())) {
+			return sl_false;
+		}
+		for (sl_size i = 0; i < l.count; i++) {
+			if (!(_writeVariant(l.data[i]))) {
+				return sl_false;
+			}
+		}
+		return endArray();
+	}
+	
+	sl_bool JsonWriter::_writeMap(const Map<String, Variant>& map)
+	{
+		MutexLocker lock(map.getLocker());
+		if (!(beginObject())) {
+			return sl_false;
+		}
+		for (auto& pair : map) {
+			if (!(writeKey(pair.key))) {
+				return sl_false;
+			}
+			if (!(_writeVariant(pair.value))) {
+				return sl_false;
+			}
+		}
+		return endObject();
+	}
+	
+	sl_bool JsonWriter::_writeHashMap(const HashMap<String, Variant>& map)
+	{
+		MutexLocker lock(map.getLocker());
+		if (!(beginObject())) {
+			return sl_false;
+		}
+		for (auto& pair : map) {
+			if (!(writeKey(pair.key))) {
+				return sl_false;
+			}
+			if (!(_writeVariant(pair.value))) {
+				return sl_false;
+			}
+		}
+		return endObject();
+	}
+	
+	sl_bool JsonWriter::_writeMapList(const List< Map<String, Variant> >& list)
+	{
+		ListLocker< Map<String, Variant> > l(list);
+		if (!(beginArray())) {
+			return sl_false;
+		}
+		for (sl_size i = 0; i < l.count; i++) {
+			if (!(_writeMap(l.data[i]))) {
+				return sl_false;
+			}
+		}
+		return endArray();
+	}
+	
+	sl_bool JsonWriter::_writeHashMapList(const List< HashMap<String, Variant> >& list)
+	{
+		ListLocker< HashMap<String, Variant> > l(list);
+		if (!(beginArray())) {
+			return sl_false;
+		}
+		for (sl_size i = 0; i < l.count; i++) {
+			if (!(_writeHashMap(l.data[i]))) {
+				return sl_false;
+			}
+		}
+		return endArray();
+	}
+	
+	sl_bool JsonWriter::_flushChunk()
+	{
+		sl_size size = m_pos;
+		if (!size) {
+			return sl_true;
+		}
+		m_sizeWritten += size;
+		m_pos = 0;
+		if (m_writer) {
+			if (m_writer->writeFully(m_data, size) != (sl_reg)size) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+			return sl_true;
+		}
+		Memory chunk;
+		if (size < (m_sizeChunk >> 2)) {
+			// a small tail is copied, so that it does not pin the whole chunk
+			chunk = Memory::create(m_data, size);
+			if (chunk.isNull()) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+		} else {
+			// the chunk is handed over, next chunk is allocated on demand
+			chunk = m_chunk.sub(0, size);
+			m_chunk.setNull();
+			m_data = sl_null;
+		}
+		if (m_buffer) {
+			if (!(m_buffer->add(chunk))) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+		} else if (m_onChunk.isNotNull()) {
+			if (!(m_onChunk(chunk))) {
+				m_flagError = sl_true;
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+	
+}
@@ -25,8 +25,17 @@
 #include "slib/core/file.h"
 #include "slib/core/console.h"
 #include "slib/core/variant.h"
+#include "slib/core/thread.h"
+#include "slib/core/event.h"
+#include "slib/core/system.h"
+#include "slib/core/spin_lock.h"
 #include "slib/core/safe_static.h"
 
+#include <atomic>
+
+#define PRIV_SLIB_FILE_LOGGER_BATCH_SIZE 65536
+#define PRIV_SLIB_FILE_LOGGER_WAIT_TIMEOUT 1000
+
 #if defined(SLIB_PLATFORM_IS_ANDROID)
 #include <android/log.h>
 #endif
@@ -53,35 +62,400 @@ namespace slib
 		log(tag, content);
 	}
 
+	static String _priv_Log_getLineString(const Time& time, const String& tag, const String& content)
+	{
+		return String::format("%s [%s] %s", time, tag, content);
+	}
+	
 	static String _priv_Log_getLineString(const String& tag, const String& content)
 	{
-		return String::format("%s [%s] %s", Time::now(), tag, content);
+		return _priv_Log_getLineString(Time::now(), tag, content);
 	}
 
+	FileLoggerParam::FileLoggerParam()
+	{
+		maximumFileSize = 0;
+		maximumBackupsCount = 5;
+		queueSize = 8192;
+		flagDropOnOverload = sl_false;
+	}
+	
+	FileLoggerParam::FileLoggerParam(const String& _fileNameFormat): FileLoggerParam()
+	{
+		fileNameFormat = _fileNameFormat;
+	}
+	
+	FileLoggerParam::~FileLoggerParam()
+	{
+	}
+	
+	class _priv_FileLoggerSlot
+	{
+	public:
+		// `index + 1` when `line` is filled, `index + size` when it is free again
+		std::atomic<sl_size> sequence;
+		String line;
+		// resolved when the line was logged, so a batch never crosses a file rotation
+		String fileName;
+	};
+	
+	// bounded multi-producer ring (D. Vyukov), drained by the writer thread
+	class _priv_FileLoggerWriter : public Referable
+	{
+	public:
+		_priv_FileLoggerSlot* slots;
+		sl_size mask;
+		
+		sl_uint8 _padding0[64];
+		std::atomic<sl_size> tail;
+		sl_uint8 _padding1[64];
+		
+		sl_size head;
+		std::atomic<sl_size> countWritten;
+		std::atomic<sl_bool> flagWaiting;
+		std::atomic<sl_uint64> countDropped;
+		sl_uint64 countDroppedReported;
+		
+		Ref<Event> event;
+		Ref<Event> eventWritten;
+		Ref<Thread> thread;
+		SpinLock lockStart;
+		std::atomic<sl_bool> flagStarted;
+		std::atomic<sl_bool> flagStopped;
+		
+		FileLoggerParam param;
+		
+		// resolved by the logging threads, at most once per second
+		SpinLock lockFileName;
+		String fileNameNext;
+		std::atomic<sl_int64> timeFileName;
+		
+		Ref<File> file;
+		String fileName;
+		sl_uint64 fileSize;
+		
+		sl_uint8* buf;
+		sl_size sizeBuf;
+		sl_size capacityBuf;
+		
+	public:
+		_priv_FileLoggerWriter(): slots(sl_null), tail(0), head(0), countWritten(0), flagWaiting(sl_false), countDropped(0), countDroppedReported(0), flagStarted(sl_false), flagStopped(sl_false), timeFileName(-1), fileSize(0), buf(sl_null), sizeBuf(0), capacityBuf(0)
+		{
+		}
+		
+		~_priv_FileLoggerWriter()
+		{
+			if (slots) {
+				delete[] slots;
+			}
+			if (buf) {
+				Base::freeMemory(buf);
+			}
+		}
+		
+	public:
+		sl_bool init(const FileLoggerParam& _param)
+		{
+			param = _param;
+			sl_size n = 2;
+			while (n < param.queueSize) {
+				n <<= 1;
+			}
+			slots = new _priv_FileLoggerSlot[n];
+			if (!slots) {
+				return sl_false;
+			}
+			for (sl_size i = 0; i < n; i++) {
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+			mask = n - 1;
+			event = Event::create();
+			eventWritten = Event::create(sl_false);
+			return event.isNotNull() && eventWritten.isNotNull();
+		}
+		
+		sl_bool start()
+		{
+			SpinLocker lock(&lockStart);
+			if (flagStarted.load(std::memory_order_relaxed)) {
+				return sl_true;
+			}
+			if (flagStopped.load(std::memory_order_relaxed)) {
+				return sl_false;
+			}
+			// the thread holds the writer, not the logger
+			thread = Thread::start(SLIB_FUNCTION_REF(_priv_FileLoggerWriter, run, this));
+			if (thread.isNull()) {
+				return sl_false;
+			}
+			flagStarted.store(sl_true, std::memory_order_release);
+			return sl_true;
+		}
+		
+		// writes the queued lines and joins the writer thread
+		void stop()
+		{
+			Ref<Thread> _thread;
+			{
+				SpinLocker lock(&lockStart);
+				flagStopped.store(sl_true);
+				_thread = Move(thread);
+			}
+			if (_thread.isNotNull()) {
+				_thread->finish();
+				event->set();
+				_thread->join();
+			}
+		}
+		
+		void setFileName(const String& name, sl_int64 time)
+		{
+			SpinLocker lock(&lockFileName);
+			fileNameNext = name;
+			timeFileName.store(time, std::memory_order_relaxed);
+		}
+		
+		String getFileName()
+		{
+			SpinLocker lock(&lockFileName);
+			return fileNameNext;
+		}
+		
+		sl_bool push(String& line, const String& fileName)
+		{
+			sl_size pos = tail.load(std::memory_order_relaxed);
+			for (;;) {
+				_priv_FileLoggerSlot& slot = slots[pos & mask];
+				sl_size seq = slot.sequence.load(std::memory_order_acquire);
+				sl_reg diff = (sl_reg)(seq - pos);
+				if (!diff) {
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						slot.line = Move(line);
+						slot.fileName = fileName;
+						// sequentially consistent, to pair with `flagWaiting`
+						slot.sequence.store(pos + 1);
+						return sl_true;
+					}
+				} else if (diff < 0) {
+					return sl_false;
+				} else {
+					pos = tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+		
+		sl_bool isEmpty()
+		{
+			return slots[head & mask].sequence.load() != head + 1;
+		}
+		
+		sl_bool pop(String& line, String& fileName)
+		{
+			_priv_FileLoggerSlot& slot = slots[head & mask];
+			if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+				return sl_false;
+			}
+			line = Move(slot.line);
+			fileName = Move(slot.fileName);
+			slot.sequence.store(head + mask + 1, std::memory_order_release);
+			head++;
+			return sl_true;
+		}
+		
+		void wake()
+		{
+			if (flagWaiting.exchange(sl_false)) {
+				event->set();
+			}
+		}
+		
+		sl_bool append(const void* data, sl_size size)
+		{
+			if (sizeBuf + size > capacityBuf) {
+				sl_size n = Math::max(sizeBuf + size, (sl_size)PRIV_SLIB_FILE_LOGGER_BATCH_SIZE);
+				sl_uint8* p = (sl_uint8*)(Base::reallocMemory(buf, n));
+				if (!p) {
+					return sl_false;
+				}
+				buf = p;
+				capacityBuf = n;
+			}
+			Base::copyMemory(buf + sizeBuf, data, size);
+			sizeBuf += size;
+			return sl_true;
+		}
+		
+		void rotate()
+		{
+			file.setNull();
+			sl_uint32 n = param.maximumBackupsCount;
+			if (n) {
+				File::deleteFile(fileName + "." + String::fromUint32(n));
+				for (sl_uint32 i = n - 1; i > 0; i--) {
+					String path = fileName + "." + String::fromUint32(i);
+					if (File::exists(path)) {
+						File::rename(path, fileName + "." + String::fromUint32(i + 1));
+					}
+				}
+				File::rename(fileName, fileName + ".1");
+			} else {
+				File::deleteFile(fileName);
+			}
+			fileSize = 0;
+		}
+		
+		void write(const String& _fileName)
+		{
+			if (!sizeBuf) {
+				return;
+			}
+			if (_fileName.isEmpty()) {
+				sizeBuf = 0;
+				return;
+			}
+			if (file.isNull() || fileName != _fileName) {
+				file = File::openForAppend(_fileName);
+				fileName = _fileName;
+				fileSize = file.isNotNull() ? file->getSize() : 0;
+			}
+			if (param.maximumFileSize && fileSize && fileSize + sizeBuf > param.maximumFileSize) {
+				rotate();
+				file = File::openForAppend(fileName);
+			}
+			if (file.isNotNull()) {
+				sl_reg n = file->writeFully(buf, sizeBuf);
+				if (n > 0) {
+					fileSize += n;
+				}
+			}
+			sizeBuf = 0;
+		}
+		
+		void writeLines()
+		{
+			String name = getFileName();
+			String line;
+			String lineFileName;
+			for (;;) {
+				sl_bool flagLine = pop(line, lineFileName);
+				if (flagLine) {
+					if (lineFileName != name) {
+						write(name);
+						name = Move(lineFileName);
+					}
+					append(line.getData(), line.getLength());
+					append("\r\n", 2);
+					line.setNull();
+				}
+				if (!flagLine || sizeBuf >= PRIV_SLIB_FILE_LOGGER_BATCH_SIZE) {
+					if (sizeBuf) {
+						write(name);
+						countWritten.store(head);
+					}
+					if (!flagLine) {
+						break;
+					}
+				}
+			}
+			countWritten.store(head);
+			sl_uint64 nDropped = countDropped.load(std::memory_order_relaxed);
+			if (nDropped != countDroppedReported) {
+				String s = _priv_Log_getLineString("FileLogger", String::format("%s lines were dropped", String::fromUint64(nDropped - countDroppedReported)));
+				countDroppedReported = nDropped;
+				append(s.getData(), s.getLength());
+				append("\r\n", 2);
+				write(name);
+			}
+			eventWritten->set();
+		}
+		
+		void run()
+		{
+			Ref<Thread> current = Thread::getCurrent();
+			if (current.isNull()) {
+				return;
+			}
+			while (current->isNotStopping()) {
+				writeLines();
+				flagWaiting.store(sl_true);
+				if (isEmpty()) {
+					event->wait(PRIV_SLIB_FILE_LOGGER_WAIT_TIMEOUT);
+				}
+				flagWaiting.store(sl_false);
+			}
+			writeLines();
+			file.setNull();
+		}
+		
+	};
+	
 	FileLogger::FileLogger()
 	{
+		_init(FileLoggerParam());
 	}
 
 	FileLogger::FileLogger(const String& fileNameFormat)
 	{
-		m_fileNameFormat = fileNameFormat;
+		_init(FileLoggerParam(fileNameFormat));
+	}
+	
+	FileLogger::FileLogger(const FileLoggerParam& param)
+	{
+		_init(param);
 	}
 
 	FileLogger::~FileLogger()
 	{
+		_priv_FileLoggerWriter* writer = (_priv_FileLoggerWriter*)(m_writer.get());
+		if (writer) {
+			writer->stop();
+		}
+	}
+	
+	void FileLogger::_init(const FileLoggerParam& param)
+	{
+		m_fileNameFormat = param.fileNameFormat;
+		Ref<_priv_FileLoggerWriter> writer = new _priv_FileLoggerWriter;
+		if (writer.isNotNull()) {
+			if (writer->init(param)) {
+				m_writer = writer;
+			}
+		}
 	}
 
 	void FileLogger::log(const String& tag, const String& content)
 	{
-		String fileName = getFileName();
-		if (fileName.isEmpty()) {
+		_priv_FileLoggerWriter* writer = (_priv_FileLoggerWriter*)(m_writer.get());
+		if (!writer) {
 			return;
 		}
-		String s = _priv_Log_getLineString(tag, content) + "\r\n";
-		if (s.getLength() > 0) {
-			ObjectLocker lock(this);
-			File::appendAllTextUTF8(fileName, s);
+		if (!(writer->flagStarted.load(std::memory_order_acquire))) {
+			if (!(writer->start())) {
+				return;
+			}
+		}
+		Time now = Time::now();
+		sl_int64 seconds = now.toInt() / 1000000;
+		String fileName;
+		if (writer->timeFileName.load(std::memory_order_relaxed) != seconds) {
+			// `getFileName()` is virtual, so it is called by the logging thread instead of the writer thread
+			fileName = getFileName();
+			writer->setFileName(fileName, seconds);
+		} else {
+			fileName = writer->getFileName();
 		}
+		String line = _priv_Log_getLineString(now, tag, content);
+		sl_uint32 nRetry = 0;
+		while (!(writer->push(line, fileName))) {
+			if (writer->param.flagDropOnOverload) {
+				writer->countDropped++;
+				return;
+			}
+			writer->wake();
+			System::yield(nRetry);
+			nRetry++;
+		}
+		writer->wake();
 	}
 	
 	String FileLogger::getFileName()
@@ -89,6 +463,32 @@ namespace slib
 		return String::format(m_fileNameFormat, Time::now());
 	}
 	
+	void FileLogger::flush()
+	{
+		_priv_FileLoggerWriter* writer = (_priv_FileLoggerWriter*)(m_writer.get());
+		if (!writer || !(writer->flagStarted.load(std::memory_order_acquire))) {
+			return;
+		}
+		sl_size target = writer->tail.load();
+		for (;;) {
+			writer->eventWritten->reset();
+			if (writer->countWritten.load() >= target || writer->flagStopped.load()) {
+				break;
+			}
+			writer->event->set();
+			writer->eventWritten->wait(PRIV_SLIB_FILE_LOGGER_WAIT_TIMEOUT);
+		}
+	}
+	
+	sl_uint64 FileLogger::getDroppedLinesCount()
+	{
+		_priv_FileLoggerWriter* writer = (_priv_FileLoggerWriter*)(m_writer.get());
+		if (writer) {
+			return writer->countDropped.load(std::memory_order_relaxed);
+		}
+		return 0;
+	}
+	
 	class ConsoleLogger : public Logger
 	{
 	public:
@@ -148,51 +548,65 @@ namespace slib
 
 	void LoggerSet::clearDefaultLogger()
 	{
-		m_listLoggers.removeAll();
+		ObjectLocker lock(this);
+		m_listLoggers.setNull();
 	}
 
 	void LoggerSet::addDefaultLogger(const Ref<Logger>& logger)
 	{
-		m_listLoggers.add(logger);
+		ObjectLocker lock(this);
+		List< Ref<Logger> > list = m_listLoggers.duplicate();
+		list.add_NoLock(logger);
+		m_listLoggers = list;
 	}
 
 	void LoggerSet::removeDefaultLogger(const Ref<Logger>& logger)
 	{
-		m_listLoggers.remove(logger);
+		ObjectLocker lock(this);
+		List< Ref<Logger> > list = m_listLoggers.duplicate();
+		list.remove_NoLock(logger);
+		m_listLoggers = list;
 	}
 
 	void LoggerSet::setDefaultLogger(const Ref<Logger>& logger)
 	{
-		m_listLoggers.removeAll();
-		m_listLoggers.add(logger);
+		ObjectLocker lock(this);
+		m_listLoggers = List< Ref<Logger> >::createFromElement(logger);
 	}
 
 
 	void LoggerSet::clearErrorLogger()
 	{
-		m_listErrorLoggers.removeAll();
+		ObjectLocker lock(this);
+		m_listErrorLoggers.setNull();
 	}
 
 	void LoggerSet::addErrorLogger(const Ref<Logger>& logger)
 	{
-		m_listErrorLoggers.add(logger);
+		ObjectLocker lock(this);
+		List< Ref<Logger> > list = m_listErrorLoggers.duplicate();
+		list.add_NoLock(logger);
+		m_listErrorLoggers = list;
 	}
 
 	void LoggerSet::removeErrorLogger(const Ref<Logger>& logger)
 	{
-		m_listErrorLoggers.remove(logger);
+		ObjectLocker lock(this);
+		List< Ref<Logger> > list = m_listErrorLoggers.duplicate();
+		list.remove_NoLock(logger);
+		m_listErrorLoggers = list;
 	}
 
 	void LoggerSet::setErrorLogger(const Ref<Logger>& logger)
 	{
-		m_listErrorLoggers.removeAll();
-		m_listErrorLoggers.add(logger);
+		ObjectLocker lock(this);
+		m_listErrorLoggers = List< Ref<Logger> >::createFromElement(logger);
 	}
 
 
 	void LoggerSet::log(const String& tag, const String& content)
 	{
-		ListLocker< Ref<Logger> > list(m_listLoggers);
+		ListElements< Ref<Logger> > list(m_listLoggers);
 		for (sl_size i = 0; i < list.count; i++) {
 			list[i]->log(tag, content);
 		}
@@ -200,7 +614,7 @@ namespace slib
 
 	void LoggerSet::logError(const String& tag, const String& content)
 	{
-		ListLocker< Ref<Logger> > list(m_listErrorLoggers);
+		ListElements< Ref<Logger> > list(m_listErrorLoggers);
 		for (sl_size i = 0; i < list.count; i++) {
 			list[i]->logError(tag, content);
 		}
@@ -229,6 +643,11 @@ namespace slib
 	{
 		return new FileLogger(fileNameFormat);
 	}
+	
+	Ref<Logger> Logger::createFileLogger(const FileLoggerParam& param)
+	{
+		return new FileLogger(param);
+	}
 
 	void Logger::logGlobal(const String& tag, const String& content)
 	{
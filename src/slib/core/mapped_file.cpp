@@ -0,0 +1,332 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/mapped_file.h"
+
+#if defined(SLIB_PLATFORM_IS_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace slib
+{
+
+	MappedFileParam::MappedFileParam()
+	{
+		flagWritable = sl_false;
+		offset = 0;
+		size = 0;
+		hint = MappedFileHint::Normal;
+	}
+
+	MappedFileParam::~MappedFileParam()
+	{
+	}
+
+
+	SLIB_DEFINE_OBJECT(MappedFile, Object)
+
+	MappedFile::MappedFile()
+	{
+		m_data = sl_null;
+		m_size = 0;
+		m_offset = 0;
+		m_flagWritable = sl_false;
+		m_base = sl_null;
+		m_sizeBase = 0;
+#if defined(SLIB_PLATFORM_IS_WIN32)
+		m_handleMapping = sl_null;
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+		_unmap();
+	}
+
+	Ref<MappedFile> MappedFile::open(const MappedFileParam& param)
+	{
+		Ref<File> file = param.file;
+		if (file.isNull()) {
+			if (param.flagWritable) {
+				file = File::open(param.path, FileMode::ReadWrite | FileMode::NotCreate | FileMode::NotTruncate);
+			} else {
+				file = File::openForRead(param.path);
+			}
+			if (file.isNull()) {
+				return sl_null;
+			}
+		}
+		sl_uint64 sizeFile = file->getSize();
+		if (param.offset >= sizeFile) {
+			return sl_null;
+		}
+		sl_uint64 size = sizeFile - param.offset;
+		if (param.size && param.size < size) {
+			size = param.size;
+		}
+		if (size > SLIB_SIZE_MAX) {
+			return sl_null;
+		}
+		Ref<MappedFile> ret = new MappedFile;
+		if (ret.isNotNull()) {
+			if (ret->_map(file->getHandle(), param.offset, (sl_size)size, param.flagWritable)) {
+				ret->m_file = file;
+				if (param.hint != MappedFileHint::Normal) {
+					ret->advise(param.hint);
+				}
+				return ret;
+			}
+		}
+		return sl_null;
+	}
+
+	Ref<MappedFile> MappedFile::openForRead(const String& path, MappedFileHint hint)
+	{
+		MappedFileParam param;
+		param.path = path;
+		param.hint = hint;
+		return open(param);
+	}
+
+	Ref<MappedFile> MappedFile::openForReadWrite(const String& path)
+	{
+		MappedFileParam param;
+		param.path = path;
+		param.flagWritable = sl_true;
+		return open(param);
+	}
+
+	Memory MappedFile::mapAllBytes(const String& path, MappedFileHint hint)
+	{
+		Ref<MappedFile> file = openForRead(path, hint);
+		if (file.isNotNull()) {
+			return file->getMemory();
+		}
+		return sl_null;
+	}
+
+	void* MappedFile::getData() const
+	{
+		return m_data;
+	}
+
+	sl_size MappedFile::getSize() const
+	{
+		return m_size;
+	}
+
+	sl_uint64 MappedFile::getOffset() const
+	{
+		return m_offset;
+	}
+
+	sl_bool MappedFile::isWritable() const
+	{
+		return m_flagWritable;
+	}
+
+	Memory MappedFile::getMemory()
+	{
+		if (m_data) {
+			return Memory::createStatic(m_data, m_size, this);
+		}
+		return sl_null;
+	}
+
+	sl_bool MappedFile::advise(MappedFileHint hint)
+	{
+		return advise(0, m_size, hint);
+	}
+
+#if defined(SLIB_PLATFORM_IS_WIN32)
+
+	sl_bool MappedFile::_map(sl_file file, sl_uint64 offset, sl_size size, sl_bool flagWritable)
+	{
+		HANDLE hMapping = CreateFileMappingW((HANDLE)file, NULL, flagWritable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+		if (!hMapping) {
+			return sl_false;
+		}
+		SYSTEM_INFO si;
+		GetSystemInfo(&si);
+		sl_uint64 granularity = si.dwAllocationGranularity;
+		sl_uint64 offsetBase = offset - (offset % granularity);
+		sl_size sizeBase = (sl_size)(offset - offsetBase) + size;
+		void* base = MapViewOfFile(hMapping, flagWritable ? FILE_MAP_WRITE : FILE_MAP_READ, (DWORD)(offsetBase >> 32), (DWORD)offsetBase, sizeBase);
+		if (!base) {
+			CloseHandle(hMapping);
+			return sl_false;
+		}
+		m_handleMapping = hMapping;
+		m_base = base;
+		m_sizeBase = sizeBase;
+		m_data = (sl_uint8*)base + (sl_size)(offset - offsetBase);
+		m_size = size;
+		m_offset = offset;
+		m_flagWritable = flagWritable;
+		return sl_true;
+	}
+
+	void MappedFile::_unmap()
+	{
+		if (m_base) {
+			UnmapViewOfFile(m_base);
+			m_base = sl_null;
+		}
+		if (m_handleMapping) {
+			CloseHandle((HANDLE)m_handleMapping);
+			m_handleMapping = sl_null;
+		}
+		m_data = sl_null;
+		m_size = 0;
+	}
+
+	typedef BOOL (WINAPI *_priv_MappedFile_PrefetchVirtualMemory)(HANDLE, ULONG_PTR, PVOID, ULONG);
+
+	struct _priv_MappedFile_MemoryRangeEntry
+	{
+		PVOID VirtualAddress;
+		SIZE_T NumberOfBytes;
+	};
+
+	sl_bool MappedFile::advise(sl_size offset, sl_size size, MappedFileHint hint)
+	{
+		if (!m_data || offset >= m_size) {
+			return sl_false;
+		}
+		if (size > m_size - offset) {
+			size = m_size - offset;
+		}
+		if (hint == MappedFileHint::WillNeed) {
+			// PrefetchVirtualMemory is available since Windows 8
+			static _priv_MappedFile_PrefetchVirtualMemory func = (_priv_MappedFile_PrefetchVirtualMemory)(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "PrefetchVirtualMemory"));
+			if (func) {
+				_priv_MappedFile_MemoryRangeEntry entry;
+				entry.VirtualAddress = m_data + offset;
+				entry.NumberOfBytes = size;
+				return func(GetCurrentProcess(), 1, &entry, 0) != 0;
+			}
+			return sl_false;
+		}
+		if (hint == MappedFileHint::DontNeed) {
+			return VirtualUnlock(m_data + offset, size) != 0;
+		}
+		// access pattern hints are chosen by the system on Windows
+		return sl_true;
+	}
+
+	sl_bool MappedFile::flush(sl_bool flagSync)
+	{
+		if (!m_data) {
+			return sl_false;
+		}
+		if (!m_flagWritable) {
+			return sl_true;
+		}
+		if (!(FlushViewOfFile(m_base, m_sizeBase))) {
+			return sl_false;
+		}
+		if (flagSync && m_file.isNotNull()) {
+			return FlushFileBuffers((HANDLE)(m_file->getHandle())) != 0;
+		}
+		return sl_true;
+	}
+
+#else
+
+	sl_bool MappedFile::_map(sl_file file, sl_uint64 offset, sl_size size, sl_bool flagWritable)
+	{
+		sl_uint64 sizePage = (sl_uint64)(sysconf(_SC_PAGESIZE));
+		sl_uint64 offsetBase = offset - (offset % sizePage);
+		sl_size sizeBase = (sl_size)(offset - offsetBase) + size;
+		void* base = mmap(sl_null, sizeBase, flagWritable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, (int)file, (off_t)offsetBase);
+		if (base == MAP_FAILED) {
+			return sl_false;
+		}
+		m_base = base;
+		m_sizeBase = sizeBase;
+		m_data = (sl_uint8*)base + (sl_size)(offset - offsetBase);
+		m_size = size;
+		m_offset = offset;
+		m_flagWritable = flagWritable;
+		return sl_true;
+	}
+
+	void MappedFile::_unmap()
+	{
+		if (m_base) {
+			munmap(m_base, m_sizeBase);
+			m_base = sl_null;
+		}
+		m_data = sl_null;
+		m_size = 0;
+	}
+
+	sl_bool MappedFile::advise(sl_size offset, sl_size size, MappedFileHint hint)
+	{
+		if (!m_data || offset >= m_size) {
+			return sl_false;
+		}
+		if (size > m_size - offset) {
+			size = m_size - offset;
+		}
+		int advice;
+		switch (hint) {
+			case MappedFileHint::Sequential:
+				advice = POSIX_MADV_SEQUENTIAL;
+				break;
+			case MappedFileHint::Random:
+				advice = POSIX_MADV_RANDOM;
+				break;
+			case MappedFileHint::WillNeed:
+				advice = POSIX_MADV_WILLNEED;
+				break;
+			case MappedFileHint::DontNeed:
+				advice = POSIX_MADV_DONTNEED;
+				break;
+			default:
+				advice = POSIX_MADV_NORMAL;
+				break;
+		}
+		// the address passed to madvise must be aligned to the page
+		sl_uint8* start = m_data + offset;
+		sl_size sizePage = (sl_size)(sysconf(_SC_PAGESIZE));
+		sl_size delta = (sl_size)start % sizePage;
+		return posix_madvise(start - delta, size + delta, advice) == 0;
+	}
+
+	sl_bool MappedFile::flush(sl_bool flagSync)
+	{
+		if (!m_data) {
+			return sl_false;
+		}
+		if (!m_flagWritable) {
+			return sl_true;
+		}
+		return msync(m_base, m_sizeBase, flagSync ? MS_SYNC : MS_ASYNC) == 0;
+	}
+
+#endif
+
+}
@@ -0,0 +1,148 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/mpsc_queue.h"
+
+#include "slib/core/base.h"
+
+#include <atomic>
+
+#define PRIV_MPSC_FREE_MAX 1024
+#define PRIV_MPSC_ELEMENT_OFFSET 16
+
+namespace slib
+{
+	
+	// the first field of every node (and the stub) is the pointer to the next node
+	SLIB_INLINE static std::atomic<void*>& _priv_MpscQueue_next(void* node) noexcept
+	{
+		return *((std::atomic<void*>*)node);
+	}
+	
+	SLIB_INLINE static std::atomic<void*>& _priv_MpscQueue_atomic(void* const* p) noexcept
+	{
+		return *((std::atomic<void*>*)p);
+	}
+	
+	MpscQueueBase::MpscQueueBase(sl_size sizeElement) noexcept
+	{
+		m_sizeNode = PRIV_MPSC_ELEMENT_OFFSET + sizeElement;
+		m_stub = sl_null;
+		m_head = &m_stub;
+		m_tail = &m_stub;
+		m_free = sl_null;
+		m_nFree = 0;
+	}
+	
+	MpscQueueBase::~MpscQueueBase() noexcept
+	{
+		void* node = m_free;
+		while (node) {
+			void* next = *((void**)node);
+			Base::freeMemory(node);
+			node = next;
+		}
+	}
+	
+	sl_bool MpscQueueBase::isEmpty() const noexcept
+	{
+		// the tail node holds an element unless it is the stub
+		return m_tail == &m_stub && _priv_MpscQueue_atomic(&m_head).load(std::memory_order_acquire) == &m_stub;
+	}
+	
+	sl_bool MpscQueueBase::isNotEmpty() const noexcept
+	{
+		return !(isEmpty());
+	}
+	
+	void* MpscQueueBase::_allocNode() noexcept
+	{
+		{
+			SpinLocker lock(&m_lockFree);
+			void* node = m_free;
+			if (node) {
+				m_free = *((void**)node);
+				m_nFree--;
+				return node;
+			}
+		}
+		return Base::createMemory(m_sizeNode);
+	}
+	
+	void MpscQueueBase::_freeNode(void* node) noexcept
+	{
+		{
+			SpinLocker lock(&m_lockFree);
+			if (m_nFree < PRIV_MPSC_FREE_MAX) {
+				*((void**)node) = m_free;
+				m_free = node;
+				m_nFree++;
+				return;
+			}
+		}
+		Base::freeMemory(node);
+	}
+	
+	void* MpscQueueBase::_getElement(void* node) noexcept
+	{
+		return (sl_uint8*)node + PRIV_MPSC_ELEMENT_OFFSET;
+	}
+	
+	void MpscQueueBase::_pushNode(void* node) noexcept
+	{
+		_priv_MpscQueue_next(node).store(sl_null, std::memory_order_relaxed);
+		void* prev = _priv_MpscQueue_atomic(&m_head).exchange(node, std::memory_order_acq_rel);
+		_priv_MpscQueue_next(prev).store(node, std::memory_order_release);
+	}
+	
+	void* MpscQueueBase::_popNode() noexcept
+	{
+		void* stub = &m_stub;
+		void* tail = m_tail;
+		void* next = _priv_MpscQueue_next(tail).load(std::memory_order_acquire);
+		if (tail == stub) {
+			if (!next) {
+				return sl_null;
+			}
+			m_tail = next;
+			tail = next;
+			next = _priv_MpscQueue_next(next).load(std::memory_order_acquire);
+		}
+		if (next) {
+			m_tail = next;
+			return tail;
+		}
+		if (tail != _priv_MpscQueue_atomic(&m_head).load(std::memory_order_acquire)) {
+			// a producer is linking the next node
+			return sl_null;
+		}
+		// the last node is released by pushing the stub behind it
+		_pushNode(stub);
+		next = _priv_MpscQueue_next(tail).load(std::memory_order_acquire);
+		if (next) {
+			m_tail = next;
+			return tail;
+		}
+		return sl_null;
+	}
+	
+}
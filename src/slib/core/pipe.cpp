@@ -25,6 +25,10 @@
 
 #if defined(SLIB_PLATFORM_IS_UNIX)
 #include <poll.h>
+#include <unistd.h>
+#endif
+#if defined(SLIB_PLATFORM_IS_LINUX)
+#include <sys/eventfd.h>
 #endif
 
 namespace slib
@@ -98,15 +102,33 @@ namespace slib
 
 	PipeEvent::PipeEvent()
 	{
+		m_hEvent = SLIB_PIPE_INVALID_HANDLE;
 		m_flagSet = sl_false;
 	}
 
 	PipeEvent::~PipeEvent()
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (m_hEvent != SLIB_PIPE_INVALID_HANDLE) {
+			::close((int)m_hEvent);
+		}
+#endif
 	}
 
 	Ref<PipeEvent> PipeEvent::create()
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (fd >= 0) {
+			Ref<PipeEvent> ret = new PipeEvent;
+			if (ret.isNotNull()) {
+				ret->m_hEvent = (sl_pipe)fd;
+				return ret;
+			}
+			::close(fd);
+			return sl_null;
+		}
+#endif
 		Ref<Pipe> pipe = Pipe::create();
 		if (pipe.isNotNull()) {
 			Ref<PipeEvent> ret = new PipeEvent;
@@ -134,6 +156,14 @@ namespace slib
 			return;
 		}
 		m_flagSet = sl_true;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (m_hEvent != SLIB_PIPE_INVALID_HANDLE) {
+			eventfd_t v = 1;
+			ssize_t n = ::write((int)m_hEvent, &v, sizeof(v));
+			SLIB_UNUSED(n);
+			return;
+		}
+#endif
 		char c = 1;
 		m_pipe->write(&c, 1);
 	}
@@ -145,6 +175,15 @@ namespace slib
 			return;
 		}
 		m_flagSet = sl_false;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (m_hEvent != SLIB_PIPE_INVALID_HANDLE) {
+			// a single read clears the counter
+			eventfd_t v;
+			ssize_t n = ::read((int)m_hEvent, &v, sizeof(v));
+			SLIB_UNUSED(n);
+			return;
+		}
+#endif
 		while (1) {
 			static char t[200];
 			sl_reg n = m_pipe->read(t, 200);
@@ -177,11 +216,17 @@ namespace slib
 
 	sl_pipe PipeEvent::getReadPipeHandle()
 	{
+		if (m_hEvent != SLIB_PIPE_INVALID_HANDLE) {
+			return m_hEvent;
+		}
 		return m_pipe->getReadHandle();
 	}
 
 	sl_pipe PipeEvent::getWritePipeHandle()
 	{
+		if (m_hEvent != SLIB_PIPE_INVALID_HANDLE) {
+			return m_hEvent;
+		}
 		return m_pipe->getWriteHandle();
 	}
 
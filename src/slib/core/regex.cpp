@@ -1,48 +1,1690 @@
-/*
- *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
- *
- *   Permission is hereby granted, free of charge, to any person obtaining a copy
- *   of this software and associated documentation files (the "Software"), to deal
- *   in the Software without restriction, including without limitation the rights
- *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- *   copies of the Software, and to permit persons to whom the Software is
- *   furnished to do so, subject to the following conditions:
- *
- *   The above copyright notice and this permission notice shall be included in
- *   all copies or substantial portions of the Software.
- *
- *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
- *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
- *   THE SOFTWARE.
- */
-
 #include "slib/core/regex.h"
 
+#include "slib/core/hash_map.h"
+#include "slib/core/flat_hash_map.h"
+#include "slib/core/sort.h"
 #include "slib/core/safe_static.h"
 
 #include <regex>
 
+#define PRIV_SLIB_REGEX_MAX_DEPTH 256
+#define PRIV_SLIB_REGEX_MAX_REPEAT 1000
+#define PRIV_SLIB_REGEX_MAX_INSTRUCTIONS 65536
+#define PRIV_SLIB_REGEX_MAX_DFA_STATES 2048
+#define PRIV_SLIB_REGEX_MAX_DFA_TABLE 0x100000
+#define PRIV_SLIB_REGEX_MAX_CODE 0x10FFFF
+#define PRIV_SLIB_REGEX_INFINITE 0xFFFFFFFF
+#define PRIV_SLIB_REGEX_CACHE_SIZE 256
+
 namespace slib
 {
+
+	enum class _priv_RegExOp
+	{
+		Char = 0,
+		Split = 1,
+		Jump = 2,
+		Bol = 3,
+		Eol = 4,
+		WordBoundary = 5,
+		NotWordBoundary = 6,
+		Match = 7
+	};
+
+	class _priv_RegExInst
+	{
+	public:
+		_priv_RegExOp op;
+		sl_uint32 x; // Char: set index, Split/Jump: target, Match: pattern index
+		sl_uint32 y; // Split: second target
+	};
+
+	class _priv_RegExRange
+	{
+	public:
+		sl_uint32 first;
+		sl_uint32 last;
+	};
+
+	class _priv_RegExRangeCompare
+	{
+	public:
+		SLIB_INLINE int operator()(const _priv_RegExRange& a, const _priv_RegExRange& b) const noexcept
+		{
+			return a.first < b.first ? -1 : (a.first > b.first ? 1 : 0);
+		}
+	};
+
+	class _priv_RegExCharSet
+	{
+	public:
+		List<_priv_RegExRange> ranges;
+		sl_uint32 ascii[4];
+
+	public:
+		_priv_RegExCharSet() noexcept
+		{
+			Base::zeroMemory(ascii, sizeof(ascii));
+		}
+
+	public:
+		void add(sl_uint32 first, sl_uint32 last) noexcept
+		{
+			_priv_RegExRange range;
+			range.first = first;
+			range.last = last;
+			ranges.add_NoLock(range);
+		}
+
+		void add(sl_uint32 c) noexcept
+		{
+			add(c, c);
+		}
+
+		void add(const _priv_RegExCharSet& other) noexcept
+		{
+			ranges.addAll_NoLock(other.ranges);
+		}
+
+		// sorts and merges the ranges, and builds the ASCII bitmap
+		void normalize() noexcept
+		{
+			sl_size n = ranges.getCount();
+			_priv_RegExRange* r = ranges.getData();
+			PdqSort::sortAsc(r, n, _priv_RegExRangeCompare());
+			sl_size k = 0;
+			for (sl_size i = 0; i < n; i++) {
+				if (k && r[i].first <= r[k - 1].last + 1) {
+					if (r[i].last > r[k - 1].last) {
+						r[k - 1].last = r[i].last;
+					}
+				} else {
+					r[k++] = r[i];
+				}
+			}
+			ranges.setCount_NoLock(k);
+			Base::zeroMemory(ascii, sizeof(ascii));
+			for (sl_size i = 0; i < k; i++) {
+				for (sl_uint32 c = r[i].first; c <= r[i].last && c < 128; c++) {
+					ascii[c >> 5] |= (1 << (c & 31));
+				}
+			}
+		}
+
+		// requires normalized ranges
+		void negate() noexcept
+		{
+			List<_priv_RegExRange> old = ranges;
+			ranges.setNull();
+			sl_uint32 start = 0;
+			ListElements<_priv_RegExRange> r(old);
+			for (sl_size i = 0; i < r.count; i++) {
+				if (r[i].first > start) {
+					add(start, r[i].first - 1);
+				}
+				start = r[i].last + 1;
+			}
+			if (start <= PRIV_SLIB_REGEX_MAX_CODE) {
+				add(start, PRIV_SLIB_REGEX_MAX_CODE);
+			}
+			normalize();
+		}
+
+		// ASCII letters only
+		void foldCase() noexcept
+		{
+			ListElements<_priv_RegExRange> r(ranges);
+			sl_size n = r.count;
+			for (sl_size i = 0; i < n; i++) {
+				sl_uint32 first = r[i].first;
+				sl_uint32 last = r[i].last;
+				if (first <= 'z' && last >= 'a') {
+					add(Math::max(first, (sl_uint32)'a') - 32, Math::min(last, (sl_uint32)'z') - 32);
+				}
+				if (first <= 'Z' && last >= 'A') {
+					add(Math::max(first, (sl_uint32)'A') + 32, Math::min(last, (sl_uint32)'Z') + 32);
+				}
+			}
+			normalize();
+		}
+
+		SLIB_INLINE sl_bool contains(sl_uint32 c) const noexcept
+		{
+			if (c < 128) {
+				return (ascii[c >> 5] >> (c & 31)) & 1;
+			}
+			_priv_RegExRange* r = ranges.getData();
+			sl_size low = 0;
+			sl_size high = ranges.getCount();
+			while (low < high) {
+				sl_size mid = (low + high) >> 1;
+				if (c < r[mid].first) {
+					high = mid;
+				} else if (c > r[mid].last) {
+					low = mid + 1;
+				} else {
+					return sl_true;
+				}
+			}
+			return sl_false;
+		}
+
+		sl_bool getSingle(sl_uint32& c) const noexcept
+		{
+			if (ranges.getCount() == 1) {
+				_priv_RegExRange* r = ranges.getData();
+				if (r->first == r->last) {
+					c = r->first;
+					return sl_true;
+				}
+			}
+			return sl_false;
+		}
+
+	};
+
+	SLIB_INLINE static sl_bool _priv_RegEx_isWord(sl_uint32 c) noexcept
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+	}
+
+	// invalid sequences are decoded byte by byte into 0xDC80~0xDCFF (lone surrogates never appear in patterns)
+	SLIB_INLINE static sl_uint32 _priv_RegEx_decode(const sl_uint8* s, sl_size len, sl_size& pos) noexcept
+	{
+		sl_uint32 c = s[pos];
+		if (c < 0x80) {
+			pos++;
+			return c;
+		}
+		sl_uint32 n;
+		sl_uint32 code;
+		if ((c & 0xE0) == 0xC0) {
+			n = 1;
+			code = c & 0x1F;
+		} else if ((c & 0xF0) == 0xE0) {
+			n = 2;
+			code = c & 0x0F;
+		} else if ((c & 0xF8) == 0xF0) {
+			n = 3;
+			code = c & 0x07;
+		} else {
+			pos++;
+			return 0xDC00 | c;
+		}
+		if (pos + n >= len) {
+			pos++;
+			return 0xDC00 | c;
+		}
+		for (sl_uint32 i = 1; i <= n; i++) {
+			sl_uint32 b = s[pos + i];
+			if ((b & 0xC0) != 0x80) {
+				pos++;
+				return 0xDC00 | c;
+			}
+			code = (code << 6) | (b & 0x3F);
+		}
+		pos += n + 1;
+		return code;
+	}
+
+	class _priv_RegExContext
+	{
+	public:
+		sl_bool flagBol;
+		sl_bool flagEol;
+		sl_bool flagWordBoundary;
+	};
+
+	// sparse set of instruction indices, filled by following the epsilon transitions
+	class _priv_RegExThreads
+	{
+	public:
+		sl_uint32* dense;
+		sl_uint32* sparse;
+		sl_uint32* stack;
+		sl_uint32 count;
+
+	public:
+		_priv_RegExThreads() noexcept: dense(sl_null), sparse(sl_null), stack(sl_null), count(0) {}
+
+		~_priv_RegExThreads() noexcept
+		{
+			if (dense) {
+				Base::freeMemory(dense);
+			}
+		}
+
+	public:
+		sl_bool init(sl_uint32 n) noexcept
+		{
+			dense = (sl_uint32*)(Base::createZeroMemory(sizeof(sl_uint32) * (4 * (sl_size)n + 2)));
+			if (dense) {
+				sparse = dense + n;
+				stack = sparse + n;
+				return sl_true;
+			}
+			return sl_false;
+		}
+
+		SLIB_INLINE sl_bool contains(sl_uint32 pc) const noexcept
+		{
+			sl_uint32 i = sparse[pc];
+			return i < count && dense[i] == pc;
+		}
+
+		void add(const _priv_RegExInst* insts, sl_uint32 pc, const _priv_RegExContext& context) noexcept
+		{
+			sl_uint32 top = 0;
+			stack[top++] = pc;
+			while (top) {
+				pc = stack[--top];
+				if (contains(pc)) {
+					continue;
+				}
+				sparse[pc] = count;
+				dense[count++] = pc;
+				const _priv_RegExInst& inst = insts[pc];
+				switch (inst.op) {
+					case _priv_RegExOp::Jump:
+						stack[top++] = inst.x;
+						break;
+					case _priv_RegExOp::Split:
+						stack[top++] = inst.y;
+						stack[top++] = inst.x;
+						break;
+					case _priv_RegExOp::Bol:
+						if (context.flagBol) {
+							stack[top++] = pc + 1;
+						}
+						break;
+					case _priv_RegExOp::Eol:
+						if (context.flagEol) {
+							stack[top++] = pc + 1;
+						}
+						break;
+					case _priv_RegExOp::WordBoundary:
+						if (context.flagWordBoundary) {
+							stack[top++] = pc + 1;
+						}
+						break;
+					case _priv_RegExOp::NotWordBoundary:
+						if (!(context.flagWordBoundary)) {
+							stack[top++] = pc + 1;
+						}
+						break;
+					default:
+						break;
+				}
+			}
+		}
+
+	};
+
+	class _priv_RegExDfa
+	{
+	public:
+		sl_bool flagValid;
+		// [0]: at the beginning of line, [1]: `NotBol`
+		sl_int32 start[2];
+		// state reached when no match is in progress (unanchored), or -1
+		sl_int32 idle;
+		// nStates * nClasses, -1 for the dead state
+		List<sl_int32> table;
+		// bit 0: matched at the current position, bit 1: matched when the input ends here
+		List<sl_uint8> accepts;
+		List< List<sl_uint32> > acceptIds;
+		List< List<sl_uint32> > acceptIdsAtEnd;
+
+	public:
+		_priv_RegExDfa() noexcept: flagValid(sl_false), idle(-1)
+		{
+			start[0] = start[1] = -1;
+		}
+
+	};
+
+	class _priv_RegExProgram : public Referable
+	{
+	public:
+		List<_priv_RegExInst> insts;
+		List<_priv_RegExCharSet> sets;
+		sl_uint32 nPatterns;
+		sl_bool flagWordBoundary;
+		// UTF-8 literal every match starts with
+		String prefix;
+
+		// code point equivalence classes
+		List<sl_uint32> classBounds;
+		sl_uint32 nClasses;
+		sl_uint32 asciiClasses[128];
+
+		_priv_RegExDfa dfaAnchored;
+		_priv_RegExDfa dfaUnanchored;
+
+	public:
+		_priv_RegExProgram() noexcept: nPatterns(0), flagWordBoundary(sl_false), nClasses(0) {}
+
+	public:
+		SLIB_INLINE sl_uint32 getClass(sl_uint32 c) const noexcept
+		{
+			if (c < 128) {
+				return asciiClasses[c];
+			}
+			const sl_uint32* b = classBounds.getData();
+			sl_uint32 low = 0;
+			sl_uint32 high = nClasses;
+			// last bound <= c
+			while (high - low > 1) {
+				sl_uint32 mid = (low + high) >> 1;
+				if (b[mid] <= c) {
+					low = mid;
+				} else {
+					high = mid;
+				}
+			}
+			return low;
+		}
+
+		void buildClasses() noexcept
+		{
+			List<sl_uint32> bounds;
+			bounds.add_NoLock(0);
+			ListElements<_priv_RegExCharSet> s(sets);
+			for (sl_size i = 0; i < s.count; i++) {
+				ListElements<_priv_RegExRange> r(s[i].ranges);
+				for (sl_size k = 0; k < r.count; k++) {
+					bounds.add_NoLock(r[k].first);
+					if (r[k].last < PRIV_SLIB_REGEX_MAX_CODE) {
+						bounds.add_NoLock(r[k].last + 1);
+					}
+				}
+			}
+			sl_uint32* b = bounds.getData();
+			sl_size n = bounds.getCount();
+			RadixSort::sortAsc(b, n);
+			sl_size k = 0;
+			for (sl_size i = 0; i < n; i++) {
+				if (!k || b[i] != b[k - 1]) {
+					b[k++] = b[i];
+				}
+			}
+			bounds.setCount_NoLock(k);
+			classBounds = bounds;
+			nClasses = (sl_uint32)k;
+			sl_uint32 index = 0;
+			for (sl_uint32 c = 0; c < 128; c++) {
+				while (index + 1 < k && b[index + 1] <= c) {
+					index++;
+				}
+				asciiClasses[c] = index;
+			}
+		}
+
+		sl_bool buildDfa(_priv_RegExDfa& dfa, sl_bool flagUnanchored) noexcept;
+
+		sl_bool runDfa(const _priv_RegExDfa& dfa, const sl_uint8* s, sl_size len, int flags, sl_bool flagSearch, sl_bool* found) const noexcept;
+
+		sl_bool runNfa(const sl_uint8* s, sl_size len, int flags, sl_bool flagSearch, sl_bool* found) const noexcept;
+
+		// `found`: null to stop at the first match, or an array of `nPatterns` flags
+		sl_bool run(const String& str, int flags, sl_bool flagSearch, sl_bool* found) const noexcept
+		{
+			const sl_uint8* s = (const sl_uint8*)(str.getData());
+			sl_size len = str.getLength();
+			if (flagSearch && (flags & RegExMatchFlags::Continuous)) {
+				if (!(flags & RegExMatchFlags::NotNull) && dfaAnchored.flagValid) {
+					return runDfa(dfaAnchored, s, len, flags, sl_true, found);
+				}
+				return runNfa(s, len, flags, sl_true, found);
+			}
+			if (!flagSearch) {
+				if (len < prefix.getLength() || !(Base::equalsMemory(s, prefix.getData(), prefix.getLength()))) {
+					return sl_false;
+				}
+				if (!len && (flags & RegExMatchFlags::NotNull)) {
+					return sl_false;
+				}
+				if (dfaAnchored.flagValid) {
+					return runDfa(dfaAnchored, s, len, flags, sl_false, found);
+				}
+			} else {
+				if (!(flags & RegExMatchFlags::NotNull) && dfaUnanchored.flagValid) {
+					return runDfa(dfaUnanchored, s, len, flags, sl_true, found);
+				}
+			}
+			return runNfa(s, len, flags, flagSearch, found);
+		}
+
+	};
+
+	class _priv_RegExDfaBuilder
+	{
+	public:
+		_priv_RegExProgram* program;
+		_priv_RegExDfa* dfa;
+		sl_bool flagUnanchored;
+		const _priv_RegExInst* insts;
+		sl_uint32 nInsts;
+		FlatHashMap<String, sl_int32> map;
+		List< List<sl_uint32> > states;
+		List<sl_uint32> key;
+		_priv_RegExThreads threads;
+
+	public:
+		// keeps the instructions which consume a character, match, or wait for the end
+		sl_int32 addState(sl_bool flagStart) noexcept
+		{
+			key.setCount_NoLock(1);
+			sl_uint32* pcs = threads.dense;
+			for (sl_uint32 i = 0; i < threads.count; i++) {
+				_priv_RegExOp op = insts[pcs[i]].op;
+				if (op == _priv_RegExOp::Char || op == _priv_RegExOp::Match || op == _priv_RegExOp::Eol) {
+					key.add_NoLock(pcs[i]);
+				}
+			}
+			sl_uint32 n = (sl_uint32)(key.getCount());
+			if (n == 1) {
+				return -1;
+			}
+			sl_uint32* k = key.getData();
+			k[0] = flagStart ? 1 : 0;
+			RadixSort::sortAsc(k + 1, n - 1);
+			String str((const sl_char8*)k, n * sizeof(sl_uint32));
+			if (str.isNull()) {
+				return -2;
+			}
+			sl_int32 index = (sl_int32)(states.getCount());
+			MapEmplaceReturn< FlatHashMapNode<String, sl_int32> > ret = map.emplace(Move(str), index);
+			if (!ret.node) {
+				return -2;
+			}
+			if (!(ret.isSuccess)) {
+				return ret.node->value;
+			}
+			if ((sl_size)index >= PRIV_SLIB_REGEX_MAX_DFA_STATES || ((sl_size)index + 1) * program->nClasses > PRIV_SLIB_REGEX_MAX_DFA_TABLE) {
+				return -2;
+			}
+			List<sl_uint32> pcs2;
+			if (!(pcs2.addElements_NoLock(k, n))) {
+				return -2;
+			}
+			if (!(states.add_NoLock(Move(pcs2)))) {
+				return -2;
+			}
+			if (!(dfa->table.addElements_NoLock(program->nClasses, -1))) {
+				return -2;
+			}
+			// acceptance
+			List<sl_uint32> ids;
+			for (sl_uint32 i = 1; i < n; i++) {
+				const _priv_RegExInst& inst = insts[k[i]];
+				if (inst.op == _priv_RegExOp::Match) {
+					ids.add_NoLock(inst.x);
+				}
+			}
+			_priv_RegExThreads end;
+			if (!(end.init(nInsts))) {
+				return -2;
+			}
+			_priv_RegExContext context;
+			context.flagBol = flagStart;
+			context.flagEol = sl_true;
+			context.flagWordBoundary = sl_false;
+			for (sl_uint32 i = 1; i < n; i++) {
+				end.add(insts, k[i], context);
+			}
+			List<sl_uint32> idsAtEnd;
+			for (sl_uint32 i = 0; i < end.count; i++) {
+				const _priv_RegExInst& inst = insts[end.dense[i]];
+				if (inst.op == _priv_RegExOp::Match) {
+					idsAtEnd.add_NoLock(inst.x);
+				}
+			}
+			RadixSort::sortAsc(ids.getData(), ids.getCount());
+			RadixSort::sortAsc(idsAtEnd.getData(), idsAtEnd.getCount());
+			sl_uint8 accept = 0;
+			if (ids.isNotEmpty()) {
+				accept |= 1;
+			}
+			if (idsAtEnd.isNotEmpty()) {
+				accept |= 2;
+			}
+			dfa->accepts.add_NoLock(accept);
+			dfa->acceptIds.add_NoLock(Move(ids));
+			dfa->acceptIdsAtEnd.add_NoLock(Move(idsAtEnd));
+			return index;
+		}
+
+		sl_bool build() noexcept
+		{
+			insts = program->insts.getData();
+			nInsts = (sl_uint32)(program->insts.getCount());
+			if (!(threads.init(nInsts))) {
+				return sl_false;
+			}
+			_priv_RegExContext context;
+			context.flagEol = sl_false;
+			context.flagWordBoundary = sl_false;
+			for (sl_uint32 i = 0; i < 2; i++) {
+				context.flagBol = !i;
+				threads.count = 0;
+				threads.add(insts, 0, context);
+				sl_int32 s = addState(!i);
+				if (s == -2) {
+					return sl_false;
+				}
+				dfa->start[i] = s;
+			}
+			context.flagBol = sl_false;
+			if (flagUnanchored) {
+				threads.count = 0;
+				threads.add(insts, 0, context);
+				sl_int32 s = addState(sl_false);
+				if (s == -2) {
+					return sl_false;
+				}
+				dfa->idle = s;
+			}
+			sl_uint32 nClasses = program->nClasses;
+			const sl_uint32* bounds = program->classBounds.getData();
+			const _priv_RegExCharSet* sets = program->sets.getData();
+			for (sl_size iState = 0; iState < states.getCount(); iState++) {
+				List<sl_uint32> pcs = states.getValueAt_NoLock(iState);
+				const sl_uint32* p = pcs.getData();
+				sl_uint32 n = (sl_uint32)(pcs.getCount());
+				for (sl_uint32 iClass = 0; iClass < nClasses; iClass++) {
+					sl_uint32 c = bounds[iClass];
+					threads.count = 0;
+					for (sl_uint32 i = 1; i < n; i++) {
+						const _priv_RegExInst& inst = insts[p[i]];
+						if (inst.op == _priv_RegExOp::Char && sets[inst.x].contains(c)) {
+							threads.add(insts, p[i] + 1, context);
+						}
+					}
+					if (flagUnanchored) {
+						threads.add(insts, 0, context);
+					}
+					sl_int32 s = addState(sl_false);
+					if (s == -2) {
+						return sl_false;
+					}
+					dfa->table.getData()[iState * nClasses + iClass] = s;
+				}
+			}
+			return sl_true;
+		}
+
+	};
+
+	sl_bool _priv_RegExProgram::buildDfa(_priv_RegExDfa& dfa, sl_bool flagUnanchored) noexcept
+	{
+		_priv_RegExDfaBuilder builder;
+		builder.program = this;
+		builder.dfa = &dfa;
+		builder.flagUnanchored = flagUnanchored;
+		if (builder.build()) {
+			dfa.flagValid = sl_true;
+			return sl_true;
+		}
+		dfa.table.setNull();
+		dfa.accepts.setNull();
+		dfa.acceptIds.setNull();
+		dfa.acceptIdsAtEnd.setNull();
+		return sl_false;
+	}
+
+	static sl_bool _priv_RegEx_accept(const List<sl_uint32>& ids, sl_bool* found, sl_uint32 nPatterns, sl_uint32& nFound) noexcept
+	{
+		ListElements<sl_uint32> list(ids);
+		for (sl_size i = 0; i < list.count; i++) {
+			sl_uint32 id = list[i];
+			if (!(found[id])) {
+				found[id] = sl_true;
+				nFound++;
+			}
+		}
+		return nFound == nPatterns;
+	}
+
+	sl_bool _priv_RegExProgram::runDfa(const _priv_RegExDfa& dfa, const sl_uint8* s, sl_size len, int flags, sl_bool flagSearch, sl_bool* found) const noexcept
+	{
+		sl_int32 state = dfa.start[(flags & RegExMatchFlags::NotBol) ? 1 : 0];
+		if (state < 0) {
+			return sl_false;
+		}
+		const sl_int32* table = dfa.table.getData();
+		const sl_uint8* accepts = dfa.accepts.getData();
+		sl_uint32 nFound = 0;
+		sl_int32 idle = -1;
+		const sl_uint8* pattern = (const sl_uint8*)(prefix.getData());
+		sl_size lenPattern = prefix.getLength();
+		if (lenPattern && flagSearch) {
+			idle = dfa.idle;
+		}
+		sl_size pos = 0;
+		for (;;) {
+			if (flagSearch && (accepts[state] & 1)) {
+				if (!found) {
+					return sl_true;
+				}
+				if (_priv_RegEx_accept(dfa.acceptIds.getValueAt_NoLock(state), found, nPatterns, nFound)) {
+					return sl_true;
+				}
+			}
+			if (pos >= len) {
+				break;
+			}
+			if (state == idle) {
+				// no match is in progress: skip to the next occurrence of the prefix
+				const sl_uint8* p = s + pos;
+				const sl_uint8* end = s + len;
+				for (;;) {
+					p = Base::findMemory(p, pattern[0], end - p);
+					if (!p) {
+						return nFound > 0;
+					}
+					if ((sl_size)(end - p) < lenPattern) {
+						return nFound > 0;
+					}
+					if (Base::equalsMemory(p, pattern, lenPattern)) {
+						break;
+					}
+					p++;
+				}
+				pos = p - s;
+			}
+			sl_uint32 c = s[pos];
+			if (c < 0x80) {
+				c = asciiClasses[c];
+				pos++;
+			} else {
+				c = getClass(_priv_RegEx_decode(s, len, pos));
+			}
+			state = table[(sl_size)state * nClasses + c];
+			if (state < 0) {
+				return nFound > 0;
+			}
+		}
+		if (flags & RegExMatchFlags::NotEol) {
+			if (!flagSearch && (accepts[state] & 1)) {
+				if (found) {
+					_priv_RegEx_accept(dfa.acceptIds.getValueAt_NoLock(state), found, nPatterns, nFound);
+				}
+				return sl_true;
+			}
+		} else {
+			if (accepts[state] & 2) {
+				if (found) {
+					_priv_RegEx_accept(dfa.acceptIdsAtEnd.getValueAt_NoLock(state), found, nPatterns, nFound);
+				}
+				return sl_true;
+			}
+		}
+		return nFound > 0;
+	}
+
+	sl_bool _priv_RegExProgram::runNfa(const sl_uint8* s, sl_size len, int flags, sl_bool flagSearch, sl_bool* found) const noexcept
+	{
+		sl_uint32 nInsts = (sl_uint32)(insts.getCount());
+		_priv_RegExThreads list1, list2;
+		if (!(list1.init(nInsts)) || !(list2.init(nInsts))) {
+			return sl_false;
+		}
+		_priv_RegExThreads* current = &list1;
+		_priv_RegExThreads* next = &list2;
+		const _priv_RegExInst* insts = this->insts.getData();
+		const _priv_RegExCharSet* sets = this->sets.getData();
+		sl_bool flagUnanchored = flagSearch && !(flags & RegExMatchFlags::Continuous);
+		sl_bool flagNotNull = (flags & RegExMatchFlags::NotNull) != 0;
+		sl_uint32 nFound = 0;
+
+		sl_size pos = 0;
+		sl_size posNext = 0;
+		sl_uint32 c = 0;
+		sl_bool flagPrevWord = sl_false;
+		sl_bool flagNextWord = sl_false;
+		if (len) {
+			c = _priv_RegEx_decode(s, len, posNext);
+			flagNextWord = _priv_RegEx_isWord(c);
+		}
+		_priv_RegExContext context;
+		context.flagBol = !(flags & RegExMatchFlags::NotBol);
+		context.flagEol = !len && !(flags & RegExMatchFlags::NotEol);
+		context.flagWordBoundary = flagNextWord && !(flags & RegExMatchFlags::NotBow);
+		if (!len && (flags & RegExMatchFlags::NotEow)) {
+			context.flagWordBoundary = sl_false;
+		}
+		for (;;) {
+			// with `NotNull`, the threads starting here are added after checking the matches
+			for (sl_uint32 step = 0; step < 2; step++) {
+				if ((step == 0) == flagNotNull) {
+					if (flagSearch || pos == len) {
+						for (sl_uint32 i = 0; i < current->count; i++) {
+							const _priv_RegExInst& inst = insts[current->dense[i]];
+							if (inst.op == _priv_RegExOp::Match) {
+								if (!found) {
+									return sl_true;
+								}
+								if (!(found[inst.x])) {
+									found[inst.x] = sl_true;
+									nFound++;
+									if (nFound == nPatterns) {
+										return sl_true;
+									}
+								}
+							}
+						}
+					}
+				} else {
+					if (!pos || flagUnanchored) {
+						current->add(insts, 0, context);
+					}
+				}
+			}
+			if (pos >= len) {
+				break;
+			}
+			if (!(current->count) && !flagUnanchored) {
+				break;
+			}
+			// step over `c`
+			pos = posNext;
+			flagPrevWord = flagNextWord;
+			sl_uint32 cNext = 0;
+			if (pos < len) {
+				cNext = _priv_RegEx_decode(s, len, posNext);
+				flagNextWord = _priv_RegEx_isWord(cNext);
+			} else {
+				flagNextWord = sl_false;
+			}
+			context.flagBol = sl_false;
+			context.flagEol = pos >= len && !(flags & RegExMatchFlags::NotEol);
+			context.flagWordBoundary = flagPrevWord != flagNextWord;
+			if (pos >= len && (flags & RegExMatchFlags::NotEow)) {
+				context.flagWordBoundary = sl_false;
+			}
+			next->count = 0;
+			for (sl_uint32 i = 0; i < current->count; i++) {
+				sl_uint32 pc = current->dense[i];
+				const _priv_RegExInst& inst = insts[pc];
+				if (inst.op == _priv_RegExOp::Char && sets[inst.x].contains(c)) {
+					next->add(insts, pc + 1, context);
+				}
+			}
+			_priv_RegExThreads* t = current;
+			current = next;
+			next = t;
+			c = cNext;
+		}
+		return nFound > 0;
+	}
+
+	enum class _priv_RegExNodeType
+	{
+		Empty,
+		Set,
+		Concat,
+		Alternate,
+		Repeat,
+		Bol,
+		Eol,
+		WordBoundary,
+		NotWordBoundary
+	};
+
+	class _priv_RegExNode
+	{
+	public:
+		_priv_RegExNodeType type;
+		sl_uint32 min; // Set: set index
+		sl_uint32 max;
+		List<sl_int32> children;
+	};
+
+	// ECMAScript grammar
+	class _priv_RegExParser
+	{
+	public:
+		const sl_uint8* data;
+		sl_size len;
+		sl_size pos;
+		sl_bool flagIcase;
+		sl_uint32 depth;
+		_priv_RegExProgram* program;
+		List<_priv_RegExNode> nodes;
+
+	public:
+		sl_int32 parse() noexcept
+		{
+			pos = 0;
+			depth = 0;
+			sl_int32 root = parseAlternate();
+			if (root < 0 || pos != len) {
+				return -1;
+			}
+			return root;
+		}
+
+	private:
+		sl_int32 addNode(_priv_RegExNodeType type, sl_uint32 min = 0, sl_uint32 max = 0) noexcept
+		{
+			_priv_RegExNode node;
+			node.type = type;
+			node.min = min;
+			node.max = max;
+			sl_int32 index = (sl_int32)(nodes.getCount());
+			if (nodes.add_NoLock(Move(node))) {
+				return index;
+			}
+			return -1;
+		}
+
+		sl_int32 addSet(_priv_RegExCharSet& set) noexcept
+		{
+			if (flagIcase) {
+				set.foldCase();
+			}
+			sl_uint32 index = (sl_uint32)(program->sets.getCount());
+			if (program->sets.add_NoLock(set)) {
+				return addNode(_priv_RegExNodeType::Set, index);
+			}
+			return -1;
+		}
+
+		sl_int32 parseAlternate() noexcept
+		{
+			if (depth >= PRIV_SLIB_REGEX_MAX_DEPTH) {
+				return -1;
+			}
+			depth++;
+			sl_int32 first = parseConcat();
+			if (first < 0) {
+				return -1;
+			}
+			if (pos >= len || data[pos] != '|') {
+				depth--;
+				return first;
+			}
+			sl_int32 ret = addNode(_priv_RegExNodeType::Alternate);
+			if (ret < 0) {
+				return -1;
+			}
+			List<sl_int32> children;
+			children.add_NoLock(first);
+			while (pos < len && data[pos] == '|') {
+				pos++;
+				sl_int32 child = parseConcat();
+				if (child < 0) {
+					return -1;
+				}
+				children.add_NoLock(child);
+			}
+			nodes.getPointerAt(ret)->children = children;
+			depth--;
+			return ret;
+		}
+
+		sl_int32 parseConcat() noexcept
+		{
+			List<sl_int32> children;
+			while (pos < len && data[pos] != '|' && data[pos] != ')') {
+				sl_int32 child = parseRepeat();
+				if (child < 0) {
+					return -1;
+				}
+				children.add_NoLock(child);
+			}
+			sl_size n = children.getCount();
+			if (!n) {
+				return addNode(_priv_RegExNodeType::Empty);
+			}
+			if (n == 1) {
+				return children.getValueAt_NoLock(0);
+			}
+			sl_int32 ret = addNode(_priv_RegExNodeType::Concat);
+			if (ret < 0) {
+				return -1;
+			}
+			nodes.getPointerAt(ret)->children = children;
+			return ret;
+		}
+
+		sl_bool parseNumber(sl_uint32& n) noexcept
+		{
+			sl_size start = pos;
+			n = 0;
+			while (pos < len && data[pos] >= '0' && data[pos] <= '9') {
+				n = n * 10 + (data[pos] - '0');
+				if (n > PRIV_SLIB_REGEX_MAX_REPEAT) {
+					return sl_false;
+				}
+				pos++;
+			}
+			return pos > start;
+		}
+
+		sl_int32 parseRepeat() noexcept
+		{
+			sl_int32 atom = parseAtom();
+			if (atom < 0 || pos >= len) {
+				return atom;
+			}
+			sl_uint32 min, max;
+			switch (data[pos]) {
+				case '*':
+					min = 0;
+					max = PRIV_SLIB_REGEX_INFINITE;
+					pos++;
+					break;
+				case '+':
+					min = 1;
+					max = PRIV_SLIB_REGEX_INFINITE;
+					pos++;
+					break;
+				case '?':
+					min = 0;
+					max = 1;
+					pos++;
+					break;
+				case '{':
+					pos++;
+					if (!(parseNumber(min))) {
+						return -1;
+					}
+					if (pos < len && data[pos] == ',') {
+						pos++;
+						if (pos < len && data[pos] == '}') {
+							max = PRIV_SLIB_REGEX_INFINITE;
+						} else {
+							if (!(parseNumber(max)) || max < min) {
+								return -1;
+							}
+						}
+					} else {
+						max = min;
+					}
+					if (pos >= len || data[pos] != '}') {
+						return -1;
+					}
+					pos++;
+					break;
+				default:
+					return atom;
+			}
+			switch (nodes.getPointerAt(atom)->type) {
+				case _priv_RegExNodeType::Bol:
+				case _priv_RegExNodeType::Eol:
+				case _priv_RegExNodeType::WordBoundary:
+				case _priv_RegExNodeType::NotWordBoundary:
+					return -1;
+				default:
+					break;
+			}
+			// lazy quantifier: same language
+			if (pos < len && data[pos] == '?') {
+				pos++;
+			}
+			if (pos < len) {
+				sl_uint8 c = data[pos];
+				if (c == '*' || c == '+' || c == '?' || c == '{') {
+					return -1;
+				}
+			}
+			sl_int32 ret = addNode(_priv_RegExNodeType::Repeat, min, max);
+			if (ret < 0) {
+				return -1;
+			}
+			nodes.getPointerAt(ret)->children.add_NoLock(atom);
+			return ret;
+		}
+
+		sl_int32 parseAtom() noexcept
+		{
+			sl_uint8 c = data[pos];
+			switch (c) {
+				case '(':
+					{
+						pos++;
+						if (pos < len && data[pos] == '?') {
+							// look-around is not supported
+							if (pos + 1 < len && data[pos + 1] == ':') {
+								pos += 2;
+							} else {
+								return -1;
+							}
+						}
+						sl_int32 ret = parseAlternate();
+						if (ret < 0 || pos >= len || data[pos] != ')') {
+							return -1;
+						}
+						pos++;
+						return ret;
+					}
+				case '[':
+					{
+						pos++;
+						_priv_RegExCharSet set;
+						if (!(parseClass(set))) {
+							return -1;
+						}
+						return addSet(set);
+					}
+				case '.':
+					{
+						pos++;
+						_priv_RegExCharSet set;
+						set.add('\n');
+						set.add('\r');
+						set.add(0x2028, 0x2029);
+						set.normalize();
+						set.negate();
+						return addSet(set);
+					}
+				case '^':
+					pos++;
+					return addNode(_priv_RegExNodeType::Bol);
+				case '$':
+					pos++;
+					return addNode(_priv_RegExNodeType::Eol);
+				case '\\':
+					{
+						pos++;
+						_priv_RegExCharSet set;
+						int ret = parseEscape(set, sl_false);
+						if (ret == 1) {
+							return addSet(set);
+						} else if (ret == 2) {
+							return addNode(_priv_RegExNodeType::WordBoundary);
+						} else if (ret == 3) {
+							return addNode(_priv_RegExNodeType::NotWordBoundary);
+						}
+						return -1;
+					}
+				case '*':
+				case '+':
+				case '?':
+				case '{':
+				case ')':
+					return -1;
+				default:
+					{
+						_priv_RegExCharSet set;
+						set.add(_priv_RegEx_decode(data, len, pos));
+						set.normalize();
+						return addSet(set);
+					}
+			}
+		}
+
+		static void addDigit(_priv_RegExCharSet& set) noexcept
+		{
+			set.add('0', '9');
+		}
+
+		static void addWord(_priv_RegExCharSet& set) noexcept
+		{
+			set.add('a', 'z');
+			set.add('A', 'Z');
+			set.add('0', '9');
+			set.add('_');
+		}
+
+		static void addSpace(_priv_RegExCharSet& set) noexcept
+		{
+			set.add('\t', '\r');
+			set.add(' ');
+			set.add(0xA0);
+			set.add(0x1680);
+			set.add(0x2000, 0x200A);
+			set.add(0x2028, 0x2029);
+			set.add(0x202F);
+			set.add(0x205F);
+			set.add(0x3000);
+			set.add(0xFEFF);
+		}
+
+		static void addNegated(_priv_RegExCharSet& set, void (*fn)(_priv_RegExCharSet&)) noexcept
+		{
+			_priv_RegExCharSet other;
+			fn(other);
+			other.normalize();
+			other.negate();
+			set.add(other);
+		}
+
+		sl_bool parseHex(sl_uint32 nDigits, sl_uint32& value) noexcept
+		{
+			if (pos + nDigits > len) {
+				return sl_false;
+			}
+			value = 0;
+			for (sl_uint32 i = 0; i < nDigits; i++) {
+				sl_uint32 h = data[pos + i];
+				if (h >= '0' && h <= '9') {
+					h -= '0';
+				} else if (h >= 'a' && h <= 'f') {
+					h -= 'a' - 10;
+				} else if (h >= 'A' && h <= 'F') {
+					h -= 'A' - 10;
+				} else {
+					return sl_false;
+				}
+				value = (value << 4) | h;
+			}
+			pos += nDigits;
+			return sl_true;
+		}
+
+		// after '\\'. returns 1 for a character set, 2 for `\b`, 3 for `\B`, 0 on unsupported escapes
+		int parseEscape(_priv_RegExCharSet& set, sl_bool flagInClass) noexcept
+		{
+			if (pos >= len) {
+				return 0;
+			}
+			sl_uint32 c = data[pos++];
+			switch (c) {
+				case 'd':
+					addDigit(set);
+					break;
+				case 'D':
+					addNegated(set, addDigit);
+					break;
+				case 'w':
+					addWord(set);
+					break;
+				case 'W':
+					addNegated(set, addWord);
+					break;
+				case 's':
+					addSpace(set);
+					break;
+				case 'S':
+					addNegated(set, addSpace);
+					break;
+				case 'b':
+					if (flagInClass) {
+						set.add(8);
+						break;
+					}
+					return 2;
+				case 'B':
+					if (flagInClass) {
+						return 0;
+					}
+					return 3;
+				case 'n':
+					set.add('\n');
+					break;
+				case 'r':
+					set.add('\r');
+					break;
+				case 't':
+					set.add('\t');
+					break;
+				case 'f':
+					set.add('\f');
+					break;
+				case 'v':
+					set.add('\v');
+					break;
+				case '0':
+					if (pos < len && data[pos] >= '0' && data[pos] <= '9') {
+						return 0;
+					}
+					set.add(0);
+					break;
+				case 'x':
+					if (!(parseHex(2, c))) {
+						return 0;
+					}
+					set.add(c);
+					break;
+				case 'u':
+					if (!(parseHex(4, c))) {
+						return 0;
+					}
+					set.add(c);
+					break;
+				case 'c':
+					if (pos < len && ((data[pos] >= 'a' && data[pos] <= 'z') || (data[pos] >= 'A' && data[pos] <= 'Z'))) {
+						set.add(data[pos++] & 31);
+						break;
+					}
+					return 0;
+				default:
+					if (c >= '1' && c <= '9') {
+						// back-reference
+						return 0;
+					}
+					if (_priv_RegEx_isWord(c)) {
+						return 0;
+					}
+					pos--;
+					set.add(_priv_RegEx_decode(data, len, pos));
+					break;
+			}
+			set.normalize();
+			return 1;
+		}
+
+		sl_bool parsePosixClass(_priv_RegExCharSet& set) noexcept
+		{
+			sl_size start = pos;
+			while (pos + 1 < len && !(data[pos] == ':' && data[pos + 1] == ']')) {
+				pos++;
+			}
+			if (pos + 1 >= len) {
+				return sl_false;
+			}
+			String name((const sl_char8*)(data + start), pos - start);
+			pos += 2;
+			if (name == "alpha") {
+				set.add('a', 'z');
+				set.add('A', 'Z');
+			} else if (name == "digit" || name == "d") {
+				addDigit(set);
+			} else if (name == "alnum") {
+				set.add('a', 'z');
+				set.add('A', 'Z');
+				set.add('0', '9');
+			} else if (name == "w") {
+				addWord(set);
+			} else if (name == "space" || name == "s") {
+				set.add('\t', '\r');
+				set.add(' ');
+			} else if (name == "upper") {
+				set.add('A', 'Z');
+				if (flagIcase) {
+					set.add('a', 'z');
+				}
+			} else if (name == "lower") {
+				set.add('a', 'z');
+				if (flagIcase) {
+					set.add('A', 'Z');
+				}
+			} else if (name == "xdigit") {
+				set.add('0', '9');
+				set.add('a', 'f');
+				set.add('A', 'F');
+			} else if (name == "blank") {
+				set.add('\t');
+				set.add(' ');
+			} else if (name == "cntrl") {
+				set.add(0, 0x1F);
+				set.add(0x7F);
+			} else if (name == "punct") {
+				set.add(0x21, 0x2F);
+				set.add(0x3A, 0x40);
+				set.add(0x5B, 0x60);
+				set.add(0x7B, 0x7E);
+			} else if (name == "print") {
+				set.add(0x20, 0x7E);
+			} else if (name == "graph") {
+				set.add(0x21, 0x7E);
+			} else {
+				return sl_false;
+			}
+			return sl_true;
+		}
+
+		// after '['
+		sl_bool parseClass(_priv_RegExCharSet& set) noexcept
+		{
+			sl_bool flagNegate = sl_false;
+			if (pos < len && data[pos] == '^') {
+				flagNegate = sl_true;
+				pos++;
+			}
+			// `[]` and `[^]` differ between implementations
+			if (pos < len && data[pos] == ']') {
+				return sl_false;
+			}
+			for (;;) {
+				if (pos >= len) {
+					return sl_false;
+				}
+				sl_uint32 c = data[pos];
+				if (c == ']') {
+					pos++;
+					break;
+				}
+				sl_uint32 first;
+				if (!(parseClassAtom(set, first))) {
+					return sl_false;
+				}
+				if (first == PRIV_SLIB_REGEX_INFINITE) {
+					continue;
+				}
+				if (pos + 1 < len && data[pos] == '-' && data[pos + 1] != ']') {
+					pos++;
+					sl_uint32 last;
+					if (!(parseClassAtom(set, last))) {
+						return sl_false;
+					}
+					if (last == PRIV_SLIB_REGEX_INFINITE || last < first) {
+						return sl_false;
+					}
+					set.add(first, last);
+				} else {
+					set.add(first);
+				}
+			}
+			set.normalize();
+			if (flagNegate) {
+				if (flagIcase) {
+					set.foldCase();
+				}
+				set.negate();
+			}
+			return sl_true;
+		}
+
+		// `c`: a single character, or PRIV_SLIB_REGEX_INFINITE when a class was added to `set`
+		sl_bool parseClassAtom(_priv_RegExCharSet& set, sl_uint32& c) noexcept
+		{
+			c = data[pos];
+			if (c == '[' && pos + 1 < len && data[pos + 1] == ':') {
+				pos += 2;
+				c = PRIV_SLIB_REGEX_INFINITE;
+				return parsePosixClass(set);
+			}
+			if (c == '\\') {
+				pos++;
+				_priv_RegExCharSet sub;
+				if (parseEscape(sub, sl_true) != 1) {
+					return sl_false;
+				}
+				if (!(sub.getSingle(c))) {
+					c = PRIV_SLIB_REGEX_INFINITE;
+					set.add(sub);
+				}
+				return sl_true;
+			}
+			c = _priv_RegEx_decode(data, len, pos);
+			return sl_true;
+		}
+
+	};
+
+	class _priv_RegExCompiler
+	{
+	public:
+		_priv_RegExProgram* program;
+		_priv_RegExParser* parser;
+
+	public:
+		sl_uint32 getPosition() noexcept
+		{
+			return (sl_uint32)(program->insts.getCount());
+		}
+
+		sl_bool emit(_priv_RegExOp op, sl_uint32 x = 0, sl_uint32 y = 0) noexcept
+		{
+			if (program->insts.getCount() >= PRIV_SLIB_REGEX_MAX_INSTRUCTIONS) {
+				return sl_false;
+			}
+			_priv_RegExInst inst;
+			inst.op = op;
+			inst.x = x;
+			inst.y = y;
+			return program->insts.add_NoLock(inst);
+		}
+
+		_priv_RegExInst& getInst(sl_uint32 pc) noexcept
+		{
+			return *(program->insts.getPointerAt(pc));
+		}
+
+		sl_bool compile(sl_int32 index) noexcept
+		{
+			_priv_RegExNode* node = parser->nodes.getPointerAt(index);
+			_priv_RegExNodeType type = node->type;
+			sl_uint32 min = node->min;
+			sl_uint32 max = node->max;
+			List<sl_int32> children = node->children;
+			ListElements<sl_int32> c(children);
+			switch (type) {
+				case _priv_RegExNodeType::Empty:
+					return sl_true;
+				case _priv_RegExNodeType::Set:
+					return emit(_priv_RegExOp::Char, min);
+				case _priv_RegExNodeType::Bol:
+					return emit(_priv_RegExOp::Bol);
+				case _priv_RegExNodeType::Eol:
+					return emit(_priv_RegExOp::Eol);
+				case _priv_RegExNodeType::WordBoundary:
+					program->flagWordBoundary = sl_true;
+					return emit(_priv_RegExOp::WordBoundary);
+				case _priv_RegExNodeType::NotWordBoundary:
+					program->flagWordBoundary = sl_true;
+					return emit(_priv_RegExOp::NotWordBoundary);
+				case _priv_RegExNodeType::Concat:
+					for (sl_size i = 0; i < c.count; i++) {
+						if (!(compile(c[i]))) {
+							return sl_false;
+						}
+					}
+					return sl_true;
+				case _priv_RegExNodeType::Alternate:
+					{
+						List<sl_uint32> jumps;
+						for (sl_size i = 0; i < c.count; i++) {
+							if (i + 1 < c.count) {
+								sl_uint32 split = getPosition();
+								if (!(emit(_priv_RegExOp::Split, split + 1))) {
+									return sl_false;
+								}
+								if (!(compile(c[i]))) {
+									return sl_false;
+								}
+								jumps.add_NoLock(getPosition());
+								if (!(emit(_priv_RegExOp::Jump))) {
+									return sl_false;
+								}
+								getInst(split).y = getPosition();
+							} else {
+								if (!(compile(c[i]))) {
+									return sl_false;
+								}
+							}
+						}
+						sl_uint32 end = getPosition();
+						ListElements<sl_uint32> j(jumps);
+						for (sl_size i = 0; i < j.count; i++) {
+							getInst(j[i]).x = end;
+						}
+						return sl_true;
+					}
+				case _priv_RegExNodeType::Repeat:
+					{
+						sl_int32 child = c[0];
+						for (sl_uint32 i = 0; i < min; i++) {
+							if (!(compile(child))) {
+								return sl_false;
+							}
+						}
+						if (max == PRIV_SLIB_REGEX_INFINITE) {
+							sl_uint32 loop = getPosition();
+							if (!(emit(_priv_RegExOp::Split, loop + 1))) {
+								return sl_false;
+							}
+							if (!(compile(child))) {
+								return sl_false;
+							}
+							if (!(emit(_priv_RegExOp::Jump, loop))) {
+								return sl_false;
+							}
+							getInst(loop).y = getPosition();
+						} else {
+							List<sl_uint32> splits;
+							for (sl_uint32 i = min; i < max; i++) {
+								sl_uint32 split = getPosition();
+								splits.add_NoLock(split);
+								if (!(emit(_priv_RegExOp::Split, split + 1))) {
+									return sl_false;
+								}
+								if (!(compile(child))) {
+									return sl_false;
+								}
+							}
+							sl_uint32 end = getPosition();
+							ListElements<sl_uint32> s(splits);
+							for (sl_size i = 0; i < s.count; i++) {
+								getInst(s[i]).y = end;
+							}
+						}
+						return sl_true;
+					}
+			}
+			return sl_false;
+		}
+
+		// literal every match of the node starts with
+		void getPrefix(sl_int32 index, List<sl_uint32>& prefix, sl_bool& flagComplete) noexcept
+		{
+			_priv_RegExNode* node = parser->nodes.getPointerAt(index);
+			switch (node->type) {
+				case _priv_RegExNodeType::Empty:
+					return;
+				case _priv_RegExNodeType::Set:
+					{
+						sl_uint32 c;
+						if (program->sets.getPointerAt(node->min)->getSingle(c)) {
+							prefix.add_NoLock(c);
+							return;
+						}
+						break;
+					}
+				case _priv_RegExNodeType::Concat:
+					{
+						ListElements<sl_int32> c(node->children);
+						for (sl_size i = 0; i < c.count && flagComplete; i++) {
+							getPrefix(c[i], prefix, flagComplete);
+						}
+						return;
+					}
+				case _priv_RegExNodeType::Repeat:
+					if (node->min) {
+						getPrefix(node->children.getValueAt_NoLock(0), prefix, flagComplete);
+					}
+					break;
+				default:
+					break;
+			}
+			flagComplete = sl_false;
+		}
+
+	};
+
+	static Ref<_priv_RegExProgram> _priv_RegEx_compile(const String* patterns, sl_size nPatterns, int flags) noexcept
+	{
+		if (!nPatterns) {
+			return sl_null;
+		}
+		if (flags & (RegExFlags::Collate | RegExFlags::Basic | RegExFlags::Extended | RegExFlags::Awk | RegExFlags::Grep | RegExFlags::Egrep)) {
+			return sl_null;
+		}
+		Ref<_priv_RegExProgram> program = new _priv_RegExProgram;
+		if (program.isNull()) {
+			return sl_null;
+		}
+		program->nPatterns = (sl_uint32)nPatterns;
+		List<sl_uint32> prefix;
+		for (sl_size i = 0; i < nPatterns; i++) {
+			_priv_RegExParser parser;
+			parser.data = (const sl_uint8*)(patterns[i].getData());
+			parser.len = patterns[i].getLength();
+			parser.flagIcase = (flags & RegExFlags::Icase) != 0;
+			parser.program = program.get();
+			sl_int32 root = parser.parse();
+			if (root < 0) {
+				return sl_null;
+			}
+			_priv_RegExCompiler compiler;
+			compiler.program = program.get();
+			compiler.parser = &parser;
+			sl_uint32 split = 0;
+			if (i + 1 < nPatterns) {
+				split = compiler.getPosition();
+				if (!(compiler.emit(_priv_RegExOp::Split, split + 1))) {
+					return sl_null;
+				}
+			}
+			if (!(compiler.compile(root))) {
+				return sl_null;
+			}
+			if (!(compiler.emit(_priv_RegExOp::Match, (sl_uint32)i))) {
+				return sl_null;
+			}
+			if (i + 1 < nPatterns) {
+				compiler.getInst(split).y = compiler.getPosition();
+			}
+			if (nPatterns == 1) {
+				sl_bool flagComplete = sl_true;
+				compiler.getPrefix(root, prefix, flagComplete);
+			}
+		}
+		ListElements<sl_uint32> p(prefix);
+		for (sl_size i = 0; i < p.count; i++) {
+			if (p[i] >= 0xD800 && p[i] < 0xE000) {
+				p.count = i;
+				break;
+			}
+		}
+		if (p.count) {
+			program->prefix = String::fromUtf32((const sl_char32*)(p.data), p.count);
+		}
+		program->buildClasses();
+		if (!(program->flagWordBoundary)) {
+			if (program->buildDfa(program->dfaAnchored, sl_false)) {
+				program->buildDfa(program->dfaUnanchored, sl_true);
+			}
+		}
+		return program;
+	}
+
+	typedef CHashMap< String, Ref<CRegEx> > _priv_RegExCache;
+
+	SLIB_SAFE_STATIC_GETTER(_priv_RegExCache, _priv_RegEx_getCache)
+
 	SLIB_DEFINE_OBJECT(CRegEx, Object)
 	
 	CRegEx::CRegEx() noexcept
 	{
+		m_obj = sl_null;
 	}
 	
 	CRegEx::~CRegEx() noexcept
 	{
-		delete ((std::regex*)m_obj);
+		if (m_obj) {
+			delete ((std::regex*)m_obj);
+		}
 	}
 	
 	Ref<CRegEx> CRegEx::_create(const String& pattern, int _flags) noexcept
 	{
-		std::regex* obj = (std::regex*)(Base::createMemory(sizeof(std::regex)));
-		if (obj) {
+		_priv_RegExCache* cache = _priv_RegEx_getCache();
+		String key;
+		if (cache) {
+			key = String::fromInt32(_flags) + ":" + pattern;
+			Ref<CRegEx> ret;
+			if (cache->get(key, &ret)) {
+				return ret;
+			}
+		}
+		Ref<CRegEx> ret;
+		Ref<_priv_RegExProgram> program = _priv_RegEx_compile(&pattern, 1, _flags);
+		if (program.isNotNull()) {
+			ret = new CRegEx;
+			if (ret.isNull()) {
+				return sl_null;
+			}
+			ret->m_program = Move(program);
+		} else {
+			std::regex* obj = (std::regex*)(Base::createMemory(sizeof(std::regex)));
+			if (!obj) {
+				return sl_null;
+			}
 			int flags = 0;
 			if (_flags & RegExFlags::Icase) {
 				flags |= std::regex_constants::icase;
@@ -84,14 +1726,20 @@ namespace slib
 				Base::freeMemory(obj);
 				return sl_null;
 			}
-			Ref<CRegEx> ret = new CRegEx;
-			if (ret.isNotNull()) {
-				ret->m_obj = obj;
-				return ret;
+			ret = new CRegEx;
+			if (ret.isNull()) {
+				delete obj;
+				return sl_null;
 			}
-			delete obj;
+			ret->m_obj = obj;
 		}
-		return sl_null;
+		if (cache) {
+			if (cache->getCount() >= PRIV_SLIB_REGEX_CACHE_SIZE) {
+				cache->removeAll();
+			}
+			cache->put(key, ret);
+		}
+		return ret;
 	}
 	
 	Ref<CRegEx> CRegEx::create(const String& pattern) noexcept
@@ -104,10 +1752,9 @@ namespace slib
 		return _create(pattern, flags);
 	}
 	
-	sl_bool CRegEx::match(const String& str, const RegExMatchFlags& _flags) noexcept
+	static int _priv_RegEx_getStdMatchFlags(int v) noexcept
 	{
 		int flags = 0;
-		int v = _flags.value;
 		if (v) {
 			if (v & RegExMatchFlags::NotBol) {
 				flags |= std::regex_constants::match_not_bol;
@@ -143,12 +1790,104 @@ namespace slib
 				flags |= std::regex_constants::format_first_only;
 			}
 		}
+		return flags;
+	}
+	
+	sl_bool CRegEx::match(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		_priv_RegExProgram* program = (_priv_RegExProgram*)(m_program.get());
+		if (program) {
+			return program->run(str, flags.value, sl_false, sl_null);
+		}
+		std::regex* obj = (std::regex*)m_obj;
+		const char* start = (char*)(str.getData());
+		const char* end = start + str.getLength();
+		return std::regex_match(start, end, *obj, (std::regex_constants::match_flag_type)(_priv_RegEx_getStdMatchFlags(flags.value)));
+	}
+	
+	sl_bool CRegEx::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		_priv_RegExProgram* program = (_priv_RegExProgram*)(m_program.get());
+		if (program) {
+			return program->run(str, flags.value, sl_true, sl_null);
+		}
 		std::regex* obj = (std::regex*)m_obj;
 		const char* start = (char*)(str.getData());
 		const char* end = start + str.getLength();
-		return std::regex_match(start, end, *obj, (std::regex_constants::match_flag_type)flags);
+		return std::regex_search(start, end, *obj, (std::regex_constants::match_flag_type)(_priv_RegEx_getStdMatchFlags(flags.value)));
+	}
+	
+	
+	SLIB_DEFINE_OBJECT(RegExSet, Object)
+	
+	RegExSet::RegExSet() noexcept
+	{
+	}
+	
+	RegExSet::~RegExSet() noexcept
+	{
+	}
+	
+	Ref<RegExSet> RegExSet::create(const List<String>& _patterns, const RegExFlags& flags) noexcept
+	{
+		ListElements<String> patterns(_patterns);
+		Ref<_priv_RegExProgram> program = _priv_RegEx_compile(patterns.data, patterns.count, flags);
+		if (program.isNotNull()) {
+			Ref<RegExSet> ret = new RegExSet;
+			if (ret.isNotNull()) {
+				ret->m_program = Move(program);
+				return ret;
+			}
+		}
+		return sl_null;
 	}
 	
+	sl_uint32 RegExSet::getPatternsCount() noexcept
+	{
+		return ((_priv_RegExProgram*)(m_program.get()))->nPatterns;
+	}
+	
+	static List<sl_uint32> _priv_RegExSet_run(Referable* _program, const String& str, int flags, sl_bool flagSearch) noexcept
+	{
+		_priv_RegExProgram* program = (_priv_RegExProgram*)_program;
+		sl_uint32 n = program->nPatterns;
+		sl_bool* found = (sl_bool*)(Base::createZeroMemory(n * sizeof(sl_bool)));
+		if (!found) {
+			return sl_null;
+		}
+		List<sl_uint32> ret;
+		if (program->run(str, flags, flagSearch, found)) {
+			for (sl_uint32 i = 0; i < n; i++) {
+				if (found[i]) {
+					ret.add_NoLock(i);
+				}
+			}
+		}
+		Base::freeMemory(found);
+		return ret;
+	}
+	
+	List<sl_uint32> RegExSet::match(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		return _priv_RegExSet_run(m_program.get(), str, flags.value, sl_false);
+	}
+	
+	List<sl_uint32> RegExSet::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		return _priv_RegExSet_run(m_program.get(), str, flags.value, sl_true);
+	}
+	
+	sl_bool RegExSet::matchAny(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		return ((_priv_RegExProgram*)(m_program.get()))->run(str, flags.value, sl_false, sl_null);
+	}
+	
+	sl_bool RegExSet::searchAny(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		return ((_priv_RegExProgram*)(m_program.get()))->run(str, flags.value, sl_true, sl_null);
+	}
+	
+	
 	RegEx::RegEx(const String& pattern) noexcept
 	 : ref(CRegEx::create(pattern))
 	{
@@ -167,6 +1906,14 @@ namespace slib
 		return sl_false;
 	}
 	
+	sl_bool RegEx::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		if (ref.isNotNull()) {
+			return ref->search(str, flags);
+		}
+		return sl_false;
+	}
+	
 	Atomic<RegEx>::Atomic(const String& pattern) noexcept
 	 : ref(CRegEx::create(pattern, 0))
 	{
@@ -185,6 +1932,15 @@ namespace slib
 		}
 		return sl_false;
 	}
+	
+	sl_bool Atomic<RegEx>::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		Ref<CRegEx> ref(this->ref);
+		if (ref.isNotNull()) {
+			return ref->search(str, flags);
+		}
+		return sl_false;
+	}
 
 	
 	sl_bool RegEx::matchEmail(const String& str) noexcept
@@ -0,0 +1,125 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#include "slib/core/sort.h"
+
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/core/system.h"
+#include "slib/core/safe_static.h"
+
+#define PRIV_SLIB_PARALLEL_SORT_MIN_CHUNK_SIZE 16384
+#define PRIV_SLIB_PARALLEL_SORT_MAX_CHUNKS 64
+
+namespace slib
+{
+	
+	class _priv_ParallelSortJob : public Referable
+	{
+	public:
+		void (*task)(void* context, sl_uint32 index);
+		void* context;
+		sl_reg nTasks;
+		sl_reg indexNext;
+		sl_reg nRemaining;
+		Ref<Event> eventDone;
+		
+	public:
+		void run()
+		{
+			for (;;) {
+				sl_reg index = Base::interlockedIncrement(&indexNext) - 1;
+				if (index >= nTasks) {
+					return;
+				}
+				task(context, (sl_uint32)index);
+				if (!(Base::interlockedDecrement(&nRemaining))) {
+					eventDone->set();
+				}
+			}
+		}
+		
+	};
+	
+	SLIB_SAFE_STATIC_GETTER(Ref<ThreadPool>, _priv_ParallelSort_getDefaultPool, ThreadPool::createWorkStealing())
+	
+	sl_uint32 _priv_ParallelSort::getChunksCount(sl_size size) noexcept
+	{
+		sl_uint32 nProcessors = System::getProcessorsCount();
+		sl_uint32 n = 1;
+		while ((n << 1) <= nProcessors && n < PRIV_SLIB_PARALLEL_SORT_MAX_CHUNKS) {
+			n <<= 1;
+		}
+		while (n > 1 && size / n < PRIV_SLIB_PARALLEL_SORT_MIN_CHUNK_SIZE) {
+			n >>= 1;
+		}
+		return n;
+	}
+	
+	void _priv_ParallelSort::run(ThreadPool* _pool, sl_uint32 nTasks, void (*task)(void* context, sl_uint32 index), void* context) noexcept
+	{
+		Ref<ThreadPool> pool = _pool;
+		if (pool.isNull()) {
+			Ref<ThreadPool>* pPool = _priv_ParallelSort_getDefaultPool();
+			if (pPool) {
+				pool = *pPool;
+			}
+		}
+		Ref<_priv_ParallelSortJob> job;
+		if (nTasks > 1 && pool.isNotNull()) {
+			job = new _priv_ParallelSortJob;
+			if (job.isNotNull()) {
+				job->eventDone = Event::create();
+				if (job->eventDone.isNull()) {
+					job.setNull();
+				}
+			}
+		}
+		if (job.isNull()) {
+			for (sl_uint32 i = 0; i < nTasks; i++) {
+				task(context, i);
+			}
+			return;
+		}
+		job->task = task;
+		job->context = context;
+		job->nTasks = nTasks;
+		job->indexNext = 0;
+		job->nRemaining = nTasks;
+		sl_uint32 nHelpers = nTasks - 1;
+		sl_uint32 nThreads = pool->isWorkStealing() ? pool->getThreadsCount() : pool->getMaximumThreadsCount();
+		if (nThreads && nHelpers > nThreads) {
+			nHelpers = nThreads;
+		}
+		for (sl_uint32 i = 0; i < nHelpers; i++) {
+			Ref<_priv_ParallelSortJob> _job = job;
+			pool->addTask([_job]() {
+				_job->run();
+			});
+		}
+		// the calling thread also takes the tasks, so this never waits for a busy pool
+		job->run();
+		while (job->nRemaining > 0) {
+			job->eventDone->wait();
+		}
+	}
+	
+}
@@ -1835,6 +1835,7 @@ namespace slib
 	{
 		if (m_container && m_container != &_g_string8_empty_container) {
 			m_container->len = len;
+			m_container->hash = 0;
 		}
 	}
 
@@ -1842,6 +1843,7 @@ namespace slib
 	{
 		if (m_container && m_container != &_g_string16_empty_container) {
 			m_container->len = len;
+			m_container->hash = 0;
 		}
 	}
 	
@@ -1849,12 +1851,11 @@ namespace slib
 	template <class CT>
 	SLIB_INLINE static sl_size _priv_String_calcHash(const CT* buf, sl_size len) noexcept
 	{
-		sl_size hash = 0;
-		for (sl_size i = 0; i < len; i++) {
-			sl_uint32 ch = buf[i];
-			hash = hash * 31 + ch;
+		sl_size hash = HashBytes(buf, len * sizeof(CT));
+		// zero means `not calculated` in the container
+		if (!hash) {
+			hash = 1;
 		}
-		hash = Rehash(hash);
 		return hash;
 	}
 	
@@ -5458,45 +5459,53 @@ namespace slib
 	void String::makeUpper() noexcept
 	{
 		_priv_String_copyMakingUpper(getData(), getData(), getLength());
+		setHashCode(0);
 	}
 
 	void String16::makeUpper() noexcept
 	{
 		_priv_String_copyMakingUpper(getData(), getData(), getLength());
+		setHashCode(0);
 	}
 
 	void Atomic<String>::makeUpper() noexcept
 	{
 		String s(*this);
 		_priv_String_copyMakingUpper(s.getData(), s.getData(), s.getLength());
+		s.setHashCode(0);
 	}
 
 	void Atomic<String16>::makeUpper() noexcept
 	{
 		String16 s(*this);
 		_priv_String_copyMakingUpper(s.getData(), s.getData(), s.getLength());
+		s.setHashCode(0);
 	}
 
 	void String::makeLower() noexcept
 	{
 		_priv_String_copyMakingLower(getData(), getData(), getLength());
+		setHashCode(0);
 	}
 
 	void String16::makeLower() noexcept
 	{
 		_priv_String_copyMakingLower(getData(), getData(), getLength());
+		setHashCode(0);
 	}
 
 	void Atomic<String>::makeLower() noexcept
 	{
 		String s(*this);
 		_priv_String_copyMakingLower(s.getData(), s.getData(), s.getLength());
+		s.setHashCode(0);
 	}
 
 	void Atomic<String16>::makeLower() noexcept
 	{
 		String16 s(*this);
 		_priv_String_copyMakingLower(s.getData(), s.getData(), s.getLength());
+		s.setHashCode(0);
 	}
 
 	String String::toUpper(const sl_char8* sz, sl_reg _len) noexcept
@@ -8052,6 +8061,11 @@ https://docs.oracle.com/javase/7/docs/api/java/util/Formatter.html
 		return a.equals(b);
 	}
 
+	sl_bool Equals<String>::operator()(const String& a, const sl_char8* b) const noexcept
+	{
+		return a.equals(b);
+	}
+
 	sl_bool Equals<String16>::operator()(const String16& a, const String16& b) const noexcept
 	{
 		return a.equals(b);
@@ -8073,6 +8087,17 @@ https://docs.oracle.com/javase/7/docs/api/java/util/Formatter.html
 		return v.getHashCode();
 	}
 
+	sl_size Hash<String>::operator()(const sl_char8* v) const noexcept
+	{
+		if (v) {
+			sl_size n = Base::getStringLength(v);
+			if (n > 0) {
+				return _priv_String_calcHash(v, n);
+			}
+		}
+		return 0;
+	}
+
 	sl_size Hash<String16>::operator()(const String16& v) const noexcept
 	{
 		return v.getHashCode();
@@ -8533,6 +8558,16 @@ https://docs.oracle.com/javase/7/docs/api/java/util/Formatter.html
 		m_len = 0;
 	}
 
+	Link<StringData>* StringBuffer::getFirstItem() const noexcept
+	{
+		return m_queue.getFront();
+	}
+
+	Link<StringData>* StringBuffer16::getFirstItem() const noexcept
+	{
+		return m_queue.getFront();
+	}
+
 	String StringBuffer::merge() const noexcept
 	{
 		if (m_queue.getCount() == 0) {
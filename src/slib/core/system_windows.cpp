@@ -114,6 +114,16 @@ namespace slib
 		return ::GetCurrentThreadId();
 	}
 
+	sl_uint32 System::getProcessorsCount()
+	{
+		SYSTEM_INFO si;
+		::GetSystemInfo(&si);
+		if (si.dwNumberOfProcessors > 0) {
+			return (sl_uint32)(si.dwNumberOfProcessors);
+		}
+		return 1;
+	}
+
 #if defined (SLIB_PLATFORM_IS_WIN32)
 	sl_bool System::createProcess(const String& _pathExecutable, const String* cmds, sl_uint32 nCmds)
 	{
@@ -0,0 +1,268 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "text_scan.h"
+
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+#	include <immintrin.h>
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64) && defined(__ARM_NEON)
+#	include <arm_neon.h>
+#	define PRIV_TEXT_SCAN_NEON
+#endif
+
+/*
+	The kernels compute a bit mask of the matching bytes in a block:
+		FLAG_CONTROL: characters less than 0x20 also match
+		FLAG_INVERT: the characters which do not match are searched
+*/
+
+namespace slib
+{
+	
+	SLIB_INLINE static sl_uint32 _priv_TextScan_ctz(sl_uint32 n)
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+		unsigned long index;
+		_BitScanForward(&index, n);
+		return (sl_uint32)index;
+#else
+		return (sl_uint32)(__builtin_ctz(n));
+#endif
+	}
+	
+	SLIB_INLINE static sl_uint32 _priv_TextScan_ctz64(sl_uint64 n)
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+		sl_uint32 low = (sl_uint32)n;
+		if (low) {
+			return _priv_TextScan_ctz(low);
+		}
+		return 32 + _priv_TextScan_ctz((sl_uint32)(n >> 32));
+#else
+		return (sl_uint32)(__builtin_ctzll(n));
+#endif
+	}
+	
+	template <sl_uint32 N, sl_bool FLAG_INVERT, sl_bool FLAG_CONTROL>
+	SLIB_INLINE static sl_bool _priv_TextScan_match(sl_uint8 ch, const sl_uint8* chars)
+	{
+		sl_bool f = FLAG_CONTROL && ch < 0x20;
+		for (sl_uint32 i = 0; i < N; i++) {
+			if (ch == chars[i]) {
+				f = sl_true;
+			}
+		}
+		return FLAG_INVERT ? !f : f;
+	}
+	
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+	
+	template <sl_uint32 N, sl_bool FLAG_INVERT, sl_bool FLAG_CONTROL>
+	SLIB_TARGET_FEATURES("sse2") static const sl_uint8* _priv_TextScan_find_SSE2(const sl_uint8* p, const sl_uint8* end, const sl_uint8* chars)
+	{
+		__m128i c[N];
+		for (sl_uint32 i = 0; i < N; i++) {
+			c[i] = _mm_set1_epi8((char)(chars[i]));
+		}
+		__m128i maskControl = _mm_set1_epi8((char)0xE0);
+		__m128i zero = _mm_setzero_si128();
+		while (p + 16 <= end) {
+			__m128i v = _mm_loadu_si128((const __m128i*)p);
+			__m128i m = _mm_cmpeq_epi8(v, c[0]);
+			for (sl_uint32 i = 1; i < N; i++) {
+				m = _mm_or_si128(m, _mm_cmpeq_epi8(v, c[i]));
+			}
+			if (FLAG_CONTROL) {
+				m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_and_si128(v, maskControl), zero));
+			}
+			sl_uint32 bits = (sl_uint32)(_mm_movemask_epi8(m));
+			if (FLAG_INVERT) {
+				bits ^= 0xFFFF;
+			}
+			if (bits) {
+				return p + _priv_TextScan_ctz(bits);
+			}
+			p += 16;
+		}
+		return p;
+	}
+	
+	template <sl_uint32 N, sl_bool FLAG_INVERT, sl_bool FLAG_CONTROL>
+	SLIB_TARGET_FEATURES("avx2") static const sl_uint8* _priv_TextScan_find_AVX2(const sl_uint8* p, const sl_uint8* end, const sl_uint8* chars)
+	{
+		__m256i c[N];
+		for (sl_uint32 i = 0; i < N; i++) {
+			c[i] = _mm256_set1_epi8((char)(chars[i]));
+		}
+		__m256i maskControl = _mm256_set1_epi8((char)0xE0);
+		__m256i zero = _mm256_setzero_si256();
+		while (p + 32 <= end) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)p);
+			__m256i m = _mm256_cmpeq_epi8(v, c[0]);
+			for (sl_uint32 i = 1; i < N; i++) {
+				m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, c[i]));
+			}
+			if (FLAG_CONTROL) {
+				m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_and_si256(v, maskControl), zero));
+			}
+			sl_uint32 bits = (sl_uint32)(_mm256_movemask_epi8(m));
+			if (FLAG_INVERT) {
+				bits = ~bits;
+			}
+			if (bits) {
+				return p + _priv_TextScan_ctz(bits);
+			}
+			p += 32;
+		}
+		return p;
+	}
+	
+	static sl_bool _priv_TextScan_isSSE2()
+	{
+#if defined(SLIB_ARCH_IS_X64)
+		return sl_true;
+#else
+		static sl_bool flag = Cpu::isSSE2Supported();
+		return flag;
+#endif
+	}
+	
+	static sl_bool _priv_TextScan_isAVX2()
+	{
+		static sl_bool flag = Cpu::isAVX2Supported();
+		return flag;
+	}
+	
+#elif defined(PRIV_TEXT_SCAN_NEON)
+	
+	template <sl_uint32 N, sl_bool FLAG_INVERT, sl_bool FLAG_CONTROL>
+	static const sl_uint8* _priv_TextScan_find_NEON(const sl_uint8* p, const sl_uint8* end, const sl_uint8* chars)
+	{
+		uint8x16_t c[N];
+		for (sl_uint32 i = 0; i < N; i++) {
+			c[i] = vdupq_n_u8(chars[i]);
+		}
+		uint8x16_t limitControl = vdupq_n_u8(0x20);
+		while (p + 16 <= end) {
+			uint8x16_t v = vld1q_u8(p);
+			uint8x16_t m = vceqq_u8(v, c[0]);
+			for (sl_uint32 i = 1; i < N; i++) {
+				m = vorrq_u8(m, vceqq_u8(v, c[i]));
+			}
+			if (FLAG_CONTROL) {
+				m = vorrq_u8(m, vcltq_u8(v, limitControl));
+			}
+			if (FLAG_INVERT) {
+				m = vmvnq_u8(m);
+			}
+			// 4 bits per byte
+			sl_uint64 bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+			if (bits) {
+				return p + (_priv_TextScan_ctz64(bits) >> 2);
+			}
+			p += 16;
+		}
+		return p;
+	}
+	
+#endif
+	
+	template <sl_uint32 N, sl_bool FLAG_INVERT, sl_bool FLAG_CONTROL>
+	static const sl_char8* _priv_TextScan_find(const sl_char8* _p, const sl_char8* _end, const sl_uint8* chars)
+	{
+		const sl_uint8* p = (const sl_uint8*)_p;
+		const sl_uint8* end = (const sl_uint8*)_end;
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (p + 16 <= end && _priv_TextScan_isSSE2()) {
+			// the first block is checked by SSE2 to avoid the cost of AVX2 on the short runs
+			const sl_uint8* q = _priv_TextScan_find_SSE2<N, FLAG_INVERT, FLAG_CONTROL>(p, p + 16, chars);
+			if (q != p + 16) {
+				return (const sl_char8*)q;
+			}
+			p = q;
+			if (p + 32 <= end && _priv_TextScan_isAVX2()) {
+				p = _priv_TextScan_find_AVX2<N, FLAG_INVERT, FLAG_CONTROL>(p, end, chars);
+				if (p + 32 <= end) {
+					return (const sl_char8*)p;
+				}
+			}
+			p = _priv_TextScan_find_SSE2<N, FLAG_INVERT, FLAG_CONTROL>(p, end, chars);
+			if (p + 16 <= end) {
+				return (const sl_char8*)p;
+			}
+		}
+#elif defined(PRIV_TEXT_SCAN_NEON)
+		p = _priv_TextScan_find_NEON<N, FLAG_INVERT, FLAG_CONTROL>(p, end, chars);
+		if (p + 16 <= end) {
+			return (const sl_char8*)p;
+		}
+#endif
+		while (p < end) {
+			if (_priv_TextScan_match<N, FLAG_INVERT, FLAG_CONTROL>(*p, chars)) {
+				break;
+			}
+			p++;
+		}
+		return (const sl_char8*)p;
+	}
+	
+	const sl_char8* _priv_TextScan_skipWhiteSpaces(const sl_char8* p, const sl_char8* end)
+	{
+		// most runs are short
+		for (sl_uint32 i = 0; i < 4; i++) {
+			if (p >= end) {
+				return p;
+			}
+			sl_char8 ch = *p;
+			if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n') {
+				return p;
+			}
+			p++;
+		}
+		static const sl_uint8 chars[4] = {' ', '\t', '\r', '\n'};
+		return _priv_TextScan_find<4, sl_true, sl_false>(p, end, chars);
+	}
+	
+	const sl_char8* _priv_TextScan_findAny(const sl_char8* p, const sl_char8* end, sl_char8 c1, sl_char8 c2, sl_char8 c3, sl_char8 c4)
+	{
+		sl_uint8 chars[4] = {(sl_uint8)c1, (sl_uint8)c2, (sl_uint8)(c3 ? c3 : c1), (sl_uint8)(c4 ? c4 : c1)};
+		return _priv_TextScan_find<4, sl_false, sl_false>(p, end, chars);
+	}
+	
+	const sl_char8* _priv_TextScan_findStringSpecial(const sl_char8* p, const sl_char8* end, sl_char8 quote)
+	{
+		sl_uint8 chars[2] = {(sl_uint8)quote, '\\'};
+		return _priv_TextScan_find<2, sl_false, sl_true>(p, end, chars);
+	}
+	
+	const sl_char8* _priv_TextScan_findJsonStructural(const sl_char8* p, const sl_char8* end)
+	{
+		static const sl_uint8 chars[7] = {'"', '\'', '{', '}', '[', ']', '/'};
+		return _priv_TextScan_find<7, sl_false, sl_false>(p, end, chars);
+	}
+	
+}
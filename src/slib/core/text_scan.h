@@ -0,0 +1,95 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_TEXT_SCAN
+#define CHECKHEADER_SLIB_CORE_TEXT_SCAN
+
+#include "slib/core/definition.h"
+
+/*
+	Character class scanning for the text parsers (JSON, XML)
+
+	UTF-8 input is classified 16 or 32 bytes at a time (SSE2/AVX2 on x86, NEON on ARM64).
+	UTF-16 input is scanned by the scalar loops.
+*/
+
+namespace slib
+{
+	
+	// returns the first position of a character which is not ' ', '\t', '\r' or '\n'
+	const sl_char8* _priv_TextScan_skipWhiteSpaces(const sl_char8* p, const sl_char8* end);
+	
+	// returns the first position of one of the characters
+	const sl_char8* _priv_TextScan_findAny(const sl_char8* p, const sl_char8* end, sl_char8 c1, sl_char8 c2, sl_char8 c3 = 0, sl_char8 c4 = 0);
+	
+	// returns the first position of `quote`, backslash or a control character (less than 0x20) in a quoted string
+	const sl_char8* _priv_TextScan_findStringSpecial(const sl_char8* p, const sl_char8* end, sl_char8 quote);
+	
+	// returns the first position of a quote, bracket, brace or slash (start of comment)
+	const sl_char8* _priv_TextScan_findJsonStructural(const sl_char8* p, const sl_char8* end);
+	
+	
+	SLIB_INLINE static const sl_char16* _priv_TextScan_skipWhiteSpaces(const sl_char16* p, const sl_char16* end)
+	{
+		while (p < end) {
+			sl_char16 ch = *p;
+			if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n') {
+				break;
+			}
+			p++;
+		}
+		return p;
+	}
+	
+	SLIB_INLINE static const sl_char16* _priv_TextScan_findAny(const sl_char16* p, const sl_char16* end, sl_char16 c1, sl_char16 c2, sl_char16 c3 = 0, sl_char16 c4 = 0)
+	{
+		if (!c3) {
+			c3 = c1;
+		}
+		if (!c4) {
+			c4 = c1;
+		}
+		while (p < end) {
+			sl_char16 ch = *p;
+			if (ch == c1 || ch == c2 || ch == c3 || ch == c4) {
+				break;
+			}
+			p++;
+		}
+		return p;
+	}
+	
+	SLIB_INLINE static const sl_char16* _priv_TextScan_findStringSpecial(const sl_char16* p, const sl_char16* end, sl_char16 quote)
+	{
+		while (p < end) {
+			sl_char16 ch = *p;
+			if (ch == quote || ch == '\\' || ch < 0x20) {
+				break;
+			}
+			p++;
+		}
+		return p;
+	}
+	
+}
+
+#endif
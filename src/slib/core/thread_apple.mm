@@ -138,6 +138,12 @@ namespace slib
 			[thread setThreadPriority:p];
 		}
 	}
+	
+	sl_bool Thread::setCurrentThreadAffinity(sl_uint32 processorIndex)
+	{
+		// not supported: Mach only provides affinity tags
+		return sl_false;
+	}
 
 }
 
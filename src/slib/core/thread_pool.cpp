@@ -22,8 +22,30 @@
 
 #include "slib/core/thread_pool.h"
 
+#include "slib/core/system.h"
+
+#include <atomic>
+
 namespace slib
 {
+	
+	class _priv_ThreadPoolWorker : public Referable
+	{
+	public:
+		Ref<Thread> thread;
+		CLinkedList< Function<void()> > tasks;
+		sl_int32 flagSleeping;
+		
+	public:
+		_priv_ThreadPoolWorker()
+		{
+			flagSleeping = 0;
+		}
+		
+	};
+	
+	SLIB_THREAD ThreadPool* _gt_threadPoolCurrent = sl_null;
+	SLIB_THREAD sl_uint32 _gt_threadPoolWorkerIndex = 0;
 
 	SLIB_DEFINE_OBJECT(ThreadPool, Dispatcher)
 
@@ -31,6 +53,11 @@ namespace slib
 	{
 		setThreadStackSize(SLIB_THREAD_DEFAULT_STACK_SIZE);
 		m_flagRunning = sl_true;
+		
+		m_flagWorkStealing = sl_false;
+		m_nStealingWorkers = 0;
+		m_nSleepingStealingWorkers = 0;
+		m_indexNextStealingWorker = 0;
 	}
 
 	ThreadPool::~ThreadPool()
@@ -47,6 +74,45 @@ namespace slib
 		}
 		return ret;
 	}
+	
+	Ref<ThreadPool> ThreadPool::createWorkStealing(sl_uint32 nWorkers)
+	{
+		if (!nWorkers) {
+			nWorkers = System::getProcessorsCount();
+		}
+		Ref<ThreadPool> ret = new ThreadPool();
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->setMinimumThreadsCount(nWorkers);
+		ret->setMaximumThreadsCount(nWorkers);
+		Array< Ref<_priv_ThreadPoolWorker> > workers = Array< Ref<_priv_ThreadPoolWorker> >::create(nWorkers);
+		if (workers.isNull()) {
+			return sl_null;
+		}
+		sl_uint32 i;
+		for (i = 0; i < nWorkers; i++) {
+			Ref<_priv_ThreadPoolWorker> worker = new _priv_ThreadPoolWorker;
+			if (worker.isNull()) {
+				return sl_null;
+			}
+			worker->thread = Thread::create(SLIB_BIND_CLASS(void(), ThreadPool, onRunStealingWorker, ret.get(), i));
+			if (worker->thread.isNull()) {
+				return sl_null;
+			}
+			workers[i] = worker;
+		}
+		ret->m_stealingWorkers = workers;
+		ret->m_nStealingWorkers = nWorkers;
+		ret->m_flagWorkStealing = sl_true;
+		for (i = 0; i < nWorkers; i++) {
+			if (!(workers[i]->thread->start(ret->getThreadStackSize()))) {
+				ret->release();
+				return sl_null;
+			}
+		}
+		return ret;
+	}
 
 	void ThreadPool::release()
 	{
@@ -56,6 +122,23 @@ namespace slib
 		}
 		m_flagRunning = sl_false;
 		
+		if (m_flagWorkStealing) {
+			lock.unlock();
+			Ref<_priv_ThreadPoolWorker>* workers = m_stealingWorkers.getData();
+			sl_uint32 n = m_nStealingWorkers;
+			sl_uint32 i;
+			for (i = 0; i < n; i++) {
+				workers[i]->thread->finish();
+			}
+			for (i = 0; i < n; i++) {
+				if (!(workers[i]->thread->isCurrentThread())) {
+					workers[i]->thread->finishAndWait();
+				}
+				workers[i]->tasks.removeAll();
+			}
+			return;
+		}
+		
 		ListElements< Ref<Thread> > threads(m_threadWorkers);
 		sl_size i;
 		for (i = 0; i < threads.count; i++) {
@@ -71,8 +154,16 @@ namespace slib
 		return m_flagRunning;
 	}
 
+	sl_bool ThreadPool::isWorkStealing()
+	{
+		return m_flagWorkStealing;
+	}
+
 	sl_uint32 ThreadPool::getThreadsCount()
 	{
+		if (m_flagWorkStealing) {
+			return m_nStealingWorkers;
+		}
 		return (sl_uint32)(m_threadWorkers.getCount());
 	}
 
@@ -81,6 +172,9 @@ namespace slib
 		if (task.isNull()) {
 			return sl_false;
 		}
+		if (m_flagWorkStealing) {
+			return _addStealingTask(task);
+		}
 		ObjectLocker lock(this);
 		if (!m_flagRunning) {
 			return sl_false;
@@ -129,6 +223,10 @@ namespace slib
 				task();
 			} else {
 				ObjectLocker lock(this);
+				// a task may have been added after the failed pop
+				if (m_tasks.isNotEmpty()) {
+					continue;
+				}
 				sl_size nThreads = m_threadWorkers.getCount();
 				if (nThreads > getMinimumThreadsCount()) {
 					m_threadWorkers.remove_NoLock(thread);
@@ -141,5 +239,110 @@ namespace slib
 			}
 		}
 	}
+	
+	void ThreadPool::onRunStealingWorker(sl_uint32 index)
+	{
+		Ref<Thread> thread = Thread::getCurrent();
+		if (thread.isNull()) {
+			return;
+		}
+		_priv_ThreadPoolWorker* worker = m_stealingWorkers[index].get();
+		_gt_threadPoolCurrent = this;
+		_gt_threadPoolWorkerIndex = index;
+		while (m_flagRunning && Thread::isNotStoppingCurrent()) {
+			Function<void()> task;
+			if (_popStealingTask(index, task)) {
+				task();
+				continue;
+			}
+			// announce sleeping, then check again to avoid losing a task pushed in the meantime
+			if (Base::interlockedCompareExchange32(&(worker->flagSleeping), 1, 0)) {
+				Base::interlockedIncrement32(&m_nSleepingStealingWorkers);
+			}
+			if (_popStealingTask(index, task)) {
+				if (Base::interlockedCompareExchange32(&(worker->flagSleeping), 0, 1)) {
+					Base::interlockedDecrement32(&m_nSleepingStealingWorkers);
+				}
+				task();
+				continue;
+			}
+			thread->wait();
+			if (Base::interlockedCompareExchange32(&(worker->flagSleeping), 0, 1)) {
+				Base::interlockedDecrement32(&m_nSleepingStealingWorkers);
+			}
+		}
+		_gt_threadPoolCurrent = sl_null;
+	}
+	
+	sl_bool ThreadPool::_addStealingTask(const Function<void()>& task)
+	{
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		sl_uint32 n = m_nStealingWorkers;
+		sl_uint32 index;
+		sl_bool flagLocal;
+		if (_gt_threadPoolCurrent == this) {
+			index = _gt_threadPoolWorkerIndex;
+			flagLocal = sl_true;
+		} else {
+			index = ((sl_uint32)(Base::interlockedIncrement32(&m_indexNextStealingWorker))) % n;
+			flagLocal = sl_false;
+		}
+		_priv_ThreadPoolWorker* worker = m_stealingWorkers[index].get();
+		if (!(worker->tasks.pushBack(task))) {
+			return sl_false;
+		}
+		// orders the push before reading the sleeping count; pairs with the announce-then-recheck in onRunStealingWorker
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (flagLocal) {
+			// the current worker will run it unless an idle worker steals it first
+			if (m_nSleepingStealingWorkers > 0) {
+				_wakeStealingWorker((index + 1) % n);
+			}
+		} else {
+			_wakeStealingWorker(index);
+		}
+		return sl_true;
+	}
+	
+	sl_bool ThreadPool::_popStealingTask(sl_uint32 index, Function<void()>& task)
+	{
+		Ref<_priv_ThreadPoolWorker>* workers = m_stealingWorkers.getData();
+		sl_uint32 n = m_nStealingWorkers;
+		// newest local task first, for cache locality
+		if (workers[index]->tasks.isNotEmpty()) {
+			if (workers[index]->tasks.popBack(&task)) {
+				return sl_true;
+			}
+		}
+		// steal the oldest task from the other workers
+		for (sl_uint32 i = 1; i < n; i++) {
+			_priv_ThreadPoolWorker* victim = workers[(index + i) % n].get();
+			if (victim->tasks.isNotEmpty()) {
+				if (victim->tasks.popFront(&task)) {
+					return sl_true;
+				}
+			}
+		}
+		return sl_false;
+	}
+	
+	void ThreadPool::_wakeStealingWorker(sl_uint32 index)
+	{
+		Ref<_priv_ThreadPoolWorker>* workers = m_stealingWorkers.getData();
+		sl_uint32 n = m_nStealingWorkers;
+		for (sl_uint32 i = 0; i < n; i++) {
+			if (m_nSleepingStealingWorkers <= 0) {
+				return;
+			}
+			_priv_ThreadPoolWorker* worker = workers[(index + i) % n].get();
+			if (Base::interlockedCompareExchange32(&(worker->flagSleeping), 0, 1)) {
+				Base::interlockedDecrement32(&m_nSleepingStealingWorkers);
+				worker->thread->wakeSelfEvent();
+				return;
+			}
+		}
+	}
 
 }
@@ -25,6 +25,7 @@
 #if defined(SLIB_PLATFORM_IS_UNIX) && !defined(SLIB_PLATFORM_IS_APPLE)
 
 #include <pthread.h>
+#include <sched.h>
 #include <time.h>
 
 #include "slib/core/thread.h"
@@ -125,6 +126,21 @@ namespace slib
 			}
 		}
 	}
+	
+	sl_bool Thread::setCurrentThreadAffinity(sl_uint32 processorIndex)
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX) && defined(CPU_SET)
+		if (processorIndex >= CPU_SETSIZE) {
+			return sl_false;
+		}
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(processorIndex, &set);
+		return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+		return sl_false;
+#endif
+	}
 
 }
 
@@ -95,6 +95,14 @@ namespace slib
 		}
 	}
 
+	sl_bool Thread::setCurrentThreadAffinity(sl_uint32 processorIndex)
+	{
+		if (processorIndex >= sizeof(DWORD_PTR) * 8) {
+			return sl_false;
+		}
+		return SetThreadAffinityMask(GetCurrentThread(), ((DWORD_PTR)1) << processorIndex) != 0;
+	}
+
 	void Thread::_nativeClose()
 	{
 		if (m_handle) {
@@ -0,0 +1,446 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/timing_wheel.h"
+
+#include "slib/core/base.h"
+#include "slib/core/new_helper.h"
+
+#if defined(SLIB_COMPILER_IS_VC)
+#	include <intrin.h>
+#endif
+
+#define PRIV_TIMING_WHEEL_LEVEL0_BITS 8
+#define PRIV_TIMING_WHEEL_LEVEL0_SIZE 256
+#define PRIV_TIMING_WHEEL_LEVEL_BITS 6
+#define PRIV_TIMING_WHEEL_LEVEL_SIZE 64
+#define PRIV_TIMING_WHEEL_LEVELS 5
+#define PRIV_TIMING_WHEEL_MAX_DELTA ((((sl_uint64)1) << 32) - 1)
+#define PRIV_TIMING_WHEEL_PAGE_BITS 8
+#define PRIV_TIMING_WHEEL_PAGE_SIZE 256
+#define PRIV_TIMING_WHEEL_NONE 0xFFFFFFFF
+// the tasks added for the ticks which are already processed
+#define PRIV_TIMING_WHEEL_SLOT_DUE 512
+
+namespace slib
+{
+
+	class _priv_TimingWheelNode
+	{
+	public:
+		sl_uint64 expire;
+		Function<void()> task;
+		sl_uint32 prev;
+		sl_uint32 next;
+		sl_uint32 slot;
+		sl_uint32 generation;
+		sl_bool flagUsed;
+
+	public:
+		_priv_TimingWheelNode() noexcept: expire(0), prev(PRIV_TIMING_WHEEL_NONE), next(PRIV_TIMING_WHEEL_NONE), slot(0), generation(1), flagUsed(sl_false) {}
+
+	};
+
+	SLIB_INLINE static sl_uint32 _priv_TimingWheel_ctz64(sl_uint64 n) noexcept
+	{
+#if defined(SLIB_COMPILER_IS_VC)
+		unsigned long index;
+		sl_uint32 low = (sl_uint32)n;
+		if (low) {
+			_BitScanForward(&index, low);
+			return (sl_uint32)index;
+		}
+		_BitScanForward(&index, (sl_uint32)(n >> 32));
+		return 32 + (sl_uint32)index;
+#else
+		return (sl_uint32)(__builtin_ctzll(n));
+#endif
+	}
+
+	SLIB_INLINE static sl_uint32 _priv_TimingWheel_getShift(sl_uint32 level) noexcept
+	{
+		return PRIV_TIMING_WHEEL_LEVEL0_BITS + (level - 1) * PRIV_TIMING_WHEEL_LEVEL_BITS;
+	}
+
+	SLIB_INLINE static sl_uint32 _priv_TimingWheel_getLevelBase(sl_uint32 level) noexcept
+	{
+		return PRIV_TIMING_WHEEL_LEVEL0_SIZE + (level - 1) * PRIV_TIMING_WHEEL_LEVEL_SIZE;
+	}
+
+	// returns the slot where the nodes expiring at `expire` are kept while the wheel is at `current`
+	static sl_uint32 _priv_TimingWheel_getSlot(sl_uint64 expire, sl_uint64 current) noexcept
+	{
+		sl_uint64 delta = expire - current;
+		if (delta < PRIV_TIMING_WHEEL_LEVEL0_SIZE) {
+			return (sl_uint32)(expire & (PRIV_TIMING_WHEEL_LEVEL0_SIZE - 1));
+		}
+		if (delta > PRIV_TIMING_WHEEL_MAX_DELTA) {
+			// cascaded again when the last level wraps around
+			expire = current + PRIV_TIMING_WHEEL_MAX_DELTA;
+			delta = PRIV_TIMING_WHEEL_MAX_DELTA;
+		}
+		for (sl_uint32 level = 1; level < PRIV_TIMING_WHEEL_LEVELS - 1; level++) {
+			sl_uint32 shift = _priv_TimingWheel_getShift(level);
+			if (delta < (((sl_uint64)1) << (shift + PRIV_TIMING_WHEEL_LEVEL_BITS))) {
+				return _priv_TimingWheel_getLevelBase(level) + (sl_uint32)((expire >> shift) & (PRIV_TIMING_WHEEL_LEVEL_SIZE - 1));
+			}
+		}
+		sl_uint32 level = PRIV_TIMING_WHEEL_LEVELS - 1;
+		return _priv_TimingWheel_getLevelBase(level) + (sl_uint32)((expire >> _priv_TimingWheel_getShift(level)) & (PRIV_TIMING_WHEEL_LEVEL_SIZE - 1));
+	}
+
+
+	TimingWheel::TimingWheel(sl_uint32 tickMilliseconds) noexcept
+	{
+		if (!tickMilliseconds) {
+			tickMilliseconds = 1;
+		}
+		m_tick = tickMilliseconds;
+		m_current = 0;
+		m_count = 0;
+		m_pages = sl_null;
+		m_nPages = 0;
+		m_indexFree = PRIV_TIMING_WHEEL_NONE;
+		for (sl_uint32 i = 0; i <= PRIV_TIMING_WHEEL_SLOT_DUE; i++) {
+			m_heads[i] = PRIV_TIMING_WHEEL_NONE;
+		}
+		Base::zeroMemory(m_bitmap, sizeof(m_bitmap));
+	}
+
+	TimingWheel::~TimingWheel() noexcept
+	{
+		for (sl_uint32 i = 0; i < m_nPages; i++) {
+			NewHelper<_priv_TimingWheelNode>::free(m_pages[i], PRIV_TIMING_WHEEL_PAGE_SIZE);
+		}
+		if (m_pages) {
+			Base::freeMemory(m_pages);
+		}
+	}
+
+	sl_uint32 TimingWheel::getTickMilliseconds() const noexcept
+	{
+		return m_tick;
+	}
+
+	sl_size TimingWheel::getCount() const noexcept
+	{
+		return m_count;
+	}
+
+	sl_bool TimingWheel::isEmpty() const noexcept
+	{
+		return !m_count;
+	}
+
+	sl_bool TimingWheel::isNotEmpty() const noexcept
+	{
+		return m_count != 0;
+	}
+
+	sl_uint64 TimingWheel::add(sl_uint64 time, const Function<void()>& task) noexcept
+	{
+		if (task.isNull()) {
+			return 0;
+		}
+		sl_uint32 index = _allocNode();
+		if (index == PRIV_TIMING_WHEEL_NONE) {
+			return 0;
+		}
+		_priv_TimingWheelNode* node = _getNode(index);
+		// rounds up, so that the task never runs before `time`
+		sl_uint64 expire = time / m_tick;
+		if (time % m_tick) {
+			expire++;
+		}
+		node->expire = expire;
+		node->task = task;
+		node->flagUsed = sl_true;
+		if (expire < m_current) {
+			_link(index, node, PRIV_TIMING_WHEEL_SLOT_DUE);
+		} else {
+			_link(index, node, _priv_TimingWheel_getSlot(expire, m_current));
+		}
+		m_count++;
+		return (((sl_uint64)(node->generation)) << 32) | index;
+	}
+
+	sl_bool TimingWheel::cancel(sl_uint64 id) noexcept
+	{
+		sl_uint32 index = (sl_uint32)id;
+		if (index >= (m_nPages << PRIV_TIMING_WHEEL_PAGE_BITS)) {
+			return sl_false;
+		}
+		_priv_TimingWheelNode* node = _getNode(index);
+		if (!(node->flagUsed) || node->generation != (sl_uint32)(id >> 32)) {
+			return sl_false;
+		}
+		_unlink(index, node);
+		_freeNode(index, node);
+		m_count--;
+		return sl_true;
+	}
+
+	sl_bool TimingWheel::contains(sl_uint64 id) const noexcept
+	{
+		sl_uint32 index = (sl_uint32)id;
+		if (index >= (m_nPages << PRIV_TIMING_WHEEL_PAGE_BITS)) {
+			return sl_false;
+		}
+		_priv_TimingWheelNode* node = _getNode(index);
+		return node->flagUsed && node->generation == (sl_uint32)(id >> 32);
+	}
+
+	void TimingWheel::removeAll() noexcept
+	{
+		for (sl_uint32 slot = 0; slot <= PRIV_TIMING_WHEEL_SLOT_DUE; slot++) {
+			sl_uint32 index = m_heads[slot];
+			while (index != PRIV_TIMING_WHEEL_NONE) {
+				_priv_TimingWheelNode* node = _getNode(index);
+				sl_uint32 next = node->next;
+				_freeNode(index, node);
+				index = next;
+			}
+			m_heads[slot] = PRIV_TIMING_WHEEL_NONE;
+		}
+		Base::zeroMemory(m_bitmap, sizeof(m_bitmap));
+		m_count = 0;
+	}
+
+	void TimingWheel::advance(sl_uint64 now, List< Function<void()> >& output) noexcept
+	{
+		_moveSlot(PRIV_TIMING_WHEEL_SLOT_DUE, output);
+		sl_uint64 target = now / m_tick;
+		while (m_current <= target) {
+			if (!m_count) {
+				m_current = target + 1;
+				return;
+			}
+			// jumps over the ticks where nothing happens
+			sl_uint64 tick = _getNextTick();
+			if (tick > target) {
+				m_current = target + 1;
+				return;
+			}
+			m_current = tick;
+			sl_uint32 slot = (sl_uint32)(tick & (PRIV_TIMING_WHEEL_LEVEL0_SIZE - 1));
+			if (!slot) {
+				_cascade();
+			}
+			_moveSlot(slot, output);
+			m_current = tick + 1;
+		}
+	}
+
+	sl_int64 TimingWheel::getTimeout(sl_uint64 now) const noexcept
+	{
+		if (!m_count) {
+			return -1;
+		}
+		if (m_heads[PRIV_TIMING_WHEEL_SLOT_DUE] != PRIV_TIMING_WHEEL_NONE) {
+			return 0;
+		}
+		sl_uint64 time = _getNextTick() * m_tick;
+		if (time <= now) {
+			return 0;
+		}
+		return (sl_int64)(time - now);
+	}
+
+	_priv_TimingWheelNode* TimingWheel::_getNode(sl_uint32 index) const noexcept
+	{
+		return m_pages[index >> PRIV_TIMING_WHEEL_PAGE_BITS] + (index & (PRIV_TIMING_WHEEL_PAGE_SIZE - 1));
+	}
+
+	sl_uint32 TimingWheel::_allocNode() noexcept
+	{
+		if (m_indexFree == PRIV_TIMING_WHEEL_NONE) {
+			// pages are never moved, so that the indices stay valid
+			if (m_nPages >= (PRIV_TIMING_WHEEL_NONE >> PRIV_TIMING_WHEEL_PAGE_BITS)) {
+				return PRIV_TIMING_WHEEL_NONE;
+			}
+			_priv_TimingWheelNode** pages = (_priv_TimingWheelNode**)(Base::reallocMemory(m_pages, sizeof(_priv_TimingWheelNode*) * (m_nPages + 1)));
+			if (!pages) {
+				return PRIV_TIMING_WHEEL_NONE;
+			}
+			m_pages = pages;
+			_priv_TimingWheelNode* page = NewHelper<_priv_TimingWheelNode>::create(PRIV_TIMING_WHEEL_PAGE_SIZE);
+			if (!page) {
+				return PRIV_TIMING_WHEEL_NONE;
+			}
+			m_pages[m_nPages] = page;
+			sl_uint32 base = m_nPages << PRIV_TIMING_WHEEL_PAGE_BITS;
+			for (sl_uint32 i = 0; i < PRIV_TIMING_WHEEL_PAGE_SIZE - 1; i++) {
+				page[i].next = base + i + 1;
+			}
+			page[PRIV_TIMING_WHEEL_PAGE_SIZE - 1].next = PRIV_TIMING_WHEEL_NONE;
+			m_indexFree = base;
+			m_nPages++;
+		}
+		sl_uint32 index = m_indexFree;
+		m_indexFree = _getNode(index)->next;
+		return index;
+	}
+
+	void TimingWheel::_freeNode(sl_uint32 index, _priv_TimingWheelNode* node) noexcept
+	{
+		node->task.setNull();
+		node->flagUsed = sl_false;
+		// invalidates the ids handed out for this node
+		node->generation++;
+		if (!(node->generation)) {
+			node->generation = 1;
+		}
+		node->next = m_indexFree;
+		m_indexFree = index;
+	}
+
+	void TimingWheel::_link(sl_uint32 index, _priv_TimingWheelNode* node, sl_uint32 slot) noexcept
+	{
+		sl_uint32 head = m_heads[slot];
+		node->slot = slot;
+		node->prev = PRIV_TIMING_WHEEL_NONE;
+		node->next = head;
+		if (head != PRIV_TIMING_WHEEL_NONE) {
+			_getNode(head)->prev = index;
+		}
+		m_heads[slot] = index;
+		if (slot < PRIV_TIMING_WHEEL_SLOT_DUE) {
+			m_bitmap[slot >> 6] |= ((sl_uint64)1) << (slot & 63);
+		}
+	}
+
+	void TimingWheel::_unlink(sl_uint32 index, _priv_TimingWheelNode* node) noexcept
+	{
+		sl_uint32 slot = node->slot;
+		if (node->prev != PRIV_TIMING_WHEEL_NONE) {
+			_getNode(node->prev)->next = node->next;
+		} else {
+			m_heads[slot] = node->next;
+			if (node->next == PRIV_TIMING_WHEEL_NONE && slot < PRIV_TIMING_WHEEL_SLOT_DUE) {
+				m_bitmap[slot >> 6] &= ~(((sl_uint64)1) << (slot & 63));
+			}
+		}
+		if (node->next != PRIV_TIMING_WHEEL_NONE) {
+			_getNode(node->next)->prev = node->prev;
+		}
+	}
+
+	void TimingWheel::_cascade() noexcept
+	{
+		// called when the lower bits of `m_current` are all zero: moves the nodes of the reached slots into the lower levels
+		for (sl_uint32 level = 1; level < PRIV_TIMING_WHEEL_LEVELS; level++) {
+			sl_uint32 shift = _priv_TimingWheel_getShift(level);
+			sl_uint32 k = (sl_uint32)((m_current >> shift) & (PRIV_TIMING_WHEEL_LEVEL_SIZE - 1));
+			sl_uint32 slot = _priv_TimingWheel_getLevelBase(level) + k;
+			sl_uint32 index = _detachSlot(slot);
+			while (index != PRIV_TIMING_WHEEL_NONE) {
+				_priv_TimingWheelNode* node = _getNode(index);
+				sl_uint32 prev = node->prev;
+				_link(index, node, _priv_TimingWheel_getSlot(node->expire, m_current));
+				index = prev;
+			}
+			if (k) {
+				break;
+			}
+		}
+	}
+
+	sl_uint32 TimingWheel::_detachSlot(sl_uint32 slot) noexcept
+	{
+		sl_uint32 index = m_heads[slot];
+		if (index == PRIV_TIMING_WHEEL_NONE) {
+			return index;
+		}
+		m_heads[slot] = PRIV_TIMING_WHEEL_NONE;
+		if (slot < PRIV_TIMING_WHEEL_SLOT_DUE) {
+			m_bitmap[slot >> 6] &= ~(((sl_uint64)1) << (slot & 63));
+		}
+		// nodes are linked at the head, so the tail is the oldest one
+		for (;;) {
+			sl_uint32 next = _getNode(index)->next;
+			if (next == PRIV_TIMING_WHEEL_NONE) {
+				return index;
+			}
+			index = next;
+		}
+	}
+
+	void TimingWheel::_moveSlot(sl_uint32 slot, List< Function<void()> >& output) noexcept
+	{
+		sl_uint32 index = _detachSlot(slot);
+		while (index != PRIV_TIMING_WHEEL_NONE) {
+			_priv_TimingWheelNode* node = _getNode(index);
+			sl_uint32 prev = node->prev;
+			output.add_NoLock(Move(node->task));
+			_freeNode(index, node);
+			m_count--;
+			index = prev;
+		}
+	}
+
+	sl_uint64 TimingWheel::_getNextTick() const noexcept
+	{
+		sl_uint64 current = m_current;
+		sl_uint64 ret = (sl_uint64)-1;
+		// level 0: the nodes expire in [current, current + 256)
+		{
+			sl_uint32 k = (sl_uint32)(current & (PRIV_TIMING_WHEEL_LEVEL0_SIZE - 1));
+			sl_uint64 base = current - k;
+			for (sl_uint32 i = 0; i < 4; i++) {
+				sl_uint32 w = ((k >> 6) + i) & 3;
+				sl_uint64 bits = m_bitmap[w];
+				if (!i) {
+					bits &= ((sl_uint64)-1) << (k & 63);
+				}
+				if (bits) {
+					sl_uint32 slot = (w << 6) + _priv_TimingWheel_ctz64(bits);
+					ret = base + slot + (slot < k ? PRIV_TIMING_WHEEL_LEVEL0_SIZE : 0);
+					break;
+				}
+			}
+			if (ret == (sl_uint64)-1) {
+				sl_uint64 bits = m_bitmap[k >> 6] & ~(((sl_uint64)-1) << (k & 63));
+				if (bits) {
+					ret = base + PRIV_TIMING_WHEEL_LEVEL0_SIZE + ((k >> 6) << 6) + _priv_TimingWheel_ctz64(bits);
+				}
+			}
+		}
+		// higher levels: the slot is cascaded when the wheel reaches it
+		for (sl_uint32 level = 1; level < PRIV_TIMING_WHEEL_LEVELS; level++) {
+			sl_uint64 bits = m_bitmap[4 + level - 1];
+			if (bits) {
+				sl_uint32 shift = _priv_TimingWheel_getShift(level);
+				sl_uint64 unit = (current + (((sl_uint64)1) << shift) - 1) >> shift;
+				sl_uint32 r = (sl_uint32)(unit & (PRIV_TIMING_WHEEL_LEVEL_SIZE - 1));
+				if (r) {
+					bits = (bits >> r) | (bits << (64 - r));
+				}
+				sl_uint64 tick = (unit + _priv_TimingWheel_ctz64(bits)) << shift;
+				if (tick < ret) {
+					ret = tick;
+				}
+			}
+		}
+		return ret;
+	}
+
+}
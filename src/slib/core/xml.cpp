@@ -23,9 +23,12 @@
 #include "slib/core/xml.h"
 
 #include "slib/core/file.h"
+#include "slib/core/mapped_file.h"
 #include "slib/core/log.h"
 #include "slib/core/string_buffer.h"
 
+#include "text_scan.h"
+
 namespace slib
 {
 
@@ -1476,19 +1479,20 @@ namespace slib
 	template <class ST, class CT, class BT>
 	void _priv_Xml_Parser<ST, CT, BT>::escapeWhiteSpaces()
 	{
-		while (pos < len) {
-			CT ch = buf[pos];
-			if (!(SLIB_CHAR_IS_WHITE_SPACE(ch))) {
-				break;
-			}
-			pos++;
-		}
+		pos = (sl_size)(_priv_TextScan_skipWhiteSpaces(buf + pos, buf + len) - buf);
 	}
 
 	template <class ST, class CT, class BT>
 	void _priv_Xml_Parser<ST, CT, BT>::calcLineNumber()
 	{
 		for (sl_size i = posForLineColumn; i < pos; i++) {
+			// jump to the next line break
+			sl_size next = (sl_size)(_priv_TextScan_findAny(buf + i, buf + pos, (CT)'\r', (CT)'\n') - buf);
+			columnNumber += next - i;
+			i = next;
+			if (i >= pos) {
+				break;
+			}
 			CT ch = buf[i];
 			if (ch == '\r') {
 				lineNumber++;
@@ -1496,13 +1500,11 @@ namespace slib
 				if (i + 1 < len && buf[i+1] == '\n') {
 					i++;
 				}
-			} else if (ch == '\n') {
+			} else {
 				if (i == 0 || buf[i-1] != '\r') {
 					lineNumber++;
 					columnNumber = 1;
 				}
-			} else {
-				columnNumber++;
 			}
 		}
 		posForLineColumn = pos;
@@ -1651,6 +1653,10 @@ namespace slib
 		sl_size startComment = pos;
 		sl_bool flagEnded = sl_false;
 		while (pos + 2 < len) {
+			pos = (sl_size)(_priv_TextScan_findAny(buf + pos, buf + len - 2, (CT)'-', (CT)'-') - buf);
+			if (pos + 2 >= len) {
+				break;
+			}
 			if (buf[pos] == '-' && buf[pos + 1] == '-') {
 				if (buf[pos + 2] == '>') {
 					if (param.flagCreateCommentNodes) {
@@ -1700,6 +1706,10 @@ namespace slib
 		sl_size startCDATA = pos;
 		sl_bool flagEnded = sl_false;
 		while (pos + 2 < len) {
+			pos = (sl_size)(_priv_TextScan_findAny(buf + pos, buf + len - 2, (CT)']', (CT)']') - buf);
+			if (pos + 2 >= len) {
+				break;
+			}
 			if (buf[pos] == ']' && buf[pos + 1] == ']' && buf[pos + 2] == '>') {
 				if (param.flagCreateTextNodes) {
 					String str(buf + startCDATA, pos - startCDATA);
@@ -1762,6 +1772,10 @@ namespace slib
 		sl_size startPI = pos;
 		sl_bool flagEnded = sl_false;
 		while (pos + 1 < len) {
+			pos = (sl_size)(_priv_TextScan_findAny(buf + pos, buf + len - 1, (CT)'?', (CT)'?') - buf);
+			if (pos + 1 >= len) {
+				break;
+			}
 			if (buf[pos] == '?' && buf[pos + 1] == '>') {
 				if (param.flagCreateProcessingInstructionNodes) {
 					String str(buf + startPI, pos - startPI);
@@ -1850,6 +1864,10 @@ namespace slib
 			BT sb;
 			CT chQuot = ch;
 			while (pos < len) {
+				pos = (sl_size)(_priv_TextScan_findAny(buf + pos, buf + len, (CT)'&', (CT)'<', chQuot) - buf);
+				if (pos >= len) {
+					break;
+				}
 				ch = buf[pos];
 				if (ch == '&') {
 					if (pos > startAttrValue) {
@@ -2085,6 +2103,10 @@ namespace slib
 		BT _sb;
 		BT* sb = param.flagCreateTextNodes ? &_sb : sl_null;
 		while (pos < len) {
+			pos = (sl_size)(_priv_TextScan_findAny(buf + pos, buf + len, (CT)'&', (CT)'<') - buf);
+			if (pos >= len) {
+				break;
+			}
 			CT ch = buf[pos];
 			if (ch == '&') {
 				if (sb) {
@@ -2313,6 +2335,21 @@ namespace slib
 
 	Ref<XmlDocument> Xml::parseXmlFromTextFile(const String& filePath, XmlParseParam& param)
 	{
+		// UTF-8 text is parsed directly on the mapped file
+		Memory mem = MappedFile::mapAllBytes(filePath);
+		if (mem.isNotNull()) {
+			sl_char8* data = (sl_char8*)(mem.getData());
+			sl_size size = mem.getSize();
+			if (size >= 2 && (((sl_uint8)(data[0]) == 0xFF && (sl_uint8)(data[1]) == 0xFE) || ((sl_uint8)(data[0]) == 0xFE && (sl_uint8)(data[1]) == 0xFF))) {
+				String16 xml = String16::fromUtf(data, size);
+				return _priv_Xml_Parser<String16, sl_char16, StringBuffer16>::parseXml(filePath, xml.getData(), xml.getLength(), param);
+			}
+			if (size >= 3 && (sl_uint8)(data[0]) == 0xEF && (sl_uint8)(data[1]) == 0xBB && (sl_uint8)(data[2]) == 0xBF) {
+				data += 3;
+				size -= 3;
+			}
+			return _priv_Xml_Parser<String, sl_char8, StringBuffer>::parseXml(filePath, data, size, param);
+		}
 		String16 xml = File::readAllText16(filePath);
 		return _priv_Xml_Parser<String16, sl_char16, StringBuffer16>::parseXml(filePath, xml.getData(), xml.getLength(), param);
 	}
@@ -2320,8 +2357,7 @@ namespace slib
 	Ref<XmlDocument> Xml::parseXmlFromTextFile(const String& filePath)
 	{
 		XmlParseParam param;
-		String16 xml = File::readAllText16(filePath);
-		return _priv_Xml_Parser<String16, sl_char16, StringBuffer16>::parseXml(filePath, xml.getData(), xml.getLength(), param);
+		return parseXmlFromTextFile(filePath, param);
 	}
 
 	
@@ -0,0 +1,862 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#include "slib/core/xml_reader.h"
+
+#include "slib/core/xml.h"
+#include "slib/core/io.h"
+#include "slib/core/async.h"
+#include "slib/core/base.h"
+
+#include "text_scan.h"
+
+namespace slib
+{
+	
+	// 1: matched, 0: more input is required, -1: not matched
+	static sl_int32 _priv_XmlReader_matchPrefix(const sl_char8* buf, sl_size len, const char* prefix, sl_size n)
+	{
+		sl_size m = len < n ? len : n;
+		for (sl_size i = 0; i < m; i++) {
+			if (buf[i] != prefix[i]) {
+				return -1;
+			}
+		}
+		return m == n ? 1 : 0;
+	}
+	
+	// finds `c1 c2 c3` sequence, returns `end` when not found
+	static const sl_char8* _priv_XmlReader_findSequence(const sl_char8* p, const sl_char8* end, sl_char8 c1, sl_char8 c2, sl_char8 c3)
+	{
+		for (;;) {
+			p = _priv_TextScan_findAny(p, end, c1, c1);
+			if (p + 2 >= end) {
+				return end;
+			}
+			if (p[1] == c2 && p[2] == c3) {
+				return p;
+			}
+			p++;
+		}
+	}
+	
+	static sl_bool _priv_XmlReader_isWhiteSpaces(const sl_char8* buf, sl_size len)
+	{
+		return _priv_TextScan_skipWhiteSpaces(buf, buf + len) == buf + len;
+	}
+	
+	// returns the error message of the first invalid entity, same as `Xml::parseXml`
+	static const char* _priv_XmlReader_checkEntities(const sl_char8* p, const sl_char8* end)
+	{
+		for (;;) {
+			p = _priv_TextScan_findAny(p, end, '&', '&');
+			if (p >= end) {
+				return sl_null;
+			}
+			p++;
+			if (p < end && *p == '#') {
+				p++;
+				const sl_char8* digits;
+				if (p < end && *p == 'x') {
+					p++;
+					digits = p;
+					while (p < end && SLIB_CHAR_IS_HEX(*p)) {
+						p++;
+					}
+				} else {
+					digits = p;
+					while (p < end && SLIB_CHAR_IS_DIGIT(*p)) {
+						p++;
+					}
+				}
+				if (p == digits) {
+					return "Invalid escaping entity";
+				}
+				if (p >= end || *p != ';') {
+					return "Missing semi-colon(;) at the end of entity definition";
+				}
+				p++;
+				continue;
+			}
+			const sl_char8* name = p;
+			while (p < end && *p != ';' && p - name < 5) {
+				p++;
+			}
+			if (p >= end || *p != ';') {
+				return "Invalid escaping entity";
+			}
+			sl_size n = p - name;
+			if (!((n == 2 && (Base::equalsMemory(name, "lt", 2) || Base::equalsMemory(name, "gt", 2))) || (n == 3 && Base::equalsMemory(name, "amp", 3)) || (n == 4 && (Base::equalsMemory(name, "apos", 4) || Base::equalsMemory(name, "quot", 4))))) {
+				return "Invalid escaping entity";
+			}
+			p++;
+		}
+	}
+	
+	
+	String XmlReaderAttribute::getName() const
+	{
+		return String(name, nameLength);
+	}
+	
+	String XmlReaderAttribute::getValue() const
+	{
+		return Xml::decodeTextFromEntities(String(value, valueLength));
+	}
+	
+	sl_bool XmlReaderAttribute::equalsName(const sl_char8* _name, sl_size length) const
+	{
+		return nameLength == length && Base::equalsMemory(name, _name, length);
+	}
+	
+	sl_bool XmlReaderAttribute::equalsName(const String& _name) const
+	{
+		return equalsName(_name.getData(), _name.getLength());
+	}
+	
+	
+	SLIB_DEFINE_OBJECT(XmlReader, Object)
+	
+	XmlReader::XmlReader()
+	{
+		m_sizeChunk = 16384;
+		
+		m_data = sl_null;
+		m_start = 0;
+		m_end = 0;
+		m_position = 0;
+		m_flagEnded = sl_false;
+		
+		m_event = XmlReaderEvent::None;
+		m_name = sl_null;
+		m_lenName = 0;
+		m_text = sl_null;
+		m_lenText = 0;
+		m_nAttributes = 0;
+		m_flagEmptyElement = sl_false;
+		m_flagPendingEnd = sl_false;
+		
+		m_sizeStack = 0;
+		m_flagFoundRoot = sl_false;
+		
+		m_flagIgnoreWhiteSpaces = sl_true;
+	}
+	
+	XmlReader::~XmlReader()
+	{
+	}
+	
+	Ref<XmlReader> XmlReader::create(sl_size sizeChunk)
+	{
+		Ref<XmlReader> ret = new XmlReader;
+		if (ret.isNotNull()) {
+			if (sizeChunk < 256) {
+				sizeChunk = 256;
+			}
+			ret->m_sizeChunk = sizeChunk;
+			return ret;
+		}
+		return sl_null;
+	}
+	
+	Ref<XmlReader> XmlReader::create(const Ptr<IReader>& reader, sl_size sizeChunk)
+	{
+		if (reader.isNull()) {
+			return sl_null;
+		}
+		Ref<XmlReader> ret = create(sizeChunk);
+		if (ret.isNotNull()) {
+			ret->m_reader = reader;
+			return ret;
+		}
+		return sl_null;
+	}
+	
+	sl_bool XmlReader::put(const void* data, sl_size size)
+	{
+		if (m_event == XmlReaderEvent::Error || m_flagEnded) {
+			return sl_false;
+		}
+		if (!size) {
+			return sl_true;
+		}
+		if (!(_prepareBuffer(size))) {
+			return sl_false;
+		}
+		Base::copyMemory(m_data + m_end, data, size);
+		m_end += size;
+		return sl_true;
+	}
+	
+	void XmlReader::end()
+	{
+		m_flagEnded = sl_true;
+	}
+	
+	XmlReaderEvent XmlReader::next()
+	{
+		if (m_event == XmlReaderEvent::Error || m_event == XmlReaderEvent::EndDocument) {
+			return m_event;
+		}
+		m_nAttributes = 0;
+		if (m_flagPendingEnd) {
+			// `m_name` still points to the name of the empty element
+			m_flagPendingEnd = sl_false;
+			_popName();
+			m_event = XmlReaderEvent::EndElement;
+			return m_event;
+		}
+		m_flagEmptyElement = sl_false;
+		for (;;) {
+			m_event = XmlReaderEvent::None;
+			sl_size n = _parse(m_data + m_start, m_end - m_start, m_flagEnded);
+			if (m_event == XmlReaderEvent::Error) {
+				return m_event;
+			}
+			if (n) {
+				m_start += n;
+				m_position += n;
+				if (m_event != XmlReaderEvent::None) {
+					return m_event;
+				}
+				continue;
+			}
+			if (m_flagEnded) {
+				if (m_stack.getCount()) {
+					_setError("Unexpected end of document");
+				} else if (!m_flagFoundRoot) {
+					_setError("Document must be well-formed");
+				} else {
+					m_event = XmlReaderEvent::EndDocument;
+				}
+				return m_event;
+			}
+			if (m_reader.isNull()) {
+				return XmlReaderEvent::None;
+			}
+			if (!(_fill())) {
+				return m_event;
+			}
+		}
+	}
+	
+	sl_bool XmlReader::read(const Ref<AsyncStream>& stream, const Function<void(XmlReader*, XmlReaderEvent)>& onEvent, const Function<void(XmlReader*, sl_bool flagSuccess)>& onComplete, sl_uint32 sizeChunk)
+	{
+		if (stream.isNull()) {
+			return sl_false;
+		}
+		if (!sizeChunk) {
+			sizeChunk = 16384;
+		}
+		Memory mem = Memory::create(sizeChunk);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		_readStream(stream, mem, onEvent, onComplete);
+		return sl_true;
+	}
+	
+	void XmlReader::_readStream(const Ref<AsyncStream>& stream, const Memory& buf, const Function<void(XmlReader*, XmlReaderEvent)>& onEvent, const Function<void(XmlReader*, sl_bool flagSuccess)>& onComplete)
+	{
+		Ref<XmlReader> thiz = this;
+		sl_bool flagRequested = stream->readToMemory(buf, [thiz, buf, onEvent, onComplete](AsyncStreamResult* result) {
+			if (result->flagError) {
+				onComplete(thiz.get(), sl_false);
+				return;
+			}
+			if (result->size) {
+				if (!(thiz->put(result->data, result->size))) {
+					onComplete(thiz.get(), sl_false);
+					return;
+				}
+			} else {
+				thiz->end();
+			}
+			if (thiz->_dispatchEvents(onEvent, onComplete)) {
+				thiz->_readStream(result->stream, buf, onEvent, onComplete);
+			}
+		});
+		if (!flagRequested) {
+			onComplete(this, sl_false);
+		}
+	}
+	
+	sl_bool XmlReader::_dispatchEvents(const Function<void(XmlReader*, XmlReaderEvent)>& onEvent, const Function<void(XmlReader*, sl_bool flagSuccess)>& onComplete)
+	{
+		for (;;) {
+			XmlReaderEvent ev = next();
+			switch (ev) {
+				case XmlReaderEvent::None:
+					return sl_true;
+				case XmlReaderEvent::EndDocument:
+					onComplete(this, sl_true);
+					return sl_false;
+				case XmlReaderEvent::Error:
+					onComplete(this, sl_false);
+					return sl_false;
+				default:
+					onEvent(this, ev);
+					break;
+			}
+		}
+	}
+	
+	XmlReaderEvent XmlReader::getEvent()
+	{
+		return m_event;
+	}
+	
+	const sl_char8* XmlReader::getName(sl_size* outLength)
+	{
+		if (outLength) {
+			*outLength = m_lenName;
+		}
+		return m_name;
+	}
+	
+	String XmlReader::getName()
+	{
+		return String(m_name, m_lenName);
+	}
+	
+	sl_bool XmlReader::equalsName(const sl_char8* name, sl_size length)
+	{
+		return m_lenName == length && Base::equalsMemory(m_name, name, length);
+	}
+	
+	sl_bool XmlReader::equalsName(const String& name)
+	{
+		return equalsName(name.getData(), name.getLength());
+	}
+	
+	sl_size XmlReader::getAttributesCount()
+	{
+		return m_nAttributes;
+	}
+	
+	const XmlReaderAttribute* XmlReader::getAttributes()
+	{
+		return m_attributes.getData();
+	}
+	
+	String XmlReader::getAttribute(const String& name)
+	{
+		XmlReaderAttribute* attrs = m_attributes.getData();
+		for (sl_size i = 0; i < m_nAttributes; i++) {
+			if (attrs[i].equalsName(name)) {
+				return attrs[i].getValue();
+			}
+		}
+		return sl_null;
+	}
+	
+	sl_bool XmlReader::isEmptyElement()
+	{
+		return m_flagEmptyElement;
+	}
+	
+	const sl_char8* XmlReader::getText(sl_size* outLength)
+	{
+		if (outLength) {
+			*outLength = m_lenText;
+		}
+		return m_text;
+	}
+	
+	String XmlReader::getText()
+	{
+		if (m_event == XmlReaderEvent::Text) {
+			return Xml::decodeTextFromEntities(String(m_text, m_lenText));
+		}
+		return String(m_text, m_lenText);
+	}
+	
+	sl_size XmlReader::getDepth()
+	{
+		return m_stack.getCount();
+	}
+	
+	sl_uint64 XmlReader::getPosition()
+	{
+		return m_position;
+	}
+	
+	sl_bool XmlReader::isError()
+	{
+		return m_event == XmlReaderEvent::Error;
+	}
+	
+	String XmlReader::getErrorMessage()
+	{
+		return m_errorMessage;
+	}
+	
+	sl_bool XmlReader::isIgnoringWhiteSpaces()
+	{
+		return m_flagIgnoreWhiteSpaces;
+	}
+	
+	void XmlReader::setIgnoringWhiteSpaces(sl_bool flag)
+	{
+		m_flagIgnoreWhiteSpaces = flag;
+	}
+	
+	sl_size XmlReader::_parse(const sl_char8* buf, sl_size len, sl_bool flagEnd)
+	{
+		if (!len) {
+			return 0;
+		}
+		if (buf[0] != '<') {
+			return _parseText(buf, len, flagEnd);
+		}
+		if (len < 2) {
+			if (flagEnd) {
+				_setError("Invalid Markup");
+			}
+			return 0;
+		}
+		const sl_char8* end = buf + len;
+		sl_char8 ch = buf[1];
+		if (ch == '!') {
+			sl_int32 iComment = _priv_XmlReader_matchPrefix(buf, len, "<!--", 4);
+			if (iComment > 0) {
+				const sl_char8* p = buf + 4;
+				for (;;) {
+					p = _priv_TextScan_findAny(p, end, '-', '-');
+					if (p + 2 >= end) {
+						if (flagEnd) {
+							_setError("Comment Section must be ended with -->");
+						}
+						return 0;
+					}
+					if (p[1] == '-') {
+						if (p[2] != '>') {
+							_setError("Double-hyphen(--) is not allowed in comment text");
+							return 0;
+						}
+						m_text = buf + 4;
+						m_lenText = p - m_text;
+						m_event = XmlReaderEvent::Comment;
+						return p + 3 - buf;
+					}
+					p++;
+				}
+			}
+			sl_int32 iCDATA = _priv_XmlReader_matchPrefix(buf, len, "<![CDATA[", 9);
+			if (iCDATA > 0) {
+				const sl_char8* p = _priv_XmlReader_findSequence(buf + 9, end, ']', ']', '>');
+				if (p == end) {
+					if (flagEnd) {
+						_setError("CDATA Section must be ended with ]]>");
+					}
+					return 0;
+				}
+				if (!(m_stack.getCount())) {
+					_setError("Document must be well-formed");
+					return 0;
+				}
+				m_text = buf + 9;
+				m_lenText = p - m_text;
+				m_event = XmlReaderEvent::CDATA;
+				return p + 3 - buf;
+			}
+			if ((iComment == 0 || iCDATA == 0) && !flagEnd) {
+				return 0;
+			}
+			_setError("Invalid Markup");
+			return 0;
+		} else if (ch == '?') {
+			const sl_char8* p = buf + 2;
+			while (p < end && *p != '?' && !(SLIB_CHAR_IS_WHITE_SPACE(*p))) {
+				p++;
+			}
+			if (p >= end) {
+				if (flagEnd) {
+					_setError("Processing Instruction Section must be ended with ?>");
+				}
+				return 0;
+			}
+			const sl_char8* target = buf + 2;
+			sl_size lenTarget = p - target;
+			if (!(Xml::checkName(target, lenTarget))) {
+				_setError("Name definition is containing invalid character");
+				return 0;
+			}
+			const sl_char8* content = _priv_TextScan_skipWhiteSpaces(p, end);
+			p = content;
+			for (;;) {
+				p = _priv_TextScan_findAny(p, end, '?', '?');
+				if (p + 1 >= end) {
+					if (flagEnd) {
+						_setError("Processing Instruction Section must be ended with ?>");
+					}
+					return 0;
+				}
+				if (p[1] == '>') {
+					break;
+				}
+				p++;
+			}
+			m_name = target;
+			m_lenName = lenTarget;
+			m_text = content;
+			m_lenText = p - content;
+			m_event = XmlReaderEvent::ProcessingInstruction;
+			return p + 2 - buf;
+		} else if (ch == '/') {
+			return _parseEndTag(buf, len, flagEnd);
+		} else {
+			return _parseStartTag(buf, len, flagEnd);
+		}
+	}
+	
+	sl_size XmlReader::_parseText(const sl_char8* buf, sl_size len, sl_bool flagEnd)
+	{
+		sl_size n = _priv_TextScan_findAny(buf, buf + len, '<', '<') - buf;
+		if (n == len && !flagEnd) {
+			if (len < m_sizeChunk) {
+				return 0;
+			}
+			// reports a part of the long text, without splitting an entity or a UTF-8 sequence
+			for (sl_size i = 1; i <= 10 && i <= n; i++) {
+				sl_char8 c = buf[n - i];
+				if (c == ';') {
+					break;
+				}
+				if (c == '&') {
+					n -= i;
+					break;
+				}
+			}
+			// back to the start of the last UTF-8 sequence when it is incomplete
+			sl_size k = n;
+			while (k > 0 && n - k < 3 && (((sl_uint8)(buf[k - 1])) & 0xC0) == 0x80) {
+				k--;
+			}
+			if (k > 0) {
+				sl_uint8 lead = (sl_uint8)(buf[k - 1]);
+				if (lead >= 0xC0) {
+					sl_size m = lead >= 0xF0 ? 4 : (lead >= 0xE0 ? 3 : 2);
+					if (k - 1 + m > n) {
+						n = k - 1;
+					}
+				}
+			}
+			if (!n) {
+				return 0;
+			}
+		}
+		sl_bool flagWhiteSpaces = _priv_XmlReader_isWhiteSpaces(buf, n);
+		if (!flagWhiteSpaces) {
+			if (!(m_stack.getCount())) {
+				// text is not allowed outside of the root element
+				_setError("Document must be well-formed");
+				return 0;
+			}
+			const char* error = _priv_XmlReader_checkEntities(buf, buf + n);
+			if (error) {
+				_setError(error);
+				return 0;
+			}
+		}
+		if (flagWhiteSpaces && m_flagIgnoreWhiteSpaces) {
+			return n;
+		}
+		m_text = buf;
+		m_lenText = n;
+		m_event = XmlReaderEvent::Text;
+		return n;
+	}
+	
+	sl_size XmlReader::_parseStartTag(const sl_char8* buf, sl_size len, sl_bool flagEnd)
+	{
+		const sl_char8* end = buf + len;
+		const sl_char8* p = buf + 1;
+		while (p < end) {
+			sl_char8 c = *p;
+			if (c == '>' || c == '/' || SLIB_CHAR_IS_WHITE_SPACE(c)) {
+				break;
+			}
+			p++;
+		}
+		if (p >= end) {
+			if (flagEnd) {
+				_setError("Element tag definition must be ended with > or />");
+			}
+			return 0;
+		}
+		const sl_char8* name = buf + 1;
+		sl_size lenName = p - name;
+		if (!lenName) {
+			_setError("Name definition is missing");
+			return 0;
+		}
+		if (!(Xml::checkName(name, lenName))) {
+			_setError("Name definition is containing invalid character");
+			return 0;
+		}
+		sl_size nAttrs = 0;
+		sl_bool flagEmpty = sl_false;
+		sl_bool flagClosed = sl_false;
+		for (;;) {
+			p = _priv_TextScan_skipWhiteSpaces(p, end);
+			if (p >= end) {
+				break;
+			}
+			sl_char8 c = *p;
+			if (c == '>') {
+				p++;
+				flagClosed = sl_true;
+				break;
+			}
+			if (c == '/') {
+				if (p + 1 >= end) {
+					break;
+				}
+				if (p[1] != '>') {
+					_setError("Element tag definition must be ended with > or />");
+					return 0;
+				}
+				flagEmpty = sl_true;
+				flagClosed = sl_true;
+				p += 2;
+				break;
+			}
+			// attribute
+			const sl_char8* attrName = p;
+			while (p < end) {
+				c = *p;
+				if (c == '=' || c == '>' || c == '/' || SLIB_CHAR_IS_WHITE_SPACE(c)) {
+					break;
+				}
+				p++;
+			}
+			sl_size lenAttrName = p - attrName;
+			p = _priv_TextScan_skipWhiteSpaces(p, end);
+			if (p >= end) {
+				break;
+			}
+			if (!(Xml::checkName(attrName, lenAttrName))) {
+				_setError("Name definition is containing invalid character");
+				return 0;
+			}
+			if (*p != '=') {
+				_setError("An assign(=) symbol is required for attribute definition");
+				return 0;
+			}
+			p = _priv_TextScan_skipWhiteSpaces(p + 1, end);
+			if (p >= end) {
+				break;
+			}
+			sl_char8 quote = *p;
+			if (quote != '"' && quote != '\'') {
+				_setError("Attribute value definition must be started with \" or ' symbol");
+				return 0;
+			}
+			const sl_char8* value = p + 1;
+			p = _priv_TextScan_findAny(value, end, quote, quote);
+			if (p >= end) {
+				break;
+			}
+			p++;
+			if (p < end) {
+				c = *p;
+				if (!(c == '>' || c == '/' || SLIB_CHAR_IS_WHITE_SPACE(c))) {
+					_setError("Attribute value definition must be followed by >, /, or whitespaces");
+					return 0;
+				}
+			}
+			const char* error = _priv_XmlReader_checkEntities(value, p - 1);
+			if (error) {
+				_setError(error);
+				return 0;
+			}
+			XmlReaderAttribute attr;
+			attr.name = attrName;
+			attr.nameLength = lenAttrName;
+			attr.value = value;
+			attr.valueLength = p - 1 - value;
+			if (nAttrs < m_attributes.getCount()) {
+				m_attributes.getData()[nAttrs] = attr;
+			} else {
+				if (!(m_attributes.add_NoLock(attr))) {
+					_setError("Lack of Memory");
+					return 0;
+				}
+			}
+			nAttrs++;
+		}
+		if (!flagClosed) {
+			if (flagEnd) {
+				_setError("Element tag definition must be ended with > or />");
+			}
+			return 0;
+		}
+		if (!(m_stack.getCount())) {
+			if (m_flagFoundRoot) {
+				// second root element
+				_setError("Document must be well-formed");
+				return 0;
+			}
+			m_flagFoundRoot = sl_true;
+		}
+		if (!(_pushName(name, lenName))) {
+			return 0;
+		}
+		m_name = name;
+		m_lenName = lenName;
+		m_nAttributes = nAttrs;
+		m_flagEmptyElement = flagEmpty;
+		m_flagPendingEnd = flagEmpty;
+		m_event = XmlReaderEvent::StartElement;
+		return p - buf;
+	}
+	
+	sl_size XmlReader::_parseEndTag(const sl_char8* buf, sl_size len, sl_bool flagEnd)
+	{
+		const sl_char8* end = buf + len;
+		const sl_char8* p = _priv_TextScan_findAny(buf + 2, end, '>', '>');
+		if (p >= end) {
+			if (flagEnd) {
+				_setError("Element tag definition must be ended with > or />");
+			}
+			return 0;
+		}
+		const sl_char8* name = buf + 2;
+		sl_size lenName = p - name;
+		while (lenName && SLIB_CHAR_IS_WHITE_SPACE(name[lenName - 1])) {
+			lenName--;
+		}
+		sl_size nStack = m_stack.getCount();
+		if (!nStack) {
+			_setError("Element must be terminated by the matching end-tag");
+			return 0;
+		}
+		sl_size offset = m_stack.getData()[nStack - 1];
+		if (m_sizeStack - offset != lenName || !(Base::equalsMemory(((sl_char8*)(m_bufStack.getData())) + offset, name, lenName))) {
+			_setError("Element must be terminated by the matching end-tag");
+			return 0;
+		}
+		_popName();
+		m_name = name;
+		m_lenName = lenName;
+		m_event = XmlReaderEvent::EndElement;
+		return p + 1 - buf;
+	}
+	
+	sl_bool XmlReader::_prepareBuffer(sl_size sizeRequired)
+	{
+		sl_size sizeRemain = m_end - m_start;
+		if (m_start) {
+			if (sizeRemain) {
+				Base::moveMemory(m_data, m_data + m_start, sizeRemain);
+			}
+			m_start = 0;
+			m_end = sizeRemain;
+		}
+		sl_size capacity = m_buf.getSize();
+		sl_size sizeTotal = sizeRemain + sizeRequired;
+		if (sizeTotal > capacity) {
+			capacity <<= 1;
+			if (capacity < sizeTotal) {
+				capacity = sizeTotal;
+			}
+			if (capacity < (m_sizeChunk << 1)) {
+				capacity = m_sizeChunk << 1;
+			}
+			Memory mem = Memory::create(capacity);
+			if (mem.isNull()) {
+				_setError("Lack of Memory");
+				return sl_false;
+			}
+			if (sizeRemain) {
+				Base::copyMemory(mem.getData(), m_data, sizeRemain);
+			}
+			m_buf = mem;
+			m_data = (sl_char8*)(mem.getData());
+		}
+		return sl_true;
+	}
+	
+	sl_bool XmlReader::_fill()
+	{
+		PtrLocker<IReader> reader(m_reader);
+		if (reader.isNull()) {
+			m_flagEnded = sl_true;
+			return sl_true;
+		}
+		if (!(_prepareBuffer(m_sizeChunk))) {
+			return sl_false;
+		}
+		sl_reg n = reader->read(m_data + m_end, m_buf.getSize() - m_end);
+		if (n > 0) {
+			m_end += n;
+		} else {
+			m_flagEnded = sl_true;
+		}
+		return sl_true;
+	}
+	
+	sl_bool XmlReader::_pushName(const sl_char8* name, sl_size len)
+	{
+		sl_size size = m_sizeStack + len;
+		if (size > m_bufStack.getSize()) {
+			sl_size capacity = m_bufStack.getSize() << 1;
+			if (capacity < size) {
+				capacity = size;
+			}
+			if (capacity < 256) {
+				capacity = 256;
+			}
+			Memory mem = Memory::create(capacity);
+			if (mem.isNull()) {
+				_setError("Lack of Memory");
+				return sl_false;
+			}
+			if (m_sizeStack) {
+				Base::copyMemory(mem.getData(), m_bufStack.getData(), m_sizeStack);
+			}
+			m_bufStack = mem;
+		}
+		if (!(m_stack.add_NoLock(m_sizeStack))) {
+			_setError("Lack of Memory");
+			return sl_false;
+		}
+		Base::copyMemory(((sl_char8*)(m_bufStack.getData())) + m_sizeStack, name, len);
+		m_sizeStack = size;
+		return sl_true;
+	}
+	
+	void XmlReader::_popName()
+	{
+		sl_size offset;
+		if (m_stack.popBack_NoLock(&offset)) {
+			m_sizeStack = offset;
+		}
+	}
+	
+	void XmlReader::_setError(const char* message)
+	{
+		m_event = XmlReaderEvent::Error;
+		m_errorMessage = message;
+	}
+	
+}
@@ -24,6 +24,12 @@
 
 #include "slib/crypto/sha2.h"
 #include "slib/core/mio.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+#	include <wmmintrin.h>
+#	define PRIV_AES_NI SLIB_TARGET_FEATURES("aes,sse2")
+#endif
 
 /*
 	AES - Advanced Encryption Standard
@@ -36,6 +42,8 @@ namespace slib
 
 	AES::AES()
 	{
+		m_nCountRounds = 0;
+		m_flagAESNI = sl_false;
 	}
 
 	AES::~AES()
@@ -266,6 +274,104 @@ static const sl_uint32 _priv_AES_RT3[256] = { RT };
 #define SBOX_INV3(x) (_priv_AES_RT3[SBOX(x)])
 #define ROUND_KEY_INV(x) ((SBOX_INV0(TO_BYTE((x) >> 24))) ^ (SBOX_INV1(TO_BYTE((x) >> 16))) ^ (SBOX_INV2(TO_BYTE((x) >> 8))) ^ (SBOX_INV3(TO_BYTE(x))))
 
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+/*
+	AES-NI
+
+	Round keys are the same as the table-driven implementation, in byte order.
+	Decryption uses the Equivalent Inverse Cipher, with InvMixColumns (AESIMC) applied to the middle round keys.
+*/
+	PRIV_AES_NI static void _priv_AES_NI_prepareDecryptionKeys(const sl_uint8* enc, sl_uint8* dec, sl_uint32 nRounds)
+	{
+		_mm_storeu_si128((__m128i*)dec, _mm_loadu_si128((const __m128i*)(enc + (nRounds << 4))));
+		for (sl_uint32 i = 1; i < nRounds; i++) {
+			_mm_storeu_si128((__m128i*)(dec + (i << 4)), _mm_aesimc_si128(_mm_loadu_si128((const __m128i*)(enc + ((nRounds - i) << 4)))));
+		}
+		_mm_storeu_si128((__m128i*)(dec + (nRounds << 4)), _mm_loadu_si128((const __m128i*)enc));
+	}
+
+	// 4 blocks are processed in parallel to hide the latency of AESENC
+	PRIV_AES_NI static void _priv_AES_NI_encryptBlocks(const sl_uint8* keys, sl_uint32 nRounds, const void* _src, void* _dst, sl_size nBlocks)
+	{
+		const __m128i* src = (const __m128i*)_src;
+		__m128i* dst = (__m128i*)_dst;
+		__m128i K[15];
+		sl_uint32 i;
+		for (i = 0; i <= nRounds; i++) {
+			K[i] = _mm_loadu_si128((const __m128i*)(keys + (i << 4)));
+		}
+		while (nBlocks >= 4) {
+			__m128i b0 = _mm_xor_si128(_mm_loadu_si128(src), K[0]);
+			__m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + 1), K[0]);
+			__m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + 2), K[0]);
+			__m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + 3), K[0]);
+			for (i = 1; i < nRounds; i++) {
+				b0 = _mm_aesenc_si128(b0, K[i]);
+				b1 = _mm_aesenc_si128(b1, K[i]);
+				b2 = _mm_aesenc_si128(b2, K[i]);
+				b3 = _mm_aesenc_si128(b3, K[i]);
+			}
+			_mm_storeu_si128(dst, _mm_aesenclast_si128(b0, K[nRounds]));
+			_mm_storeu_si128(dst + 1, _mm_aesenclast_si128(b1, K[nRounds]));
+			_mm_storeu_si128(dst + 2, _mm_aesenclast_si128(b2, K[nRounds]));
+			_mm_storeu_si128(dst + 3, _mm_aesenclast_si128(b3, K[nRounds]));
+			src += 4;
+			dst += 4;
+			nBlocks -= 4;
+		}
+		while (nBlocks) {
+			__m128i b = _mm_xor_si128(_mm_loadu_si128(src), K[0]);
+			for (i = 1; i < nRounds; i++) {
+				b = _mm_aesenc_si128(b, K[i]);
+			}
+			_mm_storeu_si128(dst, _mm_aesenclast_si128(b, K[nRounds]));
+			src++;
+			dst++;
+			nBlocks--;
+		}
+	}
+
+	PRIV_AES_NI static void _priv_AES_NI_decryptBlocks(const sl_uint8* keys, sl_uint32 nRounds, const void* _src, void* _dst, sl_size nBlocks)
+	{
+		const __m128i* src = (const __m128i*)_src;
+		__m128i* dst = (__m128i*)_dst;
+		__m128i K[15];
+		sl_uint32 i;
+		for (i = 0; i <= nRounds; i++) {
+			K[i] = _mm_loadu_si128((const __m128i*)(keys + (i << 4)));
+		}
+		while (nBlocks >= 4) {
+			__m128i b0 = _mm_xor_si128(_mm_loadu_si128(src), K[0]);
+			__m128i b1 = _mm_xor_si128(_mm_loadu_si128(src + 1), K[0]);
+			__m128i b2 = _mm_xor_si128(_mm_loadu_si128(src + 2), K[0]);
+			__m128i b3 = _mm_xor_si128(_mm_loadu_si128(src + 3), K[0]);
+			for (i = 1; i < nRounds; i++) {
+				b0 = _mm_aesdec_si128(b0, K[i]);
+				b1 = _mm_aesdec_si128(b1, K[i]);
+				b2 = _mm_aesdec_si128(b2, K[i]);
+				b3 = _mm_aesdec_si128(b3, K[i]);
+			}
+			_mm_storeu_si128(dst, _mm_aesdeclast_si128(b0, K[nRounds]));
+			_mm_storeu_si128(dst + 1, _mm_aesdeclast_si128(b1, K[nRounds]));
+			_mm_storeu_si128(dst + 2, _mm_aesdeclast_si128(b2, K[nRounds]));
+			_mm_storeu_si128(dst + 3, _mm_aesdeclast_si128(b3, K[nRounds]));
+			src += 4;
+			dst += 4;
+			nBlocks -= 4;
+		}
+		while (nBlocks) {
+			__m128i b = _mm_xor_si128(_mm_loadu_si128(src), K[0]);
+			for (i = 1; i < nRounds; i++) {
+				b = _mm_aesdec_si128(b, K[i]);
+			}
+			_mm_storeu_si128(dst, _mm_aesdeclast_si128(b, K[nRounds]));
+			src++;
+			dst++;
+			nBlocks--;
+		}
+	}
+#endif
+
 	sl_bool AES::setKey(const void* _key, sl_uint32 lenKey)
 	{
 		const sl_uint8* key = (const sl_uint8*)_key;
@@ -365,6 +471,17 @@ static const sl_uint32 _priv_AES_RT3[256] = { RT };
 			W += 4;
 		}
 		Base::copyMemory(W, WE, 32);
+		
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		m_flagAESNI = Cpu::isAESNISupported();
+		if (m_flagAESNI) {
+			j = (nRounds + 1) << 2;
+			for (i = 0; i < j; i++) {
+				MIO::writeUint32BE(m_roundKeyEncNI + (i << 2), m_roundKeyEnc[i]);
+			}
+			_priv_AES_NI_prepareDecryptionKeys(m_roundKeyEncNI, m_roundKeyDecNI, nRounds);
+		}
+#endif
 		return sl_true;
 	}
 
@@ -446,6 +563,12 @@ Roundn (Last):
 	
 	void AES::encryptBlock(const void* _src, void *_dst) const
 	{
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (m_flagAESNI) {
+			_priv_AES_NI_encryptBlocks(m_roundKeyEncNI, m_nCountRounds, _src, _dst, 1);
+			return;
+		}
+#endif
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
 
@@ -542,6 +665,12 @@ Roundn (Last):
 	
 	void AES::decryptBlock(const void* _src, void *_dst) const
 	{
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (m_flagAESNI) {
+			_priv_AES_NI_decryptBlocks(m_roundKeyDecNI, m_nCountRounds, _src, _dst, 1);
+			return;
+		}
+#endif
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
 		
@@ -558,6 +687,50 @@ Roundn (Last):
 		MIO::writeUint32BE(OUT + 12, d3);
 	}
 
+	sl_size AES::encryptBlocks(const void* _src, void* _dst, sl_size size) const
+	{
+		if (size & 15) {
+			return 0;
+		}
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (m_flagAESNI) {
+			_priv_AES_NI_encryptBlocks(m_roundKeyEncNI, m_nCountRounds, _src, _dst, size >> 4);
+			return size;
+		}
+#endif
+		const sl_uint8* src = (const sl_uint8*)_src;
+		sl_uint8* dst = (sl_uint8*)_dst;
+		sl_size n = size >> 4;
+		for (sl_size i = 0; i < n; i++) {
+			encryptBlock(src, dst);
+			src += 16;
+			dst += 16;
+		}
+		return size;
+	}
+
+	sl_size AES::decryptBlocks(const void* _src, void* _dst, sl_size size) const
+	{
+		if (size & 15) {
+			return 0;
+		}
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (m_flagAESNI) {
+			_priv_AES_NI_decryptBlocks(m_roundKeyDecNI, m_nCountRounds, _src, _dst, size >> 4);
+			return size;
+		}
+#endif
+		const sl_uint8* src = (const sl_uint8*)_src;
+		sl_uint8* dst = (sl_uint8*)_dst;
+		sl_size n = size >> 4;
+		for (sl_size i = 0; i < n; i++) {
+			decryptBlock(src, dst);
+			src += 16;
+			dst += 16;
+		}
+		return size;
+	}
+
 	void AES::setKey_SHA256(const String& key)
 	{
 		char sig[32];
@@ -30,6 +30,8 @@
 #include "slib/crypto/blowfish.h"
 #include "slib/crypto/des.h"
 
+#define PRIV_BLOCKCIPHER_CTR_BATCH 8
+
 namespace slib
 {
 
@@ -134,13 +136,13 @@ namespace slib
 			return 0;
 		}
 		sl_size n = size / block;
-		for (sl_size i = 0; i < n; i++) {
-			crypto->encryptBlock(src, dst);
-			src += block;
-			dst += block;
+		sl_size p = n * block;
+		if (n) {
+			crypto->encryptBlocks(src, dst, p);
+			src += p;
+			dst += p;
 		}
 		char last[256];
-		sl_size p = n * block;
 		sl_uint32 m = (sl_uint32)(size - p);
 		Base::copyMemory(last, src, m);
 		Padding::addPadding(last + m, block - m);
@@ -161,13 +163,11 @@ namespace slib
 		if (size % block != 0) {
 			return 0;
 		}
-		sl_size n = size / block;
-		for (sl_size i = 0; i < n; i++) {
-			crypto->decryptBlock(src, dst);
-			src += block;
-			dst += block;
+		if (!size) {
+			return 0;
 		}
-		sl_uint32 padding = Padding::removePadding(dst - block, block);
+		crypto->decryptBlocks(src, dst, size);
+		sl_uint32 padding = Padding::removePadding(dst + size - block, block);
 		if (padding > 0) {
 			return size - padding;
 		} else {
@@ -255,15 +255,36 @@ namespace slib
 		if (size % block != 0) {
 			return 0;
 		}
+		if (!size) {
+			return 0;
+		}
 		sl_size n = size / block;
-		for (sl_size i = 0; i < n; i++) {
-			crypto->decryptBlock(src, dst);
-			for (sl_uint32 k = 0; k < block; k++) {
-				dst[k] ^= iv[k];
+		if (src + size <= dst || dst + size <= src) {
+			// blocks are independent on decryption: decrypt all at once and chain afterwards
+			crypto->decryptBlocks(src, dst, size);
+			for (sl_size i = 0; i < n; i++) {
+				for (sl_uint32 k = 0; k < block; k++) {
+					dst[k] ^= iv[k];
+				}
+				iv = src;
+				src += block;
+				dst += block;
+			}
+		} else {
+			// overlapped buffers: keep the previous cipher block before it is overwritten
+			char prev[256];
+			char cur[256];
+			Base::copyMemory(prev, iv, block);
+			for (sl_size i = 0; i < n; i++) {
+				Base::copyMemory(cur, src, block);
+				crypto->decryptBlock(src, dst);
+				for (sl_uint32 k = 0; k < block; k++) {
+					dst[k] ^= prev[k];
+				}
+				Base::copyMemory(prev, cur, block);
+				src += block;
+				dst += block;
 			}
-			iv = src;
-			src += block;
-			dst += block;
 		}
 		sl_uint32 padding = Padding::removePadding(dst - block, block);
 		if (padding > 0) {
@@ -341,6 +362,28 @@ namespace slib
 				return size;
 			}
 		}
+		if (size >= (sizeBlock << 1)) {
+			// encrypt a batch of counter blocks at once, so that the cipher can pipeline them
+			sl_uint8 masks[SLIB_CRYPTO_BLOCK_CIPHER_BLOCK_MAX_LEN * PRIV_BLOCKCIPHER_CTR_BATCH];
+			do {
+				sl_size nBlocks = size / sizeBlock;
+				if (nBlocks > PRIV_BLOCKCIPHER_CTR_BATCH) {
+					nBlocks = PRIV_BLOCKCIPHER_CTR_BATCH;
+				}
+				n = nBlocks * sizeBlock;
+				for (i = 0; i < n; i += sizeBlock) {
+					Base::copyMemory(masks + i, counter, sizeBlock);
+					MIO::increaseBE(counter, sizeBlock);
+				}
+				crypto->encryptBlocks(masks, masks, n);
+				for (i = 0; i < n; i++) {
+					output[i] = input[i] ^ masks[i];
+				}
+				size -= n;
+				input += n;
+				output += n;
+			} while (size >= sizeBlock);
+		}
 		while (size > 0) {
 			crypto->encryptBlock(counter, mask);
 			n = SLIB_MIN(sizeBlock, size);
@@ -387,6 +430,9 @@ namespace slib
 	{ return BlockCipher_Blocks<CLASS>::encryptBlocks(this, src, dst, size); } \
 	sl_size CLASS::decryptBlocks(const void* src, void* dst, sl_size size) const \
 	{ return BlockCipher_Blocks<CLASS>::decryptBlocks(this, src, dst, size); } \
+	DEFINE_BLOCKCIPHER_MODES(CLASS)
+
+#define DEFINE_BLOCKCIPHER_MODES(CLASS) \
 	sl_size CLASS::encrypt_ECB_PKCS7Padding(const void* src, sl_size size, void* dst) const \
 	{ return BlockCipher_ECB<CLASS, BlockCipherPadding_PKCS7>::encrypt(this, src, size, dst); } \
 	sl_size CLASS::decrypt_ECB_PKCS7Padding(const void* src, sl_size size, void* dst) const \
@@ -414,7 +460,8 @@ namespace slib
 	sl_size CLASS::encrypt_CTR(const void* iv, sl_uint64 pos, const void* input, sl_size size, void* output) const \
 	{ return BlockCipher_CTR<CLASS>::encrypt(this, iv, pos, input, size, output); }
 
-	DEFINE_BLOCKCIPHER(AES);
+	// AES::encryptBlocks() and AES::decryptBlocks() are defined in aes.cpp (AES-NI)
+	DEFINE_BLOCKCIPHER_MODES(AES);
 	DEFINE_BLOCKCIPHER(Blowfish);
 	DEFINE_BLOCKCIPHER(DES);
 	DEFINE_BLOCKCIPHER(TripleDES);
@@ -22,8 +22,28 @@
 
 #include "slib/crypto/zlib.h"
 
+#include "slib/core/cpu.h"
+#include "slib/core/event.h"
+#include "slib/core/mio.h"
+#include "slib/core/safe_static.h"
+
 #include "zlib/zlib.h"
 
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+#	include <immintrin.h>
+#	define PRIV_ZLIB_CRC32_CLMUL SLIB_TARGET_FEATURES("pclmul,sse4.1")
+#	define PRIV_ZLIB_ADLER32_SSSE3 SLIB_TARGET_FEATURES("ssse3")
+#elif defined(SLIB_ARCH_IS_ARM64) && defined(__ARM_FEATURE_CRC32)
+#	include <arm_acle.h>
+#	define PRIV_ZLIB_CRC32_ARMV8
+#endif
+
+// shorter input is processed by the scalar code in zlib
+#define PRIV_ZLIB_SIMD_MIN_LENGTH 64
+
+#define PRIV_ZLIB_PARALLEL_BLOCK_SIZE 131072
+#define PRIV_ZLIB_PARALLEL_DICTIONARY_SIZE 32768
+
 #define STREAM ((z_stream*)(this->m_stream))
 #define GZIP_HEADER ((gz_header*)(this->m_gzipHeader))
 
@@ -186,6 +206,53 @@ namespace slib
 		return ret;
 	}
 
+	Memory ZlibCompress::compressAndFlush(const void* data, sl_size size)
+	{
+		if (!m_flagStarted) {
+			return sl_null;
+		}
+		sl_uint32 sizeChunk;
+		if (size > 16384) {
+			sizeChunk = 262144;
+		} else {
+			sizeChunk = 4096;
+		}
+		Memory memChunk = Memory::create(sizeChunk);
+		if (memChunk.isNull()) {
+			return sl_null;
+		}
+		sl_uint8* chunk = (sl_uint8*)(memChunk.getData());
+		
+		z_stream* stream = STREAM;
+		stream->next_in = (Bytef*)data;
+		MemoryBuffer buffer;
+		do {
+			sl_uint32 sizeInput = (sl_uint32)(SLIB_MIN(size, (sl_size)0x40000000));
+			size -= sizeInput;
+			stream->avail_in = sizeInput;
+			for (;;) {
+				stream->next_out = (Bytef*)chunk;
+				stream->avail_out = sizeChunk;
+				int iRet = deflate(stream, size ? Z_NO_FLUSH : Z_SYNC_FLUSH);
+				// Z_BUF_ERROR: no progress was possible
+				if (iRet < 0 && iRet != Z_BUF_ERROR) {
+					abort();
+					return sl_null;
+				}
+				sl_uint32 sizeOutput = sizeChunk - stream->avail_out;
+				if (sizeOutput) {
+					if (!(buffer.add(Memory::create(chunk, sizeOutput)))) {
+						return sl_null;
+					}
+				}
+				if (stream->avail_out) {
+					break;
+				}
+			}
+		} while (size);
+		return buffer.merge();
+	}
+
 	void ZlibCompress::abort()
 	{
 		if (m_flagStarted) {
@@ -316,9 +383,178 @@ namespace slib
 		}
 	}
 
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+/*
+	CRC32 by folding with carry-less multiplication
+ 
+	Intel: Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction
+	`size` should be a multiple of 16, and at least 64. `crc` is in the inverted form.
+*/
+	PRIV_ZLIB_CRC32_CLMUL static sl_uint32 _priv_Zlib_crc32_CLMUL(sl_uint32 crc, const sl_uint8* buf, sl_size size)
+	{
+		// bit-reflected constants of the CRC32 polynomial (0x04C11DB7)
+		const __m128i k1k2 = _mm_set_epi64x(SLIB_UINT64(0x01c6e41596), SLIB_UINT64(0x0154442bd4));
+		const __m128i k3k4 = _mm_set_epi64x(SLIB_UINT64(0x00ccaa009e), SLIB_UINT64(0x01751997d0));
+		const __m128i k5k0 = _mm_set_epi64x(0, SLIB_UINT64(0x0163cd6124));
+		const __m128i poly = _mm_set_epi64x(SLIB_UINT64(0x01f7011641), SLIB_UINT64(0x01db710641));
+		
+		__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+		
+		x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)buf), _mm_cvtsi32_si128((int)crc));
+		x2 = _mm_loadu_si128((const __m128i*)(buf + 16));
+		x3 = _mm_loadu_si128((const __m128i*)(buf + 32));
+		x4 = _mm_loadu_si128((const __m128i*)(buf + 48));
+		buf += 64;
+		size -= 64;
+		
+		// fold 4 x 128 bits in parallel
+		x0 = k1k2;
+		while (size >= 64) {
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+			x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+			x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)buf));
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(buf + 16)));
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(buf + 32)));
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(buf + 48)));
+			buf += 64;
+			size -= 64;
+		}
+		
+		// fold into 128 bits
+		x0 = k3k4;
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+		
+		// fold the remaining 128 bits blocks
+		while (size >= 16) {
+			x2 = _mm_loadu_si128((const __m128i*)buf);
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+			buf += 16;
+			size -= 16;
+		}
+		
+		// fold 128 bits to 64 bits
+		x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+		x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+		x1 = _mm_srli_si128(x1, 8);
+		x1 = _mm_xor_si128(x1, x2);
+		x0 = k5k0;
+		x2 = _mm_srli_si128(x1, 4);
+		x1 = _mm_and_si128(x1, x3);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+		
+		// Barrett reduction to 32 bits
+		x0 = poly;
+		x2 = _mm_and_si128(x1, x3);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+		x2 = _mm_and_si128(x2, x3);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+		
+		return (sl_uint32)(_mm_extract_epi32(x1, 1));
+	}
+
+	// `size` should be a multiple of 32
+	PRIV_ZLIB_ADLER32_SSSE3 static sl_uint32 _priv_Zlib_adler32_SSSE3(sl_uint32 adler, const sl_uint8* buf, sl_size size)
+	{
+		const sl_uint32 BASE = 65521;
+		// largest number of 32 bytes blocks before s2 overflows (NMAX = 5552)
+		const sl_uint32 NBLOCKS_MAX = 5552 / 32;
+		
+		sl_uint32 s1 = adler & 0xffff;
+		sl_uint32 s2 = adler >> 16;
+		
+		const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+		const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ones = _mm_set1_epi16(1);
+		
+		sl_size nBlocks = size >> 5;
+		while (nBlocks) {
+			sl_uint32 n = NBLOCKS_MAX;
+			if (n > nBlocks) {
+				n = (sl_uint32)nBlocks;
+			}
+			nBlocks -= n;
+			
+			__m128i v_ps = _mm_set_epi32(0, 0, 0, (int)(s1 * n));
+			__m128i v_s2 = _mm_set_epi32(0, 0, 0, (int)s2);
+			__m128i v_s1 = _mm_setzero_si128();
+			do {
+				__m128i bytes1 = _mm_loadu_si128((const __m128i*)buf);
+				__m128i bytes2 = _mm_loadu_si128((const __m128i*)(buf + 16));
+				v_ps = _mm_add_epi32(v_ps, v_s1);
+				v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+				v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+				v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+				v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+				buf += 32;
+			} while (--n);
+			v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+			
+			v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+			s1 += (sl_uint32)(_mm_cvtsi128_si32(v_s1));
+			v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+			v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+			s2 = (sl_uint32)(_mm_cvtsi128_si32(v_s2));
+			
+			s1 %= BASE;
+			s2 %= BASE;
+		}
+		return s1 | (s2 << 16);
+	}
+#endif
+
+#if defined(PRIV_ZLIB_CRC32_ARMV8)
+	static sl_uint32 _priv_Zlib_crc32_ARMv8(sl_uint32 crc, const sl_uint8* buf, sl_size size)
+	{
+		crc = ~crc;
+		while (size && (((sl_size)buf) & 7)) {
+			crc = __crc32b(crc, *buf);
+			buf++;
+			size--;
+		}
+		while (size >= 8) {
+			crc = __crc32d(crc, *((const sl_uint64*)buf));
+			buf += 8;
+			size -= 8;
+		}
+		while (size) {
+			crc = __crc32b(crc, *buf);
+			buf++;
+			size--;
+		}
+		return ~crc;
+	}
+#endif
+
 	sl_uint32 Zlib::adler32(sl_uint32 adler, const void* _data, sl_size size)
 	{
 		const char* data = (const char*)_data;
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (size >= PRIV_ZLIB_SIMD_MIN_LENGTH && Cpu::isSSSE3Supported()) {
+			sl_size n = size & ~((sl_size)31);
+			adler = _priv_Zlib_adler32_SSSE3(adler, (const sl_uint8*)data, n);
+			data += n;
+			size -= n;
+		}
+#endif
 		while (size > 0) {
 			sl_uint32 n = 0x10000000;
 			if (size < n) {
@@ -349,6 +585,16 @@ namespace slib
 	sl_uint32 Zlib::crc32(sl_uint32 crc, const void* _data, sl_size size)
 	{
 		const char* data = (const char*)_data;
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (size >= PRIV_ZLIB_SIMD_MIN_LENGTH && Cpu::isPCLMULSupported() && Cpu::isSSE41Supported()) {
+			sl_size n = size & ~((sl_size)15);
+			crc = ~(_priv_Zlib_crc32_CLMUL(~crc, (const sl_uint8*)data, n));
+			data += n;
+			size -= n;
+		}
+#elif defined(PRIV_ZLIB_CRC32_ARMV8)
+		return _priv_Zlib_crc32_ARMv8(crc, (const sl_uint8*)data, size);
+#endif
 		while (size > 0) {
 			sl_uint32 n = 0x10000000;
 			if (size < n) {
@@ -410,6 +656,239 @@ namespace slib
 		return compressGzip(param, data, size, level);
 	}
 
+
+/*****************************************
+		Parallel Compression
+******************************************/
+
+	SLIB_SAFE_STATIC_GETTER(Ref<ThreadPool>, _priv_Zlib_getDefaultThreadPool, ThreadPool::createWorkStealing())
+
+	class _priv_ZlibParallelContext : public Referable
+	{
+	public:
+		const sl_uint8* data;
+		sl_size size;
+		sl_size nBlocks;
+		sl_int32 level;
+		sl_bool flagGzip;
+		
+		Memory* outputs;
+		sl_uint32* checksums;
+		sl_bool flagError;
+		
+		sl_reg indexNext;
+		sl_reg nRemainingBlocks;
+		Ref<Event> eventDone;
+		
+	public:
+		// returns `sl_false` when there is no block left
+		sl_bool compressNextBlock()
+		{
+			sl_reg index = Base::interlockedIncrement(&indexNext) - 1;
+			if (index >= (sl_reg)nBlocks) {
+				return sl_false;
+			}
+			sl_size offset = (sl_size)index * PRIV_ZLIB_PARALLEL_BLOCK_SIZE;
+			const sl_uint8* block = data + offset;
+			sl_uint32 sizeBlock = (sl_uint32)(SLIB_MIN(size - offset, (sl_size)PRIV_ZLIB_PARALLEL_BLOCK_SIZE));
+			sl_bool flagLast = (sl_size)index == nBlocks - 1;
+			
+			if (flagGzip) {
+				checksums[index] = Zlib::crc32(block, sizeBlock);
+			} else {
+				checksums[index] = Zlib::adler32(block, sizeBlock);
+			}
+			
+			z_stream stream;
+			Base::zeroMemory(&stream, sizeof(stream));
+			if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+				sl_bool flagSuccess = sl_true;
+				if (offset) {
+					sl_uint32 sizeDictionary = (sl_uint32)(SLIB_MIN(offset, (sl_size)PRIV_ZLIB_PARALLEL_DICTIONARY_SIZE));
+					if (deflateSetDictionary(&stream, block - sizeDictionary, sizeDictionary) != Z_OK) {
+						flagSuccess = sl_false;
+					}
+				}
+				if (flagSuccess) {
+					// an empty stored block is appended by the sync-flush
+					sl_uint32 sizeOutput = (sl_uint32)(deflateBound(&stream, sizeBlock)) + 16;
+					Memory output = Memory::create(sizeOutput);
+					if (output.isNotNull()) {
+						stream.next_in = (Bytef*)block;
+						stream.avail_in = sizeBlock;
+						stream.next_out = (Bytef*)(output.getData());
+						stream.avail_out = sizeOutput;
+						int iRet = deflate(&stream, flagLast ? Z_FINISH : Z_SYNC_FLUSH);
+						if ((iRet == Z_STREAM_END || (iRet == Z_OK && !flagLast)) && !(stream.avail_in)) {
+							outputs[index] = output.sub(0, sizeOutput - stream.avail_out);
+						} else {
+							flagSuccess = sl_false;
+						}
+					} else {
+						flagSuccess = sl_false;
+					}
+				}
+				deflateEnd(&stream);
+				if (!flagSuccess) {
+					flagError = sl_true;
+				}
+			} else {
+				flagError = sl_true;
+			}
+			
+			if (Base::interlockedDecrement(&nRemainingBlocks) == 0) {
+				eventDone->set();
+			}
+			return sl_true;
+		}
+		
+	};
+
+	static Memory _priv_Zlib_compressParallel(const GzipParam* paramGzip, const void* data, sl_size size, sl_int32 level, const Ref<ThreadPool>& _pool)
+	{
+		sl_size nBlocks = (size + PRIV_ZLIB_PARALLEL_BLOCK_SIZE - 1) / PRIV_ZLIB_PARALLEL_BLOCK_SIZE;
+		Ref<ThreadPool> pool = _pool;
+		if (pool.isNull()) {
+			Ref<ThreadPool>* p = _priv_Zlib_getDefaultThreadPool();
+			if (p) {
+				pool = *p;
+			}
+		}
+		if (nBlocks < 2 || pool.isNull()) {
+			if (paramGzip) {
+				return Zlib::compressGzip(*paramGzip, data, size, level);
+			} else {
+				return Zlib::compress(data, size, level);
+			}
+		}
+		if (level < 0) {
+			level = 6;
+		}
+		
+		Array<Memory> outputs = Array<Memory>::create(nBlocks);
+		Array<sl_uint32> checksums = Array<sl_uint32>::create(nBlocks);
+		Ref<Event> eventDone = Event::create(sl_false);
+		if (outputs.isNull() || checksums.isNull() || eventDone.isNull()) {
+			return sl_null;
+		}
+		Ref<_priv_ZlibParallelContext> context = new _priv_ZlibParallelContext;
+		if (context.isNull()) {
+			return sl_null;
+		}
+		context->data = (const sl_uint8*)data;
+		context->size = size;
+		context->nBlocks = nBlocks;
+		context->level = level;
+		context->flagGzip = paramGzip != sl_null;
+		context->outputs = outputs.getData();
+		context->checksums = checksums.getData();
+		context->flagError = sl_false;
+		context->indexNext = 0;
+		context->nRemainingBlocks = (sl_reg)nBlocks;
+		context->eventDone = eventDone;
+		
+		sl_size nTasks = SLIB_MIN(nBlocks - 1, (sl_size)(pool->getThreadsCount()));
+		for (sl_size i = 0; i < nTasks; i++) {
+			pool->addTask([context]() {
+				while (context->compressNextBlock()) {
+				}
+			});
+		}
+		// the caller also takes blocks, so that it never waits for a queued task
+		while (context->compressNextBlock()) {
+		}
+		while (context->nRemainingBlocks > 0) {
+			eventDone->wait();
+		}
+		if (context->flagError) {
+			return sl_null;
+		}
+		
+		MemoryBuffer buffer;
+		sl_uint32 checksum;
+		if (paramGzip) {
+			// RFC 1952
+			sl_uint8 header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 255 };
+			if (level == 9) {
+				header[8] = 2;
+			} else if (level == 1) {
+				header[8] = 4;
+			}
+			String fileName = paramGzip->fileName;
+			String comment = paramGzip->comment;
+			if (fileName.isNotEmpty()) {
+				header[3] |= 0x08;
+			}
+			if (comment.isNotEmpty()) {
+				header[3] |= 0x10;
+			}
+			buffer.add(Memory::create(header, 10));
+			if (fileName.isNotEmpty()) {
+				buffer.add(Memory::create(fileName.getData(), fileName.getLength() + 1));
+			}
+			if (comment.isNotEmpty()) {
+				buffer.add(Memory::create(comment.getData(), comment.getLength() + 1));
+			}
+			checksum = 0;
+		} else {
+			// RFC 1950
+			sl_uint32 levelFlags;
+			if (level < 2) {
+				levelFlags = 0;
+			} else if (level < 6) {
+				levelFlags = 1;
+			} else if (level == 6) {
+				levelFlags = 2;
+			} else {
+				levelFlags = 3;
+			}
+			sl_uint32 h = (0x78 << 8) | (levelFlags << 6);
+			h += 31 - (h % 31);
+			sl_uint8 header[2] = { (sl_uint8)(h >> 8), (sl_uint8)h };
+			buffer.add(Memory::create(header, 2));
+			checksum = 1;
+		}
+		
+		sl_size sizeLast = size - (nBlocks - 1) * PRIV_ZLIB_PARALLEL_BLOCK_SIZE;
+		for (sl_size i = 0; i < nBlocks; i++) {
+			buffer.add(outputs[i]);
+			sl_size sizeBlock = i == nBlocks - 1 ? sizeLast : PRIV_ZLIB_PARALLEL_BLOCK_SIZE;
+			if (paramGzip) {
+				checksum = (sl_uint32)(crc32_combine(checksum, checksums[i], (z_off_t)sizeBlock));
+			} else {
+				checksum = (sl_uint32)(adler32_combine(checksum, checksums[i], (z_off_t)sizeBlock));
+			}
+		}
+		
+		if (paramGzip) {
+			sl_uint8 trailer[8];
+			MIO::writeUint32LE(trailer, checksum);
+			MIO::writeUint32LE(trailer + 4, (sl_uint32)size);
+			buffer.add(Memory::create(trailer, 8));
+		} else {
+			sl_uint8 trailer[4];
+			MIO::writeUint32BE(trailer, checksum);
+			buffer.add(Memory::create(trailer, 4));
+		}
+		return buffer.merge();
+	}
+
+	Memory Zlib::compressParallel(const void* data, sl_size size, sl_int32 level, const Ref<ThreadPool>& pool)
+	{
+		return _priv_Zlib_compressParallel(sl_null, data, size, level, pool);
+	}
+
+	Memory Zlib::compressGzipParallel(const GzipParam& param, const void* data, sl_size size, sl_int32 level, const Ref<ThreadPool>& pool)
+	{
+		return _priv_Zlib_compressParallel(&param, data, size, level, pool);
+	}
+
+	Memory Zlib::compressGzipParallel(const void* data, sl_size size, sl_int32 level, const Ref<ThreadPool>& pool)
+	{
+		GzipParam param;
+		return _priv_Zlib_compressParallel(&param, data, size, level, pool);
+	}
+
 	Memory Zlib::decompress(const void* data, sl_size size)
 	{
 		ZlibDecompress zlib;
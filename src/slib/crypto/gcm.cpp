@@ -23,10 +23,105 @@
 #include "slib/crypto/gcm.h"
 
 #include "slib/crypto/aes.h"
+#include "slib/core/cpu.h"
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+#	include <wmmintrin.h>
+#	include <tmmintrin.h>
+#	define PRIV_GCM_CLMUL SLIB_TARGET_FEATURES("pclmul,ssse3")
+#endif
+
+#define PRIV_GCM_BATCH_BLOCKS 8
 
 namespace slib
 {
 
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+/*
+	GHASH multiplication by PCLMULQDQ
+
+	Intel Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode (Algorithm 5)
+	Operands are byte-reversed, so that the bit-reflected polynomial can be reduced by shifts.
+*/
+	PRIV_GCM_CLMUL static __m128i _priv_GCM_CLMUL_reverse(__m128i a)
+	{
+		return _mm_shuffle_epi8(a, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+	}
+
+	PRIV_GCM_CLMUL static __m128i _priv_GCM_CLMUL_multiply(__m128i a, __m128i b)
+	{
+		__m128i t2, t3, t4, t5, t6, t7, t8, t9;
+		t3 = _mm_clmulepi64_si128(a, b, 0x00);
+		t4 = _mm_clmulepi64_si128(a, b, 0x10);
+		t5 = _mm_clmulepi64_si128(a, b, 0x01);
+		t6 = _mm_clmulepi64_si128(a, b, 0x11);
+		t4 = _mm_xor_si128(t4, t5);
+		t5 = _mm_slli_si128(t4, 8);
+		t4 = _mm_srli_si128(t4, 8);
+		t3 = _mm_xor_si128(t3, t5);
+		t6 = _mm_xor_si128(t6, t4);
+		// shift the 256-bit product left by 1 bit
+		t7 = _mm_srli_epi32(t3, 31);
+		t8 = _mm_srli_epi32(t6, 31);
+		t3 = _mm_slli_epi32(t3, 1);
+		t6 = _mm_slli_epi32(t6, 1);
+		t9 = _mm_srli_si128(t7, 12);
+		t8 = _mm_slli_si128(t8, 4);
+		t7 = _mm_slli_si128(t7, 4);
+		t3 = _mm_or_si128(t3, t7);
+		t6 = _mm_or_si128(t6, t8);
+		t6 = _mm_or_si128(t6, t9);
+		// reduction modulo x^128 + x^7 + x^2 + x + 1
+		t7 = _mm_slli_epi32(t3, 31);
+		t8 = _mm_slli_epi32(t3, 30);
+		t9 = _mm_slli_epi32(t3, 25);
+		t7 = _mm_xor_si128(t7, t8);
+		t7 = _mm_xor_si128(t7, t9);
+		t8 = _mm_srli_si128(t7, 4);
+		t7 = _mm_slli_si128(t7, 12);
+		t3 = _mm_xor_si128(t3, t7);
+		t2 = _mm_srli_epi32(t3, 1);
+		t4 = _mm_srli_epi32(t3, 2);
+		t5 = _mm_srli_epi32(t3, 7);
+		t2 = _mm_xor_si128(t2, t4);
+		t2 = _mm_xor_si128(t2, t5);
+		t2 = _mm_xor_si128(t2, t8);
+		t3 = _mm_xor_si128(t3, t2);
+		return _mm_xor_si128(t6, t3);
+	}
+
+	PRIV_GCM_CLMUL static void _priv_GCM_CLMUL_prepare(const void* H, void* H_CLMUL)
+	{
+		_mm_storeu_si128((__m128i*)H_CLMUL, _priv_GCM_CLMUL_reverse(_mm_loadu_si128((const __m128i*)H)));
+	}
+
+	PRIV_GCM_CLMUL static void _priv_GCM_CLMUL_multiplyH(const void* H_CLMUL, const void* X, void* O)
+	{
+		__m128i h = _mm_loadu_si128((const __m128i*)H_CLMUL);
+		__m128i x = _priv_GCM_CLMUL_reverse(_mm_loadu_si128((const __m128i*)X));
+		_mm_storeu_si128((__m128i*)O, _priv_GCM_CLMUL_reverse(_priv_GCM_CLMUL_multiply(x, h)));
+	}
+
+	// processes only the complete blocks
+	PRIV_GCM_CLMUL static void _priv_GCM_CLMUL_multiplyData(const void* H_CLMUL, void* X, const void* _D, sl_size nBlocks)
+	{
+		const __m128i* D = (const __m128i*)_D;
+		__m128i h = _mm_loadu_si128((const __m128i*)H_CLMUL);
+		__m128i x = _priv_GCM_CLMUL_reverse(_mm_loadu_si128((const __m128i*)X));
+		for (sl_size i = 0; i < nBlocks; i++) {
+			x = _mm_xor_si128(x, _priv_GCM_CLMUL_reverse(_mm_loadu_si128(D)));
+			x = _priv_GCM_CLMUL_multiply(x, h);
+			D++;
+		}
+		_mm_storeu_si128((__m128i*)X, _priv_GCM_CLMUL_reverse(x));
+	}
+#endif
+
+	GCM_Table::GCM_Table()
+	{
+		flagCLMUL = sl_false;
+	}
+
 	void GCM_Table::generateTable(const void* inH)
 	{
 		sl_uint32 i, j;
@@ -62,6 +157,13 @@ namespace slib
 			}
 			i <<= 1;
 		}
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		flagCLMUL = Cpu::isPCLMULSupported() && Cpu::isSSSE3Supported();
+		if (flagCLMUL) {
+			_priv_GCM_CLMUL_prepare(inH, H_CLMUL);
+		}
+#endif
 	}
 
 	static const sl_uint64 PRIV_GCM_R[16] =
@@ -86,6 +188,12 @@ namespace slib
 
 	void GCM_Table::multiplyH(const void* inX, void* inO) const
 	{
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (flagCLMUL) {
+			_priv_GCM_CLMUL_multiplyH(H_CLMUL, inX, inO);
+			return;
+		}
+#endif
 		const sl_uint8* X = (const sl_uint8*)inX;
 		sl_uint8* O = (sl_uint8*)inO;
 		Uint128 Z;
@@ -132,6 +240,13 @@ namespace slib
 		sl_size i, k, n;
 
 		n = lenD >> 4;
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (flagCLMUL) {
+			_priv_GCM_CLMUL_multiplyData(H_CLMUL, X, D, n);
+			D += (n << 4);
+			n = 0;
+		}
+#endif
 		for (i = 0; i < n; i++) {
 			for (k = 0; k < 16; k++) {
 				X[k] ^= *D;
@@ -329,6 +444,27 @@ namespace slib
 		const sl_uint8* P = (const sl_uint8*)src;
 		sl_uint8* C = (sl_uint8*)dst;
 		
+		// complete blocks: encrypt the counters in a batch, and hash the cipher text at once
+		sl_uint8 GCTRs[16 * PRIV_GCM_BATCH_BLOCKS];
+		while (len >= 16) {
+			n = len >> 4;
+			if (n > PRIV_GCM_BATCH_BLOCKS) {
+				n = PRIV_GCM_BATCH_BLOCKS;
+			}
+			n <<= 4;
+			for (k = 0; k < n; k += 16) {
+				increaseCIV();
+				Base::copyMemory(GCTRs + k, CIV, 16);
+			}
+			m_cipher->encryptBlocks(GCTRs, GCTRs, n);
+			for (k = 0; k < n; k++) {
+				C[k] = P[k] ^ GCTRs[k];
+			}
+			multiplyData(GHASH_X, C, n);
+			P += n;
+			C += n;
+			len -= n;
+		}
 		for (i = 0; i < len; i += 16) {
 			increaseCIV();
 			m_cipher->encryptBlock(CIV, GCTR);
@@ -372,6 +508,27 @@ namespace slib
 		const sl_uint8* C = (const sl_uint8*)src;
 		sl_uint8* P = (sl_uint8*)dst;
 		
+		// complete blocks: hash the cipher text before it can be overwritten (in-place decryption)
+		sl_uint8 GCTRs[16 * PRIV_GCM_BATCH_BLOCKS];
+		while (len >= 16) {
+			n = len >> 4;
+			if (n > PRIV_GCM_BATCH_BLOCKS) {
+				n = PRIV_GCM_BATCH_BLOCKS;
+			}
+			n <<= 4;
+			for (k = 0; k < n; k += 16) {
+				increaseCIV();
+				Base::copyMemory(GCTRs + k, CIV, 16);
+			}
+			m_cipher->encryptBlocks(GCTRs, GCTRs, n);
+			multiplyData(GHASH_X, C, n);
+			for (k = 0; k < n; k++) {
+				P[k] = C[k] ^ GCTRs[k];
+			}
+			C += n;
+			P += n;
+			len -= n;
+		}
 		for (i = 0; i < len; i += 16) {
 			increaseCIV();
 			m_cipher->encryptBlock(CIV, GCTR);
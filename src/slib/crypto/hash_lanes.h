@@ -0,0 +1,175 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+#ifndef CHECKHEADER_SLIB_CRYPTO_HASH_LANES
+#define CHECKHEADER_SLIB_CRYPTO_HASH_LANES
+
+#include "slib/core/base.h"
+#include "slib/core/mio.h"
+
+/*
+	Multi-buffer hashing for the Merkle-Damgard hash functions with 64 bytes block and big-endian length (SHA1, SHA2-256)
+
+	Independent messages are fed into 8 lanes of a SIMD compression function.
+	When a lane finishes its message, the next message is loaded into the lane.
+*/
+
+#define PRIV_HASH_LANES_COUNT 8
+// Remaining messages are hashed one by one when the active lanes are fewer than this
+#define PRIV_HASH_LANES_MIN_ACTIVE 3
+
+namespace slib
+{
+
+	typedef void (*_priv_HashLanes_Compress8)(sl_uint32 (*state)[PRIV_HASH_LANES_COUNT], const sl_uint8* const* blocks);
+
+	typedef void (*_priv_HashLanes_Compress)(sl_uint32* h, const sl_uint8* blocks, sl_size nBlocks);
+
+	class _priv_HashLane
+	{
+	public:
+		sl_size index;
+		const sl_uint8* data;
+		sl_size nBlocks;
+		sl_uint8 tail[128];
+		sl_uint32 nTailBlocks;
+		sl_uint32 posTail;
+
+	public:
+		void load(sl_size _index, const void* input, sl_size size)
+		{
+			index = _index;
+			data = (const sl_uint8*)input;
+			nBlocks = size >> 6;
+			sl_uint32 nRemain = (sl_uint32)(size & 63);
+			if (nRemain) {
+				Base::copyMemory(tail, data + (nBlocks << 6), nRemain);
+			}
+			tail[nRemain] = 0x80;
+			nTailBlocks = nRemain < 56 ? 1 : 2;
+			sl_uint32 sizeTail = nTailBlocks << 6;
+			Base::zeroMemory(tail + nRemain + 1, sizeTail - nRemain - 9);
+			MIO::writeUint64BE(tail + sizeTail - 8, ((sl_uint64)size) << 3);
+			posTail = 0;
+		}
+
+		const sl_uint8* getBlock() const
+		{
+			if (nBlocks) {
+				return data;
+			} else {
+				return tail + (posTail << 6);
+			}
+		}
+
+		// returns `sl_true` when the message is finished
+		sl_bool next()
+		{
+			if (nBlocks) {
+				data += 64;
+				nBlocks--;
+				return sl_false;
+			} else {
+				posTail++;
+				return posTail >= nTailBlocks;
+			}
+		}
+
+	};
+
+	template <sl_uint32 STATE_WORDS, sl_uint32 HASH_SIZE>
+	static void _priv_HashLanes_hashMany(const sl_uint32* IV, _priv_HashLanes_Compress8 compress8, _priv_HashLanes_Compress compress, const void* const* inputs, const sl_size* sizes, sl_size n, void* _outputs)
+	{
+		sl_uint8* outputs = (sl_uint8*)_outputs;
+		_priv_HashLane lanes[PRIV_HASH_LANES_COUNT];
+		sl_bool flagActive[PRIV_HASH_LANES_COUNT];
+		sl_uint32 state[STATE_WORDS][PRIV_HASH_LANES_COUNT];
+		const sl_uint8* blocks[PRIV_HASH_LANES_COUNT];
+		sl_uint8 blockIdle[64] = {0};
+		sl_uint32 i, k;
+		
+		sl_size iNext = 0;
+		sl_uint32 nActive = 0;
+		for (i = 0; i < PRIV_HASH_LANES_COUNT; i++) {
+			if (iNext < n) {
+				lanes[i].load(iNext, inputs[iNext], sizes[iNext]);
+				iNext++;
+				for (k = 0; k < STATE_WORDS; k++) {
+					state[k][i] = IV[k];
+				}
+				flagActive[i] = sl_true;
+				nActive++;
+			} else {
+				flagActive[i] = sl_false;
+			}
+		}
+		
+		while (nActive) {
+			if (iNext >= n && nActive < PRIV_HASH_LANES_MIN_ACTIVE) {
+				break;
+			}
+			for (i = 0; i < PRIV_HASH_LANES_COUNT; i++) {
+				blocks[i] = flagActive[i] ? lanes[i].getBlock() : blockIdle;
+			}
+			compress8(state, blocks);
+			for (i = 0; i < PRIV_HASH_LANES_COUNT; i++) {
+				if (flagActive[i] && lanes[i].next()) {
+					sl_uint8* output = outputs + lanes[i].index * HASH_SIZE;
+					for (k = 0; k < (HASH_SIZE >> 2); k++) {
+						MIO::writeUint32BE(output + (k << 2), state[k][i]);
+					}
+					if (iNext < n) {
+						lanes[i].load(iNext, inputs[iNext], sizes[iNext]);
+						iNext++;
+						for (k = 0; k < STATE_WORDS; k++) {
+							state[k][i] = IV[k];
+						}
+					} else {
+						flagActive[i] = sl_false;
+						nActive--;
+					}
+				}
+			}
+		}
+		
+		// finish the remaining lanes without SIMD
+		for (i = 0; i < PRIV_HASH_LANES_COUNT; i++) {
+			if (flagActive[i]) {
+				_priv_HashLane& lane = lanes[i];
+				sl_uint32 h[STATE_WORDS];
+				for (k = 0; k < STATE_WORDS; k++) {
+					h[k] = state[k][i];
+				}
+				if (lane.nBlocks) {
+					compress(h, lane.data, lane.nBlocks);
+				}
+				compress(h, lane.tail + (lane.posTail << 6), lane.nTailBlocks - lane.posTail);
+				sl_uint8* output = outputs + lane.index * HASH_SIZE;
+				for (k = 0; k < (HASH_SIZE >> 2); k++) {
+					MIO::writeUint32BE(output + (k << 2), h[k]);
+				}
+			}
+		}
+	}
+
+}
+
+#endif
@@ -24,10 +24,215 @@
 
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+
+#include "hash_lanes.h"
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+#	include <immintrin.h>
+#	define PRIV_SHA1_NI SLIB_TARGET_FEATURES("sha,sse4.1")
+#	define PRIV_SHA1_AVX2 SLIB_TARGET_FEATURES("avx2")
+#endif
 
 namespace slib
 {
 
+	static void _priv_SHA1_updateSection(sl_uint32* h, const sl_uint8* input)
+	{
+		static const sl_uint32 K[4] = {
+			0x5A827999ul, 0x6ED9EBA1ul, 0x8F1BBCDCul, 0xCA62C1D6ul
+		};
+
+		sl_uint32 W[80];
+		sl_uint32 v[5];
+		sl_uint32 i;
+		for (i = 0; i < 16; i++) {
+			W[i] = MIO::readUint32BE(input + (i << 2));
+		}
+		for (i = 16; i < 80; i++) {
+			W[i] = Math::rotateLeft32(W[i - 3] ^ W[i - 8] ^ W[i - 14] ^ W[i - 16], 1);
+		}
+		for (i = 0; i < 5; i++) {
+			v[i] = h[i];
+		}
+		sl_uint32 f[4];
+		for (i = 0; i < 80; i++) {
+			sl_uint32 j = i / 20;
+			f[0] = v[3] ^ (v[1] & (v[2] ^ v[3]));
+			f[1] = v[1] ^ v[2] ^ v[3];
+			f[2] = (v[1] & v[2]) | (v[3] & (v[1] | v[2]));
+			f[3] = f[1];
+			sl_uint32 t = Math::rotateLeft32(v[0], 5) + f[j] + v[4] + K[j] + W[i];
+			v[4] = v[3];
+			v[3] = v[2];
+			v[2] = Math::rotateLeft32(v[1], 30);
+			v[1] = v[0];
+			v[0] = t;
+		}
+		for (i = 0; i < 5; i++) {
+			h[i] += v[i];
+		}
+	}
+
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+	// SHA extensions (SHA-NI)
+	PRIV_SHA1_NI static void _priv_SHA1_NI_updateSections(sl_uint32* h, const sl_uint8* input, sl_size nSections)
+	{
+		const __m128i MASK = _mm_set_epi64x(SLIB_UINT64(0x0001020304050607), SLIB_UINT64(0x08090a0b0c0d0e0f));
+		__m128i ABCD = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0x1B);
+		__m128i E0 = _mm_set_epi32((int)(h[4]), 0, 0, 0);
+		__m128i E1, ABCD_SAVE, E0_SAVE;
+		__m128i MSG0, MSG1, MSG2, MSG3;
+		
+#define PRIV_SHA1_NI_ROUNDS(F, E_IN, E_OUT, MSG) \
+		E_IN = _mm_sha1nexte_epu32(E_IN, MSG); \
+		E_OUT = ABCD; \
+		ABCD = _mm_sha1rnds4_epu32(ABCD, E_IN, F);
+		
+		for (sl_size iSection = 0; iSection < nSections; iSection++) {
+			ABCD_SAVE = ABCD;
+			E0_SAVE = E0;
+			
+			// Rounds 0-3
+			MSG0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)input), MASK);
+			E0 = _mm_add_epi32(E0, MSG0);
+			E1 = ABCD;
+			ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+			// Rounds 4-7
+			MSG1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 16)), MASK);
+			PRIV_SHA1_NI_ROUNDS(0, E1, E0, MSG1)
+			MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+			// Rounds 8-11
+			MSG2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 32)), MASK);
+			PRIV_SHA1_NI_ROUNDS(0, E0, E1, MSG2)
+			MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+			MSG0 = _mm_xor_si128(MSG0, MSG2);
+			// Rounds 12-15
+			MSG3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 48)), MASK);
+			MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+			PRIV_SHA1_NI_ROUNDS(0, E1, E0, MSG3)
+			MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+			MSG1 = _mm_xor_si128(MSG1, MSG3);
+			
+			// Rounds 16-67: message schedule rotates over MSG0..MSG3
+#define PRIV_SHA1_NI_SCHEDULE(F, E_IN, E_OUT, CUR, NEXT, PREV, PREV2) \
+			NEXT = _mm_sha1msg2_epu32(NEXT, CUR); \
+			PRIV_SHA1_NI_ROUNDS(F, E_IN, E_OUT, CUR) \
+			PREV = _mm_sha1msg1_epu32(PREV, CUR); \
+			PREV2 = _mm_xor_si128(PREV2, CUR);
+			
+			PRIV_SHA1_NI_SCHEDULE(0, E0, E1, MSG0, MSG1, MSG3, MSG2) // 16-19
+			PRIV_SHA1_NI_SCHEDULE(1, E1, E0, MSG1, MSG2, MSG0, MSG3) // 20-23
+			PRIV_SHA1_NI_SCHEDULE(1, E0, E1, MSG2, MSG3, MSG1, MSG0) // 24-27
+			PRIV_SHA1_NI_SCHEDULE(1, E1, E0, MSG3, MSG0, MSG2, MSG1) // 28-31
+			PRIV_SHA1_NI_SCHEDULE(1, E0, E1, MSG0, MSG1, MSG3, MSG2) // 32-35
+			PRIV_SHA1_NI_SCHEDULE(1, E1, E0, MSG1, MSG2, MSG0, MSG3) // 36-39
+			PRIV_SHA1_NI_SCHEDULE(2, E0, E1, MSG2, MSG3, MSG1, MSG0) // 40-43
+			PRIV_SHA1_NI_SCHEDULE(2, E1, E0, MSG3, MSG0, MSG2, MSG1) // 44-47
+			PRIV_SHA1_NI_SCHEDULE(2, E0, E1, MSG0, MSG1, MSG3, MSG2) // 48-51
+			PRIV_SHA1_NI_SCHEDULE(2, E1, E0, MSG1, MSG2, MSG0, MSG3) // 52-55
+			PRIV_SHA1_NI_SCHEDULE(2, E0, E1, MSG2, MSG3, MSG1, MSG0) // 56-59
+			PRIV_SHA1_NI_SCHEDULE(3, E1, E0, MSG3, MSG0, MSG2, MSG1) // 60-63
+			PRIV_SHA1_NI_SCHEDULE(3, E0, E1, MSG0, MSG1, MSG3, MSG2) // 64-67
+			
+			// Rounds 68-71
+			MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+			PRIV_SHA1_NI_ROUNDS(3, E1, E0, MSG1)
+			MSG3 = _mm_xor_si128(MSG3, MSG1);
+			// Rounds 72-75
+			MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+			PRIV_SHA1_NI_ROUNDS(3, E0, E1, MSG2)
+			// Rounds 76-79
+			PRIV_SHA1_NI_ROUNDS(3, E1, E0, MSG3)
+			
+			E0 = _mm_sha1nexte_epu32(E0, E0_SAVE);
+			ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+			
+			input += 64;
+		}
+		
+#undef PRIV_SHA1_NI_SCHEDULE
+#undef PRIV_SHA1_NI_ROUNDS
+		
+		_mm_storeu_si128((__m128i*)h, _mm_shuffle_epi32(ABCD, 0x1B));
+		h[4] = (sl_uint32)(_mm_extract_epi32(E0, 3));
+	}
+
+	// 8 independent messages in the lanes of AVX2 registers
+	PRIV_SHA1_AVX2 static void _priv_SHA1_AVX2_updateSection8(sl_uint32 (*state)[PRIV_HASH_LANES_COUNT], const sl_uint8* const* blocks)
+	{
+#define PRIV_SHA1_AVX2_ROTL(X, N) _mm256_or_si256(_mm256_slli_epi32(X, N), _mm256_srli_epi32(X, 32 - N))
+		__m256i W[16];
+		__m256i a, b, c, d, e, f, t;
+		sl_uint32 i;
+		for (i = 0; i < 16; i++) {
+			sl_uint32 k = i << 2;
+			W[i] = _mm256_set_epi32(
+				(int)(MIO::readUint32BE(blocks[7] + k)), (int)(MIO::readUint32BE(blocks[6] + k)),
+				(int)(MIO::readUint32BE(blocks[5] + k)), (int)(MIO::readUint32BE(blocks[4] + k)),
+				(int)(MIO::readUint32BE(blocks[3] + k)), (int)(MIO::readUint32BE(blocks[2] + k)),
+				(int)(MIO::readUint32BE(blocks[1] + k)), (int)(MIO::readUint32BE(blocks[0] + k)));
+		}
+		a = _mm256_loadu_si256((const __m256i*)(state[0]));
+		b = _mm256_loadu_si256((const __m256i*)(state[1]));
+		c = _mm256_loadu_si256((const __m256i*)(state[2]));
+		d = _mm256_loadu_si256((const __m256i*)(state[3]));
+		e = _mm256_loadu_si256((const __m256i*)(state[4]));
+		__m256i a0 = a, b0 = b, c0 = c, d0 = d, e0 = e;
+		for (i = 0; i < 80; i++) {
+			__m256i w;
+			if (i < 16) {
+				w = W[i];
+			} else {
+				w = _mm256_xor_si256(_mm256_xor_si256(W[(i - 3) & 15], W[(i - 8) & 15]), _mm256_xor_si256(W[(i - 14) & 15], W[i & 15]));
+				w = PRIV_SHA1_AVX2_ROTL(w, 1);
+				W[i & 15] = w;
+			}
+			sl_uint32 K;
+			if (i < 20) {
+				f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+				K = 0x5A827999ul;
+			} else if (i < 40) {
+				f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+				K = 0x6ED9EBA1ul;
+			} else if (i < 60) {
+				f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c)));
+				K = 0x8F1BBCDCul;
+			} else {
+				f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+				K = 0xCA62C1D6ul;
+			}
+			t = _mm256_add_epi32(_mm256_add_epi32(PRIV_SHA1_AVX2_ROTL(a, 5), f), _mm256_add_epi32(_mm256_add_epi32(e, w), _mm256_set1_epi32((int)K)));
+			e = d;
+			d = c;
+			c = PRIV_SHA1_AVX2_ROTL(b, 30);
+			b = a;
+			a = t;
+		}
+#undef PRIV_SHA1_AVX2_ROTL
+		_mm256_storeu_si256((__m256i*)(state[0]), _mm256_add_epi32(a, a0));
+		_mm256_storeu_si256((__m256i*)(state[1]), _mm256_add_epi32(b, b0));
+		_mm256_storeu_si256((__m256i*)(state[2]), _mm256_add_epi32(c, c0));
+		_mm256_storeu_si256((__m256i*)(state[3]), _mm256_add_epi32(d, d0));
+		_mm256_storeu_si256((__m256i*)(state[4]), _mm256_add_epi32(e, e0));
+	}
+#endif
+
+	static void _priv_SHA1_updateSections(sl_uint32* h, const sl_uint8* input, sl_size nSections)
+	{
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (Cpu::isSHASupported() && Cpu::isSSE41Supported()) {
+			_priv_SHA1_NI_updateSections(h, input, nSections);
+			return;
+		}
+#endif
+		for (sl_size i = 0; i < nSections; i++) {
+			_priv_SHA1_updateSection(h, input);
+			input += 64;
+		}
+	}
+
 	SHA1::SHA1()
 	{
 		rdata_len = 0;
@@ -66,7 +271,7 @@ namespace slib
 				return;
 			} else {
 				Base::copyMemory(rdata + rdata_len, input, n);
-				_updateSection(rdata);
+				_updateSections(rdata, 1);
 				rdata_len = 0;
 				sizeInput -= n;
 				input += n;
@@ -75,10 +280,12 @@ namespace slib
 				}
 			}
 		}
-		while (sizeInput >= 64) {
-			_updateSection(input);
-			sizeInput -= 64;
-			input += 64;
+		if (sizeInput >= 64) {
+			sl_size nSections = sizeInput >> 6;
+			_updateSections(input, nSections);
+			nSections <<= 6;
+			sizeInput -= nSections;
+			input += nSections;
 		}
 		if (sizeInput) {
 			Base::copyMemory(rdata, input, sizeInput);
@@ -95,13 +302,13 @@ namespace slib
 		if (rdata_len < 56) {
 			Base::zeroMemory(rdata + rdata_len + 1, 55 - rdata_len);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		} else {
 			Base::zeroMemory(rdata + rdata_len + 1, 63 - rdata_len);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 			Base::zeroMemory(rdata, 56);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		}
 		rdata_len = 0;
 
@@ -112,40 +319,25 @@ namespace slib
 		}
 	}
 
-	void SHA1::_updateSection(const sl_uint8* input)
+	void SHA1::_updateSections(const sl_uint8* input, sl_size nSections)
 	{
-		static sl_uint32 K[4] = {
-			0x5A827999ul, 0x6ED9EBA1ul, 0x8F1BBCDCul, 0xCA62C1D6ul
-		};
+		_priv_SHA1_updateSections(h, input, nSections);
+	}
 
-		sl_uint32 W[80];
-		sl_uint32 v[5];
-		sl_uint32 i;
-		for (i = 0; i < 16; i++) {
-			W[i] = MIO::readUint32BE(input + (i << 2));
-		}
-		for (i = 16; i < 80; i++) {
-			W[i] = Math::rotateLeft32(W[i - 3] ^ W[i - 8] ^ W[i - 14] ^ W[i - 16], 1);
-		}
-		for (i = 0; i < 5; i++) {
-			v[i] = h[i];
-		}
-		sl_uint32 f[4];
-		for (i = 0; i < 80; i++) {
-			sl_uint32 j = i / 20;
-			f[0] = v[3] ^ (v[1] & (v[2] ^ v[3]));
-			f[1] = v[1] ^ v[2] ^ v[3];
-			f[2] = (v[1] & v[2]) | (v[3] & (v[1] | v[2]));
-			f[3] = f[1];
-			sl_uint32 t = Math::rotateLeft32(v[0], 5) + f[j] + v[4] + K[j] + W[i];
-			v[4] = v[3];
-			v[3] = v[2];
-			v[2] = Math::rotateLeft32(v[1], 30);
-			v[1] = v[0];
-			v[0] = t;
+	void SHA1::hashMany(const void* const* inputs, const sl_size* sizes, sl_size n, void* _outputs)
+	{
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		// the multi-buffer lanes outperform SHA-NI on SHA1
+		if (n >= PRIV_HASH_LANES_MIN_ACTIVE && Cpu::isAVX2Supported()) {
+			static const sl_uint32 IV[5] = { 0x67452301ul, 0xEFCDAB89ul, 0x98BADCFEul, 0x10325476ul, 0xC3D2E1F0ul };
+			_priv_HashLanes_hashMany<5, HashSize>(IV, _priv_SHA1_AVX2_updateSection8, _priv_SHA1_updateSections, inputs, sizes, n, _outputs);
+			return;
 		}
-		for (i = 0; i < 5; i++) {
-			h[i] += v[i];
+#endif
+		sl_uint8* outputs = (sl_uint8*)_outputs;
+		for (sl_size i = 0; i < n; i++) {
+			hash(inputs[i], sizes[i], outputs);
+			outputs += HashSize;
 		}
 	}
 
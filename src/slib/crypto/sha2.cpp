@@ -23,6 +23,15 @@
 #include "slib/crypto/sha2.h"
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+
+#include "hash_lanes.h"
+
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+#	include <immintrin.h>
+#	define PRIV_SHA256_NI SLIB_TARGET_FEATURES("sha,sse4.1")
+#	define PRIV_SHA256_AVX2 SLIB_TARGET_FEATURES("avx2")
+#endif
 
 namespace slib
 {
@@ -60,7 +69,7 @@ namespace slib
 				return;
 			} else {
 				Base::copyMemory(rdata + rdata_len, input, n);
-				_updateSection(rdata);
+				_updateSections(rdata, 1);
 				rdata_len = 0;
 				sizeInput -= n;
 				input += n;
@@ -69,10 +78,12 @@ namespace slib
 				}
 			}
 		}
-		while (sizeInput >= 64) {
-			_updateSection(input);
-			sizeInput -= 64;
-			input += 64;
+		if (sizeInput >= 64) {
+			sl_size nSections = sizeInput >> 6;
+			_updateSections(input, nSections);
+			nSections <<= 6;
+			sizeInput -= nSections;
+			input += nSections;
 		}
 		if (sizeInput) {
 			Base::copyMemory(rdata, input, sizeInput);
@@ -89,38 +100,38 @@ namespace slib
 		if (rdata_len < 56) {
 			Base::zeroMemory(rdata + rdata_len + 1, 55 - rdata_len);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		} else {
 			Base::zeroMemory(rdata + rdata_len + 1, 63 - rdata_len);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 			Base::zeroMemory(rdata, 56);
 			MIO::writeUint64BE(rdata + 56, sizeTotalInput << 3);
-			_updateSection(rdata);
+			_updateSections(rdata, 1);
 		}
 		rdata_len = 0;
 	}
 
-	void _priv_SHA256Base::_updateSection(const sl_uint8* input)
-	{
-		static sl_uint32 K[64] = {
-			0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
-			0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
-			0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
-			0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
-			0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
-			0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
-			0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
-			0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
-			0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
-			0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
-			0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
-			0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
-			0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
-			0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
-			0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
-			0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
-		};
-
+	static const sl_uint32 PRIV_SHA256_K[64] = {
+		0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
+		0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+		0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
+		0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+		0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
+		0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+		0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
+		0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+		0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
+		0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+		0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
+		0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+		0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
+		0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+		0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
+		0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+	};
+
+	static void _priv_SHA256_updateSection(sl_uint32* h, const sl_uint8* input)
+	{
 		sl_uint32 W[64];
 		sl_uint32 v[8];
 		sl_uint32 i;
@@ -138,7 +149,7 @@ namespace slib
 		for (i = 0; i < 64; i++) {
 			sl_uint32 S1 = Math::rotateRight32(v[4], 6) ^ Math::rotateRight32(v[4], 11) ^ Math::rotateRight32(v[4], 25);
 			sl_uint32 ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
-			sl_uint32 temp1 = v[7] + S1 + ch + K[i] + W[i];
+			sl_uint32 temp1 = v[7] + S1 + ch + PRIV_SHA256_K[i] + W[i];
 			sl_uint32 S0 = Math::rotateRight32(v[0], 2) ^ Math::rotateRight32(v[0], 13) ^ Math::rotateRight32(v[0], 22);
 			sl_uint32 maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
 			sl_uint32 temp2 = S0 + maj;
@@ -156,6 +167,138 @@ namespace slib
 		}
 	}
 
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+	// SHA extensions (SHA-NI)
+	PRIV_SHA256_NI static void _priv_SHA256_NI_updateSections(sl_uint32* h, const sl_uint8* input, sl_size nSections)
+	{
+		const __m128i MASK = _mm_set_epi64x(SLIB_UINT64(0x0c0d0e0f08090a0b), SLIB_UINT64(0x0405060700010203));
+		__m128i STATE0, STATE1, MSG, TMP, ABEF_SAVE, CDGH_SAVE;
+		__m128i M[4];
+		
+		TMP = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0xB1); // CDAB
+		STATE1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(h + 4)), 0x1B); // EFGH
+		STATE0 = _mm_alignr_epi8(TMP, STATE1, 8); // ABEF
+		STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); // CDGH
+		
+		for (sl_size iSection = 0; iSection < nSections; iSection++) {
+			ABEF_SAVE = STATE0;
+			CDGH_SAVE = STATE1;
+			// 4 rounds per step, the message schedule rotates over M[0..3]
+			for (sl_uint32 i = 0; i < 16; i++) {
+				__m128i& cur = M[i & 3];
+				if (i < 4) {
+					cur = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + (i << 4))), MASK);
+				}
+				MSG = _mm_add_epi32(cur, _mm_loadu_si128((const __m128i*)(PRIV_SHA256_K + (i << 2))));
+				STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+				if (i >= 3 && i < 15) {
+					__m128i& next = M[(i + 1) & 3];
+					TMP = _mm_alignr_epi8(cur, M[(i + 3) & 3], 4);
+					next = _mm_add_epi32(next, TMP);
+					next = _mm_sha256msg2_epu32(next, cur);
+				}
+				MSG = _mm_shuffle_epi32(MSG, 0x0E);
+				STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+				if (i >= 1 && i < 13) {
+					__m128i& prev = M[(i + 3) & 3];
+					prev = _mm_sha256msg1_epu32(prev, cur);
+				}
+			}
+			STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+			STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+			input += 64;
+		}
+		
+		TMP = _mm_shuffle_epi32(STATE0, 0x1B); // FEBA
+		STATE1 = _mm_shuffle_epi32(STATE1, 0xB1); // DCHG
+		STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0); // DCBA
+		STATE1 = _mm_alignr_epi8(STATE1, TMP, 8); // HGFE
+		_mm_storeu_si128((__m128i*)h, STATE0);
+		_mm_storeu_si128((__m128i*)(h + 4), STATE1);
+	}
+
+	// 8 independent messages in the lanes of AVX2 registers
+	PRIV_SHA256_AVX2 static void _priv_SHA256_AVX2_updateSection8(sl_uint32 (*state)[PRIV_HASH_LANES_COUNT], const sl_uint8* const* blocks)
+	{
+#define PRIV_SHA256_AVX2_ROTR(X, N) _mm256_or_si256(_mm256_srli_epi32(X, N), _mm256_slli_epi32(X, 32 - N))
+		__m256i W[64];
+		__m256i v[8], v0[8];
+		sl_uint32 i;
+		for (i = 0; i < 16; i++) {
+			sl_uint32 k = i << 2;
+			W[i] = _mm256_set_epi32(
+				(int)(MIO::readUint32BE(blocks[7] + k)), (int)(MIO::readUint32BE(blocks[6] + k)),
+				(int)(MIO::readUint32BE(blocks[5] + k)), (int)(MIO::readUint32BE(blocks[4] + k)),
+				(int)(MIO::readUint32BE(blocks[3] + k)), (int)(MIO::readUint32BE(blocks[2] + k)),
+				(int)(MIO::readUint32BE(blocks[1] + k)), (int)(MIO::readUint32BE(blocks[0] + k)));
+		}
+		for (i = 16; i < 64; i++) {
+			__m256i s0 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(W[i - 15], 7), PRIV_SHA256_AVX2_ROTR(W[i - 15], 18)), _mm256_srli_epi32(W[i - 15], 3));
+			__m256i s1 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(W[i - 2], 17), PRIV_SHA256_AVX2_ROTR(W[i - 2], 19)), _mm256_srli_epi32(W[i - 2], 10));
+			W[i] = _mm256_add_epi32(_mm256_add_epi32(W[i - 16], s0), _mm256_add_epi32(W[i - 7], s1));
+		}
+		for (i = 0; i < 8; i++) {
+			v[i] = v0[i] = _mm256_loadu_si256((const __m256i*)(state[i]));
+		}
+		for (i = 0; i < 64; i++) {
+			__m256i S1 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(v[4], 6), PRIV_SHA256_AVX2_ROTR(v[4], 11)), PRIV_SHA256_AVX2_ROTR(v[4], 25));
+			__m256i ch = _mm256_xor_si256(v[6], _mm256_and_si256(v[4], _mm256_xor_si256(v[5], v[6])));
+			__m256i temp1 = _mm256_add_epi32(_mm256_add_epi32(v[7], S1), _mm256_add_epi32(ch, _mm256_add_epi32(W[i], _mm256_set1_epi32((int)(PRIV_SHA256_K[i])))));
+			__m256i S0 = _mm256_xor_si256(_mm256_xor_si256(PRIV_SHA256_AVX2_ROTR(v[0], 2), PRIV_SHA256_AVX2_ROTR(v[0], 13)), PRIV_SHA256_AVX2_ROTR(v[0], 22));
+			__m256i maj = _mm256_or_si256(_mm256_and_si256(v[0], v[1]), _mm256_and_si256(v[2], _mm256_or_si256(v[0], v[1])));
+			__m256i temp2 = _mm256_add_epi32(S0, maj);
+			v[7] = v[6];
+			v[6] = v[5];
+			v[5] = v[4];
+			v[4] = _mm256_add_epi32(v[3], temp1);
+			v[3] = v[2];
+			v[2] = v[1];
+			v[1] = v[0];
+			v[0] = _mm256_add_epi32(temp1, temp2);
+		}
+#undef PRIV_SHA256_AVX2_ROTR
+		for (i = 0; i < 8; i++) {
+			_mm256_storeu_si256((__m256i*)(state[i]), _mm256_add_epi32(v[i], v0[i]));
+		}
+	}
+#endif
+
+	static void _priv_SHA256_updateSections(sl_uint32* h, const sl_uint8* input, sl_size nSections)
+	{
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		if (Cpu::isSHASupported() && Cpu::isSSE41Supported()) {
+			_priv_SHA256_NI_updateSections(h, input, nSections);
+			return;
+		}
+#endif
+		for (sl_size i = 0; i < nSections; i++) {
+			_priv_SHA256_updateSection(h, input);
+			input += 64;
+		}
+	}
+
+	void _priv_SHA256Base::_updateSections(const sl_uint8* input, sl_size nSections)
+	{
+		_priv_SHA256_updateSections(h, input, nSections);
+	}
+
+	template <class HASH>
+	static void _priv_SHA256_hashMany(const sl_uint32* IV, const void* const* inputs, const sl_size* sizes, sl_size n, void* _outputs)
+	{
+#if defined(SLIB_CPU_IS_X86_FAMILY)
+		// SHA-NI outperforms the multi-buffer lanes on SHA256
+		if (n >= PRIV_HASH_LANES_MIN_ACTIVE && !(Cpu::isSHASupported()) && Cpu::isAVX2Supported()) {
+			_priv_HashLanes_hashMany<8, HASH::HashSize>(IV, _priv_SHA256_AVX2_updateSection8, _priv_SHA256_updateSections, inputs, sizes, n, _outputs);
+			return;
+		}
+#endif
+		sl_uint8* outputs = (sl_uint8*)_outputs;
+		for (sl_size i = 0; i < n; i++) {
+			HASH::hash(inputs[i], sizes[i], outputs);
+			outputs += HASH::HashSize;
+		}
+	}
+
 
 	SHA224::SHA224()
 	{
@@ -188,6 +331,12 @@ namespace slib
 		}
 	}
 
+	void SHA224::hashMany(const void* const* inputs, const sl_size* sizes, sl_size n, void* outputs)
+	{
+		static const sl_uint32 IV[8] = { 0xc1059ed8ul, 0x367cd507ul, 0x3070dd17ul, 0xf70e5939ul, 0xffc00b31ul, 0x68581511ul, 0x64f98fa7ul, 0xbefa4fa4ul };
+		_priv_SHA256_hashMany<SHA224>(IV, inputs, sizes, n, outputs);
+	}
+
 
 	SHA256::SHA256()
 	{
@@ -220,6 +369,12 @@ namespace slib
 		}
 	}
 
+	void SHA256::hashMany(const void* const* inputs, const sl_size* sizes, sl_size n, void* outputs)
+	{
+		static const sl_uint32 IV[8] = { 0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul };
+		_priv_SHA256_hashMany<SHA256>(IV, inputs, sizes, n, outputs);
+	}
+
 
 	_priv_SHA512Base::_priv_SHA512Base()
 	{
@@ -28,6 +28,7 @@
 #include "slib/core/log.h"
 
 #define PRIV_MAX_NAME SLIB_NETWORK_DNS_NAME_MAX_LENGTH
+#define PRIV_DNS_FORWARD_TIMEOUT 10000
 
 namespace slib
 {
@@ -838,7 +839,7 @@ namespace slib
 
 	SLIB_DEFINE_OBJECT(DnsServer, Object)
 
-	DnsServer::DnsServer()
+	DnsServer::DnsServer(): m_mapForward(CacheParam(0x10000, CacheEviction::LRU, PRIV_DNS_FORWARD_TIMEOUT))
 	{
 		m_flagInit = sl_false;
 		m_flagRunning = sl_false;
@@ -162,6 +162,7 @@ namespace slib
 	DEFINE_HTTP_HEADER(TransferEncoding, "Transfer-Encoding")
 	DEFINE_HTTP_HEADER(ContentEncoding, "Content-Encoding")
 	DEFINE_HTTP_HEADER(Connection, "Connection")
+	DEFINE_HTTP_HEADER(Vary, "Vary")
 
 	DEFINE_HTTP_HEADER(Range, "Range")
 	DEFINE_HTTP_HEADER(ContentRange, "Content-Range")
@@ -477,6 +478,67 @@ namespace slib
 		setRequestHeader(HttpHeaders::Origin, origin);
 	}
 
+	String HttpRequest::getRequestAcceptEncoding() const
+	{
+		return getRequestHeader(HttpHeaders::AcceptEncoding);
+	}
+
+	void HttpRequest::setRequestAcceptEncoding(const String& encoding)
+	{
+		setRequestHeader(HttpHeaders::AcceptEncoding, encoding);
+	}
+
+	HttpContentEncoding HttpRequest::getRequestAcceptedContentEncoding() const
+	{
+		String header = getRequestAcceptEncoding();
+		if (header.isEmpty()) {
+			return HttpContentEncoding::Identity;
+		}
+		// -1: not listed, 0: refused, 1: accepted
+		sl_int32 gzip = -1;
+		sl_int32 deflate = -1;
+		sl_int32 any = -1;
+		ListElements<String> items(header.split(","));
+		for (sl_size i = 0; i < items.count; i++) {
+			String item = items[i];
+			String name;
+			sl_bool flagAccept = sl_true;
+			sl_reg index = item.indexOf(';');
+			if (index >= 0) {
+				name = item.substring(0, index).trim().toLower();
+				String param = item.substring(index + 1).trim();
+				if (param.startsWith("q=")) {
+					float q = 1;
+					if (param.substring(2).parseFloat(&q) && q <= 0) {
+						flagAccept = sl_false;
+					}
+				}
+			} else {
+				name = item.trim().toLower();
+			}
+			if (name == "gzip" || name == "x-gzip") {
+				gzip = flagAccept;
+			} else if (name == "deflate") {
+				deflate = flagAccept;
+			} else if (name == "*") {
+				any = flagAccept;
+			}
+		}
+		if (gzip < 0) {
+			gzip = any;
+		}
+		if (deflate < 0) {
+			deflate = any;
+		}
+		if (gzip > 0) {
+			return HttpContentEncoding::Gzip;
+		}
+		if (deflate > 0) {
+			return HttpContentEncoding::Deflate;
+		}
+		return HttpContentEncoding::Identity;
+	}
+
 	const HashMap<String, String>& HttpRequest::getParameters() const
 	{
 		return m_parameters;
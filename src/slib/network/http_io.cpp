@@ -22,6 +22,8 @@
 
 #include "slib/network/http_io.h"
 
+#include "slib/core/json_writer.h"
+
 namespace slib
 {
 
@@ -56,11 +58,25 @@ namespace slib
 		m_bufferOutput.write(mem);
 	}
 
+	void HttpOutputBuffer::writeJson(const Json& json)
+	{
+		JsonWriter writer([this](const Memory& chunk) {
+			m_bufferOutput.write(chunk);
+			return sl_true;
+		});
+		writer.write(json);
+	}
+
 	void HttpOutputBuffer::copyFrom(AsyncStream* stream, sl_uint64 size)
 	{
 		m_bufferOutput.copyFrom(stream, size);
 	}
 
+	void HttpOutputBuffer::copyFrom(AsyncStream* stream, sl_uint64 size, const Ref<AsyncStreamFilter>& filter)
+	{
+		m_bufferOutput.copyFrom(stream, size, filter);
+	}
+
 	void HttpOutputBuffer::copyFromFile(const String& path)
 	{
 		m_bufferOutput.copyFromFile(path);
@@ -71,11 +87,21 @@ namespace slib
 		m_bufferOutput.copyFromFile(path, dispatcher);
 	}
 
+	void HttpOutputBuffer::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bufferOutput.sendFile(file, offset, size);
+	}
+
 	sl_uint64 HttpOutputBuffer::getOutputLength() const
 	{
 		return m_bufferOutput.getOutputLength();
 	}
 
+	sl_bool HttpOutputBuffer::getOutputMemory(Memory& _out)
+	{
+		return m_bufferOutput.getOutputMemory(_out);
+	}
+
 /***********************************************************************
 						HttpHeaderReader
 ***********************************************************************/
@@ -487,4 +513,76 @@ namespace slib
 		}
 	}
 
+/***********************************************************************
+						HttpContentEncoder
+***********************************************************************/
+
+	HttpContentEncoder::HttpContentEncoder()
+	{
+		m_encoding = HttpContentEncoding::Identity;
+		m_sizeRemain = 0;
+	}
+
+	HttpContentEncoder::~HttpContentEncoder()
+	{
+	}
+
+	Ref<HttpContentEncoder> HttpContentEncoder::create(HttpContentEncoding encoding, sl_uint64 contentLength, sl_int32 level)
+	{
+		if (contentLength == 0) {
+			return sl_null;
+		}
+		Ref<HttpContentEncoder> ret = new HttpContentEncoder;
+		if (ret.isNotNull()) {
+			sl_bool flagStarted = sl_false;
+			if (encoding == HttpContentEncoding::Gzip) {
+				flagStarted = ret->m_zlib.startGzip(level);
+			} else if (encoding == HttpContentEncoding::Deflate) {
+				flagStarted = ret->m_zlib.start(level);
+			}
+			if (flagStarted) {
+				ret->m_encoding = encoding;
+				ret->m_sizeRemain = contentLength;
+				return ret;
+			}
+		}
+		return sl_null;
+	}
+
+	HttpContentEncoding HttpContentEncoder::getEncoding()
+	{
+		return m_encoding;
+	}
+
+	Memory HttpContentEncoder::filterWrite(const void* data, sl_uint32 size, Referable* userObject)
+	{
+		if (!m_sizeRemain) {
+			setWritingError();
+			return sl_null;
+		}
+		Memory output;
+		if (size >= m_sizeRemain) {
+			output = m_zlib.compress(data, (sl_size)m_sizeRemain, sl_true);
+			m_sizeRemain = 0;
+		} else {
+			// flushes every write, so that the chunks are never empty
+			output = m_zlib.compressAndFlush(data, size);
+			m_sizeRemain -= size;
+		}
+		if (output.isNull()) {
+			setWritingError();
+			return sl_null;
+		}
+		MemoryBuffer buffer;
+		String sizeChunk = String::fromUint64(output.getSize(), 16) + "\r\n";
+		buffer.add(Memory::create(sizeChunk.getData(), sizeChunk.getLength()));
+		buffer.add(output);
+		if (m_sizeRemain) {
+			buffer.addStatic("\r\n", 2);
+		} else {
+			buffer.addStatic("\r\n0\r\n\r\n", 7);
+		}
+		return buffer.merge();
+	}
+
 }
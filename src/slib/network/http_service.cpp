@@ -29,6 +29,7 @@
 #include "slib/core/log.h"
 #include "slib/core/json.h"
 #include "slib/core/content_type.h"
+#include "slib/core/system.h"
 
 #define SERVICE_TAG "HTTP SERVICE"
 
@@ -116,6 +117,13 @@ namespace slib
 
 	Ref<AsyncIoLoop> HttpServiceContext::getAsyncIoLoop()
 	{
+		Ref<AsyncStream> io = getIO();
+		if (io.isNotNull()) {
+			Ref<AsyncIoLoop> loop = io->getIoLoop();
+			if (loop.isNotNull()) {
+				return loop;
+			}
+		}
 		Ref<HttpService> service = getService();
 		if (service.isNotNull()) {
 			return service->getAsyncIoLoop();
@@ -162,6 +170,47 @@ namespace slib
 		}
 	}
 
+	String HttpServiceContext::getPathParameter(const String& name) const
+	{
+		ListElements<String> names(m_pathParameterNames);
+		for (sl_size i = 0; i < names.count; i++) {
+			if (names[i] == name) {
+				return getPathParameterValue((sl_uint32)i);
+			}
+		}
+		return sl_null;
+	}
+
+	sl_uint32 HttpServiceContext::getPathParametersCount() const
+	{
+		return (sl_uint32)(m_pathParameterNames.getCount());
+	}
+
+	String HttpServiceContext::getPathParameterName(sl_uint32 index) const
+	{
+		return m_pathParameterNames.getValueAt(index);
+	}
+
+	String HttpServiceContext::getPathParameterValue(sl_uint32 index) const
+	{
+		if (index < m_pathParameterNames.getCount()) {
+			return m_path.substring(m_pathParameterRanges[index << 1], m_pathParameterRanges[index << 1] + m_pathParameterRanges[(index << 1) + 1]);
+		}
+		return sl_null;
+	}
+
+	void HttpServiceContext::setPathParameters(const List<String>& names, const sl_uint32* ranges)
+	{
+		sl_size n = names.getCount();
+		if (n > SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS) {
+			return;
+		}
+		m_pathParameterNames = names;
+		if (n) {
+			Base::copyMemory(m_pathParameterRanges, ranges, n * 2 * sizeof(sl_uint32));
+		}
+	}
+
 /******************************************************
 			HttpServiceConnection
 ******************************************************/
@@ -390,11 +439,40 @@ namespace slib
 
 	void HttpServiceConnection::_completeResponse(HttpServiceContext* context)
 	{
-		context->setResponseHeader(HttpHeaders::ContentLength, String::fromUint64(context->getResponseContentLength()));
 		String oldResponseContentType = context->getResponseContentType();
 		if (oldResponseContentType.isEmpty()) {
 			context->setResponseContentType(ContentTypes::TextHtml_Utf8);
 		}
+		Ref<HttpService> service = m_service;
+		if (service.isNotNull()) {
+			if (!(context->isProcessingByThread()) && service->isCompressibleResponse(context) && context->getRequestAcceptedContentEncoding() != HttpContentEncoding::Identity) {
+				// the I/O loop never compresses: encode on the thread pool, then write from there
+				Ref<ThreadPool> threadPool = service->getThreadPool();
+				if (threadPool.isNotNull()) {
+					Ref<HttpServiceContext> refContext = context;
+					threadPool->addTask(SLIB_BIND_WEAKREF(void(), HttpServiceConnection, _encodeResponse, this, refContext));
+					return;
+				}
+			}
+			service->processContentEncoding(context);
+		}
+		_writeResponse(context);
+	}
+
+	void HttpServiceConnection::_encodeResponse(const Ref<HttpServiceContext>& context)
+	{
+		Ref<HttpService> service = m_service;
+		if (service.isNotNull()) {
+			service->processContentEncoding(context);
+		}
+		_writeResponse(context.get());
+	}
+
+	void HttpServiceConnection::_writeResponse(HttpServiceContext* context)
+	{
+		if (!(context->isChunkedResponse())) {
+			context->setResponseHeader(HttpHeaders::ContentLength, String::fromUint64(context->getResponseContentLength()));
+		}
 		Memory header = context->makeResponsePacket();
 		if (header.isNull()) {
 			close();
@@ -538,8 +616,8 @@ namespace slib
 	class _priv_DefaultHttpServiceConnectionProvider : public HttpServiceConnectionProvider
 	{
 	public:
-		Ref<AsyncTcpServer> m_server;
-		Ref<AsyncIoLoop> m_loop;
+		List< Ref<AsyncTcpServer> > m_servers;
+		Ref<AsyncIoLoopGroup> m_loops;
 
 	public:
 		_priv_DefaultHttpServiceConnectionProvider()
@@ -554,20 +632,36 @@ namespace slib
 	public:
 		static Ref<HttpServiceConnectionProvider> create(HttpService* service, const SocketAddress& addressListen)
 		{
-			Ref<AsyncIoLoop> loop = service->getAsyncIoLoop();
-			if (loop.isNotNull()) {
+			Ref<AsyncIoLoopGroup> loops = service->getAsyncIoLoopGroup();
+			if (loops.isNotNull()) {
 				Ref<_priv_DefaultHttpServiceConnectionProvider> ret = new _priv_DefaultHttpServiceConnectionProvider;
 				if (ret.isNotNull()) {
-					ret->m_loop = loop;
+					ret->m_loops = loops;
 					ret->setService(service);
 					AsyncTcpServerParam sp;
 					sp.bindAddress = addressListen;
 					sp.onAccept = SLIB_FUNCTION_WEAKREF(_priv_DefaultHttpServiceConnectionProvider, onAccept, ret);
-					sp.ioLoop = loop;
-					Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
-					if (server.isNotNull()) {
-						ret->m_server = server;
+					sl_uint32 nLoops = loops->getLoopsCount();
+					if (service->getParam().flagReusePort && nLoops > 1) {
+						// each loop accepts on its own listener, and keeps the accepted sockets
+						sp.flagReusePort = sl_true;
+						for (sl_uint32 i = 0; i < nLoops; i++) {
+							sp.ioLoop = loops->getLoop(i);
+							Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
+							if (server.isNull()) {
+								ret->release();
+								return sl_null;
+							}
+							ret->m_servers.add_NoLock(server);
+						}
 						return ret;
+					} else {
+						sp.ioLoop = loops->getLoop(0);
+						Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
+						if (server.isNotNull()) {
+							ret->m_servers.add_NoLock(server);
+							return ret;
+						}
 					}
 				}
 			}
@@ -577,8 +671,9 @@ namespace slib
 		void release()
 		{
 			ObjectLocker lock(this);
-			if (m_server.isNotNull()) {
-				m_server->close();
+			ListElements< Ref<AsyncTcpServer> > servers(m_servers);
+			for (sl_size i = 0; i < servers.count; i++) {
+				servers[i]->close();
 			}
 		}
 
@@ -586,7 +681,15 @@ namespace slib
 		{
 			Ref<HttpService> service = getService();
 			if (service.isNotNull()) {
-				Ref<AsyncIoLoop> loop = m_loop;
+				Ref<AsyncIoLoop> loop;
+				if (m_servers.getCount() > 1) {
+					loop = socketListen->getIoLoop();
+				} else {
+					Ref<AsyncIoLoopGroup> loops = m_loops;
+					if (loops.isNotNull()) {
+						loop = loops->selectLoop();
+					}
+				}
 				if (loop.isNull()) {
 					return;
 				}
@@ -614,6 +717,12 @@ namespace slib
 		
 		maxThreadsCount = 32;
 		flagProcessByThreads = sl_true;
+		flagUseWorkStealingThreadPool = sl_false;
+		
+		ioLoopsCount = 1;
+		ioLoopBalance = AsyncIoLoopBalance::RoundRobin;
+		flagReusePort = sl_false;
+		flagPinIoLoops = sl_false;
 		
 		flagUseWebRoot = sl_false;
 		flagUseAsset = sl_false;
@@ -624,6 +733,20 @@ namespace slib
 		flagAllowCrossOrigin = sl_false;
 		flagAlwaysRespondAcceptRangesHeader = sl_true;
 		
+		flagCompressResponse = sl_false;
+		compressionLevel = 6;
+		minCompressionSize = 1024;
+		compressibleContentTypes.add_NoLock("text/");
+		compressibleContentTypes.add_NoLock("application/json");
+		compressibleContentTypes.add_NoLock("application/javascript");
+		compressibleContentTypes.add_NoLock("application/x-javascript");
+		compressibleContentTypes.add_NoLock("application/xml");
+		compressibleContentTypes.add_NoLock("application/xhtml+xml");
+		compressibleContentTypes.add_NoLock("image/svg+xml");
+		flagUsePrecompressedFile = sl_true;
+		maxCompressionCacheSize = 0x4000000; // 64MB
+		maxCompressionCacheFileSize = 0x400000; // 4MB
+		
 		flagLogDebug = sl_false;
 	}
 
@@ -636,6 +759,14 @@ namespace slib
 
 	SLIB_DEFINE_OBJECT(HttpService, Object)
 
+	class _priv_HttpServiceCompressedFile : public Referable
+	{
+	public:
+		Time modifiedTime;
+		sl_uint64 sizeOriginal;
+		Memory content;
+	};
+
 	HttpService::HttpService()
 	{
 		m_flagRunning = sl_true;
@@ -648,26 +779,40 @@ namespace slib
 
 	sl_bool HttpService::_init(const HttpServiceParam& param)
 	{
-		Ref<AsyncIoLoop> ioLoop = AsyncIoLoop::create(sl_false);
+		Ref<AsyncIoLoopGroup> ioLoopGroup = AsyncIoLoopGroup::create(param.ioLoopsCount, param.flagPinIoLoops, sl_false);
 		
-		if (ioLoop.isNotNull()) {
+		if (ioLoopGroup.isNotNull()) {
 			
-			Ref<ThreadPool> threadPool = ThreadPool::create();
+			ioLoopGroup->setBalance(param.ioLoopBalance);
+			
+			Ref<ThreadPool> threadPool;
+			if (param.flagUseWorkStealingThreadPool) {
+				sl_uint32 nWorkers = System::getProcessorsCount();
+				if (param.maxThreadsCount && nWorkers > param.maxThreadsCount) {
+					nWorkers = param.maxThreadsCount;
+				}
+				threadPool = ThreadPool::createWorkStealing(nWorkers);
+			} else {
+				threadPool = ThreadPool::create();
+				if (threadPool.isNotNull()) {
+					threadPool->setMaximumThreadsCount(param.maxThreadsCount);
+				}
+			}
 			
 			if (threadPool.isNotNull()) {
 				
-				threadPool->setMaximumThreadsCount(param.maxThreadsCount);
-				
-				m_ioLoop = ioLoop;
+				m_ioLoopGroup = ioLoopGroup;
+				m_ioLoop = ioLoopGroup->getLoop(0);
 				m_threadPool = threadPool;
 				m_param = param;
+				m_compressedFiles.setCapacity((sl_size)(param.maxCompressionCacheSize));
 				if (param.port) {
 					if (! (addHttpService(param.addressBind, param.port))) {
 						return sl_false;
 					}
 				}
 				
-				ioLoop->start();
+				ioLoopGroup->start();
 
 				return sl_true;
 			}
@@ -704,11 +849,12 @@ namespace slib
 		}
 		m_connectionProviders.removeAll();
 		
-		Ref<AsyncIoLoop> ioLoop = m_ioLoop;
-		if (ioLoop.isNotNull()) {
-			ioLoop->release();
-			m_ioLoop.setNull();
+		Ref<AsyncIoLoopGroup> ioLoopGroup = m_ioLoopGroup;
+		if (ioLoopGroup.isNotNull()) {
+			ioLoopGroup->release();
+			m_ioLoopGroup.setNull();
 		}
+		m_ioLoop.setNull();
 		Ref<ThreadPool> threadPool = m_threadPool;
 		if (threadPool.isNotNull()) {
 			threadPool->release();
@@ -716,6 +862,8 @@ namespace slib
 		}
 		
 		m_connections.removeAll();
+		
+		m_compressedFiles.removeAll();
 	}
 
 	sl_bool HttpService::isRunning()
@@ -728,6 +876,11 @@ namespace slib
 		return m_ioLoop;
 	}
 
+	Ref<AsyncIoLoopGroup> HttpService::getAsyncIoLoopGroup()
+	{
+		return m_ioLoopGroup;
+	}
+
 	Ref<ThreadPool> HttpService::getThreadPool()
 	{
 		return m_threadPool;
@@ -872,6 +1025,12 @@ namespace slib
 
 			String rangeHeader = context->getRequestRange();
 			
+			if (rangeHeader.isEmpty() && m_param.flagCompressResponse) {
+				if (_processCompressedFile(context, path, totalSize)) {
+					return sl_true;
+				}
+			}
+			
 			if (rangeHeader.isNotEmpty()) {
 				
 				sl_uint64 start;
@@ -879,7 +1038,10 @@ namespace slib
 				
 				if (processRangeRequest(context, totalSize, rangeHeader, start, len)) {
 
-					Ref<AsyncFile> file = AsyncFile::openForRead(path, m_threadPool);
+					if (_sendFile(context, path, start, len)) {
+						return sl_true;
+					}
+					Ref<AsyncStream> file = _openFileStream(context, path);
 					if (file.isNotNull()) {
 						file->seek(start);
 						context->copyFrom(file.get(), len);
@@ -892,8 +1054,14 @@ namespace slib
 				
 			} else {
 				if (totalSize > 100000) {
-					context->copyFromFile(path, m_threadPool);
-					return sl_true;
+					if (_sendFile(context, path, 0, totalSize)) {
+						return sl_true;
+					}
+					Ref<AsyncStream> file = _openFileStream(context, path);
+					if (file.isNotNull()) {
+						context->copyFrom(file.get(), totalSize);
+						return sl_true;
+					}
 				} else {
 					Memory mem = File::readAllBytes(path);
 					if (mem.isNotNull()) {
@@ -909,6 +1077,265 @@ namespace slib
 		
 	}
 
+	sl_bool HttpService::_sendFile(const Ref<HttpServiceContext>& context, const String& path, sl_uint64 offset, sl_uint64 size)
+	{
+		Ref<AsyncStream> io = context->getIO();
+		if (io.isNull() || !(io->isSendFileSupported())) {
+			return sl_false;
+		}
+		Ref<File> file = File::openForRead(path);
+		if (file.isNull()) {
+			return sl_false;
+		}
+		context->sendFile(file, offset, size);
+		return sl_true;
+	}
+
+	Ref<AsyncStream> HttpService::_openFileStream(const Ref<HttpServiceContext>& context, const String& path)
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// reads on the loop of the connection, without the thread pool
+		Ref<AsyncStream> stream = AsyncFile::openIoUring(path, FileMode::Read, context->getAsyncIoLoop());
+		if (stream.isNotNull()) {
+			return stream;
+		}
+#endif
+		return AsyncFile::openForRead(path, m_threadPool);
+	}
+
+	static const String& _priv_HttpService_getContentEncodingName(HttpContentEncoding encoding)
+	{
+		SLIB_STATIC_STRING(gzip, "gzip");
+		SLIB_STATIC_STRING(deflate, "deflate");
+		if (encoding == HttpContentEncoding::Gzip) {
+			return gzip;
+		} else {
+			return deflate;
+		}
+	}
+
+	static void _priv_HttpService_addVaryAcceptEncoding(HttpServiceContext* context)
+	{
+		String vary = context->getResponseHeader(HttpHeaders::Vary);
+		if (vary.isEmpty()) {
+			context->setResponseHeader(HttpHeaders::Vary, HttpHeaders::AcceptEncoding);
+		} else if (vary.indexOf(HttpHeaders::AcceptEncoding) < 0) {
+			context->setResponseHeader(HttpHeaders::Vary, vary + ", " + HttpHeaders::AcceptEncoding);
+		}
+	}
+
+	sl_bool HttpService::_processCompressedFile(const Ref<HttpServiceContext>& context, const String& path, sl_uint64 size)
+	{
+		if (size < m_param.minCompressionSize) {
+			return sl_false;
+		}
+		if (!(isCompressibleContentType(context->getResponseContentType()))) {
+			return sl_false;
+		}
+		
+		String pathGzip;
+		if (m_param.flagUsePrecompressedFile) {
+			// ignores the stale sibling
+			String path2 = path + ".gz";
+			if (File::exists(path2) && !(File::isDirectory(path2)) && File::getModifiedTime(path2) >= File::getModifiedTime(path)) {
+				pathGzip = path2;
+			}
+		}
+		sl_bool flagCache = size <= m_param.maxCompressionCacheFileSize;
+		// chunked transfer coding is not available in HTTP/1.0
+		sl_bool flagStream = !flagCache && context->getRequestVersion() != "HTTP/1.0";
+		if (pathGzip.isEmpty() && !flagCache && !flagStream) {
+			// the representation does not depend on `Accept-Encoding`
+			return sl_false;
+		}
+		_priv_HttpService_addVaryAcceptEncoding(context.get());
+		
+		HttpContentEncoding encoding = context->getRequestAcceptedContentEncoding();
+		if (encoding == HttpContentEncoding::Identity) {
+			return sl_false;
+		}
+		const String& encodingName = _priv_HttpService_getContentEncodingName(encoding);
+		
+		if (pathGzip.isNotEmpty() && encoding == HttpContentEncoding::Gzip) {
+			sl_uint64 sizeGzip = File::getSize(pathGzip);
+			context->setResponseContentEncoding(encodingName);
+			if (_sendFile(context, pathGzip, 0, sizeGzip)) {
+				return sl_true;
+			}
+			Ref<AsyncStream> file = _openFileStream(context, pathGzip);
+			if (file.isNotNull()) {
+				context->copyFrom(file.get(), sizeGzip);
+				return sl_true;
+			}
+			context->removeResponseHeader(HttpHeaders::ContentEncoding);
+		}
+		
+		if (flagCache) {
+			// the I/O loop never compresses: the file is compressed on the thread pool, and served as it is this time
+			sl_bool flagCompressHere = context->isProcessingByThread();
+			Memory content = _getCompressedFile(path, size, encoding, flagCompressHere);
+			if (content.isNotNull()) {
+				context->setResponseContentEncoding(encodingName);
+				context->write(content);
+				return sl_true;
+			}
+			if (!flagCompressHere) {
+				_compressFileInBackground(path, size, encoding);
+			}
+			return sl_false;
+		}
+		
+		if (flagStream) {
+			Ref<HttpContentEncoder> encoder = HttpContentEncoder::create(encoding, size, m_param.compressionLevel);
+			if (encoder.isNotNull()) {
+				Ref<AsyncStream> file = _openFileStream(context, path);
+				if (file.isNotNull()) {
+					context->setResponseContentEncoding(encodingName);
+					context->setResponseTransferEncoding("chunked");
+					context->copyFrom(file.get(), size, encoder);
+					return sl_true;
+				}
+			}
+		}
+		return sl_false;
+	}
+
+	Memory HttpService::_getCompressedFile(const String& path, sl_uint64 size, HttpContentEncoding encoding, sl_bool flagCompress)
+	{
+		Time modifiedTime = File::getModifiedTime(path);
+		String key = _priv_HttpService_getContentEncodingName(encoding) + ":" + path;
+		
+		Ref<_priv_HttpServiceCompressedFile> file;
+		if (m_compressedFiles.get(key, &file)) {
+			if (file->modifiedTime == modifiedTime && file->sizeOriginal == size) {
+				return file->content;
+			}
+		}
+		if (!flagCompress) {
+			return sl_null;
+		}
+		sl_bool flagInsert = sl_false;
+		m_compressingFiles.put(key, sl_true, &flagInsert);
+		if (!flagInsert) {
+			// already being compressed by another thread
+			return sl_null;
+		}
+		Memory content = _compressFile(key, path, size, encoding, modifiedTime);
+		m_compressingFiles.remove(key);
+		return content;
+	}
+
+	Memory HttpService::_compressFile(const String& key, const String& path, sl_uint64 size, HttpContentEncoding encoding, const Time& modifiedTime)
+	{
+		Memory mem = File::readAllBytes(path);
+		if (mem.getSize() != size) {
+			return sl_null;
+		}
+		Memory content;
+		if (encoding == HttpContentEncoding::Gzip) {
+			content = Zlib::compressGzipParallel(mem.getData(), mem.getSize(), m_param.compressionLevel);
+		} else {
+			content = Zlib::compressParallel(mem.getData(), mem.getSize(), m_param.compressionLevel);
+		}
+		if (content.isNull()) {
+			return sl_null;
+		}
+		if (m_param.maxCompressionCacheSize) {
+			Ref<_priv_HttpServiceCompressedFile> file = new _priv_HttpServiceCompressedFile;
+			if (file.isNotNull()) {
+				file->modifiedTime = modifiedTime;
+				file->sizeOriginal = size;
+				file->content = content;
+				m_compressedFiles.put(key, file, content.getSize());
+			}
+		}
+		return content;
+	}
+
+	void HttpService::_compressFileInBackground(const String& path, sl_uint64 size, HttpContentEncoding encoding)
+	{
+		if (!(m_param.maxCompressionCacheSize)) {
+			return;
+		}
+		Ref<ThreadPool> threadPool = m_threadPool;
+		if (threadPool.isNull()) {
+			return;
+		}
+		String key = _priv_HttpService_getContentEncodingName(encoding) + ":" + path;
+		sl_bool flagInsert = sl_false;
+		m_compressingFiles.put(key, sl_true, &flagInsert);
+		if (!flagInsert) {
+			// already being compressed
+			return;
+		}
+		WeakRef<HttpService> thiz = this;
+		threadPool->addTask([thiz, path, size, encoding, key]() {
+			Ref<HttpService> service = thiz;
+			if (service.isNull()) {
+				return;
+			}
+			service->_compressFile(key, path, size, encoding, File::getModifiedTime(path));
+			service->m_compressingFiles.remove(key);
+		});
+	}
+
+	void HttpService::processContentEncoding(const Ref<HttpServiceContext>& context)
+	{
+		if (!(isCompressibleResponse(context.get()))) {
+			return;
+		}
+		Memory content;
+		if (!(context->getOutputMemory(content))) {
+			return;
+		}
+		HttpContentEncoding encoding = context->getRequestAcceptedContentEncoding();
+		if (encoding == HttpContentEncoding::Identity) {
+			_priv_HttpService_addVaryAcceptEncoding(context.get());
+			return;
+		}
+		Memory compressed;
+		if (encoding == HttpContentEncoding::Gzip) {
+			compressed = Zlib::compressGzip(content.getData(), content.getSize(), m_param.compressionLevel);
+		} else {
+			compressed = Zlib::compress(content.getData(), content.getSize(), m_param.compressionLevel);
+		}
+		if (compressed.isNull() || compressed.getSize() >= content.getSize()) {
+			return;
+		}
+		context->clearOutput();
+		context->write(compressed);
+		context->setResponseContentEncoding(_priv_HttpService_getContentEncodingName(encoding));
+		_priv_HttpService_addVaryAcceptEncoding(context.get());
+	}
+
+	sl_bool HttpService::isCompressibleResponse(HttpServiceContext* context)
+	{
+		if (!(m_param.flagCompressResponse)) {
+			return sl_false;
+		}
+		if (context->getMethod() == HttpMethod::HEAD || context->getResponseCode() != HttpStatus::OK) {
+			return sl_false;
+		}
+		if (context->getResponseContentEncoding().isNotEmpty() || context->isChunkedResponse()) {
+			return sl_false;
+		}
+		if (context->getResponseContentLength() < m_param.minCompressionSize) {
+			return sl_false;
+		}
+		return isCompressibleContentType(context->getResponseContentType());
+	}
+
+	sl_bool HttpService::isCompressibleContentType(const String& contentType)
+	{
+		ListElements<String> types(m_param.compressibleContentTypes);
+		for (sl_size i = 0; i < types.count; i++) {
+			if (contentType.startsWith(types[i])) {
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
 	sl_bool HttpService::processRangeRequest(const Ref<HttpServiceContext>& context, sl_uint64 totalLength, const String& range, sl_uint64& outStart, sl_uint64& outLength)
 	{
 		if (range.getLength() < 2 || !(range.startsWith("bytes="))) {
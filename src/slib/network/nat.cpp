@@ -214,7 +214,7 @@ namespace slib
 		}
 		sl_uint16 sn = ++ m_icmpEchoSequenceCurrent;
 		if (m_mapIcmpEchoIncoming.get(sn, &element)) {
-			m_mapIcmpEchoOutgoing.removeItems(element.addressSource);
+			m_mapIcmpEchoOutgoing.remove(element.addressSource);
 		}
 		element.addressSource = address;
 		element.sequenceNumberTarget = sn;
@@ -35,6 +35,7 @@ namespace slib
 	{
 		m_flagRequestConnect = sl_false;
 		m_flagSupportingConnect = sl_true;
+		setConnection(sl_true);
 	}
 
 	AsyncTcpSocketInstance::~AsyncTcpSocketInstance()
@@ -325,6 +326,7 @@ namespace slib
 		
 		flagAutoStart = sl_true;
 		flagLogError = sl_true;
+		flagReusePort = sl_false;
 	}
 
 	AsyncTcpServerParam::~AsyncTcpServerParam()
@@ -370,6 +372,14 @@ namespace slib
 			 */
 			socket->setOption_ReuseAddress(sl_true);
 #endif
+			if (param.flagReusePort) {
+				if (!(socket->setOption_ReusePort(sl_true))) {
+					if (param.flagLogError) {
+						LogError(TAG, "AsyncTcpServer failed to set SO_REUSEPORT: %s", socket->getLastErrorMessage());
+					}
+					return sl_null;
+				}
+			}
 
 			if (!(socket->bind(param.bindAddress))) {
 				if (param.flagLogError) {
@@ -26,9 +26,52 @@
 
 #include "network_async.h"
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+#include <sys/sendfile.h>
+#include <signal.h>
+#include <errno.h>
+#endif
+
 namespace slib
 {
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	// sendfile() has no MSG_NOSIGNAL, so SIGPIPE is blocked only around the call, and a SIGPIPE raised by it is consumed
+	static sl_int32 _priv_Unix_AsyncTcpSocket_sendFile(sl_file socket, sl_file file, sl_uint64 offset, sl_uint32 size)
+	{
+		sigset_t setSigPipe, setOld, setPending;
+		sigemptyset(&setSigPipe);
+		sigaddset(&setSigPipe, SIGPIPE);
+		sigemptyset(&setPending);
+		sigpending(&setPending);
+		sl_bool flagPendingBefore = sigismember(&setPending, SIGPIPE) == 1;
+		pthread_sigmask(SIG_BLOCK, &setSigPipe, &setOld);
+		off_t pos = (off_t)offset;
+		ssize_t n;
+		int err = 0;
+		do {
+			n = ::sendfile((int)socket, (int)file, &pos, size);
+			err = n < 0 ? errno : 0;
+		} while (err == EINTR);
+		if (err == EPIPE && !flagPendingBefore) {
+			struct timespec timeout = {0, 0};
+			while (sigtimedwait(&setSigPipe, sl_null, &timeout) < 0 && errno == EINTR) {
+			}
+		}
+		pthread_sigmask(SIG_SETMASK, &setOld, sl_null);
+		if (n > 0) {
+			return (sl_int32)n;
+		}
+		if (n < 0) {
+			if (err == EAGAIN || err == EWOULDBLOCK) {
+				return 0;
+			}
+		}
+		// unexpected end of file is also an error
+		return -1;
+	}
+#endif
+
 	class _priv_Unix_AsyncTcpSocketInstance : public AsyncTcpSocketInstance
 	{
 	public:
@@ -142,9 +185,17 @@ namespace slib
 						return;
 					}
 				}
-				if (request->data && request->size) {
+				if ((request->data || request->file.isNotNull()) && request->size) {
 					sl_uint32 size = request->size - m_sizeWritten;
-					sl_int32 n = socket->send((char*)(request->data) + m_sizeWritten, size);
+					sl_int32 n;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+					if (request->file.isNotNull()) {
+						n = _priv_Unix_AsyncTcpSocket_sendFile(getHandle(), request->file->getHandle(), request->fileOffset + m_sizeWritten, size);
+					} else
+#endif
+					{
+						n = socket->send((char*)(request->data) + m_sizeWritten, size);
+					}
 					if (n > 0) {
 						m_sizeWritten += n;
 						if (m_sizeWritten >= request->size) {
@@ -170,6 +221,13 @@ namespace slib
 			}
 		}
 		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		sl_bool isSendFileSupported() override
+		{
+			return sl_true;
+		}
+#endif
+		
 		void onOrder()
 		{
 			Ref<Socket> socket = m_socket;
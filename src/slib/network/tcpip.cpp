@@ -24,6 +24,8 @@
 
 #include "slib/core/mio.h"
 
+#define PRIV_IPV4_FRAGMENTATION_MAX_PACKETS 4096
+
 namespace slib
 {
 
@@ -316,7 +318,7 @@ namespace slib
 	{
 	}
 	
-	IPv4Fragmentation::IPv4Fragmentation()
+	IPv4Fragmentation::IPv4Fragmentation(): m_packets(CacheParam(PRIV_IPV4_FRAGMENTATION_MAX_PACKETS))
 	{
 	}
 	
@@ -326,12 +328,12 @@ namespace slib
 	
 	void IPv4Fragmentation::setupExpiringDuration(sl_uint32 ms, const Ref<DispatchLoop>& loop)
 	{
-		m_packets.setupTimer(ms, loop);
+		m_packets.setTimeToLive(ms);
 	}
 	
 	void IPv4Fragmentation::setupExpiringDuration(sl_uint32 ms)
 	{
-		m_packets.setupTimer(ms);
+		m_packets.setTimeToLive(ms);
 	}
 	
 	sl_bool IPv4Fragmentation::isNeededReassembly(const IPv4Packet* ip)
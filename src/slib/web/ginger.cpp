@@ -20,23 +20,722 @@
  *   THE SOFTWARE.
  */
 
-#define SLIB_SUPPORT_STD_TYPES
 
 #include "slib/web/ginger.h"
 
-#include "ginger/ginger.h"
+#include "slib/core/async.h"
+#include "slib/core/file.h"
+#include "slib/core/hash_map.h"
+#include "slib/core/log.h"
+#include "slib/core/safe_static.h"
+
+#define PRIV_GINGER_MAX_INCLUDE_DEPTH 16
 
 namespace slib
 {
 	
+	enum class _priv_GingerNodeType
+	{
+		Text,
+		Variable,
+		For,
+		If,
+		Include,
+		Inline
+	};
+	
+	class _priv_GingerBlock;
+	
+	struct _priv_GingerCondition
+	{
+		// empty for `$else`
+		List<String> path;
+		sl_bool flagCompare;
+		String value;
+		Ref<_priv_GingerBlock> block;
+	};
+	
+	struct _priv_GingerNode
+	{
+		_priv_GingerNodeType type;
+		// text content, loop variable or file path
+		String text;
+		List<String> path;
+		Ref<_priv_GingerBlock> block;
+		List<_priv_GingerCondition> conditions;
+	};
+	
+	class _priv_GingerBlock : public Referable
+	{
+	public:
+		List<_priv_GingerNode> nodes;
+	};
+	
+	class _priv_GingerCompiler
+	{
+	public:
+		const sl_char8* data;
+		sl_size len;
+		sl_size pos;
+		sl_size line;
+		String error;
+		
+	public:
+		_priv_GingerCompiler(const String& source): data(source.getData()), len(source.getLength()), pos(0), line(1)
+		{
+		}
+		
+	public:
+		sl_bool isEnd()
+		{
+			return pos >= len;
+		}
+		
+		void skipWhitespaces()
+		{
+			while (pos < len && (sl_uint8)(data[pos]) <= 32) {
+				if (data[pos] == '\n') {
+					line++;
+				}
+				pos++;
+			}
+		}
+		
+		sl_bool eat(const char* str)
+		{
+			skipWhitespaces();
+			sl_size n = Base::getStringLength(str);
+			if (pos + n <= len && Base::equalsMemory(data + pos, str, n)) {
+				pos += n;
+				return sl_true;
+			}
+			error = String::format("'%s' is expected", str);
+			return sl_false;
+		}
+		
+		// reads characters until whitespace, '{', '}' or `stop` character
+		String readToken(sl_char8 stop = 0)
+		{
+			sl_size start = pos;
+			while (pos < len) {
+				sl_char8 c = data[pos];
+				if ((sl_uint8)c <= 32 || c == '{' || c == '}' || (stop && c == stop)) {
+					break;
+				}
+				pos++;
+			}
+			return String(data + start, pos - start);
+		}
+		
+		String readIdentifier()
+		{
+			skipWhitespaces();
+			return readToken();
+		}
+		
+		sl_bool readPath(List<String>& path)
+		{
+			skipWhitespaces();
+			for (;;) {
+				String name = readToken('.');
+				if (name.isEmpty()) {
+					error = "Variable name is expected";
+					return sl_false;
+				}
+				path.add_NoLock(Move(name));
+				if (pos < len && data[pos] == '.') {
+					pos++;
+				} else {
+					return sl_true;
+				}
+			}
+		}
+		
+		static sl_bool parsePath(const String& str, List<String>& path)
+		{
+			if (str.isEmpty()) {
+				return sl_false;
+			}
+			ListElements<String> names(str.split("."));
+			for (sl_size i = 0; i < names.count; i++) {
+				if (names[i].isEmpty()) {
+					return sl_false;
+				}
+				path.add_NoLock(names[i]);
+			}
+			return sl_true;
+		}
+		
+		// `path` or `path == value`, terminated by "{{"
+		sl_bool readCondition(_priv_GingerCondition& cond)
+		{
+			sl_size start = pos;
+			while (pos + 1 < len && !(data[pos] == '{' && data[pos + 1] == '{')) {
+				if (data[pos] == '\n') {
+					line++;
+				}
+				pos++;
+			}
+			String str(data + start, pos - start);
+			sl_reg index = str.indexOf("==");
+			cond.flagCompare = index >= 0;
+			if (cond.flagCompare) {
+				String value = str.substring(index + 2).trim();
+				sl_size n = value.getLength();
+				if (n >= 2) {
+					sl_char8 q = value.getAt(0);
+					if ((q == '"' || q == '\'') && value.getAt(n - 1) == q) {
+						value = value.substring(1, n - 1);
+					}
+				}
+				cond.value = Move(value);
+				str = str.substring(0, index);
+			}
+			if (!(parsePath(str.trim(), cond.path))) {
+				error = "Invalid condition";
+				return sl_false;
+			}
+			return sl_true;
+		}
+		
+		sl_bool readBlock(Ref<_priv_GingerBlock>& block)
+		{
+			if (!(eat("{{"))) {
+				return sl_false;
+			}
+			block = compileBlock();
+			if (block.isNull()) {
+				return sl_false;
+			}
+			return eat("}}");
+		}
+		
+		sl_bool readFilePath(String& path)
+		{
+			if (!(eat("{{"))) {
+				return sl_false;
+			}
+			skipWhitespaces();
+			sl_size start = pos;
+			while (pos < len && (sl_uint8)(data[pos]) > 32 && data[pos] != '}') {
+				pos++;
+			}
+			if (pos == start) {
+				error = "File path is expected";
+				return sl_false;
+			}
+			path = String(data + start, pos - start);
+			return eat("}}");
+		}
+		
+		static void flushText(List<_priv_GingerNode>& nodes, StringBuffer& text)
+		{
+			if (text.getLength()) {
+				_priv_GingerNode node;
+				node.type = _priv_GingerNodeType::Text;
+				node.text = text.merge();
+				nodes.add_NoLock(Move(node));
+				text.clear();
+			}
+		}
+		
+		// stops at the end of source or at "}}"
+		Ref<_priv_GingerBlock> compileBlock()
+		{
+			Ref<_priv_GingerBlock> block = new _priv_GingerBlock;
+			if (block.isNull()) {
+				return sl_null;
+			}
+			List<_priv_GingerNode>& nodes = block->nodes;
+			StringBuffer text;
+			while (pos < len) {
+				sl_size start = pos;
+				while (pos < len) {
+					sl_char8 c = data[pos];
+					if (c == '$' || c == '}') {
+						break;
+					}
+					if (c == '\n') {
+						line++;
+					}
+					pos++;
+				}
+				if (pos > start) {
+					text.addStatic(data + start, pos - start);
+				}
+				if (pos >= len) {
+					break;
+				}
+				if (data[pos] == '}') {
+					if (pos + 1 < len && data[pos + 1] == '}') {
+						break;
+					}
+					text.addStatic("}", 1);
+					pos++;
+					continue;
+				}
+				// '$'
+				pos++;
+				if (pos >= len) {
+					error = "Unexpected end after '$'";
+					return sl_null;
+				}
+				sl_char8 c = data[pos];
+				if (c == '$') {
+					text.addStatic("$", 1);
+					pos++;
+				} else if (c == '#') {
+					while (pos < len && data[pos] != '\n') {
+						pos++;
+					}
+				} else if (c == '{') {
+					pos++;
+					if (pos < len && data[pos] == '{') {
+						text.addStatic("{{", 2);
+						pos++;
+					} else {
+						_priv_GingerNode node;
+						node.type = _priv_GingerNodeType::Variable;
+						if (!(readPath(node.path))) {
+							return sl_null;
+						}
+						if (!(eat("}"))) {
+							return sl_null;
+						}
+						flushText(nodes, text);
+						nodes.add_NoLock(Move(node));
+					}
+				} else if (c == '}') {
+					pos++;
+					if (pos < len && data[pos] == '}') {
+						text.addStatic("}}", 2);
+						pos++;
+					} else {
+						error = "'}' is expected after \"$}\"";
+						return sl_null;
+					}
+				} else {
+					String command = readIdentifier();
+					_priv_GingerNode node;
+					if (command == "for") {
+						node.type = _priv_GingerNodeType::For;
+						node.text = readIdentifier();
+						if (node.text.isEmpty()) {
+							error = "Loop variable is expected";
+							return sl_null;
+						}
+						if (readIdentifier() != "in") {
+							error = "\"in\" is expected";
+							return sl_null;
+						}
+						if (!(readPath(node.path))) {
+							return sl_null;
+						}
+						if (!(readBlock(node.block))) {
+							return sl_null;
+						}
+					} else if (command == "if") {
+						node.type = _priv_GingerNodeType::If;
+						for (;;) {
+							_priv_GingerCondition cond;
+							if (!(readCondition(cond))) {
+								return sl_null;
+							}
+							if (!(readBlock(cond.block))) {
+								return sl_null;
+							}
+							node.conditions.add_NoLock(Move(cond));
+							sl_size posSaved = pos;
+							sl_size lineSaved = line;
+							skipWhitespaces();
+							if (pos < len && data[pos] == '$') {
+								pos++;
+								String next = readIdentifier();
+								if (next == "elseif") {
+									continue;
+								} else if (next == "else") {
+									_priv_GingerCondition condElse;
+									condElse.flagCompare = sl_false;
+									if (!(readBlock(condElse.block))) {
+										return sl_null;
+									}
+									node.conditions.add_NoLock(Move(condElse));
+									break;
+								}
+							}
+							pos = posSaved;
+							line = lineSaved;
+							break;
+						}
+					} else if (command == "include") {
+						node.type = _priv_GingerNodeType::Include;
+						if (!(readFilePath(node.text))) {
+							return sl_null;
+						}
+					} else if (command == "inline") {
+						node.type = _priv_GingerNodeType::Inline;
+						if (!(readFilePath(node.text))) {
+							return sl_null;
+						}
+					} else {
+						error = String::format("Unexpected command: %s", command);
+						return sl_null;
+					}
+					flushText(nodes, text);
+					nodes.add_NoLock(Move(node));
+				}
+			}
+			flushText(nodes, text);
+			return block;
+		}
+		
+	};
+	
+	class _priv_GingerScope
+	{
+	public:
+		const String* name;
+		Variant value;
+		const _priv_GingerScope* parent;
+	};
+	
+	class _priv_GingerFileEntry : public Referable
+	{
+	public:
+		Time modifiedTime;
+		String content;
+		Ref<GingerTemplate> compiled;
+	};
+	
+	class _priv_GingerFileCache
+	{
+	public:
+		CHashMap< String, Ref<_priv_GingerFileEntry> > templates;
+		CHashMap< String, Ref<_priv_GingerFileEntry> > inlines;
+		
+	public:
+		Ref<_priv_GingerFileEntry> get(CHashMap< String, Ref<_priv_GingerFileEntry> >& map, const String& path, sl_bool flagCompile)
+		{
+			Time time = File::getModifiedTime(path);
+			Ref<_priv_GingerFileEntry> entry;
+			if (map.get(path, &entry) && entry.isNotNull()) {
+				if (entry->modifiedTime == time) {
+					return entry;
+				}
+			}
+			String content = File::readAllTextUTF8(path);
+			if (content.isNull()) {
+				map.remove(path);
+				return sl_null;
+			}
+			entry = new _priv_GingerFileEntry;
+			if (entry.isNull()) {
+				return sl_null;
+			}
+			entry->modifiedTime = time;
+			if (flagCompile) {
+				entry->compiled = GingerTemplate::create(content);
+				if (entry->compiled.isNull()) {
+					return sl_null;
+				}
+			} else {
+				entry->content = Move(content);
+			}
+			map.put(path, entry);
+			return entry;
+		}
+		
+	};
+	
+	SLIB_SAFE_STATIC_GETTER(_priv_GingerFileCache, _priv_Ginger_getFileCache)
+	
+	static String _priv_Ginger_getInlineFile(const String& path)
+	{
+		_priv_GingerFileCache* cache = _priv_Ginger_getFileCache();
+		if (cache) {
+			Ref<_priv_GingerFileEntry> entry = cache->get(cache->inlines, path, sl_false);
+			if (entry.isNotNull()) {
+				return entry->content;
+			}
+		}
+		return sl_null;
+	}
+	
+	class _priv_GingerRenderer
+	{
+	public:
+		StringBuffer* output;
+		const Json* data;
+		sl_uint32 depth;
+		
+	public:
+		Variant getVariable(const List<String>& path, const _priv_GingerScope* scope)
+		{
+			String* names = path.getData();
+			sl_size n = path.getCount();
+			if (!n) {
+				return sl_null;
+			}
+			Variant value;
+			sl_bool flagFound = sl_false;
+			while (scope) {
+				if (*(scope->name) == names[0]) {
+					value = scope->value;
+					flagFound = sl_true;
+					break;
+				}
+				scope = scope->parent;
+			}
+			if (!flagFound) {
+				value = data->getItem(names[0]);
+			}
+			for (sl_size i = 1; i < n; i++) {
+				if (value.isObject() && !(value.isVariantMapOrVariantHashMap())) {
+					sl_uint32 index;
+					if (names[i].parseUint32(10, &index)) {
+						value = value.getElement(index);
+						continue;
+					}
+				}
+				value = value.getItem(names[i]);
+			}
+			return value;
+		}
+		
+		static sl_bool isTrue(const Variant& value)
+		{
+			if (value.isBoolean()) {
+				return value.getBoolean();
+			}
+			if (value.isNumber()) {
+				return value.getDouble() != 0;
+			}
+			if (value.isString()) {
+				return value.getString().isNotEmpty();
+			}
+			if (value.isObject()) {
+				return value.getElementsCount() > 0 || value.isVariantMapOrVariantHashMap();
+			}
+			return sl_false;
+		}
+		
+		sl_bool checkCondition(const _priv_GingerCondition& cond, const _priv_GingerScope* scope)
+		{
+			if (cond.path.isNull()) {
+				return sl_true;
+			}
+			Variant value = getVariable(cond.path, scope);
+			if (cond.flagCompare) {
+				if (cond.value == "true") {
+					return isTrue(value);
+				}
+				if (cond.value == "false") {
+					return !(isTrue(value));
+				}
+				return value.getString() == cond.value;
+			}
+			return isTrue(value);
+		}
+		
+		void renderBlock(_priv_GingerBlock* block, const _priv_GingerScope* scope)
+		{
+			_priv_GingerNode* nodes = block->nodes.getData();
+			sl_size n = block->nodes.getCount();
+			for (sl_size i = 0; i < n; i++) {
+				_priv_GingerNode& node = nodes[i];
+				switch (node.type) {
+					case _priv_GingerNodeType::Text:
+						output->add(node.text);
+						break;
+					case _priv_GingerNodeType::Variable:
+						{
+							Variant value = getVariable(node.path, scope);
+							if (value.isNotNull()) {
+								output->add(value.getString());
+							}
+						}
+						break;
+					case _priv_GingerNodeType::For:
+						{
+							Variant list = getVariable(node.path, scope);
+							sl_size m = list.getElementsCount();
+							_priv_GingerScope child;
+							child.name = &(node.text);
+							child.parent = scope;
+							for (sl_size k = 0; k < m; k++) {
+								child.value = list.getElement(k);
+								renderBlock(node.block.get(), &child);
+							}
+						}
+						break;
+					case _priv_GingerNodeType::If:
+						{
+							_priv_GingerCondition* conds = node.conditions.getData();
+							sl_size m = node.conditions.getCount();
+							for (sl_size k = 0; k < m; k++) {
+								if (checkCondition(conds[k], scope)) {
+									renderBlock(conds[k].block.get(), scope);
+									break;
+								}
+							}
+						}
+						break;
+					case _priv_GingerNodeType::Include:
+						if (depth < PRIV_GINGER_MAX_INCLUDE_DEPTH) {
+							Ref<GingerTemplate> t = Ginger::getTemplateFromFile(node.text);
+							if (t.isNotNull()) {
+								t->_render(*output, *data, depth + 1);
+							}
+						}
+						break;
+					case _priv_GingerNodeType::Inline:
+						output->add(_priv_Ginger_getInlineFile(node.text));
+						break;
+				}
+			}
+		}
+		
+	};
+	
+	SLIB_DEFINE_OBJECT(GingerTemplate, Object)
+	
+	GingerTemplate::GingerTemplate()
+	{
+	}
+	
+	GingerTemplate::~GingerTemplate()
+	{
+	}
+	
+	Ref<GingerTemplate> GingerTemplate::create(const String& source)
+	{
+		_priv_GingerCompiler compiler(source);
+		Ref<_priv_GingerBlock> root = compiler.compileBlock();
+		if (root.isNotNull() && !(compiler.isEnd())) {
+			// "}}" without matching block
+			compiler.error = "Unexpected \"}}\"";
+			root.setNull();
+		}
+		if (root.isNull()) {
+			LogError("Ginger", "line %d: %s", compiler.line, compiler.error);
+			return sl_null;
+		}
+		Ref<GingerTemplate> ret = new GingerTemplate;
+		if (ret.isNotNull()) {
+			ret->m_root = Move(root);
+			return ret;
+		}
+		return sl_null;
+	}
+	
+	Ref<GingerTemplate> GingerTemplate::createFromFile(const String& filePath)
+	{
+		String source = File::readAllTextUTF8(filePath);
+		if (source.isNull()) {
+			return sl_null;
+		}
+		return create(source);
+	}
+	
+	String GingerTemplate::render(const Json& data)
+	{
+		StringBuffer buf;
+		_render(buf, data, 0);
+		return buf.merge();
+	}
+	
+	void GingerTemplate::render(StringBuffer& output, const Json& data)
+	{
+		_render(output, data, 0);
+	}
+	
+	Memory GingerTemplate::renderToMemory(const Json& data)
+	{
+		StringBuffer buf;
+		_render(buf, data, 0);
+		return buf.mergeToMemory();
+	}
+	
+	class _priv_GingerOutput : public Referable
+	{
+	public:
+		StringBuffer buffer;
+	};
+	
+	sl_bool GingerTemplate::render(AsyncOutputBuffer* output, const Json& data)
+	{
+		Ref<_priv_GingerOutput> holder = new _priv_GingerOutput;
+		if (holder.isNull()) {
+			return sl_false;
+		}
+		_render(holder->buffer, data, 0);
+		// the segments are queued without merging, `holder` keeps them alive until they are sent
+		Link<StringData>* item = holder->buffer.getFirstItem();
+		if (!item) {
+			// empty output
+			return sl_true;
+		}
+		MemoryData mem;
+		mem.refer = holder;
+		while (item) {
+			mem.data = (void*)(item->value.sz8);
+			mem.size = item->value.len;
+			if (!(output->write(mem))) {
+				return sl_false;
+			}
+			item = item->next;
+		}
+		return sl_true;
+	}
+	
+	void GingerTemplate::_render(StringBuffer& output, const Json& data, sl_uint32 depth)
+	{
+		_priv_GingerRenderer renderer;
+		renderer.output = &output;
+		renderer.data = &data;
+		renderer.depth = depth;
+		renderer.renderBlock(m_root.get(), sl_null);
+	}
+	
+	
 	String Ginger::render(const String& _template, const Json& data)
 	{
-		return ginger::render_string(_template.toStd(), data);
+		Ref<GingerTemplate> t = GingerTemplate::create(_template);
+		if (t.isNotNull()) {
+			return t->render(data);
+		}
+		return sl_null;
 	}
 
 	String Ginger::renderFile(const String& filePath, const Json& data)
 	{
-		return ginger::render_file(filePath.toStd(), data);
+		Ref<GingerTemplate> t = getTemplateFromFile(filePath);
+		if (t.isNotNull()) {
+			return t->render(data);
+		}
+		return sl_null;
+	}
+	
+	Ref<GingerTemplate> Ginger::getTemplateFromFile(const String& filePath)
+	{
+		_priv_GingerFileCache* cache = _priv_Ginger_getFileCache();
+		if (cache) {
+			Ref<_priv_GingerFileEntry> entry = cache->get(cache->templates, filePath, sl_true);
+			if (entry.isNotNull()) {
+				return entry->compiled;
+			}
+			return sl_null;
+		}
+		return GingerTemplate::createFromFile(filePath);
+	}
+	
+	void Ginger::clearTemplateCache()
+	{
+		_priv_GingerFileCache* cache = _priv_Ginger_getFileCache();
+		if (cache) {
+			cache->templates.removeAll();
+			cache->inlines.removeAll();
+		}
 	}
 
 }
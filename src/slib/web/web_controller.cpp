@@ -24,6 +24,8 @@
 
 #include "slib/web/service.h"
 #include "slib/core/xml.h"
+#include "slib/core/json.h"
+#include "slib/core/log.h"
 
 namespace slib
 {
@@ -39,21 +41,24 @@ namespace slib
 		return new WebController;
 	}
 
-	void WebController::registerHandler(HttpMethod method, const String& path, const WebHandler& handler)
+	sl_bool WebController::registerHandler(HttpMethod method, const String& path, const WebHandler& handler)
 	{
-		if (handler.isNotNull()) {
-			String sig = _getHandlerSignature(method, path);
-			m_handlers.put(sig, handler);
+		if (handler.isNull()) {
+			return sl_false;
+		}
+		if (m_router.add(method, path, handler)) {
+			return sl_true;
 		}
+		LogError("WebController", "Failed to register the route: %s %s", HttpMethods::toString(method), path);
+		return sl_false;
 	}
 
 	sl_bool WebController::processHttpRequest(HttpServiceContext* context)
 	{
-		HttpMethod method = context->getMethod();
-		String path = context->getPath();
-		String sig = _getHandlerSignature(method, path);
-		WebHandler handler;
-		if (m_handlers.get(sig, &handler)) {
+		WebHandler handler = m_router.route(context);
+		if (handler.isNotNull()) {
+			HttpMethod method = context->getMethod();
+			String path = context->getPath();
 			Variant ret(handler(context, method, path));
 			if (ret.isNotNull()) {
 				if (ret.isObject()) {
@@ -64,7 +69,7 @@ namespace slib
 						} else if (CMemory* mem = CastInstance<CMemory>(obj.get())) {
 							context->write(mem);
 						} else {
-							context->write(ret.toJsonString());
+							context->writeJson(ret);
 						}
 					}
 				} else {
@@ -76,11 +81,6 @@ namespace slib
 		return sl_false;
 	}
 
-	String WebController::_getHandlerSignature(HttpMethod method, const String& path)
-	{
-		return HttpMethods::toString(method) + " " + path;
-	}
-
 
 	WebModule::WebModule(const String& path)
 	: m_path(path)
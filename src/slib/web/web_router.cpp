@@ -0,0 +1,280 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/web/router.h"
+
+#include "slib/core/log.h"
+
+namespace slib
+{
+
+	class _priv_WebRouterNode : public Referable
+	{
+	public:
+		String prefix;
+		// first characters of the static children
+		String indices;
+		List< Ref<_priv_WebRouterNode> > children;
+		Ref<_priv_WebRouterNode> parameter;
+		Ref<_priv_WebRouterNode> wildcard;
+		// name captured by a parameter or wildcard node
+		String name;
+		
+		WebHandler handler;
+		List<String> parameterNames;
+		
+	public:
+		_priv_WebRouterNode* insertStatic(const String& _text)
+		{
+			_priv_WebRouterNode* node = this;
+			String text = _text;
+			for (;;) {
+				sl_size lenText = text.getLength();
+				if (!lenText) {
+					return node;
+				}
+				sl_char8 ch = text.getData()[0];
+				sl_reg index = node->indices.indexOf(ch);
+				if (index < 0) {
+					Ref<_priv_WebRouterNode> child = new _priv_WebRouterNode;
+					if (child.isNull()) {
+						return sl_null;
+					}
+					child->prefix = text;
+					if (!(node->children.add_NoLock(child))) {
+						return sl_null;
+					}
+					node->indices += String(ch, 1);
+					return child.get();
+				}
+				Ref<_priv_WebRouterNode> child = node->children.getValueAt_NoLock(index);
+				const sl_char8* prefix = child->prefix.getData();
+				sl_size lenPrefix = child->prefix.getLength();
+				sl_size lenCommon = 1;
+				while (lenCommon < lenPrefix && lenCommon < lenText && prefix[lenCommon] == text.getData()[lenCommon]) {
+					lenCommon++;
+				}
+				if (lenCommon < lenPrefix) {
+					// splits the edge
+					Ref<_priv_WebRouterNode> mid = new _priv_WebRouterNode;
+					if (mid.isNull()) {
+						return sl_null;
+					}
+					mid->prefix = child->prefix.substring(0, lenCommon);
+					child->prefix = child->prefix.substring(lenCommon);
+					mid->indices = String(child->prefix.getData()[0], 1);
+					if (!(mid->children.add_NoLock(child))) {
+						return sl_null;
+					}
+					node->children.setAt_NoLock(index, mid);
+					child = mid;
+				}
+				text = text.substring(lenCommon);
+				node = child.get();
+			}
+		}
+		
+		// the prefix of this node is already matched
+		_priv_WebRouterNode* match(const sl_char8* path, sl_size len, sl_size pos, sl_uint32* ranges, sl_uint32 nParameters)
+		{
+			if (pos == len) {
+				if (handler.isNotNull()) {
+					return this;
+				}
+				if (wildcard.isNotNull()) {
+					ranges[nParameters << 1] = (sl_uint32)pos;
+					ranges[(nParameters << 1) + 1] = 0;
+					return wildcard.get();
+				}
+				return sl_null;
+			}
+			sl_char8 ch = path[pos];
+			const sl_char8* s = indices.getData();
+			sl_size n = indices.getLength();
+			for (sl_size i = 0; i < n; i++) {
+				if (s[i] == ch) {
+					_priv_WebRouterNode* child = children.getData()[i].get();
+					sl_size lenPrefix = child->prefix.getLength();
+					if (lenPrefix <= len - pos && Base::equalsMemory(child->prefix.getData(), path + pos, lenPrefix)) {
+						_priv_WebRouterNode* ret = child->match(path, len, pos + lenPrefix, ranges, nParameters);
+						if (ret) {
+							return ret;
+						}
+					}
+					break;
+				}
+			}
+			if (parameter.isNotNull() && ch != '/' && nParameters < SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS) {
+				sl_size end = pos + 1;
+				while (end < len && path[end] != '/') {
+					end++;
+				}
+				ranges[nParameters << 1] = (sl_uint32)pos;
+				ranges[(nParameters << 1) + 1] = (sl_uint32)(end - pos);
+				_priv_WebRouterNode* ret = parameter->match(path, len, end, ranges, nParameters + 1);
+				if (ret) {
+					return ret;
+				}
+			}
+			if (wildcard.isNotNull() && nParameters < SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS) {
+				ranges[nParameters << 1] = (sl_uint32)pos;
+				ranges[(nParameters << 1) + 1] = (sl_uint32)(len - pos);
+				return wildcard.get();
+			}
+			return sl_null;
+		}
+		
+	};
+
+	WebRouter::WebRouter()
+	{
+	}
+
+	WebRouter::~WebRouter()
+	{
+	}
+
+	sl_bool WebRouter::add(HttpMethod method, const String& path, const WebHandler& handler)
+	{
+		sl_uint32 indexMethod = (sl_uint32)method;
+		if (indexMethod > (sl_uint32)(HttpMethod::TRACE) || handler.isNull()) {
+			return sl_false;
+		}
+		
+		WriteLocker lock(&m_lock);
+		
+		Ref<_priv_WebRouterNode>& root = m_trees[indexMethod];
+		if (root.isNull()) {
+			root = new _priv_WebRouterNode;
+			if (root.isNull()) {
+				return sl_false;
+			}
+		}
+		_priv_WebRouterNode* node = root.get();
+		List<String> names;
+		
+		const sl_char8* s = path.getData();
+		sl_size len = path.getLength();
+		sl_size start = 0;
+		sl_size pos = 0;
+		while (pos < len) {
+			sl_char8 ch = s[pos];
+			if ((ch == ':' || ch == '*') && (!pos || s[pos - 1] == '/')) {
+				if (pos > start) {
+					node = node->insertStatic(path.substring(start, pos));
+					if (!node) {
+						return sl_false;
+					}
+				}
+				sl_size end = pos + 1;
+				while (end < len && s[end] != '/') {
+					end++;
+				}
+				String name = path.substring(pos + 1, end);
+				Ref<_priv_WebRouterNode>* child;
+				if (ch == ':') {
+					if (name.isEmpty()) {
+						return sl_false;
+					}
+					child = &(node->parameter);
+				} else {
+					if (end != len) {
+						return sl_false;
+					}
+					if (name.isEmpty()) {
+						name = "*";
+					}
+					child = &(node->wildcard);
+				}
+				if (names.getCount() >= SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS) {
+					LogError("WebRouter", "Too many parameters in the route: %s %s", HttpMethods::toString(method), path);
+					return sl_false;
+				}
+				if (child->isNull()) {
+					*child = new _priv_WebRouterNode;
+					if (child->isNull()) {
+						return sl_false;
+					}
+					(*child)->name = name;
+				} else if ((*child)->name != name) {
+					LogError("WebRouter", "Parameter name '%s' conflicts with '%s' in the route: %s %s", name, (*child)->name, HttpMethods::toString(method), path);
+					return sl_false;
+				}
+				node = child->get();
+				names.add_NoLock(name);
+				start = end;
+				pos = end;
+			} else {
+				pos++;
+			}
+		}
+		if (start < len) {
+			node = node->insertStatic(path.substring(start));
+			if (!node) {
+				return sl_false;
+			}
+		}
+		if (node->handler.isNotNull()) {
+			LogError("WebRouter", "Route is already registered: %s %s", HttpMethods::toString(method), path);
+			return sl_false;
+		}
+		node->handler = handler;
+		node->parameterNames = names;
+		return sl_true;
+	}
+
+	WebHandler WebRouter::find(HttpMethod method, const String& path, List<String>* outParameterNames, sl_uint32* outParameterRanges) const
+	{
+		sl_uint32 indexMethod = (sl_uint32)method;
+		if (indexMethod > (sl_uint32)(HttpMethod::TRACE)) {
+			return sl_null;
+		}
+		sl_uint32 ranges[SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS * 2];
+		if (!outParameterRanges) {
+			outParameterRanges = ranges;
+		}
+		ReadLocker lock(&m_lock);
+		_priv_WebRouterNode* root = m_trees[indexMethod].get();
+		if (root) {
+			_priv_WebRouterNode* node = root->match(path.getData(), path.getLength(), 0, outParameterRanges, 0);
+			if (node) {
+				if (outParameterNames) {
+					*outParameterNames = node->parameterNames;
+				}
+				return node->handler;
+			}
+		}
+		return sl_null;
+	}
+
+	WebHandler WebRouter::route(HttpServiceContext* context) const
+	{
+		List<String> names;
+		sl_uint32 ranges[SLIB_HTTP_SERVICE_MAX_PATH_PARAMETERS * 2];
+		WebHandler handler = find(context->getMethod(), context->getPath(), &names, ranges);
+		if (handler.isNotNull()) {
+			context->setPathParameters(names, ranges);
+		}
+		return handler;
+	}
+
+}